@@ -17,61 +17,154 @@
 //
 
 #include "ADSR.h"
+#include "ParameterUpdate.h"
+#include "TableBank.h"
 #include <math.h>
 
 
 ADSR::ADSR(void) {
     reset();
-    setAttackRate(0);
-    setDecayRate(0);
-    setReleaseRate(0);
-    setSustainLevel(1.f);
-    setTargetRatioA(0.3);
-    setTargetRatioDR(0.0001);
+    attackRate = decayRate = releaseRate = 0.f;
+    pendingAttackRate = pendingDecayRate = pendingReleaseRate = 0.f;
+    sustainLevel = 1.f;
+    targetRatioA = 0.3f;
+    targetRatioDR = 0.0001f;
+    dirty = kAttackDirty | kDecayDirty | kReleaseDirty;
+    updateCoefficients();
 }
 
 ADSR::~ADSR(void) {
 }
 
 void ADSR::setAttackRate(float rate) {
-    attackRate = rate;
-    attackCoef = calcCoef(rate, targetRatioA);
-    attackBase = (1.f + targetRatioA) * (1.f - attackCoef);
+    pendingAttackRate = rate;
+    if (ParameterUpdate::changed(rate, attackRate, kRateEpsilon))
+        dirty |= kAttackDirty;
 }
 
 void ADSR::setDecayRate(float rate) {
-    decayRate = rate;
-    decayCoef = calcCoef(rate, targetRatioDR);
-    decayBase = (sustainLevel - targetRatioDR) * (1.f - decayCoef);
+    pendingDecayRate = rate;
+    if (ParameterUpdate::changed(rate, decayRate, kRateEpsilon))
+        dirty |= kDecayDirty;
 }
 
 void ADSR::setReleaseRate(float rate) {
-    releaseRate = rate;
-    releaseCoef = calcCoef(rate, targetRatioDR);
-    releaseBase = -targetRatioDR * (1.f - releaseCoef);
+    pendingReleaseRate = rate;
+    if (ParameterUpdate::changed(rate, releaseRate, kRateEpsilon))
+        dirty |= kReleaseDirty;
 }
 
 float ADSR::calcCoef(float rate, float targetRatio) {
-    return expf(-logf((1.f + targetRatio) / targetRatio) / rate);
+    /** exp(-ln(q)/rate) = 2^(-log2(q)/rate), from the embedded tables */
+    return tableExp2(-tableLog2((1.f + targetRatio) / targetRatio) / rate);
 }
 
+// the level is compared against directly, so it applies at once; only the
+// decay base derived from it waits for the next update
 void ADSR::setSustainLevel(float level) {
-    sustainLevel = level;
-    decayBase = (sustainLevel - targetRatioDR) * (1.f - decayCoef);
+    if (level != sustainLevel) {
+        sustainLevel = level;
+        dirty |= kDecayDirty;
+    }
 }
 
 void ADSR::setTargetRatioA(float targetRatio) {
     if (targetRatio < 0.000000001)
         targetRatio = 0.000000001;  // -180 dB
-    targetRatioA = targetRatio;
-    attackBase = (1.f + targetRatioA) * (1.f - attackCoef);
+    if (targetRatio != targetRatioA) {
+        targetRatioA = targetRatio;
+        dirty |= kAttackDirty;
+    }
 }
 
 void ADSR::setTargetRatioDR(float targetRatio) {
     if (targetRatio < 0.000000001)
         targetRatio = 0.000000001;  // -180 dB
-    targetRatioDR = targetRatio;
-    decayBase = (sustainLevel - targetRatioDR) * (1.f - decayCoef);
-    releaseBase = -targetRatioDR * (1.f - releaseCoef);
+    if (targetRatio != targetRatioDR) {
+        targetRatioDR = targetRatio;
+        dirty |= kDecayDirty | kReleaseDirty;
+    }
 }
 
+void ADSR::updateCoefficients(void) {
+    if (dirty & kAttackDirty) {
+        attackRate = pendingAttackRate;
+        attackCoef = calcCoef(attackRate, targetRatioA);
+        attackBase = (1.f + targetRatioA) * (1.f - attackCoef);
+    }
+    if (dirty & kDecayDirty) {
+        decayRate = pendingDecayRate;
+        decayCoef = calcCoef(decayRate, targetRatioDR);
+        decayBase = (sustainLevel - targetRatioDR) * (1.f - decayCoef);
+    }
+    if (dirty & kReleaseDirty) {
+        releaseRate = pendingReleaseRate;
+        releaseCoef = calcCoef(releaseRate, targetRatioDR);
+        releaseBase = -targetRatioDR * (1.f - releaseCoef);
+    }
+    dirty = 0;
+    ParameterUpdate::count(ParameterUpdate::kEnvelope);
+}
+
+// copy rates, levels and coefficients from another envelope, keeping this
+// envelope's state and output, so a prepared copy can be swapped in mid-note
+void ADSR::adoptCoefficients(const ADSR &other) {
+    attackRate = other.attackRate;
+    decayRate = other.decayRate;
+    releaseRate = other.releaseRate;
+    attackCoef = other.attackCoef;
+    decayCoef = other.decayCoef;
+    releaseCoef = other.releaseCoef;
+    sustainLevel = other.sustainLevel;
+    targetRatioA = other.targetRatioA;
+    targetRatioDR = other.targetRatioDR;
+    attackBase = other.attackBase;
+    decayBase = other.decayBase;
+    releaseBase = other.releaseBase;
+    pendingAttackRate = other.pendingAttackRate;
+    pendingDecayRate = other.pendingDecayRate;
+    pendingReleaseRate = other.pendingReleaseRate;
+    dirty = other.dirty;
+}
+
+void ADSR::saveSnapshot(Snapshot &snapshot) const {
+    snapshot.state = state;
+    snapshot.output = output;
+    snapshot.attackRate = attackRate;
+    snapshot.decayRate = decayRate;
+    snapshot.releaseRate = releaseRate;
+    snapshot.attackCoef = attackCoef;
+    snapshot.decayCoef = decayCoef;
+    snapshot.releaseCoef = releaseCoef;
+    snapshot.sustainLevel = sustainLevel;
+    snapshot.targetRatioA = targetRatioA;
+    snapshot.targetRatioDR = targetRatioDR;
+    snapshot.attackBase = attackBase;
+    snapshot.decayBase = decayBase;
+    snapshot.releaseBase = releaseBase;
+    snapshot.pendingAttackRate = pendingAttackRate;
+    snapshot.pendingDecayRate = pendingDecayRate;
+    snapshot.pendingReleaseRate = pendingReleaseRate;
+    snapshot.dirty = dirty;
+}
+
+void ADSR::loadSnapshot(const Snapshot &snapshot) {
+    state = snapshot.state;
+    output = snapshot.output;
+    attackRate = snapshot.attackRate;
+    decayRate = snapshot.decayRate;
+    releaseRate = snapshot.releaseRate;
+    attackCoef = snapshot.attackCoef;
+    decayCoef = snapshot.decayCoef;
+    releaseCoef = snapshot.releaseCoef;
+    sustainLevel = snapshot.sustainLevel;
+    targetRatioA = snapshot.targetRatioA;
+    targetRatioDR = snapshot.targetRatioDR;
+    attackBase = snapshot.attackBase;
+    decayBase = snapshot.decayBase;
+    releaseBase = snapshot.releaseBase;
+    pendingAttackRate = snapshot.pendingAttackRate;
+    pendingDecayRate = snapshot.pendingDecayRate;
+    pendingReleaseRate = snapshot.pendingReleaseRate;
+    dirty = snapshot.dirty;
+}
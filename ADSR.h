@@ -46,6 +46,33 @@ public:
     void setTargetRatioA(float targetRatio);
     void setTargetRatioDR(float targetRatio);
     void reset(void);
+    void adoptCoefficients(const ADSR &other);
+
+    // lazy coefficient updates (ParameterUpdate.h): the setters above only
+    // store a target and mark its segment dirty, and process() derives the
+    // dirty segments' coefficients before its next step. A rate within
+    // kRateEpsilon (relative) of the one in use is not a change.
+    // updateCoefficients() derives them now, e.g. on a non-real-time thread
+    // before another envelope adopts them.
+    void updateCoefficients(void);
+    bool hasPendingUpdate(void) const { return dirty != 0; }
+    static constexpr float kRateEpsilon = 1e-3f;
+
+    // complete envelope state, for capturing a block's starting point and
+    // restoring it later (overrun post-mortem and replay)
+    struct Snapshot {
+        int state;
+        float output;
+        float attackRate, decayRate, releaseRate;
+        float attackCoef, decayCoef, releaseCoef;
+        float sustainLevel;
+        float targetRatioA, targetRatioDR;
+        float attackBase, decayBase, releaseBase;
+        float pendingAttackRate, pendingDecayRate, pendingReleaseRate;
+        unsigned int dirty;
+    };
+    void saveSnapshot(Snapshot &snapshot) const;
+    void loadSnapshot(const Snapshot &snapshot);
 
 protected:
 	int state;
@@ -64,9 +91,22 @@ protected:
     float releaseBase;
     std::string name;
     float calcCoef(float rate, float targetRatio);
+
+    // targets of the rate setters; attackRate etc. are the rates in use
+    enum {
+        kAttackDirty = 1,
+        kDecayDirty = 2,
+        kReleaseDirty = 4
+    };
+    float pendingAttackRate;
+    float pendingDecayRate;
+    float pendingReleaseRate;
+    unsigned int dirty;
 };
 
 inline float ADSR::process() {
+	if (dirty)
+		updateCoefficients();
 	switch (state) {
         case env_idle:
             break;
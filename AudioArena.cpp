@@ -0,0 +1,82 @@
+/**
+ * @file AudioArena.cpp
+ * @brief Implementation of the aligned audio-path arena
+ */
+
+#include "AudioArena.h"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+size_t alignUp(size_t bytes) {
+    return (bytes + AudioArena::kAlignment - 1) & ~(AudioArena::kAlignment - 1);
+}
+
+} // namespace
+
+AudioArena::AudioArena()
+    : base(nullptr), capacity(0), used(0), locked(false) {}
+
+AudioArena::~AudioArena() {
+    release();
+}
+
+size_t AudioArena::requiredBytes(const AudioArenaConfig& config) {
+    const size_t voiceBuffer = alignUp(config.subBlockFrames * config.oversampling * sizeof(float));
+    const size_t sharedBuffer = alignUp(config.subBlockFrames * sizeof(float));
+    const size_t periodBuffer = alignUp((config.periodFrames + config.subBlockFrames) * sizeof(float));
+
+    size_t total = 0;
+    total += config.maxVoices * (config.voiceBuffers * voiceBuffer + alignUp(config.voiceStateBytes));
+    total += config.sharedBuffers * sharedBuffer;
+    total += config.periodBuffers * periodBuffer;
+    total += alignUp(config.extraBytes);
+    return total;
+}
+
+bool AudioArena::reserve(size_t bytes) {
+    release();
+
+    bytes = alignUp(bytes);
+    void* memory = nullptr;
+    if (bytes == 0 || posix_memalign(&memory, kAlignment, bytes) != 0)
+        return false;
+
+    /**
+     * Touch every page now. Bela locks the process memory, but pages are
+     * still only mapped on first write; doing that here keeps page faults
+     * out of render(). Zeroing also gives every span a defined start state.
+     */
+    memset(memory, 0, bytes);
+
+    base = static_cast<unsigned char*>(memory);
+    capacity = bytes;
+    used = 0;
+    locked = false;
+    return true;
+}
+
+void* AudioArena::allocateBytes(size_t bytes) {
+    assert(!locked && "AudioArena: allocation after audio start");
+    if (locked)
+        return nullptr;
+
+    const size_t size = alignUp(bytes);
+    assert(used + size <= capacity && "AudioArena: capacity exhausted, check AudioArenaConfig");
+    if (base == nullptr || used + size > capacity)
+        return nullptr;
+
+    void* span = base + used;
+    used += size;
+    return span;
+}
+
+void AudioArena::release() {
+    free(base);
+    base = nullptr;
+    capacity = 0;
+    used = 0;
+    locked = false;
+}
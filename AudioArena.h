@@ -0,0 +1,157 @@
+/**
+ * @file AudioArena.h
+ * @brief Single pre-faulted, 64-byte-aligned memory arena for the audio path
+ *
+ * Every buffer and state block the audio thread touches is carved out of one
+ * contiguous region reserved in setup(). Plain `new float[n]` gives no
+ * alignment guarantee beyond 8 bytes, scatters buffers across the heap, and
+ * leaves freshly allocated pages untouched until the first render() writes
+ * them, which on the Bela means a page fault inside the Xenomai audio task.
+ *
+ * @design_principles
+ * 1. **Reserve once**: Size is computed from the configuration (voices,
+ *    oversampling, block sizes) and reserved in setup()
+ * 2. **Pre-fault**: The whole region is written at reservation so every page
+ *    is resident before audio starts
+ * 3. **Aligned spans**: Every allocation starts on a 64-byte (cache line)
+ *    boundary, so NEON loads never split a line
+ * 4. **Freeze**: lock() is called at the end of setup(); any later allocation
+ *    is a bug and trips an assertion (and returns nullptr in release builds)
+ * 5. **No per-object free**: Memory is returned all at once by release()
+ *
+ * @performance_characteristics
+ * - Allocation: O(1) pointer bump, setup time only
+ * - Reservation: O(bytes) for the pre-fault pass
+ * - Overhead: at most 63 bytes of padding per allocation
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/**
+ * @struct AudioArenaConfig
+ * @brief Engine configuration the arena is sized from
+ *
+ * Each field describes a class of allocation; AudioArena::requiredBytes()
+ * turns the whole configuration into a byte count including alignment
+ * padding, so callers never add up sizes by hand.
+ */
+struct AudioArenaConfig {
+    unsigned int maxVoices = 1;         ///< Simultaneous voices
+    unsigned int oversampling = 1;      ///< Oversampling factor applied to per-voice buffers
+    unsigned int periodFrames = 16;     ///< Hardware period (context->audioFrames)
+    unsigned int subBlockFrames = 8;    ///< Internal DSP block size
+    unsigned int voiceBuffers = 4;      ///< Sub-block scratch buffers per voice (at oversampled rate)
+    unsigned int sharedBuffers = 4;     ///< Sub-block scratch buffers shared by all voices
+    unsigned int periodBuffers = 2;     ///< Period-length buffers (outputs, FIFOs)
+    size_t voiceStateBytes = 256;       ///< Filter/envelope state per voice
+    size_t extraBytes = 0;              ///< Anything else (delay lines, tables)
+};
+
+/**
+ * @class AudioArena
+ * @brief Bump allocator over one aligned, pre-faulted region
+ *
+ * @usage_example
+ * @code
+ * AudioArena arena;
+ *
+ * // In setup():
+ * AudioArenaConfig config;
+ * config.periodFrames = context->audioFrames;
+ * arena.reserve(AudioArena::requiredBytes(config));
+ * float* buffer = arena.allocateFloats(config.subBlockFrames);
+ * ZDFMoogLadderFilter* filter = arena.create<ZDFMoogLadderFilter>(context->audioSampleRate);
+ * arena.lock();
+ *
+ * // In cleanup():
+ * arena.release();
+ * @endcode
+ */
+class AudioArena {
+public:
+    /** @brief Alignment of every allocation in bytes (one cache line) */
+    static const size_t kAlignment = 64;
+
+    AudioArena();
+    ~AudioArena();
+
+    /**
+     * @brief Bytes needed for a configuration, including alignment padding
+     *
+     * @param config Engine configuration
+     * @return Capacity to pass to reserve()
+     */
+    static size_t requiredBytes(const AudioArenaConfig& config);
+
+    /**
+     * @brief Reserve and pre-fault the arena
+     *
+     * @param bytes Capacity in bytes (rounded up to kAlignment)
+     * @return false if the system allocation failed
+     *
+     * @realtime_safety Non-real-time safe (allocates and touches every page)
+     */
+    bool reserve(size_t bytes);
+
+    /**
+     * @brief Hand out an aligned, zero-filled span
+     *
+     * @param bytes Size of the span
+     * @return Pointer aligned to kAlignment, or nullptr if the arena is
+     *         exhausted or locked (asserts in debug builds)
+     */
+    void* allocateBytes(size_t bytes);
+
+    /** @brief Aligned, zeroed float buffer of `count` samples */
+    float* allocateFloats(size_t count) {
+        return static_cast<float*>(allocateBytes(count * sizeof(float)));
+    }
+
+    /**
+     * @brief Construct an object (filter state, envelope, ...) in the arena
+     *
+     * The destructor is never run; only use for types whose destructor is
+     * trivial or irrelevant at shutdown.
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* memory = allocateBytes(sizeof(T));
+        return memory ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    /**
+     * @brief Forbid further allocation; call once setup() has finished
+     */
+    void lock() { locked = true; }
+
+    /**
+     * @brief Free the whole region and unlock (cleanup() only)
+     */
+    void release();
+
+    /** @brief Bytes handed out so far, including padding */
+    size_t getUsedBytes() const { return used; }
+
+    /** @brief Reserved capacity in bytes */
+    size_t getCapacityBytes() const { return capacity; }
+
+    /** @brief True after lock() */
+    bool isLocked() const { return locked; }
+
+private:
+    AudioArena(const AudioArena&) = delete;
+    AudioArena& operator=(const AudioArena&) = delete;
+
+    unsigned char* base;
+    size_t capacity;
+    size_t used;
+    bool locked;
+};
@@ -0,0 +1,191 @@
+/**
+ * @file AutomationLanes.cpp
+ * @brief Implementation of the automation lane recorder and player
+ */
+
+#include "AutomationLanes.h"
+
+namespace {
+
+const unsigned int kLaneBytes = 2 * AutomationLanes::kMaxTicks + 2;
+const float kCodeToValue = 1.0f / AutomationLanes::kMaxCode;
+
+} // namespace
+
+AutomationLanes::AutomationLanes() : laneCount(0), state(kIdle), position(0.0), tick(0), length(0) {
+    for (unsigned int l = 0; l < kMaxLanes; ++l) {
+        lanes[l].data = nullptr;
+        lanes[l].size = 0;
+        lanes[l].touched = false;
+        lanes[l].code = 0;
+        lanes[l].run = 0;
+        lanes[l].read = 0;
+        lanes[l].startCode = 0;
+        lanes[l].current = 0.0f;
+        lanes[l].next = 0.0f;
+    }
+}
+
+size_t AutomationLanes::requiredBytes(unsigned int lanes) {
+    return lanes * (kLaneBytes + AudioArena::kAlignment);
+}
+
+bool AutomationLanes::allocate(unsigned int count, AudioArena& arena) {
+    if (count > kMaxLanes)
+        return false;
+    for (unsigned int l = 0; l < count; ++l) {
+        lanes[l].data = static_cast<uint8_t*>(arena.allocateBytes(kLaneBytes));
+        if (!lanes[l].data)
+            return false;
+    }
+    laneCount = count;
+    return true;
+}
+
+void AutomationLanes::record() {
+    for (unsigned int l = 0; l < laneCount; ++l) {
+        lanes[l].size = 0;
+        lanes[l].touched = false;
+        lanes[l].run = 0;
+    }
+    position = 0.0;
+    tick = 0;
+    length = 0;
+    state = laneCount > 0 ? kRecording : kIdle;
+}
+
+void AutomationLanes::play() {
+    if (state == kRecording) {
+        /** Pad to a whole beat with the last value: zero deltas, so runs */
+        length = (tick + kTicksPerBeat - 1) / kTicksPerBeat * kTicksPerBeat;
+        for (unsigned int l = 0; l < laneCount; ++l) {
+            if (tick == 0)
+                continue;
+            lanes[l].run += length - tick;
+            flushRun(lanes[l]);
+        }
+    }
+    if (length == 0) {
+        state = kIdle;
+        return;
+    }
+    state = kPlaying;
+    restart();
+}
+
+void AutomationLanes::stop() {
+    if (state == kRecording)
+        play();
+    state = kIdle;
+}
+
+void AutomationLanes::restart() {
+    position = 0.0;
+    tick = 0;
+    if (state == kPlaying)
+        rewind();
+}
+
+void AutomationLanes::process(float* values, double beats) {
+    if (state == kRecording) {
+        position += beats * kTicksPerBeat;
+        /** Every grid point crossed this period takes the period's value */
+        while (tick <= position) {
+            for (unsigned int l = 0; l < laneCount; ++l)
+                encode(lanes[l], values[l]);
+            if (++tick == kMaxTicks) {
+                play();
+                return;
+            }
+        }
+    } else if (state == kPlaying) {
+        position += beats * kTicksPerBeat;
+        while (position >= tick + 1)
+            advancePlayback();
+        const float fraction = static_cast<float>(position - tick);
+        for (unsigned int l = 0; l < laneCount; ++l) {
+            const Lane& lane = lanes[l];
+            if (lane.touched)
+                values[l] = lane.current + (lane.next - lane.current) * fraction;
+        }
+    }
+}
+
+void AutomationLanes::encode(Lane& lane, float value) {
+    const float scaled = (value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value)) * kMaxCode;
+    if (lane.size == 0) {
+        lane.code = static_cast<int>(scaled + 0.5f);
+        lane.data[lane.size++] = static_cast<uint8_t>(0xC0 | (lane.code >> 8));
+        lane.data[lane.size++] = static_cast<uint8_t>(lane.code);
+        lane.startCode = lane.code;
+        return;
+    }
+
+    /** Hysteresis: stay on the last code until the value leaves it by 3/4 */
+    const float offset = scaled - static_cast<float>(lane.code);
+    if (offset < 0.75f && offset > -0.75f) {
+        if (++lane.run == 128)
+            flushRun(lane);
+        return;
+    }
+    flushRun(lane);
+    const int code = static_cast<int>(scaled + 0.5f);
+    const int delta = code - lane.code;
+    if (delta >= -32 && delta <= 31) {
+        lane.data[lane.size++] = static_cast<uint8_t>(0x80 | (delta + 32));
+    } else {
+        lane.data[lane.size++] = static_cast<uint8_t>(0xC0 | (code >> 8));
+        lane.data[lane.size++] = static_cast<uint8_t>(code);
+    }
+    lane.code = code;
+    lane.touched = true;
+}
+
+void AutomationLanes::flushRun(Lane& lane) {
+    while (lane.run > 0) {
+        const unsigned int count = lane.run > 128 ? 128 : lane.run;
+        lane.data[lane.size++] = static_cast<uint8_t>(count - 1);
+        lane.run -= count;
+    }
+}
+
+int AutomationLanes::decode(Lane& lane) {
+    if (lane.run > 0) {
+        --lane.run;
+        return lane.code;
+    }
+    const uint8_t token = lane.data[lane.read++];
+    if (token < 0x80)
+        lane.run = token;
+    else if (token < 0xC0)
+        lane.code += static_cast<int>(token & 0x3F) - 32;
+    else
+        lane.code = ((token & 0x0F) << 8) | lane.data[lane.read++];
+    return lane.code;
+}
+
+void AutomationLanes::rewind() {
+    for (unsigned int l = 0; l < laneCount; ++l) {
+        Lane& lane = lanes[l];
+        lane.read = 0;
+        lane.run = 0;
+        lane.current = decode(lane) * kCodeToValue;
+        lane.next = length > 1 ? decode(lane) * kCodeToValue : lane.current;
+    }
+}
+
+void AutomationLanes::advancePlayback() {
+    if (++tick == length) {
+        /** Loop: the last point already interpolated towards point 0 */
+        tick = 0;
+        position -= length;
+        rewind();
+        return;
+    }
+    const bool last = tick + 1 == length;
+    for (unsigned int l = 0; l < laneCount; ++l) {
+        Lane& lane = lanes[l];
+        lane.current = lane.next;
+        lane.next = last ? lane.startCode * kCodeToValue : decode(lane) * kCodeToValue;
+    }
+}
@@ -0,0 +1,168 @@
+/**
+ * @file AutomationLanes.h
+ * @brief Beat-synced recorder and looper for control gestures (pots and CCs)
+ *
+ * A performer records a cutoff sweep on pot 0 or a resonance swell on pot 1
+ * and has it loop in time with the sequencer. AutomationLanes samples each
+ * lane's value once per control tick (render() calls process() once per
+ * period, after reading the panel) onto a fixed beat grid of kTicksPerBeat
+ * points, and plays the grid back interpolated between points. Because the
+ * grid is in beats, not samples, a loop follows tempo changes and the MIDI
+ * clock (through StepSequencer::getBeatSamples()) instead of drifting.
+ *
+ * @encoding
+ * Values are normalised [0, 1] and quantised to 12 bits with half a code
+ * of hysteresis, which absorbs ADC noise on a pot at rest. Each lane is a
+ * byte stream of delta and run-length tokens:
+ *
+ * | Token       | Meaning                                     |
+ * |-------------|---------------------------------------------|
+ * | 0x00-0x7F   | 1-128 points unchanged (run of zero deltas) |
+ * | 0x80-0xBF   | delta of −32 to +31 codes                   |
+ * | 0xC0-0xCF x | absolute 12-bit value (high nibble, then x) |
+ *
+ * A pot at rest costs one byte per 128 points (1.3 beats); a sweep costs
+ * one byte per point. Lanes are sized for the worst case (two bytes per
+ * point over kMaxBeats), so recording never runs out of space.
+ *
+ * @transport
+ * record() clears the lanes and starts at point 0. play() ends the take,
+ * pads it to a whole number of beats with the last value and loops it;
+ * only lanes that moved during the take override the live value, so an
+ * untouched pot stays live. restart() rewinds to point 0 (MIDI clock
+ * start). A take that reaches kMaxBeats switches to playback by itself.
+ *
+ * @performance_characteristics
+ * - Per period: one multiply-add to advance the position; per lane, an
+ *   interpolation while playing
+ * - Per grid point and lane: a compare and usually one byte written, or one
+ *   token decoded (a branch and an add) while playing
+ * - Memory: 2·kMaxBeats·kTicksPerBeat bytes per lane (12 KB), from the arena
+ *
+ * @usage_example
+ * @code
+ * automation.allocate(kNumLanes, audioArena);          // setup()
+ * automation.record();                                 // CC: record
+ *
+ * // render(), once per period:
+ * float lanes[kNumLanes] = { panel.cutoff, panel.resonance };
+ * automation.process(lanes, frames / sequencer.getBeatSamples(now));
+ * panel.cutoff = lanes[0];                             // live or played back
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "AudioArena.h"
+#include <cstdint>
+
+/**
+ * @class AutomationLanes
+ * @brief Delta/run-length encoded control lanes on a beat grid
+ */
+class AutomationLanes {
+public:
+    static const unsigned int kMaxLanes = 8;
+
+    /** @brief Grid points per beat (4 ms at 150 BPM) */
+    static const unsigned int kTicksPerBeat = 96;
+
+    /** @brief Longest take: 16 bars of 4/4 */
+    static const unsigned int kMaxBeats = 64;
+
+    static const unsigned int kMaxTicks = kTicksPerBeat * kMaxBeats;
+
+    /** @brief Quantisation of the normalised value */
+    static const int kMaxCode = 4095;
+
+    /**
+     * @enum State
+     * @brief Transport state
+     */
+    enum State {
+        kIdle = 0,      ///< Live controls; a finished take is kept
+        kRecording,
+        kPlaying
+    };
+
+    AutomationLanes();
+
+    static size_t requiredBytes(unsigned int lanes);
+
+    /**
+     * @brief Take the lane buffers from the arena
+     *
+     * @return false if lanes exceeds kMaxLanes or the arena is full
+     * @realtime_safety Non-real-time safe (setup())
+     */
+    bool allocate(unsigned int lanes, AudioArena& arena);
+
+    /** @brief Clear every lane and start a take at point 0 */
+    void record();
+
+    /** @brief End a take (if recording) and loop it from point 0 */
+    void play();
+
+    /** @brief Back to the live controls; the take is kept */
+    void stop();
+
+    /** @brief Rewind to point 0 without changing state */
+    void restart();
+
+    State getState() const { return state; }
+
+    /** @brief Length of the take in beats, 0 before the first */
+    unsigned int getLengthBeats() const { return length / kTicksPerBeat; }
+
+    /** @brief True if the lane moved during the take (and so plays back) */
+    bool isTouched(unsigned int lane) const { return lanes[lane].touched; }
+
+    /** @brief Encoded size of a lane in bytes */
+    unsigned int getEncodedBytes(unsigned int lane) const { return lanes[lane].size; }
+
+    /**
+     * @brief Advance by one control tick
+     *
+     * Records the values while recording; while playing, replaces the values
+     * of touched lanes with the take at the new position.
+     *
+     * @param values One normalised value per lane, live in, result out
+     * @param beats Beats elapsed since the last call
+     * @realtime_safety Real-time safe
+     */
+    void process(float* values, double beats);
+
+private:
+    /**
+     * @struct Lane
+     * @brief One encoded stream with its encoder and decoder state
+     */
+    struct Lane {
+        uint8_t* data;
+        unsigned int size;          ///< Bytes written
+        bool touched;
+        int code;                   ///< Encoder: last code; decoder: running value
+        unsigned int run;           ///< Encoder: pending zero deltas; decoder: repeats left
+        unsigned int read;          ///< Decoder position
+        int startCode;              ///< Code at point 0, closes the loop
+        float current;              ///< Value at the current point
+        float next;                 ///< Value at the following point
+    };
+
+    void encode(Lane& lane, float value);
+    void flushRun(Lane& lane);
+    int decode(Lane& lane);
+    void rewind();
+    void advancePlayback();
+
+    Lane lanes[kMaxLanes];
+    unsigned int laneCount;
+    State state;
+    double position;                ///< Grid points since point 0, fractional
+    unsigned int tick;              ///< Recording: next point; playing: current point
+    unsigned int length;            ///< Points in the take
+};
@@ -0,0 +1,264 @@
+/**
+ * @file BlockTrace.cpp
+ * @brief Implementation of the block trace recorder
+ */
+
+#include "BlockTrace.h"
+#include "AudioArena.h"
+#include <cmath>
+#include <cstdio>
+#include <time.h>
+
+namespace {
+
+inline uint64_t nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/** @brief Trace viewer ids: one process, audio thread and counters on track 1 */
+const int kTracePid = 1;
+const int kTraceTid = 1;
+
+const char* midiName(uint8_t status) {
+    switch (status & 0xF0) {
+    case 0x80: return "note off";
+    case 0x90: return "note on";
+    case 0xB0: return "control change";
+    case 0xF0:
+        switch (status) {
+        case 0xF8: return "clock";
+        case 0xFA: return "start";
+        case 0xFC: return "stop";
+        default: return "system";
+        }
+    default: return "midi";
+    }
+}
+
+} // namespace
+
+BlockTrace::BlockTrace()
+    : ring(nullptr), mask(0), head(0), tail(0), dropped(0), overruns(0), blockStartNs(0),
+      historyNext(0), historyWrapped(false), overrunsExported(0), lastExportNs(0), exportIndex(0),
+      outputPrefix("tr123e-trace") {
+    for (int i = 0; i < kMaxParameters; ++i) {
+        lastParameter[i] = NAN;
+        parameterNames[i] = nullptr;
+    }
+    for (int i = 0; i < kMaxStages; ++i)
+        stageNames[i] = nullptr;
+    for (int i = 0; i < kMaxEnvelopes; ++i)
+        envelopeNames[i] = nullptr;
+}
+
+size_t BlockTrace::requiredBytes(unsigned int capacity) {
+    return capacity * sizeof(TraceRecord) + AudioArena::kAlignment;
+}
+
+bool BlockTrace::allocate(unsigned int capacity, unsigned int historyRecords, AudioArena& arena) {
+    if (capacity < 16 || (capacity & (capacity - 1)) != 0)
+        return false;
+    ring = static_cast<TraceRecord*>(arena.allocateBytes(capacity * sizeof(TraceRecord)));
+    if (!ring)
+        return false;
+    mask = capacity - 1;
+    history.assign(historyRecords, TraceRecord());
+    return true;
+}
+
+void BlockTrace::setStageName(int stage, const char* name) {
+    if (stage >= 0 && stage < kMaxStages)
+        stageNames[stage] = name;
+}
+
+void BlockTrace::setParameterName(int parameter, const char* name) {
+    if (parameter >= 0 && parameter < kMaxParameters)
+        parameterNames[parameter] = name;
+}
+
+void BlockTrace::setEnvelopeName(int envelope, const char* name) {
+    if (envelope >= 0 && envelope < kMaxEnvelopes)
+        envelopeNames[envelope] = name;
+}
+
+void BlockTrace::push(uint8_t type, uint8_t id, uint16_t data, float value) {
+    if (ring)
+        pushAt(nowNs(), type, id, data, value);
+}
+
+void BlockTrace::pushAt(uint64_t timeNs, uint8_t type, uint8_t id, uint16_t data, float value) {
+    const unsigned int h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) > mask) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceRecord& record = ring[h & mask];
+    record.timeNs = timeNs;
+    record.type = type;
+    record.id = id;
+    record.data = data;
+    record.value = value;
+    head.store(h + 1, std::memory_order_release);
+}
+
+void BlockTrace::blockBegin(uint64_t frame) {
+    if (!ring)
+        return;
+    blockStartNs = nowNs();
+    pushAt(blockStartNs, kBlockBegin, 0, 0, static_cast<float>(frame & 0xFFFFFF));
+}
+
+void BlockTrace::blockEnd(uint64_t periodNs) {
+    if (!ring)
+        return;
+    const uint64_t endNs = nowNs();
+    pushAt(endNs, kBlockEnd, 0, 0, 0.0f);
+
+    /**
+     * The overrun is counted even if its record is dropped, so the drain
+     * task still exports what the history holds
+     */
+    if (periodNs != 0 && endNs - blockStartNs > periodNs) {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+        pushAt(endNs, kOverrun, 0, 0, static_cast<float>(endNs - blockStartNs) / static_cast<float>(periodNs));
+    }
+}
+
+void BlockTrace::parameter(int id, float value) {
+    if (id < 0 || id >= kMaxParameters)
+        return;
+    lastParameter[id] = value;
+    push(kParameter, static_cast<uint8_t>(id), 0, value);
+}
+
+void BlockTrace::parameterIfChanged(int id, float value, float threshold) {
+    if (id < 0 || id >= kMaxParameters)
+        return;
+    if (fabsf(value - lastParameter[id]) > threshold || std::isnan(lastParameter[id]))
+        parameter(id, value);
+}
+
+bool BlockTrace::needsDrain() const {
+    if (!ring)
+        return false;
+    const unsigned int pending = head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+    return pending > (mask + 1) / 4 || overruns.load(std::memory_order_relaxed) != overrunsExported;
+}
+
+void BlockTrace::drain() {
+    if (!ring)
+        return;
+
+    /**
+     * Copy everything published so far, then hand the slots back
+     */
+    const unsigned int h = head.load(std::memory_order_acquire);
+    unsigned int t = tail.load(std::memory_order_relaxed);
+    for (; t != h; ++t) {
+        const TraceRecord& record = ring[t & mask];
+        if (!history.empty()) {
+            history[historyNext] = record;
+            if (++historyNext == history.size()) {
+                historyNext = 0;
+                historyWrapped = true;
+            }
+        }
+    }
+    tail.store(t, std::memory_order_release);
+
+    /**
+     * Export after an overrun, unless one was written very recently; the
+     * overrun then remains in the history for the next export
+     */
+    const unsigned int overrunCount = overruns.load(std::memory_order_relaxed);
+    if (overrunCount != overrunsExported) {
+        overrunsExported = overrunCount;
+        const uint64_t now = nowNs();
+        if (lastExportNs == 0 || now - lastExportNs > kExportHoldoffNs) {
+            exportHistory();
+            lastExportNs = now;
+        }
+    }
+}
+
+bool BlockTrace::flush() {
+    drain();
+    return exportHistory();
+}
+
+bool BlockTrace::exportHistory() {
+    const size_t count = historyWrapped ? history.size() : historyNext;
+    if (count == 0)
+        return true;
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s-%u.json", outputPrefix, exportIndex++);
+    FILE* file = fopen(path, "w");
+    if (!file)
+        return false;
+
+    /**
+     * Chrome trace "JSON array" format: timestamps in microseconds from the
+     * first exported record
+     */
+    const size_t first = historyWrapped ? historyNext : 0;
+    const uint64_t originNs = history[first].timeNs;
+
+    fprintf(file, "[\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"audio\"}}",
+            kTracePid, kTraceTid);
+    fprintf(file, ",\n{\"name\":\"dropped records\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"count\":%u,\"overruns\":%u}}",
+            kTracePid, kTraceTid, getDroppedCount(), getOverrunCount());
+
+    for (size_t i = 0; i < count; ++i) {
+        const TraceRecord& r = history[(first + i) % history.size()];
+        const double ts = static_cast<double>(r.timeNs - originNs) * 1e-3;
+        fprintf(file, ",\n");
+
+        switch (r.type) {
+        case kBlockBegin:
+            fprintf(file, "{\"name\":\"block\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,\"args\":{\"frame\":%.0f}}",
+                    ts, kTracePid, kTraceTid, r.value);
+            break;
+        case kBlockEnd:
+            fprintf(file, "{\"name\":\"block\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}", ts, kTracePid, kTraceTid);
+            break;
+        case kStageBegin:
+        case kStageEnd: {
+            const char* name = (r.id < kMaxStages && stageNames[r.id]) ? stageNames[r.id] : "stage";
+            fprintf(file, "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+                    name, r.type == kStageBegin ? 'B' : 'E', ts, kTracePid, kTraceTid);
+            break;
+        }
+        case kMidi:
+            fprintf(file, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,"
+                          "\"args\":{\"status\":%u,\"data1\":%u,\"data2\":%u}}",
+                    midiName(r.id), ts, kTracePid, kTraceTid, r.id, r.data & 0xFF, r.data >> 8);
+            break;
+        case kParameter:
+            if (parameterNames[r.id])
+                fprintf(file, "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"args\":{\"value\":%g}}",
+                        parameterNames[r.id], ts, kTracePid, r.value);
+            else
+                fprintf(file, "{\"name\":\"parameter %u\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"args\":{\"value\":%g}}",
+                        r.id, ts, kTracePid, r.value);
+            break;
+        case kEnvelope: {
+            const char* name = (r.id < kMaxEnvelopes && envelopeNames[r.id]) ? envelopeNames[r.id] : "envelope";
+            fprintf(file, "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"args\":{\"output\":%g,\"state\":%u}}",
+                    name, ts, kTracePid, r.value, r.data);
+            break;
+        }
+        default:
+            fprintf(file, "{\"name\":\"overrun\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,"
+                          "\"args\":{\"load\":%.2f}}",
+                    ts, kTracePid, kTraceTid, r.value);
+            break;
+        }
+    }
+    fprintf(file, "\n]\n");
+    const bool ok = (ferror(file) == 0);
+    fclose(file);
+    return ok;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file BlockTrace.h
+ * @brief Lock-free per-block trace recorder with Chrome/Perfetto trace export
+ *
+ * When a block overruns on stage there is nothing to say what the callback
+ * was doing. The audio thread logs compact 16-byte records into a
+ * preallocated single-producer/single-consumer ring:
+ * - block begin/end, with the block's first frame
+ * - stage boundaries (MIDI parsing, controls, synthesis, each sub-block, ...)
+ * - every MIDI message handled (status and data bytes)
+ * - parameter changes (MIDI CCs, and panel controls when they move)
+ * - envelope state and output, once per block
+ * - an overrun marker when a block takes longer than its period
+ *
+ * An auxiliary task drains the ring into a history covering the last
+ * several seconds. Nothing touches the disk while playing normally: the
+ * history is written as Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+ * shortly after an overrun, at most once per holdoff interval, and once
+ * more from cleanup(), so a whole set can be inspected on a laptop
+ * afterwards.
+ *
+ * @thread_model
+ * The audio thread is the only producer and the drain task the only
+ * consumer. Each side owns one index; a release store publishes it and the
+ * other side reads it with acquire. When the ring is full the record is
+ * dropped and counted: the audio thread never waits.
+ *
+ * @performance_characteristics
+ * - Per record: one clock read, one 16-byte store, one release store; the
+ *   recorder adds ~20 records per block
+ * - Ring memory: taken from the AudioArena (capacity × 16 bytes)
+ * - History memory: allocated in setup(), history × 16 bytes
+ * - Export: ~100 bytes of JSON per record, written off the audio thread
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class AudioArena;
+
+/**
+ * @struct TraceRecord
+ * @brief One 16-byte trace entry
+ */
+struct TraceRecord {
+    uint64_t timeNs;    ///< CLOCK_MONOTONIC time of the event
+    uint8_t type;       ///< BlockTrace::RecordType
+    uint8_t id;         ///< Stage, parameter or envelope id; MIDI status byte
+    uint16_t data;      ///< MIDI data bytes, envelope state, ...
+    float value;        ///< Parameter value, envelope output, block frame (low bits)
+};
+
+/**
+ * @class BlockTrace
+ * @brief Audio-thread trace ring with a background drain and JSON export
+ *
+ * @usage_example
+ * @code
+ * // setup():
+ * arenaConfig.extraBytes += BlockTrace::requiredBytes(kTraceCapacity);
+ * blockTrace.allocate(kTraceCapacity, kTraceHistory, audioArena);
+ * blockTrace.setStageName(kTraceSynthesis, "synthesis");
+ *
+ * // render():
+ * blockTrace.blockBegin(context->audioFramesElapsed);
+ * blockTrace.stageBegin(kTraceSynthesis);
+ * ...
+ * blockTrace.stageEnd(kTraceSynthesis);
+ * blockTrace.blockEnd(periodNs);
+ * if (blockTrace.needsDrain())
+ *     Bela_scheduleAuxiliaryTask(traceTask);
+ *
+ * // auxiliary task:
+ * blockTrace.drain();
+ * @endcode
+ */
+class BlockTrace {
+public:
+    /**
+     * @enum RecordType
+     * @brief Kinds of trace record
+     */
+    enum RecordType {
+        kBlockBegin = 0,    ///< value: block's first frame (mod 2^24, exact in float)
+        kBlockEnd,
+        kStageBegin,        ///< id: stage
+        kStageEnd,          ///< id: stage
+        kMidi,              ///< id: status byte, data: data1 | data2 << 8
+        kParameter,         ///< id: parameter, value: new value
+        kEnvelope,          ///< id: envelope, data: state, value: output
+        kOverrun            ///< value: block duration / period
+    };
+
+    /** @brief Name table sizes: stage and envelope ids < 32, parameter ids < 256 */
+    static const int kMaxStages = 32;
+    static const int kMaxEnvelopes = 8;
+    static const int kMaxParameters = 256;
+
+    BlockTrace();
+
+    /** @brief Arena bytes needed for a ring of `capacity` records */
+    static size_t requiredBytes(unsigned int capacity);
+
+    /**
+     * @brief Take the ring from the arena and allocate the drain history
+     *
+     * @param capacity Ring size in records, a power of two (a few hundred
+     *                 blocks' worth: the drain runs every quarter ring)
+     * @param historyRecords Records kept for export (e.g. 10 s of blocks)
+     * @param arena Unlocked audio arena
+     * @return false if the capacity is not a power of two or the arena is full
+     *
+     * @realtime_safety Non-real-time safe (call from setup())
+     */
+    bool allocate(unsigned int capacity, unsigned int historyRecords, AudioArena& arena);
+
+    /** @brief Names shown in the trace viewer (string literals; setup only) */
+    void setStageName(int stage, const char* name);
+    void setParameterName(int parameter, const char* name);
+    void setEnvelopeName(int envelope, const char* name);
+
+    /**
+     * @brief Export file prefix; files are named <prefix>-<n>.json
+     */
+    void setOutputPrefix(const char* prefix) { outputPrefix = prefix; }
+
+    // ------------------------------------------------------------------------
+    // Audio thread
+    // ------------------------------------------------------------------------
+
+    /** @brief Start of render() */
+    void blockBegin(uint64_t frame);
+
+    /**
+     * @brief End of render(); logs an overrun if the block outlasted its period
+     *
+     * @param periodNs Duration of the block's audio in nanoseconds
+     */
+    void blockEnd(uint64_t periodNs);
+
+    void stageBegin(int stage) { push(kStageBegin, static_cast<uint8_t>(stage), 0, 0.0f); }
+    void stageEnd(int stage) { push(kStageEnd, static_cast<uint8_t>(stage), 0, 0.0f); }
+
+    void midi(uint8_t status, uint8_t data1, uint8_t data2) {
+        push(kMidi, status, static_cast<uint16_t>(data1 | (data2 << 8)), 0.0f);
+    }
+
+    /** @brief A parameter set to a new value */
+    void parameter(int id, float value);
+
+    /**
+     * @brief A continuous control, logged only when it moves by more than `threshold`
+     */
+    void parameterIfChanged(int id, float value, float threshold);
+
+    void envelope(int id, int state, float output) {
+        push(kEnvelope, static_cast<uint8_t>(id), static_cast<uint16_t>(state), output);
+    }
+
+    /**
+     * @brief True when the drain task should run (ring a quarter full, or an overrun to export)
+     */
+    bool needsDrain() const;
+
+    // ------------------------------------------------------------------------
+    // Drain task
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Move ring records into the history; export after an overrun
+     *
+     * @realtime_safety Non-real-time (auxiliary task); may write a file
+     */
+    void drain();
+
+    /**
+     * @brief Drain and write the history now (cleanup())
+     *
+     * @return false if the file could not be written
+     */
+    bool flush();
+
+    /** @brief Records the audio thread had to drop because the ring was full */
+    unsigned int getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    /** @brief Overruns recorded since allocate() */
+    unsigned int getOverrunCount() const { return overruns.load(std::memory_order_relaxed); }
+
+private:
+    void push(uint8_t type, uint8_t id, uint16_t data, float value);
+    void pushAt(uint64_t timeNs, uint8_t type, uint8_t id, uint16_t data, float value);
+    bool exportHistory();
+
+    /** @brief Minimum time between two overrun exports */
+    static const uint64_t kExportHoldoffNs = 10000000000ull;
+
+    // Audio-thread side
+    TraceRecord* ring;
+    unsigned int mask;
+    std::atomic<unsigned int> head;     ///< Next slot to write (producer)
+    std::atomic<unsigned int> tail;     ///< Next slot to read (consumer)
+    std::atomic<unsigned int> dropped;
+    std::atomic<unsigned int> overruns;
+    uint64_t blockStartNs;
+    float lastParameter[kMaxParameters];
+
+    // Drain side
+    std::vector<TraceRecord> history;
+    size_t historyNext;
+    bool historyWrapped;
+    unsigned int overrunsExported;
+    uint64_t lastExportNs;
+    unsigned int exportIndex;
+    const char* outputPrefix;
+
+    const char* stageNames[kMaxStages];
+    const char* parameterNames[kMaxParameters];
+    const char* envelopeNames[kMaxEnvelopes];
+};
@@ -3,7 +3,7 @@
  * @brief Implementation of empirically-tuned Virtual Analog Moog filter
  */
 
-#include "MoogFilter.h"
+#include "EmpiricallyTunedMoogFilter.h"
 
 /**
  * @brief Fast tanh approximation using rational function
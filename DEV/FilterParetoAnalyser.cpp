@@ -0,0 +1,821 @@
+/**
+ * @file FilterParetoAnalyser.cpp
+ * @brief Quality-versus-cost analysis of the ladder filter variants, with Pareto front
+ *
+ * DEV holds several ladder implementations and nothing objective to choose
+ * between them. This tool runs every variant in every setting it supports:
+ * - Oversampling ×1, ×2 or ×4 (polyphase windowed-sinc resampler)
+ * - Saturator tier: none (ZDF drive 0), tanhf, rational tanh, quadratic (Q16)
+ * - Float or fixed point arithmetic
+ *
+ * It measures the cost and four quality figures for each configuration:
+ * - **Cost**: cycles per sample (ns when counters are unavailable, see
+ *   PerfCounters), resampler included
+ * - **Aliasing**: worst SNR over high-note tones (C7, A7, E8) driven hard
+ *   into the filter; harmonics below Nyquist count as signal, every other
+ *   bin as alias and noise
+ * - **THD**: a 220 Hz tone at half scale and resonance 0.5, harmonics
+ *   2-20, compared with the reference as |ΔTHD| in dB
+ * - **Resonance-peak accuracy**: small-signal resonant peak at resonance 0.7
+ *   for cutoffs of 1 and 5 kHz, worst error in cents against the nominal
+ *   cutoff; "-" when there is no clear peak (under 1 dB, or the variant is
+ *   already oscillating)
+ * - **Self-oscillation tuning**: frequency at full resonance and drive for
+ *   the same cutoffs, worst error in cents; "-" when it does not oscillate
+ *
+ * Configurations whose output diverges or vanishes in the THD setting are
+ * listed as unstable or silent and kept off the front.
+ *
+ * MSPMoogLadderFilter (double-precision Huovilainen model) is the
+ * distortion reference. Its cutoff is an envelope control value rather
+ * than Hz, so the tool calibrates it first: bisection finds the control
+ * value at which the response without resonance is 12 dB down at the
+ * requested cutoff, as for an ideal four-pole ladder. Its resonance is too
+ * weak for a peak or self-oscillation, so tuning is judged against the
+ * nominal cutoff instead.
+ *
+ * @pareto_front
+ * A configuration is on the front when no other one is at least as good in
+ * all five objectives (cost, -SNR, |ΔTHD|, |peak ¢|, |self-osc ¢|) and
+ * better in one. Given a sound target, the tool also names the cheapest
+ * configuration that meets it.
+ *
+ * @build
+ * @code
+ * g++ -O3 -std=c++17 -I. -IDEV DEV/FilterParetoAnalyser.cpp DEV/PerfCounters.cpp \
+ *     zdf_moogladder_v2.cpp TableBank.cpp DEV/MSPMoogLadderFilter.cpp \
+ *     DEV/BilinearTransformMoogLadderFilter.cpp DEV/EmpiricallyTunedMoogFilter.cpp \
+ *     DEV/MoogLadderFilterFixedPoint.cpp ParameterUpdate.cpp -o filterpareto
+ * ./filterpareto                                   # table and front
+ * ./filterpareto --min-snr 60 --max-cents 10       # plus cheapest passing configuration
+ * @endcode
+ * Options: --min-snr dB, --max-thd-error dB, --max-cents ¢ (applies to peak
+ * and self-oscillation), --require-self-osc. Run it on the board for
+ * deployment costs; on a desktop the cost ranking is only indicative.
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#include "PerfCounters.h"
+#include "zdf_moogladder_v2.h"
+#include "MSPMoogLadderFilter.h"
+#include "MoogLadderFilter.h"
+#include "EmpiricallyTunedMoogFilter.h"
+#include "MoogLadderFilterFixedPoint.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+const float kBaseRate = 44100.0f;
+
+/** @brief Analysis length: a power of two for the FFT */
+const unsigned int kFftSize = 16384;
+
+/** @brief Samples run before analysis so the filter reaches steady state */
+const unsigned int kSettleFrames = 8192;
+
+/** @brief Floor / ceiling applied to dB figures (a linear filter has no THD or aliasing) */
+const double kDbFloor = -140.0;
+const double kDbCeiling = 140.0;
+
+const float kPeakResonance = 0.7f;
+const float kTestCutoffs[] = {1000.0f, 5000.0f};
+const float kAliasTones[] = {2093.0f, 3520.0f, 5274.0f};    // C7, A7, E8
+
+// ============================================================================
+// FILTER MODELS
+// ============================================================================
+
+/**
+ * @class FilterModel
+ * @brief Common interface over the ladder variants
+ *
+ * Resonance is normalised: 0 none, 1 the variant's maximum (self-oscillation
+ * where it has it). Drive only affects variants with a drive control.
+ */
+class FilterModel {
+public:
+    virtual ~FilterModel() {}
+
+    /** @brief (Re)create the filter at a sample rate, clearing all state */
+    virtual void prepare(float sampleRate) = 0;
+    virtual void set(float cutoffHz, float resonance, float drive) = 0;
+    virtual float process(float input) = 0;
+};
+
+class ZdfModel : public FilterModel {
+public:
+    explicit ZdfModel(bool saturate) : saturate(saturate) {}
+    void prepare(float sampleRate) override { filter.reset(new ZDFMoogLadderFilter(sampleRate)); }
+    void set(float cutoffHz, float resonance, float drive) override {
+        filter->setCutoff(cutoffHz);
+        filter->setResonance(resonance);
+        filter->setDrive(saturate ? drive : 0.0f);
+    }
+    float process(float input) override { return filter->process(input); }
+
+private:
+    bool saturate;
+    std::unique_ptr<ZDFMoogLadderFilter> filter;
+};
+
+class BilinearModel : public FilterModel {
+public:
+    void prepare(float sampleRate) override { filter.reset(new MoogLadderFilter(sampleRate)); }
+    void set(float cutoffHz, float resonance, float) override {
+        filter->setCutoff(cutoffHz);
+        filter->setResonance(resonance);
+    }
+    float process(float input) override { return filter->process(input); }
+
+private:
+    std::unique_ptr<MoogLadderFilter> filter;
+};
+
+class EmpiricalModel : public FilterModel {
+public:
+    void prepare(float sampleRate) override { filter.reset(new MoogFilter(sampleRate)); }
+    void set(float cutoffHz, float resonance, float) override {
+        filter->setCutoff(cutoffHz);
+        filter->setResonance(resonance);
+    }
+    float process(float input) override { return filter->process(input); }
+
+private:
+    std::unique_ptr<MoogFilter> filter;
+};
+
+class FixedPointModel : public FilterModel {
+public:
+    void prepare(float sampleRate) override {
+        filter.reset(new MoogLadderFilterFixedPoint(static_cast<int>(sampleRate)));
+    }
+    void set(float cutoffHz, float resonance, float) override {
+        filter->setCutoff(static_cast<int>(cutoffHz));
+        filter->setResonance(static_cast<int>(resonance * 255.0f));
+    }
+    float process(float input) override {
+        return static_cast<float>(filter->process(static_cast<int>(input * kScale))) * (1.0f / kScale);
+    }
+
+private:
+    static constexpr float kScale = 16384.0f;
+    std::unique_ptr<MoogLadderFilterFixedPoint> filter;
+};
+
+double measureGainDb(FilterModel& model, float frequencyHz);
+
+/**
+ * @class MspModel
+ * @brief Reference model, driven in Hz through a calibrated control mapping
+ */
+class MspModel : public FilterModel {
+public:
+    MspModel() : sampleRate(kBaseRate), control(64.0), resonance(0.0) {}
+
+    void prepare(float newSampleRate) override {
+        sampleRate = newSampleRate;
+        filter.reset(new MSPMoogLadderFilter(sampleRate));
+    }
+
+    void set(float cutoffHz, float newResonance, float) override {
+        resonance = newResonance;
+        control = controlForCutoff(cutoffHz);
+    }
+
+    float process(float input) override {
+        return static_cast<float>(filter->processSample(input, control, resonance, 0.0, 0));
+    }
+
+    /** @brief Set the raw envelope control (calibration only) */
+    void setControl(double newControl, double newResonance) {
+        control = newControl;
+        resonance = newResonance;
+    }
+
+private:
+    struct CalibrationPoint {
+        float sampleRate;
+        float cutoffHz;
+        double control;
+    };
+
+    /**
+     * @brief Envelope control that puts the cutoff at cutoffHz
+     *
+     * Cutoff is taken in the ideal-ladder sense: without resonance a
+     * four-pole ladder is 12 dB down at its cutoff. The attenuation at a
+     * fixed frequency falls monotonically as the control rises, so a
+     * bisection over [0, 127] converges; results are cached per cutoff.
+     */
+    double controlForCutoff(float cutoffHz) {
+        for (const CalibrationPoint& point : calibration) {
+            if (point.sampleRate == sampleRate && point.cutoffHz == cutoffHz)
+                return point.control;
+        }
+
+        double low = 0.0;
+        double high = 127.0;
+        for (int iteration = 0; iteration < 20; ++iteration) {
+            const double middle = 0.5 * (low + high);
+            MspModel probe;
+            probe.prepare(sampleRate);
+            probe.setControl(middle, 0.0);
+            if (measureGainDb(probe, cutoffHz) < -12.0)
+                low = middle;
+            else
+                high = middle;
+        }
+        calibration.push_back({sampleRate, cutoffHz, 0.5 * (low + high)});
+        return calibration.back().control;
+    }
+
+    float sampleRate;
+    double control;
+    double resonance;
+    std::unique_ptr<MSPMoogLadderFilter> filter;
+    std::vector<CalibrationPoint> calibration;
+};
+
+/**
+ * @class OversampledModel
+ * @brief Runs a model at factor × the base rate behind polyphase FIR resamplers
+ *
+ * Both FIRs are Blackman-windowed sinc lowpasses at 0.45 × the base rate
+ * with 24 taps per phase. Only non-zero products are computed when
+ * upsampling, and the decimator is evaluated at the kept samples only, so
+ * the cost reported is what a production implementation would pay.
+ */
+class OversampledModel : public FilterModel {
+public:
+    OversampledModel(FilterModel* inner, int factor) : inner(inner), factor(factor) {
+        const int taps = kTapsPerPhase * factor;
+        coefficients.resize(taps);
+        const double cutoff = 0.45 / factor;    // cycles per oversampled sample
+        const double centre = 0.5 * (taps - 1);
+        double sum = 0.0;
+        for (int t = 0; t < taps; ++t) {
+            const double x = t - centre;
+            const double sinc = (x == 0.0) ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+            const double phase = 2.0 * M_PI * t / (taps - 1);
+            const double window = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase);
+            coefficients[t] = static_cast<float>(sinc * window);
+            sum += coefficients[t];
+        }
+        for (float& c : coefficients)
+            c = static_cast<float>(c / sum);
+        upHistory.assign(kTapsPerPhase, 0.0f);
+        downHistory.assign(taps, 0.0f);
+    }
+
+    void prepare(float sampleRate) override {
+        inner->prepare(sampleRate * factor);
+        std::fill(upHistory.begin(), upHistory.end(), 0.0f);
+        std::fill(downHistory.begin(), downHistory.end(), 0.0f);
+        downPosition = 0;
+    }
+
+    void set(float cutoffHz, float resonance, float drive) override { inner->set(cutoffHz, resonance, drive); }
+
+    float process(float input) override {
+        /**
+         * Upsample: the zero-stuffed stream's phase p only meets the
+         * coefficients p, p + factor, ...; gain factor restores the level
+         */
+        std::copy_backward(upHistory.begin(), upHistory.end() - 1, upHistory.end());
+        upHistory[0] = input;
+        float result = 0.0f;
+        const int taps = static_cast<int>(coefficients.size());
+        for (int p = 0; p < factor; ++p) {
+            float up = 0.0f;
+            for (int k = 0; k < kTapsPerPhase; ++k)
+                up += coefficients[p + k * factor] * upHistory[k];
+            const float filtered = inner->process(up * factor);
+
+            downHistory[downPosition] = filtered;
+            downPosition = (downPosition + 1 == taps) ? 0 : downPosition + 1;
+        }
+
+        /**
+         * Decimate: evaluate the lowpass only at the sample that is kept
+         */
+        int index = downPosition;
+        for (int t = taps - 1; t >= 0; --t) {
+            result += coefficients[t] * downHistory[index];
+            index = (index + 1 == taps) ? 0 : index + 1;
+        }
+        return result;
+    }
+
+private:
+    static const int kTapsPerPhase = 24;
+
+    std::unique_ptr<FilterModel> inner;
+    int factor;
+    std::vector<float> coefficients;
+    std::vector<float> upHistory;
+    std::vector<float> downHistory;
+    int downPosition = 0;
+};
+
+// ============================================================================
+// SPECTRAL ANALYSIS
+// ============================================================================
+
+/** @brief In-place iterative radix-2 FFT */
+void fft(std::vector<std::complex<double>>& data) {
+    const size_t n = data.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(data[i], data[j]);
+    }
+    for (size_t length = 2; length <= n; length <<= 1) {
+        const std::complex<double> step = std::polar(1.0, -2.0 * M_PI / static_cast<double>(length));
+        for (size_t start = 0; start < n; start += length) {
+            std::complex<double> w(1.0, 0.0);
+            for (size_t k = 0; k < length / 2; ++k) {
+                const std::complex<double> a = data[start + k];
+                const std::complex<double> b = data[start + k + length / 2] * w;
+                data[start + k] = a + b;
+                data[start + k + length / 2] = a - b;
+                w *= step;
+            }
+        }
+    }
+}
+
+/** @brief Power spectrum |X[k]|², k = 0 .. N/2 */
+std::vector<double> powerSpectrum(const std::vector<float>& signal, bool window) {
+    std::vector<std::complex<double>> data(signal.size());
+    for (size_t n = 0; n < signal.size(); ++n) {
+        const double w = window ? 0.5 - 0.5 * cos(2.0 * M_PI * n / signal.size()) : 1.0;
+        data[n] = signal[n] * w;
+    }
+    fft(data);
+    std::vector<double> power(signal.size() / 2 + 1);
+    for (size_t k = 0; k < power.size(); ++k)
+        power[k] = std::norm(data[k]);
+    return power;
+}
+
+/**
+ * @brief Frequency of the largest bin in [minHz, maxHz], refined by
+ *        parabolic interpolation on the log magnitude
+ */
+double spectralPeakHz(const std::vector<double>& power, float sampleRate, double minHz, double maxHz) {
+    const double binHz = sampleRate / static_cast<double>(2 * (power.size() - 1));
+    size_t first = static_cast<size_t>(minHz / binHz);
+    size_t last = static_cast<size_t>(maxHz / binHz);
+    if (first < 1)
+        first = 1;
+    if (last > power.size() - 2)
+        last = power.size() - 2;
+
+    size_t best = first;
+    for (size_t k = first; k <= last; ++k) {
+        if (power[k] > power[best])
+            best = k;
+    }
+    const double a = log(power[best - 1] + 1e-300);
+    const double b = log(power[best] + 1e-300);
+    const double c = log(power[best + 1] + 1e-300);
+    const double denominator = a - 2.0 * b + c;
+    const double offset = (denominator != 0.0) ? 0.5 * (a - c) / denominator : 0.0;
+    return (best + offset) * binHz;
+}
+
+/** @brief Nearest odd bin to a frequency: odd bins keep harmonics and aliases apart */
+unsigned int oddBin(float frequencyHz) {
+    unsigned int bin = static_cast<unsigned int>(frequencyHz * kFftSize / kBaseRate + 0.5f);
+    return bin | 1u;
+}
+
+double toDb(double ratio) {
+    const double db = 10.0 * log10(ratio);
+    return (db < kDbFloor) ? kDbFloor : (db > kDbCeiling) ? kDbCeiling : db;
+}
+
+double cents(double ratio) {
+    return 1200.0 * log2(ratio);
+}
+
+/**
+ * @brief Run a bin-exact sine through the model and return the settled output block
+ */
+std::vector<float> sineResponse(FilterModel& model, unsigned int bin, float amplitude) {
+    const double increment = 2.0 * M_PI * bin / kFftSize;
+    std::vector<float> out(kFftSize);
+    for (unsigned int n = 0; n < kSettleFrames + kFftSize; ++n) {
+        const float y = model.process(amplitude * static_cast<float>(sin(increment * (n % kFftSize))));
+        if (n >= kSettleFrames)
+            out[n - kSettleFrames] = y;
+    }
+    return out;
+}
+
+// ============================================================================
+// QUALITY METRICS
+// ============================================================================
+
+/**
+ * @brief Small-signal impulse response of an already configured model
+ */
+std::vector<float> impulseResponse(FilterModel& model) {
+    for (unsigned int n = 0; n < 256; ++n)
+        model.process(0.0f);
+    std::vector<float> response(kFftSize);
+    for (unsigned int n = 0; n < kFftSize; ++n)
+        response[n] = model.process(n == 0 ? 1e-3f : 0.0f);
+    return response;
+}
+
+/**
+ * @brief Small-signal gain at one frequency relative to DC, in dB
+ */
+double measureGainDb(FilterModel& model, float frequencyHz) {
+    const std::vector<float> response = impulseResponse(model);
+    std::complex<double> atFrequency(0.0, 0.0);
+    double dc = 0.0;
+    const double omega = 2.0 * M_PI * frequencyHz / kBaseRate;
+    for (unsigned int n = 0; n < kFftSize; ++n) {
+        atFrequency += std::polar(static_cast<double>(response[n]), -omega * n);
+        dc += response[n];
+    }
+    return 10.0 * log10(std::norm(atFrequency) / (dc * dc + 1e-300));
+}
+
+/**
+ * @brief Small-signal resonant peak frequency, or NaN without a clear peak
+ *
+ * The model must already be set up. The peak is searched for within two
+ * octaves of cutoffHz and must stand at least 1 dB above the DC gain and
+ * away from the edges of the search range.
+ */
+double measurePeakHz(FilterModel& model, float cutoffHz) {
+    const std::vector<double> power = powerSpectrum(impulseResponse(model), false);
+    const double minHz = cutoffHz * 0.25;
+    const double maxHz = std::min(cutoffHz * 4.0, 0.45 * kBaseRate);
+    const double peakHz = spectralPeakHz(power, kBaseRate, minHz, maxHz);
+    const double binHz = kBaseRate / kFftSize;
+    const size_t peakBin = static_cast<size_t>(peakHz / binHz + 0.5);
+
+    if (peakHz < minHz + 2.0 * binHz || peakHz > maxHz - 2.0 * binHz || !(power[peakBin] > 1.26 * power[0]))
+        return std::numeric_limits<double>::quiet_NaN();
+    return peakHz;
+}
+
+/**
+ * @brief Self-oscillation frequency at full resonance, or NaN if it dies
+ *        away or blows up
+ *
+ * Run with full drive, so saturating variants settle at a bounded level.
+ */
+double measureSelfOscillationHz(FilterModel& model, float cutoffHz) {
+    model.set(cutoffHz, 1.0f, 1.0f);
+    const unsigned int ringFrames = static_cast<unsigned int>(kBaseRate);
+    for (unsigned int n = 0; n < ringFrames; ++n)
+        model.process(n < 16 ? 0.1f : 0.0f);
+
+    std::vector<float> tail(kFftSize);
+    double energy = 0.0;
+    for (unsigned int n = 0; n < kFftSize; ++n) {
+        tail[n] = model.process(0.0f);
+        energy += static_cast<double>(tail[n]) * tail[n];
+    }
+    const double rms = sqrt(energy / kFftSize);
+    if (!(rms > 1e-3) || !std::isfinite(rms))
+        return std::numeric_limits<double>::quiet_NaN();
+    return spectralPeakHz(powerSpectrum(tail, true), kBaseRate, 20.0, 0.5 * kBaseRate);
+}
+
+/**
+ * @enum Health
+ * @brief Whether a configuration produces usable output in the THD setting
+ */
+enum Health {
+    kHealthy = 0,
+    kSilent,        ///< Fundamental more than 60 dB below the input
+    kUnstable       ///< Output diverged to inf or NaN
+};
+
+/**
+ * @brief THD of a 220 Hz half-scale tone at moderate resonance, harmonics
+ *        2-20, in dB; NaN unless the configuration is healthy
+ */
+double measureThdDb(FilterModel& model, Health& health) {
+    model.set(8000.0f, 0.5f, 1.0f);
+    const unsigned int bin = oddBin(220.0f);
+    const std::vector<float> response = sineResponse(model, bin, 0.5f);
+
+    health = kHealthy;
+    for (float y : response) {
+        if (!std::isfinite(y)) {
+            health = kUnstable;
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    const std::vector<double> power = powerSpectrum(response, false);
+    const double inputPower = 0.25 * 0.25 * kFftSize * kFftSize;
+    if (!(power[bin] > 1e-6 * inputPower)) {
+        health = kSilent;
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double harmonics = 0.0;
+    for (unsigned int h = 2; h <= 20 && h * bin < power.size(); ++h)
+        harmonics += power[h * bin];
+    return toDb(harmonics / power[bin]);
+}
+
+/**
+ * @brief Worst signal-to-alias ratio over the high-note tones, in dB
+ */
+double measureAliasSnrDb(FilterModel& model) {
+    double worst = kDbCeiling;
+    for (float tone : kAliasTones) {
+        model.set(8000.0f, 0.5f, 1.0f);
+        const unsigned int bin = oddBin(tone);
+        const std::vector<double> power = powerSpectrum(sineResponse(model, bin, 1.0f), false);
+
+        double signal = 0.0;
+        double alias = 0.0;
+        for (size_t k = 1; k < power.size(); ++k) {
+            if (k % bin == 0)
+                signal += power[k];
+            else
+                alias += power[k];
+        }
+        const double snr = toDb(signal / (alias + 1e-300));
+        if (snr < worst)
+            worst = snr;
+    }
+    return worst;
+}
+
+/**
+ * @brief Cycles (or ns without counters) per base-rate sample
+ */
+double measureCost(FilterModel& model, PerfCounters& counters, bool& inCycles) {
+    const unsigned int frames = 8192;
+    std::vector<float> noise(frames);
+    uint32_t random = 0x2468ACEu;
+    for (float& x : noise) {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        x = 0.5f * (static_cast<float>(random) * (2.0f / 4294967296.0f) - 1.0f);
+    }
+
+    model.set(2000.0f, 0.5f, 1.0f);
+    volatile float sink = 0.0f;
+    double best = std::numeric_limits<double>::infinity();
+    for (int run = 0; run < 20; ++run) {
+        PerfCounters::Reading reading;
+        float accumulator = 0.0f;
+        counters.start();
+        for (unsigned int n = 0; n < frames; ++n)
+            accumulator += model.process(noise[n]);
+        counters.stop(reading);
+        sink = accumulator;
+
+        inCycles = reading.valid[PerfCounters::kCycles];
+        const double value = inCycles ? reading.count[PerfCounters::kCycles] : reading.nanoseconds;
+        if (value < best)
+            best = value;
+    }
+    (void)sink;
+    return best / frames;
+}
+
+// ============================================================================
+// CONFIGURATIONS AND PARETO FRONT
+// ============================================================================
+
+struct Configuration {
+    std::string name;
+    FilterModel* (*create)();
+    int oversampling;
+};
+
+struct Result {
+    std::string name;
+    double cost;
+    double aliasSnrDb;
+    double thdDb;
+    double thdErrorDb;
+    double peakCents;           ///< Worst |error| over the test cutoffs, signed
+    double selfOscCents;        ///< NaN when the variant does not self-oscillate
+    Health health;
+    bool paretoOptimal;
+};
+
+FilterModel* createZdfLinear() { return new ZdfModel(false); }
+FilterModel* createZdfTanh() { return new ZdfModel(true); }
+FilterModel* createBilinear() { return new BilinearModel(); }
+FilterModel* createEmpirical() { return new EmpiricalModel(); }
+FilterModel* createFixedPoint() { return new FixedPointModel(); }
+FilterModel* createMsp() { return new MspModel(); }
+
+/** @brief Objectives to minimise; a missing peak or self-oscillation counts as infinitely bad */
+void objectives(const Result& r, double out[5]) {
+    out[0] = r.cost;
+    out[1] = -r.aliasSnrDb;
+    out[2] = r.thdErrorDb;
+    out[3] = std::isnan(r.peakCents) ? std::numeric_limits<double>::infinity() : fabs(r.peakCents);
+    out[4] = std::isnan(r.selfOscCents) ? std::numeric_limits<double>::infinity() : fabs(r.selfOscCents);
+}
+
+bool dominates(const Result& a, const Result& b) {
+    double oa[5];
+    double ob[5];
+    objectives(a, oa);
+    objectives(b, ob);
+    bool strictlyBetter = false;
+    for (int i = 0; i < 5; ++i) {
+        if (oa[i] > ob[i])
+            return false;
+        if (oa[i] < ob[i])
+            strictlyBetter = true;
+    }
+    return strictlyBetter;
+}
+
+/** @brief Signed figure with the larger magnitude; NaN if either is NaN */
+double worstCents(double a, double b) {
+    if (std::isnan(a) || std::isnan(b))
+        return std::numeric_limits<double>::quiet_NaN();
+    return (fabs(b) > fabs(a)) ? b : a;
+}
+
+/** @brief Fixed-width figure, "-" for NaN */
+const char* formatFigure(char* buffer, size_t size, double value, bool sign) {
+    if (std::isnan(value))
+        snprintf(buffer, size, "-");
+    else
+        snprintf(buffer, size, sign ? "%+.1f" : "%.1f", value);
+    return buffer;
+}
+
+void printResult(const Result& r) {
+    if (r.health != kHealthy) {
+        printf("  %-22s %9.1f   %s\n", r.name.c_str(), r.cost,
+               (r.health == kUnstable) ? "unstable (output diverges)" : "no output");
+        return;
+    }
+    char peak[32];
+    char selfOsc[32];
+    printf("%c %-22s %9.1f %9.1f %9.1f %9.1f %9s %9s\n", r.paretoOptimal ? '*' : ' ',
+           r.name.c_str(), r.cost, r.aliasSnrDb, r.thdDb, r.thdErrorDb,
+           formatFigure(peak, sizeof(peak), r.peakCents, true),
+           formatFigure(selfOsc, sizeof(selfOsc), r.selfOscCents, true));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double minSnrDb = -std::numeric_limits<double>::infinity();
+    double maxThdErrorDb = std::numeric_limits<double>::infinity();
+    double maxCents = std::numeric_limits<double>::infinity();
+    bool requireSelfOsc = false;
+    bool haveTarget = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--require-self-osc")) {
+            requireSelfOsc = true;
+            haveTarget = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "usage: %s [--min-snr dB] [--max-thd-error dB] [--max-cents c] [--require-self-osc]\n", argv[0]);
+            return 1;
+        }
+        const double value = atof(argv[i + 1]);
+        if (!strcmp(argv[i], "--min-snr"))
+            minSnrDb = value;
+        else if (!strcmp(argv[i], "--max-thd-error"))
+            maxThdErrorDb = value;
+        else if (!strcmp(argv[i], "--max-cents"))
+            maxCents = value;
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+        haveTarget = true;
+        ++i;
+    }
+
+    PerfCounters counters;
+    counters.open();
+
+    /**
+     * Reference distortion from the MSP model at the base rate
+     */
+    MspModel reference;
+    reference.prepare(kBaseRate);
+    Health referenceHealth;
+    const double referenceThdDb = measureThdDb(reference, referenceHealth);
+
+    const Configuration configurations[] = {
+        {"zdf-v2 linear", createZdfLinear, 1}, {"zdf-v2 linear", createZdfLinear, 2}, {"zdf-v2 linear", createZdfLinear, 4},
+        {"zdf-v2 tanhf", createZdfTanh, 1},    {"zdf-v2 tanhf", createZdfTanh, 2},    {"zdf-v2 tanhf", createZdfTanh, 4},
+        {"bilinear tanhf", createBilinear, 1}, {"bilinear tanhf", createBilinear, 2}, {"bilinear tanhf", createBilinear, 4},
+        {"empirical rational", createEmpirical, 1}, {"empirical rational", createEmpirical, 2}, {"empirical rational", createEmpirical, 4},
+        {"fixed Q16", createFixedPoint, 1},    {"fixed Q16", createFixedPoint, 2},    {"fixed Q16", createFixedPoint, 4},
+        {"msp reference", createMsp, 1},
+    };
+
+    std::vector<Result> results;
+    bool costInCycles = false;
+    for (const Configuration& configuration : configurations) {
+        std::unique_ptr<FilterModel> model(configuration.create());
+        if (configuration.oversampling > 1)
+            model.reset(new OversampledModel(model.release(), configuration.oversampling));
+
+        Result r;
+        r.name = configuration.name + " x" + std::to_string(configuration.oversampling);
+        r.paretoOptimal = false;
+
+        model->prepare(kBaseRate);
+        r.cost = measureCost(*model, counters, costInCycles);
+        model->prepare(kBaseRate);
+        r.aliasSnrDb = measureAliasSnrDb(*model);
+        model->prepare(kBaseRate);
+        r.thdDb = measureThdDb(*model, r.health);
+        r.thdErrorDb = fabs(r.thdDb - referenceThdDb);
+
+        /**
+         * Tuning figures keep the worst error over the test cutoffs; one
+         * missing peak or oscillation makes the whole figure missing
+         */
+        r.peakCents = 0.0;
+        r.selfOscCents = 0.0;
+        for (float cutoff : kTestCutoffs) {
+            model->prepare(kBaseRate);
+            model->set(cutoff, kPeakResonance, 0.0f);
+            r.peakCents = worstCents(r.peakCents, cents(measurePeakHz(*model, cutoff) / cutoff));
+
+            model->prepare(kBaseRate);
+            r.selfOscCents = worstCents(r.selfOscCents, cents(measureSelfOscillationHz(*model, cutoff) / cutoff));
+        }
+        results.push_back(r);
+    }
+
+    for (Result& r : results) {
+        r.paretoOptimal = (r.health == kHealthy);
+        if (!r.paretoOptimal)
+            continue;
+        for (const Result& other : results) {
+            if (&other != &r && other.health == kHealthy && dominates(other, r)) {
+                r.paretoOptimal = false;
+                break;
+            }
+        }
+    }
+
+    printf("Reference (MSP x1) THD %.1f dB; tuning errors against the nominal cutoff\n", referenceThdDb);
+    printf("Cost in %s per sample; * marks the Pareto front\n\n", costInCycles ? "cycles" : "ns");
+    printf("  %-22s %9s %9s %9s %9s %9s %9s\n", "configuration", "cost", "alias dB", "THD dB", "|dTHD|", "peak c", "osc c");
+    for (const Result& r : results)
+        printResult(r);
+
+    printf("\nPareto front, cheapest first:\n");
+    std::vector<const Result*> front;
+    for (const Result& r : results) {
+        if (r.paretoOptimal)
+            front.push_back(&r);
+    }
+    std::sort(front.begin(), front.end(), [](const Result* a, const Result* b) { return a->cost < b->cost; });
+    for (const Result* r : front)
+        printResult(*r);
+
+    if (haveTarget) {
+        const Result* cheapest = nullptr;
+        for (const Result& r : results) {
+            const bool oscillates = !std::isnan(r.selfOscCents);
+            if (r.health != kHealthy || r.aliasSnrDb < minSnrDb || r.thdErrorDb > maxThdErrorDb)
+                continue;
+            if (std::isnan(r.peakCents) || fabs(r.peakCents) > maxCents)
+                continue;
+            if ((requireSelfOsc && !oscillates) || (oscillates && fabs(r.selfOscCents) > maxCents))
+                continue;
+            if (!cheapest || r.cost < cheapest->cost)
+                cheapest = &r;
+        }
+        printf("\nCheapest configuration meeting the target: %s\n", cheapest ? cheapest->name.c_str() : "none");
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file Bela.h
+ * @brief Minimal host stand-in for the Bela API used by render.cpp
+ *
+ * Lets render.cpp build and run on a desktop for offline replay
+ * (DEV/OverrunReplay.cpp, DEV/SessionReplay.cpp). Only what render.cpp
+ * touches is provided:
+ * - BelaContext with interleaved audio and analog buffers
+ * - analogRead(), audioWrite(), rt_printf()
+ * - auxiliary tasks, which never run on their own: the host calls
+ *   HostShim::runAuxiliaryTasks() between blocks, outside any timing, and
+ *   can hold a task back to run it at a chosen block
+ *
+ * Put DEV/HostShim first on the include path; never use it on the board.
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+struct BelaContext {
+    const float* audioIn;
+    float* audioOut;
+    const float* analogIn;
+    float* analogOut;
+    uint32_t audioFrames;
+    uint32_t audioInChannels;
+    uint32_t audioOutChannels;
+    float audioSampleRate;
+    uint32_t analogFrames;
+    uint32_t analogInChannels;
+    uint32_t analogOutChannels;
+    float analogSampleRate;
+    uint64_t audioFramesElapsed;
+};
+
+static inline float analogRead(BelaContext* context, int frame, int channel) {
+    return context->analogIn[frame * context->analogInChannels + channel];
+}
+
+static inline void audioWrite(BelaContext* context, int frame, int channel, float value) {
+    context->audioOut[frame * context->audioOutChannels + channel] = value;
+}
+
+#define rt_printf printf
+
+typedef void* AuxiliaryTask;
+
+namespace HostShim {
+
+/**
+ * @struct Task
+ * @brief A registered auxiliary task and whether it has been scheduled
+ */
+struct Task {
+    void (*callback)(void*);
+    void* argument;
+    const char* name;
+    bool pending;
+    bool held;      ///< Skipped by runAuxiliaryTasks()
+};
+
+static const int kMaxTasks = 16;
+
+inline Task* tasks() {
+    static Task table[kMaxTasks];
+    return table;
+}
+
+inline int& taskCount() {
+    static int count = 0;
+    return count;
+}
+
+inline const char*& heldName() {
+    static const char* name = nullptr;
+    return name;
+}
+
+inline Task* findTask(const char* name) {
+    for (int i = 0; i < taskCount(); ++i)
+        if (tasks()[i].name && strcmp(tasks()[i].name, name) == 0)
+            return &tasks()[i];
+    return nullptr;
+}
+
+/**
+ * @brief Run every scheduled task that is not held, in creation order
+ */
+inline void runAuxiliaryTasks() {
+    for (int i = 0; i < taskCount(); ++i) {
+        if (tasks()[i].pending && !tasks()[i].held) {
+            tasks()[i].pending = false;
+            tasks()[i].callback(tasks()[i].argument);
+        }
+    }
+}
+
+/**
+ * @brief Keep a task (by name) out of runAuxiliaryTasks(); takes effect
+ *        for tasks created later too
+ */
+inline void holdAuxiliaryTask(const char* name) {
+    for (int i = 0; i < taskCount(); ++i)
+        if (tasks()[i].name && strcmp(tasks()[i].name, name) == 0)
+            tasks()[i].held = true;
+    heldName() = name;
+}
+
+/**
+ * @brief Run a task now if it has been scheduled, held or not
+ *
+ * @return true if it ran
+ */
+inline bool runAuxiliaryTask(const char* name) {
+    Task* task = findTask(name);
+    if (!task || !task->pending)
+        return false;
+    task->pending = false;
+    task->callback(task->argument);
+    return true;
+}
+
+} // namespace HostShim
+
+static inline AuxiliaryTask Bela_createAuxiliaryTask(void (*callback)(void*), int /*priority*/,
+                                                     const char* name, void* argument = nullptr) {
+    if (HostShim::taskCount() == HostShim::kMaxTasks)
+        return nullptr;
+    HostShim::Task& task = HostShim::tasks()[HostShim::taskCount()++];
+    task.callback = callback;
+    task.argument = argument;
+    task.name = name;
+    task.pending = false;
+    task.held = HostShim::heldName() && name && strcmp(HostShim::heldName(), name) == 0;
+    return &task;
+}
+
+static inline int Bela_scheduleAuxiliaryTask(AuxiliaryTask task) {
+    if (!task)
+        return -1;
+    static_cast<HostShim::Task*>(task)->pending = true;
+    return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file Midi.h
+ * @brief Host stand-in for Bela's Midi library, fed from recorded bytes
+ *
+ * The parser turns a byte stream into channel messages the way Bela's
+ * MidiParser does for the messages render.cpp handles (running status is
+ * not needed: captured streams always carry the status byte). The host
+ * pushes a block's bytes with MidiParser::parse() before calling render().
+ * Like Bela's parser it keeps messages in a preallocated ring, so reading
+ * them in render() does not allocate (and RealtimeGuard stays quiet).
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <cstdint>
+
+typedef unsigned char midi_byte_t;
+
+enum MidiMessageType {
+    kmmNoteOff = 0,
+    kmmNoteOn,
+    kmmPolyphonicKeyPressure,
+    kmmControlChange,
+    kmmProgramChange,
+    kmmChannelPressure,
+    kmmPitchBend,
+    kmmSystem,
+    kmmNone,
+    kmmAny
+};
+
+class MidiChannelMessage {
+public:
+    MidiChannelMessage() : status(0), numData(0) { data[0] = data[1] = 0; }
+    MidiChannelMessage(midi_byte_t status, const midi_byte_t* bytes, unsigned int count)
+        : status(status), numData(count) {
+        data[0] = count > 0 ? bytes[0] : 0;
+        data[1] = count > 1 ? bytes[1] : 0;
+    }
+
+    MidiMessageType getType() const {
+        if (status >= 0xF0)
+            return kmmSystem;
+        if (status < 0x80)
+            return kmmNone;
+        return static_cast<MidiMessageType>((status >> 4) - 8);
+    }
+    int getChannel() const { return status & 0x0F; }
+    midi_byte_t getStatusByte() const { return status; }
+    unsigned int getNumDataBytes() const { return numData; }
+    midi_byte_t getDataByte(unsigned int index) const { return index < 2 ? data[index] : 0; }
+
+    /** @brief Data bytes that follow a status byte */
+    static unsigned int dataBytesFor(midi_byte_t status) {
+        if (status >= 0xF8)
+            return 0;           // Real-time
+        switch (status & 0xF0) {
+        case 0xC0:
+        case 0xD0:
+            return 1;
+        case 0xF0:
+            return (status == 0xF1 || status == 0xF3) ? 1 : (status == 0xF2 ? 2 : 0);
+        default:
+            return 2;
+        }
+    }
+
+private:
+    midi_byte_t status;
+    unsigned int numData;
+    midi_byte_t data[2];
+};
+
+class MidiParser {
+public:
+    /**
+     * @brief Queue the messages in a byte stream; stray data bytes are skipped
+     */
+    void parse(const midi_byte_t* bytes, unsigned int count) {
+        unsigned int i = 0;
+        while (i < count) {
+            const midi_byte_t status = bytes[i++];
+            if (status < 0x80)
+                continue;
+            unsigned int length = MidiChannelMessage::dataBytesFor(status);
+            if (length > count - i)
+                length = count - i;
+            if (head - tail < kCapacity)
+                messages[head++ % kCapacity] = MidiChannelMessage(status, bytes + i, length);
+            i += length;
+        }
+    }
+
+    int numAvailableMessages() const { return static_cast<int>(head - tail); }
+
+    MidiChannelMessage getNextChannelMessage() {
+        return messages[tail++ % kCapacity];
+    }
+
+private:
+    static const unsigned int kCapacity = 1024;
+    MidiChannelMessage messages[kCapacity];
+    unsigned int head = 0;
+    unsigned int tail = 0;
+};
+
+class Midi {
+public:
+    int readFrom(const char* /*port*/) { return 1; }
+    void enableParser(bool /*enable*/) {}
+    MidiParser* getParser() { return &parser; }
+
+private:
+    MidiParser parser;
+};
@@ -0,0 +1,228 @@
+/**
+ * @file InstanceScalingBench.cpp
+ * @brief CPU cost of 1 to 8 SynthInstances rendered in one callback
+ *
+ * render.cpp fixes the number of parts at compile time, so this bench
+ * drives SynthInstance directly, the way render() does: per period every
+ * part plays its delayed MIDI, updates its controls and schedules its
+ * sequencer, then the sub-blocks render part 0 into the output and sum the
+ * others into it. Each part runs its own pattern (CC 20) at its own tempo
+ * (CC 22) with the cutoff LFO routed (CC 18), so the parts are busy and not
+ * in lockstep.
+ *
+ * For each part count the bench prints the mean and p99 period time, the
+ * mean cost per part, the share of real time, and the scaling against N
+ * times the single part (100% is perfectly linear; above 100% means the
+ * parts interfere, typically through the cache). The parts' own load
+ * accounting (SynthInstance::reportLoad(), as printed by cleanup()) is
+ * shown alongside, so the two measurements can be checked against each
+ * other.
+ *
+ * @build
+ * @code
+ * # From the repository root:
+ * g++ -O3 -std=c++14 -IDEV/HostShim -I. DEV/InstanceScalingBench.cpp \
+ *     $(ls *.cpp | grep -v render.cpp) -o instance-bench
+ * ./instance-bench [--period 128] [--seconds 5] [--max 8]
+ * @endcode
+ * Run on an idle machine; on the board, stop the Bela project first.
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <vector>
+#include "AudioArena.h"
+#include "ReconfigurePipeline.h"
+#include "SynthInstance.h"
+
+namespace {
+
+const float kSampleRate = 44100.0f;
+const unsigned int kMaxInstances = 8;
+const unsigned int kMaxPeriodFrames = 256;
+
+/** @brief Periods run before timing starts (caches, first notes) */
+const unsigned int kWarmupPeriods = 200;
+
+inline uint64_t nowNs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+/**
+ * @struct Result
+ * @brief Timing of one part count
+ */
+struct Result {
+    double meanNs;
+    double p99Ns;
+    bool finite;
+};
+
+/**
+ * @brief Build `count` parts in a fresh arena and time `periods` periods
+ */
+Result run(unsigned int count, unsigned int periodFrames, unsigned int periods) {
+    AudioArenaConfig config;
+    config.maxVoices = count;
+    config.oversampling = 1;
+    config.periodFrames = kMaxPeriodFrames;
+    config.subBlockFrames = SynthInstance::kSubBlockFrames;
+    config.voiceBuffers = SynthInstance::kSubBlockBuffers;
+    config.sharedBuffers = 2;
+    config.periodBuffers = 2;
+    config.voiceStateBytes = SynthInstance::requiredStateBytes();
+    config.extraBytes = 0;
+
+    AudioArena arena;
+    Result result = { 0.0, 0.0, false };
+    if (!arena.reserve(AudioArena::requiredBytes(config)))
+        return result;
+
+    float* outputL = arena.allocateFloats(kMaxPeriodFrames);
+    float* outputR = arena.allocateFloats(kMaxPeriodFrames);
+    float* mixL = arena.allocateFloats(SynthInstance::kSubBlockFrames);
+    float* mixR = arena.allocateFloats(SynthInstance::kSubBlockFrames);
+
+    ReconfigurePipeline pipeline;
+    SynthInstance* parts[kMaxInstances] = { nullptr };
+    for (unsigned int i = 0; i < count; ++i) {
+        parts[i] = arena.create<SynthInstance>();
+        if (!parts[i] || !parts[i]->setup(kSampleRate, 0x7123E + i, arena)) {
+            arena.release();
+            return result;
+        }
+        parts[i]->setMidiChannel(i);
+        pipeline.addListener(parts[i]);
+    }
+    EngineRate rate = { kSampleRate, periodFrames, false };
+    if (!pipeline.reconfigureNow(rate)) {
+        arena.release();
+        return result;
+    }
+
+    /** Pots at mid travel, the output gain shared between the parts */
+    PanelControls panel;
+    panel.drive = 0.5f;
+    panel.envDepth = 0.5f;
+    panel.outGain = 1.0f / count;
+    for (unsigned int i = 0; i < count; ++i) {
+        parts[i]->loadDefaults();
+        parts[i]->setPanel(panel);
+        parts[i]->controlChange(20, 64, 0);                         // pattern
+        parts[i]->controlChange(22, 40 + 7 * i, 0);                 // tempo
+        parts[i]->controlChange(18, 64, 0);                         // LFO 1 to cutoff
+    }
+    arena.lock();
+
+    std::vector<double> periodNs;
+    periodNs.reserve(periods);
+    uint64_t sampleClock = 0;
+    bool finite = true;
+    const unsigned int subBlocks = periodFrames / SynthInstance::kSubBlockFrames;
+
+    for (unsigned int p = 0; p < kWarmupPeriods + periods; ++p) {
+        const float currentTimeMs = sampleClock / kSampleRate * 1000.0f;
+        const uint64_t start = nowNs();
+
+        for (unsigned int i = 0; i < count; ++i) {
+            parts[i]->processDelayedMidi(currentTimeMs);
+            parts[i]->updateControls(periodFrames, sampleClock);
+            parts[i]->scheduleSequencer(sampleClock + periodFrames + SynthInstance::kSubBlockFrames);
+        }
+        for (unsigned int b = 0; b < subBlocks; ++b) {
+            float* left = outputL + b * SynthInstance::kSubBlockFrames;
+            float* right = outputR + b * SynthInstance::kSubBlockFrames;
+            parts[0]->renderSubBlock<44100>(left, right, SynthInstance::kSubBlockFrames, sampleClock);
+            for (unsigned int i = 1; i < count; ++i) {
+                parts[i]->renderSubBlock<44100>(mixL, mixR, SynthInstance::kSubBlockFrames, sampleClock);
+                for (unsigned int n = 0; n < SynthInstance::kSubBlockFrames; ++n) {
+                    left[n] += mixL[n];
+                    right[n] += mixR[n];
+                }
+            }
+            sampleClock += SynthInstance::kSubBlockFrames;
+        }
+
+        const uint64_t end = nowNs();
+        const double audioNs = periodFrames * 1e9 / kSampleRate;
+        for (unsigned int i = 0; i < count; ++i)
+            parts[i]->endPeriod(audioNs);
+        if (p >= kWarmupPeriods)
+            periodNs.push_back(static_cast<double>(end - start));
+        for (unsigned int n = 0; n < periodFrames; ++n)
+            finite = finite && std::isfinite(outputL[n]) && std::isfinite(outputR[n]);
+    }
+
+    double total = 0.0;
+    for (double ns : periodNs)
+        total += ns;
+    std::sort(periodNs.begin(), periodNs.end());
+    result.meanNs = total / periodNs.size();
+    result.p99Ns = periodNs[static_cast<size_t>(periodNs.size() * 0.99)];
+    result.finite = finite;
+
+    if (count == kMaxInstances || count == 1) {
+        printf("  self-reported (%u part%s):\n", count, count == 1 ? "" : "s");
+        for (unsigned int i = 0; i < count; ++i)
+            parts[i]->reportLoad(stdout, i);
+    }
+    arena.release();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned int periodFrames = 128;
+    double seconds = 5.0;
+    unsigned int maxInstances = kMaxInstances;
+    for (int a = 1; a < argc; ++a) {
+        if (!strcmp(argv[a], "--period") && a + 1 < argc)
+            periodFrames = static_cast<unsigned int>(atoi(argv[++a]));
+        else if (!strcmp(argv[a], "--seconds") && a + 1 < argc)
+            seconds = atof(argv[++a]);
+        else if (!strcmp(argv[a], "--max") && a + 1 < argc)
+            maxInstances = static_cast<unsigned int>(atoi(argv[++a]));
+        else {
+            fprintf(stderr, "usage: %s [--period N] [--seconds S] [--max N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (periodFrames == 0 || periodFrames > kMaxPeriodFrames || periodFrames % SynthInstance::kSubBlockFrames != 0) {
+        fprintf(stderr, "period must be a multiple of %u up to %u frames\n", SynthInstance::kSubBlockFrames,
+                kMaxPeriodFrames);
+        return 2;
+    }
+    maxInstances = std::max(1u, std::min(maxInstances, kMaxInstances));
+    const unsigned int periods = static_cast<unsigned int>(seconds * kSampleRate / periodFrames);
+    const double audioNs = periodFrames * 1e9 / kSampleRate;
+
+    printf("%u-frame periods at %.0f Hz, %u periods per run\n", periodFrames, kSampleRate, periods);
+    std::vector<Result> results;
+    for (unsigned int count = 1; count <= maxInstances; ++count) {
+        results.push_back(run(count, periodFrames, periods));
+        if (!results.back().finite) {
+            fprintf(stderr, "%u parts: setup failed or output not finite\n", count);
+            return 1;
+        }
+    }
+
+    printf("\nparts   period us   p99 us   per part us   real time   scaling\n");
+    const double single = results[0].meanNs;
+    for (unsigned int count = 1; count <= maxInstances; ++count) {
+        const Result& r = results[count - 1];
+        printf("%5u   %9.2f   %6.2f   %11.2f   %8.2f%%   %6.1f%%\n", count, r.meanNs * 1e-3, r.p99Ns * 1e-3,
+               r.meanNs * 1e-3 / count, 100.0 * r.meanNs / audioNs, 100.0 * r.meanNs / (count * single));
+    }
+    return 0;
+}
@@ -0,0 +1,477 @@
+/**
+ * @file KernelCounterBench.cpp
+ * @brief Hardware-counter microbenchmarks for the synthesis and filter kernels
+ *
+ * Runs each DSP kernel over a fixed block and reports, per sample: cycles,
+ * instructions, IPC, branch misses and L1 data cache misses, plus wall-clock
+ * nanoseconds. The counters point at the actual bottleneck:
+ * - Low IPC with few misses: a serial dependency chain or long-latency
+ *   operations (divisions, libm calls) - restructure the arithmetic
+ * - High branch misses: data-dependent branches (clamps, state machines)
+ *   - make them branch-free
+ * - High L1 misses: table or state layout - the kernels here should show ~0
+ *
+ * Counters come from PerfCounters; where they are unavailable (VM, locked
+ * down perf_event_paranoid) the table shows "-" and only ns/sample is
+ * reported.
+ *
+ * @kernels
+ * - osc-sinf: the render loop's phase accumulator and sinf()
+ * - adsr: ADSR::process(), gated on and off so all stages are visited
+ * - zdf-v2: production ladder, fixed cutoff, drive 0 (linear feedback)
+ * - zdf-v2-drive: as above with tanh feedback saturation
+ * - zdf-v2-mod: setCutoff() every sample (the pre-warp tanf and divisions)
+ * - zdf-v2-held: setCutoff() every sample with a value that only moves every
+ *   128 samples, as from a pot; the lazy update pre-warps once per step
+ * - zdf-dev: DEV/ZDFMoogLadderFilter (with -DKERNEL_BENCH_DEV_ZDF, which
+ *   replaces the production ladder: both classes are named ZDFMoogLadderFilter)
+ * - msp: MSPMoogLadderFilter::processSample (double precision Huovilainen)
+ * - bilinear: BilinearTransform ladder (four tanhf per sample)
+ * - empirical: EmpiricallyTuned ladder (rational tanh)
+ * - fixed-point: Q16 ladder
+ * - sat-tanhf, sat-rational: the two saturators used by the ladders
+ * - fx-chorus, fx-delay, fx-limiter: the post-FX stages (PostFxChain.h),
+ *   stereo, processed in 128-frame blocks; the limiter sees peaks above
+ *   its knee, the delay runs with a half-second echo
+ * - fft-scalar, fft-simd: SplitFft forward transforms of 256 points (the
+ *   convolver's size at a 128-frame period), per point transformed
+ * - conv-scalar, conv-simd: PartitionedConvolver with the built-in cabinet
+ *   (926 taps at 44.1 kHz), stereo, 128-frame periods (7 partitions)
+ * - conv-simd-16: the same at a 16-frame period (57 partitions), where the
+ *   tail's multiply-adds dominate
+ * - exp2-libm, exp2-table, exp2-simd: the cutoff bus's octaves-to-Hz step
+ *   from 40 Hz to 26 kHz, with exp2f(), tableExp2() and four lanes of vf4_exp2()
+ *
+ * The four-voice NEON ladders (MoogLadderFilterBase.h) are not included:
+ * their headers only build for ARM and redefine the scalar class.
+ *
+ * @build
+ * @code
+ * # On the Bela board (or any Linux host), from the repository root:
+ * g++ -O3 -std=c++17 -march=armv7-a -mtune=cortex-a8 -mfpu=neon -mfloat-abi=hard \
+ *     -I. -IDEV DEV/KernelCounterBench.cpp DEV/PerfCounters.cpp ADSR.cpp \
+ *     zdf_moogladder_v2.cpp TableBank.cpp DEV/MSPMoogLadderFilter.cpp \
+ *     DEV/BilinearTransformMoogLadderFilter.cpp DEV/EmpiricallyTunedMoogFilter.cpp \
+ *     DEV/MoogLadderFilterFixedPoint.cpp StereoChorus.cpp TempoDelay.cpp \
+ *     LookaheadLimiter.cpp PostFxChain.cpp AudioArena.cpp SplitFft.cpp \
+ *     ImpulseResponse.cpp PartitionedConvolver.cpp ParameterUpdate.cpp -o kernelbench
+ * ./kernelbench            # all kernels
+ * ./kernelbench zdf        # kernels whose name contains "zdf"
+ * @endcode
+ * Build with -DKERNEL_BENCH_DEV_ZDF and DEV/ZDFMoogLadderFilter.cpp in place
+ * of zdf_moogladder_v2.cpp to measure the development ladder.
+ *
+ * @method
+ * Each kernel runs kRuns times over kFrames samples of a band-limited-ish
+ * test signal (saw plus noise, so saturators and clamps see varied input)
+ * after one warm-up pass. The run with the fewest cycles (or the shortest
+ * time without counters) is reported, which filters out interrupts and
+ * preemption on the shared core.
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#include "PerfCounters.h"
+#include "ADSR.h"
+#ifdef KERNEL_BENCH_DEV_ZDF
+#include "ZDFMoogLadderFilter.h"
+#else
+#include "zdf_moogladder_v2.h"
+#endif
+#include "MSPMoogLadderFilter.h"
+#include "MoogLadderFilter.h"
+#include "EmpiricallyTunedMoogFilter.h"
+#include "MoogLadderFilterFixedPoint.h"
+#include "PartitionedConvolver.h"
+#include "PostFxChain.h"
+#include "SimdLanes.h"
+#include "TableBank.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const float kSampleRate = 44100.0f;
+const unsigned int kFrames = 4096;
+const int kRuns = 50;
+
+float input[kFrames];
+float output[kFrames];
+
+/** @brief Keeps the compiler from discarding kernel results */
+volatile float sink;
+
+// ============================================================================
+// KERNELS
+// ============================================================================
+
+float oscillatorPhase = 0.0f;
+
+void runOscillator() {
+    const float twoPi = 2.0f * static_cast<float>(M_PI);
+    const float increment = 110.0f * twoPi / kSampleRate;
+    for (unsigned int n = 0; n < kFrames; ++n) {
+        output[n] = sinf(oscillatorPhase) * (1.0f + 0.01f * input[n]);
+        oscillatorPhase += increment;
+        if (oscillatorPhase >= twoPi)
+            oscillatorPhase -= twoPi;
+    }
+}
+
+ADSR envelope;
+
+void runAdsr() {
+    /**
+     * Gate on for the first half and off for the second, so attack, decay,
+     * sustain and release all run within one block
+     */
+    envelope.gate(1);
+    for (unsigned int n = 0; n < kFrames / 2; ++n)
+        output[n] = envelope.process();
+    envelope.gate(0);
+    for (unsigned int n = kFrames / 2; n < kFrames; ++n)
+        output[n] = envelope.process();
+}
+
+ZDFMoogLadderFilter zdfFilter(kSampleRate);
+
+void runZdf() {
+    for (unsigned int n = 0; n < kFrames; ++n)
+        output[n] = zdfFilter.process(input[n]);
+}
+
+#ifndef KERNEL_BENCH_DEV_ZDF
+ZDFMoogLadderFilter zdfDriveFilter(kSampleRate);
+
+void runZdfDrive() {
+    for (unsigned int n = 0; n < kFrames; ++n)
+        output[n] = zdfDriveFilter.process(input[n]);
+}
+
+ZDFMoogLadderFilter zdfModulatedFilter(kSampleRate);
+
+void runZdfModulated() {
+    for (unsigned int n = 0; n < kFrames; ++n) {
+        zdfModulatedFilter.setCutoff(1000.0f + 500.0f * input[n]);
+        output[n] = zdfModulatedFilter.process(input[n]);
+    }
+}
+
+ZDFMoogLadderFilter zdfHeldFilter(kSampleRate);
+
+void runZdfHeld() {
+    for (unsigned int n = 0; n < kFrames; ++n) {
+        zdfHeldFilter.setCutoff(1000.0f + 500.0f * input[n & ~127u]);
+        output[n] = zdfHeldFilter.process(input[n]);
+    }
+}
+#endif
+
+MSPMoogLadderFilter mspFilter(kSampleRate);
+
+void runMsp() {
+    for (unsigned int n = 0; n < kFrames; ++n)
+        output[n] = static_cast<float>(mspFilter.processSample(input[n], 80.0, 0.5, 0.0, 0));
+}
+
+MoogLadderFilter bilinearFilter(kSampleRate);
+
+void runBilinear() {
+    for (unsigned int n = 0; n < kFrames; ++n)
+        output[n] = bilinearFilter.process(input[n]);
+}
+
+MoogFilter empiricalFilter(kSampleRate);
+
+void runEmpirical() {
+    for (unsigned int n = 0; n < kFrames; ++n)
+        output[n] = empiricalFilter.process(input[n]);
+}
+
+MoogLadderFilterFixedPoint fixedPointFilter(static_cast<int>(kSampleRate));
+
+void runFixedPoint() {
+    for (unsigned int n = 0; n < kFrames; ++n) {
+        const int in = static_cast<int>(input[n] * 16384.0f);
+        output[n] = static_cast<float>(fixedPointFilter.process(in)) * (1.0f / 16384.0f);
+    }
+}
+
+void runSaturatorTanhf() {
+    for (unsigned int n = 0; n < kFrames; ++n)
+        output[n] = tanhf(3.0f * input[n]);
+}
+
+void runSaturatorRational() {
+    for (unsigned int n = 0; n < kFrames; ++n) {
+        const float x = 3.0f * input[n];
+        const float x2 = x * x;
+        output[n] = x * (27.0f + x2) / (27.0f + 9.0f * x2);
+    }
+}
+
+AudioArena fxArena;
+PostFxChain postFx;
+float outputRight[kFrames];
+
+/** @brief Post-FX stages run per block, the way render() calls them */
+const unsigned int kFxBlock = 128;
+
+template <void (*Process)(float*, float*, unsigned int)>
+void runFx() {
+    for (unsigned int n = 0; n < kFrames; ++n) {
+        output[n] = 1.5f * input[n];
+        outputRight[n] = -1.5f * input[n];
+    }
+    for (unsigned int n = 0; n < kFrames; n += kFxBlock)
+        Process(output + n, outputRight + n, kFxBlock);
+}
+
+void chorusBlock(float* left, float* right, unsigned int frames) {
+    postFx.getChorus().process(left, right, frames);
+}
+
+void delayBlock(float* left, float* right, unsigned int frames) {
+    postFx.getDelay().process(left, right, frames);
+}
+
+void limiterBlock(float* left, float* right, unsigned int frames) {
+    postFx.getLimiter().process(left, right, frames);
+}
+
+const unsigned int kFftSize = 256;
+float fftImaginary[kFrames];
+
+template <SplitFft::Backend Backend>
+void runFft() {
+    static SplitFft fft;
+    fft.setBackend(Backend);
+    for (unsigned int n = 0; n < kFrames; ++n) {
+        output[n] = input[n];
+        fftImaginary[n] = -input[n];
+    }
+    for (unsigned int n = 0; n < kFrames; n += kFftSize)
+        fft.forward(output + n, fftImaginary + n, kFftSize);
+}
+
+/** @brief One convolver per benchmarked period, both on the built-in cabinet */
+ImpulseResponse cabinetImpulse;
+PartitionedConvolver cabinet;
+PartitionedConvolver cabinetShort;
+const unsigned int kShortBlock = 16;
+
+template <SplitFft::Backend Backend>
+void cabinetBlock(float* left, float* right, unsigned int frames) {
+    cabinet.setBackend(Backend);
+    cabinet.process(left, right, frames);
+}
+
+void runCabinetShort() {
+    for (unsigned int n = 0; n < kFrames; ++n) {
+        output[n] = input[n];
+        outputRight[n] = -input[n];
+    }
+    for (unsigned int n = 0; n < kFrames; n += kShortBlock)
+        cabinetShort.process(output + n, outputRight + n, kShortBlock);
+}
+
+/** @brief Test signal (about ±0.85) to cutoff octaves, 40 Hz to 26 kHz */
+inline float cutoffOctaves(float x) {
+    return 10.0f + 5.5f * x;
+}
+
+void runExp2Libm() {
+    for (unsigned int n = 0; n < kFrames; ++n)
+        output[n] = exp2f(cutoffOctaves(input[n]));
+}
+
+void runExp2Table() {
+    for (unsigned int n = 0; n < kFrames; ++n)
+        output[n] = tableExp2(cutoffOctaves(input[n]));
+}
+
+void runExp2Simd() {
+    const vfloat4 centre = vf4_dup(10.0f);
+    const vfloat4 span = vf4_dup(5.5f);
+    for (unsigned int n = 0; n < kFrames; n += 4)
+        vf4_store(output + n, vf4_exp2(vf4_mla(centre, span, vf4_load(input + n))));
+}
+
+struct Kernel {
+    const char* name;
+    void (*run)();
+};
+
+const Kernel kernels[] = {
+    {"osc-sinf", runOscillator},
+    {"adsr", runAdsr},
+#ifdef KERNEL_BENCH_DEV_ZDF
+    {"zdf-dev", runZdf},
+#else
+    {"zdf-v2", runZdf},
+    {"zdf-v2-drive", runZdfDrive},
+    {"zdf-v2-mod", runZdfModulated},
+    {"zdf-v2-held", runZdfHeld},
+#endif
+    {"msp", runMsp},
+    {"bilinear", runBilinear},
+    {"empirical", runEmpirical},
+    {"fixed-point", runFixedPoint},
+    {"sat-tanhf", runSaturatorTanhf},
+    {"sat-rational", runSaturatorRational},
+    {"fx-chorus", runFx<chorusBlock>},
+    {"fx-delay", runFx<delayBlock>},
+    {"fx-limiter", runFx<limiterBlock>},
+    {"fft-scalar", runFft<SplitFft::kScalar>},
+    {"fft-simd", runFft<SplitFft::kSimd>},
+    {"conv-scalar", runFx<cabinetBlock<SplitFft::kScalar> >},
+    {"conv-simd", runFx<cabinetBlock<SplitFft::kSimd> >},
+    {"conv-simd-16", runCabinetShort},
+    {"exp2-libm", runExp2Libm},
+    {"exp2-table", runExp2Table},
+    {"exp2-simd", runExp2Simd},
+};
+
+// ============================================================================
+// SETUP AND REPORTING
+// ============================================================================
+
+void configureKernels() {
+    /**
+     * Test signal: 110 Hz saw at 0.8 plus uniform noise at 0.05
+     */
+    uint32_t random = 0x1234567u;
+    float sawPhase = 0.0f;
+    for (unsigned int n = 0; n < kFrames; ++n) {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        const float noise = static_cast<float>(random) * (2.0f / 4294967296.0f) - 1.0f;
+        input[n] = 0.8f * (2.0f * sawPhase - 1.0f) + 0.05f * noise;
+        sawPhase += 110.0f / kSampleRate;
+        if (sawPhase >= 1.0f)
+            sawPhase -= 1.0f;
+    }
+
+    /**
+     * Envelope timings (in samples) short enough to finish inside a block
+     */
+    envelope.setAttackRate(0.005f * kSampleRate);
+    envelope.setDecayRate(0.01f * kSampleRate);
+    envelope.setSustainLevel(0.65f);
+    envelope.setReleaseRate(0.02f * kSampleRate);
+
+    zdfFilter.setCutoff(1000.0f);
+    zdfFilter.setResonance(0.5f);
+#ifndef KERNEL_BENCH_DEV_ZDF
+    zdfFilter.setDrive(0.0f);
+    zdfDriveFilter.setCutoff(1000.0f);
+    zdfDriveFilter.setResonance(0.5f);
+    zdfDriveFilter.setDrive(1.0f);
+    zdfModulatedFilter.setResonance(0.5f);
+    zdfModulatedFilter.setDrive(0.0f);
+    zdfHeldFilter.setResonance(0.5f);
+    zdfHeldFilter.setDrive(0.0f);
+#endif
+
+    bilinearFilter.setCutoff(1000.0f);
+    bilinearFilter.setResonance(0.5f);
+    empiricalFilter.setCutoff(1000.0f);
+    empiricalFilter.setResonance(0.5f);
+    fixedPointFilter.setCutoff(1000);
+    fixedPointFilter.setResonance(128);
+
+    fxArena.reserve(PostFxChain::requiredBytes(kSampleRate) + ImpulseResponse::requiredBytes()
+                    + PartitionedConvolver::requiredBytes(kFxBlock) + PartitionedConvolver::requiredBytes(kShortBlock));
+    postFx.allocate(fxArena, kSampleRate);
+    postFx.prepareSampleRate(kSampleRate);
+    postFx.commitSampleRate();
+    postFx.getChorus().setMix(0.5f);
+    postFx.getDelay().setTimeSeconds(0.5f);
+    postFx.getDelay().setMix(0.3f);
+
+    cabinetImpulse.allocate(fxArena);
+    cabinet.allocate(fxArena, kFxBlock);
+    cabinetShort.allocate(fxArena, kShortBlock);
+    cabinet.setImpulse(&cabinetImpulse);
+    cabinetShort.setImpulse(&cabinetImpulse);
+    cabinet.prepareConfiguration(kSampleRate, kFxBlock);
+    cabinet.commitConfiguration();
+    cabinet.setEnabled(true);
+    cabinetShort.prepareConfiguration(kSampleRate, kShortBlock);
+    cabinetShort.commitConfiguration();
+    cabinetShort.setEnabled(true);
+}
+
+void printValue(bool valid, double value) {
+    if (valid)
+        printf(" %12.2f", value);
+    else
+        printf(" %12s", "-");
+}
+
+void measure(const Kernel& kernel, PerfCounters& counters) {
+    kernel.run();   // Warm-up: caches, branch predictors, lazy libm binding
+
+    PerfCounters::Reading best = {};
+    bool haveBest = false;
+    for (int r = 0; r < kRuns; ++r) {
+        PerfCounters::Reading reading;
+        counters.start();
+        kernel.run();
+        counters.stop(reading);
+        sink = output[kFrames - 1];
+
+        bool better;
+        if (!haveBest)
+            better = true;
+        else if (reading.valid[PerfCounters::kCycles] && best.valid[PerfCounters::kCycles])
+            better = reading.count[PerfCounters::kCycles] < best.count[PerfCounters::kCycles];
+        else
+            better = reading.nanoseconds < best.nanoseconds;
+        if (better) {
+            best = reading;
+            haveBest = true;
+        }
+    }
+
+    const double perSample = 1.0 / kFrames;
+    printf("%-14s", kernel.name);
+    for (int c = 0; c < PerfCounters::kNumCounters; ++c) {
+        printValue(best.valid[c], best.count[c] * perSample);
+        if (c == PerfCounters::kInstructions) {
+            const bool ipcValid = best.valid[PerfCounters::kCycles] && best.valid[PerfCounters::kInstructions]
+                               && best.count[PerfCounters::kCycles] > 0.0;
+            printValue(ipcValid, ipcValid ? best.count[PerfCounters::kInstructions] / best.count[PerfCounters::kCycles] : 0.0);
+        }
+    }
+    printValue(true, best.nanoseconds * perSample);
+    printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* filter = (argc > 1) ? argv[1] : nullptr;
+
+    PerfCounters counters;
+    if (!counters.open())
+        printf("Hardware counters unavailable: %s\nReporting wall-clock time only.\n\n", counters.getStatus());
+    else if (strcmp(counters.getStatus(), "ok") != 0)
+        printf("Some counters unavailable: %s\n\n", counters.getStatus());
+
+    configureKernels();
+
+    printf("%d samples x %d runs, best run, per sample:\n", kFrames, kRuns);
+    printf("%-14s %12s %12s %12s %12s %12s %12s\n",
+           "kernel", "cycles", "instructions", "IPC", "branch-miss", "L1d-miss", "ns");
+    for (const Kernel& kernel : kernels) {
+        if (filter && !strstr(kernel.name, filter))
+            continue;
+        measure(kernel, counters);
+    }
+    return 0;
+}
@@ -0,0 +1,301 @@
+/**
+ * @file LadderIdleTest.cpp
+ * @brief Checks that the ladder at drive 0 stays bounded and decays at every pot position
+ *
+ * Drive 0 selects the ladder's linear feedback path, where no tanh bounds
+ * the loop. Two checks cover it:
+ * - **ladder**: a StereoLadder at drive 0 over a cutoff × resonance grid,
+ *   each filter mode, at the widest cutoff and resonance spread. Silence
+ *   into a clear ladder must give exactly zero. Then a 10 ms noise burst
+ *   (a note's tail) is followed by 4 s of silence. The output must stay
+ *   finite and below kPeakLimit, and the last 100 ms must be at most
+ *   kDecayRatio of the first 100 ms after the burst
+ * - **instance**: a SynthInstance with the drive pot at 0 over a cutoff pot
+ *   × resonance pot grid. With no note the part must output exactly zero.
+ *   After a note and its release the tail must decay the same way
+ *
+ * Each failing grid point is printed; the exit status is 1 when any failed.
+ *
+ * @build
+ * @code
+ * # From the repository root:
+ * g++ -O2 -std=c++14 -IDEV/HostShim -I. DEV/LadderIdleTest.cpp \
+ *     $(ls *.cpp | grep -v render.cpp) -o ladder-idle-test
+ * ./ladder-idle-test
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "AudioArena.h"
+#include "ReconfigurePipeline.h"
+#include "StereoLadder.h"
+#include "SynthInstance.h"
+
+namespace {
+
+const float kSampleRate = 44100.0f;
+const unsigned int kBlockFrames = 64;
+
+/** @brief Frames of the 10 ms noise burst */
+const unsigned int kBurstFrames = 441;
+
+/** @brief Frames of silence after the burst or the note */
+const unsigned int kIdleFrames = 4 * 44100;
+
+/** @brief Frames of each RMS window (100 ms) */
+const unsigned int kWindowFrames = 4410;
+
+/** @brief Largest allowed output; the burst peaks at 0.5 */
+const float kPeakLimit = 8.0f;
+
+/**
+ * @brief Largest allowed last-window over first-window RMS
+ *
+ * Full resonance rings for a long time even when it is stable: the
+ * slowest point (20 Hz, resonance 0.9 and above) falls to about a sixth
+ * over the 4 s, most others by several orders of magnitude
+ */
+const double kDecayRatio = 0.5;
+
+const float kCutoffsHz[] = { 20.0f, 100.0f, 500.0f, 1000.0f, 2700.0f, 5000.0f, 8000.0f, 12000.0f, 16000.0f, 20000.0f };
+const float kResonances[] = { 0.0f, 0.1f, 0.3f, 0.5f, 0.7f, 0.9f, 1.0f };
+const float kPots[] = { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f };
+
+const unsigned int kNumCutoffs = sizeof(kCutoffsHz) / sizeof(kCutoffsHz[0]);
+const unsigned int kNumResonances = sizeof(kResonances) / sizeof(kResonances[0]);
+const unsigned int kNumPots = sizeof(kPots) / sizeof(kPots[0]);
+
+/**
+ * @struct IdleResult
+ * @brief What one run of output looked like after the excitation
+ */
+struct IdleResult {
+    bool finite = true;
+    float peak = 0.0f;
+    double firstSquares = 0.0;  ///< Sum of squares of the first window
+    double lastSquares = 0.0;   ///< Sum of squares of the last window
+
+    /**
+     * @brief Account one output sample
+     * @param idleFrame Frames since the excitation ended
+     */
+    void add(float left, float right, unsigned int idleFrame) {
+        const float level = std::max(std::fabs(left), std::fabs(right));
+        finite = finite && std::isfinite(left) && std::isfinite(right);
+        peak = std::max(peak, level);
+        if (idleFrame < kWindowFrames)
+            firstSquares += static_cast<double>(level) * level;
+        if (idleFrame >= kIdleFrames - kWindowFrames)
+            lastSquares += static_cast<double>(level) * level;
+    }
+
+    /** @brief Finite, bounded and decaying (or silent all along) */
+    bool passed() const {
+        return finite && peak <= kPeakLimit && lastSquares <= kDecayRatio * kDecayRatio * firstSquares;
+    }
+
+    void print(const char* label) const {
+        printf("FAIL %s: finite %d peak %g rms first %g last %g\n", label, finite, peak,
+               std::sqrt(firstSquares / kWindowFrames), std::sqrt(lastSquares / kWindowFrames));
+    }
+};
+
+/** @brief LCG white noise in [-0.5, 0.5) */
+inline float burstNoise(uint32_t& seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) * (1.0f / 16777216.0f) - 0.5f;
+}
+
+/**
+ * @brief Silence, then a burst and silence, through one drive-0 ladder
+ * @return Number of failures (0, 1 or 2)
+ */
+unsigned int runLadder(float cutoffHz, float resonance, int mode) {
+    StereoLadder ladder;
+    ladder.setDrive(0.0f);
+    ladder.setMode(mode);
+    ladder.setCutoffSpread(StereoLadder::kMaxCutoffSpread);
+    ladder.setResonanceSpread(StereoLadder::kMaxResonanceSpread);
+
+    float input[kBlockFrames];
+    float cutoff[kBlockFrames];
+    float resonanceBuffer[kBlockFrames];
+    float outputL[kBlockFrames];
+    float outputR[kBlockFrames];
+    for (unsigned int n = 0; n < kBlockFrames; ++n) {
+        cutoff[n] = cutoffHz;
+        resonanceBuffer[n] = resonance;
+    }
+
+    char label[96];
+    snprintf(label, sizeof(label), "ladder %g Hz resonance %g mode %d", cutoffHz, resonance, mode);
+    unsigned int failures = 0;
+
+    /** A clear ladder fed silence must stay exactly silent */
+    for (unsigned int n = 0; n < kBlockFrames; ++n)
+        input[n] = 0.0f;
+    bool silent = true;
+    for (unsigned int frame = 0; frame < kSampleRate; frame += kBlockFrames) {
+        ladder.process<44100>(input, input, cutoff, resonanceBuffer, 1.0f, outputL, outputR, kBlockFrames);
+        for (unsigned int n = 0; n < kBlockFrames; ++n)
+            silent = silent && outputL[n] == 0.0f && outputR[n] == 0.0f;
+    }
+    if (!silent) {
+        printf("FAIL %s: output without input\n", label);
+        ++failures;
+    }
+
+    IdleResult result;
+    uint32_t seed = 1;
+    for (unsigned int frame = 0; frame < kBurstFrames + kIdleFrames; frame += kBlockFrames) {
+        for (unsigned int n = 0; n < kBlockFrames; ++n)
+            input[n] = frame + n < kBurstFrames ? burstNoise(seed) : 0.0f;
+        ladder.process<44100>(input, input, cutoff, resonanceBuffer, 1.0f, outputL, outputR, kBlockFrames);
+        for (unsigned int n = 0; n < kBlockFrames; ++n)
+            if (frame + n >= kBurstFrames && frame + n - kBurstFrames < kIdleFrames)
+                result.add(outputL[n], outputR[n], frame + n - kBurstFrames);
+    }
+    if (!result.passed()) {
+        result.print(label);
+        ++failures;
+    }
+    return failures;
+}
+
+/**
+ * @class IdlePart
+ * @brief One SynthInstance in its own arena, driven the way render() does
+ */
+class IdlePart {
+public:
+    bool setup(const PanelControls& panel) {
+        AudioArenaConfig config;
+        config.maxVoices = 1;
+        config.oversampling = 1;
+        config.periodFrames = kBlockFrames;
+        config.subBlockFrames = SynthInstance::kSubBlockFrames;
+        config.voiceBuffers = SynthInstance::kSubBlockBuffers;
+        config.sharedBuffers = 0;
+        config.periodBuffers = 0;
+        config.voiceStateBytes = SynthInstance::requiredStateBytes();
+        config.extraBytes = 0;
+        if (!arena.reserve(AudioArena::requiredBytes(config)))
+            return false;
+
+        part = arena.create<SynthInstance>();
+        if (!part || !part->setup(kSampleRate, 0x7123E, arena))
+            return false;
+        pipeline.addListener(part);
+        EngineRate rate = { kSampleRate, kBlockFrames, false };
+        if (!pipeline.reconfigureNow(rate))
+            return false;
+        part->loadDefaults();
+        part->setPanel(panel);
+        arena.lock();
+        return true;
+    }
+
+    ~IdlePart() { arena.release(); }
+
+    /** @brief Render one period into outputL/outputR */
+    void renderPeriod(float* outputL, float* outputR) {
+        part->processDelayedMidi(sampleClock / kSampleRate * 1000.0f);
+        part->updateControls(kBlockFrames, sampleClock);
+        part->scheduleSequencer(sampleClock + kBlockFrames + SynthInstance::kSubBlockFrames);
+        for (unsigned int b = 0; b < kBlockFrames; b += SynthInstance::kSubBlockFrames) {
+            part->renderSubBlock<44100>(outputL + b, outputR + b, SynthInstance::kSubBlockFrames, sampleClock);
+            sampleClock += SynthInstance::kSubBlockFrames;
+        }
+    }
+
+    void note(bool on) { part->noteMessage(57, 100, on, sampleClock / kSampleRate * 1000.0f); }
+
+private:
+    AudioArena arena;
+    ReconfigurePipeline pipeline;
+    SynthInstance* part = nullptr;
+    uint64_t sampleClock = 0;
+};
+
+/**
+ * @brief Idle, then a note and its release, through one part at drive 0
+ * @return Number of failures (0, 1 or 2)
+ */
+unsigned int runInstance(float cutoffPot, float resonancePot) {
+    PanelControls panel;
+    panel.cutoff = cutoffPot;
+    panel.resonance = resonancePot;
+    panel.drive = 0.0f;
+
+    char label[96];
+    snprintf(label, sizeof(label), "instance cutoff pot %g resonance pot %g", cutoffPot, resonancePot);
+
+    IdlePart part;
+    if (!part.setup(panel)) {
+        printf("FAIL %s: setup\n", label);
+        return 1;
+    }
+
+    float outputL[kBlockFrames];
+    float outputR[kBlockFrames];
+    unsigned int failures = 0;
+
+    /** No note: the part must output exactly zero */
+    bool silent = true;
+    for (unsigned int frame = 0; frame < kSampleRate; frame += kBlockFrames) {
+        part.renderPeriod(outputL, outputR);
+        for (unsigned int n = 0; n < kBlockFrames; ++n)
+            silent = silent && outputL[n] == 0.0f && outputR[n] == 0.0f;
+    }
+    if (!silent) {
+        printf("FAIL %s: output with no note\n", label);
+        ++failures;
+    }
+
+    /** 250 ms note, then its release and tail */
+    part.note(true);
+    for (unsigned int frame = 0; frame < kSampleRate / 4; frame += kBlockFrames)
+        part.renderPeriod(outputL, outputR);
+    part.note(false);
+    IdleResult result;
+    for (unsigned int frame = 0; frame < kIdleFrames; frame += kBlockFrames) {
+        part.renderPeriod(outputL, outputR);
+        for (unsigned int n = 0; n < kBlockFrames; ++n)
+            if (frame + n < kIdleFrames)
+                result.add(outputL[n], outputR[n], frame + n);
+    }
+    if (!result.passed()) {
+        result.print(label);
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main() {
+    unsigned int failures = 0;
+    unsigned int checks = 0;
+
+    for (unsigned int c = 0; c < kNumCutoffs; ++c)
+        for (unsigned int r = 0; r < kNumResonances; ++r)
+            for (int mode = ZDFMoogLadderFilter::LP24; mode <= ZDFMoogLadderFilter::HP24; ++mode) {
+                failures += runLadder(kCutoffsHz[c], kResonances[r], mode);
+                checks += 2;
+            }
+
+    for (unsigned int c = 0; c < kNumPots; ++c)
+        for (unsigned int r = 0; r < kNumPots; ++r) {
+            failures += runInstance(kPots[c], kPots[r]);
+            checks += 2;
+        }
+
+    printf("%u of %u drive-0 checks failed\n", failures, checks);
+    return failures ? 1 : 0;
+}
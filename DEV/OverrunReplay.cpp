@@ -0,0 +1,288 @@
+/**
+ * @file OverrunReplay.cpp
+ * @brief Replays an overrun snapshot through render.cpp on a host and profiles it
+ *
+ * Loads a tr123e-overrun-<n>.bin written by OverrunCapture, starts the
+ * engine at the snapshot's sample rate and period, restores the first
+ * block's ADSR, stereo ladder pair, portamento and resonance-ramp state,
+ * then feeds every captured block's MIDI bytes and analog frames through
+ * render() in order. Each block is timed (and counted with PerfCounters where the PMU
+ * is available), best of several runs, next to the time it took on stage.
+ *
+ * @determinism
+ * setup() runs once per process on the board, so every run is a fresh
+ * child process that starts the engine from setup() and the same snapshot.
+ * The output of each run is hashed: the hashes must agree. State the capture
+ * does not hold (oscillator phase, noise generator, LFOs, sequencer,
+ * modulation layer) starts from its setup() value rather than its value on
+ * stage, so the audio matches the stage only where those do not matter;
+ * the control flow that caused the spike - notes, glides, envelope stages,
+ * knob sweeps - is reproduced.
+ *
+ * The engine's own block trace is active during the replay and is written
+ * by cleanup() as tr123e-trace-<n>.json, giving per-stage timings of the
+ * replayed blocks.
+ *
+ * @build
+ * @code
+ * # From the repository root (host or board):
+ * g++ -O3 -std=c++14 -IDEV/HostShim -I. -IDEV DEV/OverrunReplay.cpp DEV/PerfCounters.cpp \
+ *     $(ls *.cpp) -o overrun-replay
+ * ./overrun-replay tr123e-overrun-0.bin [--repeat N]
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#include <Bela.h>
+#include <libraries/Midi/Midi.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "OverrunCapture.h"
+#include "PerfCounters.h"
+
+bool setup(BelaContext* context, void* userData);
+void render(BelaContext* context, void* userData);
+void cleanup(BelaContext* context, void* userData);
+
+extern Midi midi;
+extern OverrunCapture overrunCapture;
+
+namespace {
+
+/**
+ * @struct BlockProfile
+ * @brief Best host measurement of one replayed block
+ */
+struct BlockProfile {
+    double nanoseconds;
+    double cycles;
+    double instructions;
+    bool countersValid;
+};
+
+/**
+ * @brief FNV-1a over the output samples' bit patterns
+ */
+uint64_t hashSamples(const float* samples, size_t count, uint64_t hash) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(samples);
+    for (size_t i = 0; i < count * sizeof(float); ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief One pass over the snapshot from a fresh engine
+ *
+ * @return Output hash, or 0 if setup() failed
+ */
+uint64_t replayOnce(const std::vector<CaptureBlock>& blocks, PerfCounters& counters,
+                    std::vector<BlockProfile>& profile) {
+    const CaptureBlock& first = blocks[0];
+    std::vector<float> analog(CaptureBlock::kMaxAnalogFrames * CaptureBlock::kMaxAnalogChannels, 0.0f);
+    std::vector<float> audioOut(2 * 1024, 0.0f);
+
+    BelaContext context;
+    memset(&context, 0, sizeof(context));
+    context.audioOut = audioOut.data();
+    context.analogIn = analog.data();
+    context.audioFrames = first.audioFrames;
+    context.audioOutChannels = 2;
+    context.audioSampleRate = first.sampleRate;
+    context.analogInChannels = first.analogChannels ? first.analogChannels : 8;
+    context.analogFrames = first.analogFrames ? first.analogFrames : first.audioFrames / 2;
+    context.analogSampleRate = first.sampleRate * context.analogFrames / first.audioFrames;
+    context.audioFramesElapsed = first.frame;
+
+    if (!setup(&context, nullptr))
+        return 0;
+    overrunCapture.setArmed(false);
+    HostShim::runAuxiliaryTasks();
+    overrunCapture.restoreModules(first);
+
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const CaptureBlock& block = blocks[b];
+        context.audioFramesElapsed = block.frame;
+        context.audioFrames = block.audioFrames;
+        context.audioSampleRate = block.sampleRate;
+        if (block.analogFrames > 0) {
+            context.analogFrames = block.analogFrames;
+            context.analogInChannels = block.analogChannels;
+            memcpy(analog.data(), block.analog, block.analogFrames * block.analogChannels * sizeof(float));
+        }
+        midi.getParser()->parse(block.midi, block.midiBytes);
+
+        PerfCounters::Reading reading;
+        counters.start();
+        render(&context, nullptr);
+        counters.stop(reading);
+        hash = hashSamples(audioOut.data(), 2 * block.audioFrames, hash);
+
+        BlockProfile& best = profile[b];
+        if (reading.nanoseconds < best.nanoseconds) {
+            best.nanoseconds = reading.nanoseconds;
+            best.cycles = reading.count[PerfCounters::kCycles];
+            best.instructions = reading.count[PerfCounters::kInstructions];
+            best.countersValid = reading.valid[PerfCounters::kCycles] && reading.valid[PerfCounters::kInstructions];
+        }
+        HostShim::runAuxiliaryTasks();
+    }
+
+    cleanup(&context, nullptr);
+    return hash;
+}
+
+/**
+ * @brief Run replayOnce() in a child process with pristine engine globals
+ *
+ * The child sends its hash and block timings back through a pipe; the
+ * parent keeps the best timing per block.
+ *
+ * @return Output hash, or 0 on failure
+ */
+uint64_t replayInChild(const std::vector<CaptureBlock>& blocks, PerfCounters& counters,
+                       std::vector<BlockProfile>& best) {
+    int fds[2];
+    if (pipe(fds) != 0)
+        return 0;
+    fflush(stdout);
+    const pid_t pid = fork();
+    if (pid < 0)
+        return 0;
+
+    if (pid == 0) {
+        close(fds[0]);
+        std::vector<BlockProfile> profile(blocks.size());
+        for (size_t b = 0; b < profile.size(); ++b)
+            profile[b].nanoseconds = 1e300;
+        const uint64_t hash = replayOnce(blocks, counters, profile);
+        fflush(stdout);
+        bool ok = write(fds[1], &hash, sizeof(hash)) == static_cast<ssize_t>(sizeof(hash));
+        const size_t bytes = profile.size() * sizeof(BlockProfile);
+        ok = ok && write(fds[1], profile.data(), bytes) == static_cast<ssize_t>(bytes);
+        close(fds[1]);
+        _exit(ok ? 0 : 1);
+    }
+
+    close(fds[1]);
+    uint64_t hash = 0;
+    std::vector<BlockProfile> profile(blocks.size());
+    const size_t bytes = profile.size() * sizeof(BlockProfile);
+    bool ok = read(fds[0], &hash, sizeof(hash)) == static_cast<ssize_t>(sizeof(hash));
+    size_t received = 0;
+    while (ok && received < bytes) {
+        const ssize_t n = read(fds[0], reinterpret_cast<char*>(profile.data()) + received, bytes - received);
+        ok = n > 0;
+        received += ok ? static_cast<size_t>(n) : 0;
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return 0;
+
+    for (size_t b = 0; b < blocks.size(); ++b)
+        if (profile[b].nanoseconds < best[b].nanoseconds)
+            best[b] = profile[b];
+    return hash;
+}
+
+/**
+ * @brief Count the messages in a captured byte stream
+ */
+unsigned int countMessages(const CaptureBlock& block) {
+    unsigned int messages = 0;
+    for (unsigned int i = 0; i < block.midiBytes; ++i)
+        if (block.midi[i] >= 0x80)
+            ++messages;
+    return messages;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <tr123e-overrun-N.bin> [--repeat N]\n", argv[0]);
+        return 2;
+    }
+    int repeats = 5;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeats = atoi(argv[++i]);
+    }
+    if (repeats < 1)
+        repeats = 1;
+
+    OverrunFileHeader header;
+    std::vector<CaptureBlock> blocks;
+    if (!OverrunCapture::load(argv[1], header, blocks)) {
+        fprintf(stderr, "%s: not a snapshot from this build (missing, truncated or different layout)\n", argv[1]);
+        return 1;
+    }
+    printf("%s: %u blocks, overrun at block %u, period %.1f us, %.0f Hz, %u frames\n",
+           argv[1], header.blockCount, header.overrunBlock, header.periodNs * 1e-3,
+           blocks[0].sampleRate, blocks[0].audioFrames);
+
+    PerfCounters counters;
+    counters.open();
+    printf("counters: %s\n", counters.getStatus());
+
+    std::vector<BlockProfile> profile(blocks.size());
+    for (size_t b = 0; b < profile.size(); ++b) {
+        profile[b].nanoseconds = 1e300;
+        profile[b].cycles = 0.0;
+        profile[b].instructions = 0.0;
+        profile[b].countersValid = false;
+    }
+
+    /**
+     * Replay from scratch each time; differing hashes mean some state
+     * escaped the restart and the replay is not reproducible
+     */
+    uint64_t firstHash = 0;
+    bool deterministic = true;
+    for (int r = 0; r < repeats; ++r) {
+        const uint64_t hash = replayInChild(blocks, counters, profile);
+        if (hash == 0) {
+            fprintf(stderr, "replay failed (setup() rejected the snapshot's configuration?)\n");
+            return 1;
+        }
+        if (r == 0)
+            firstHash = hash;
+        else if (hash != firstHash)
+            deterministic = false;
+    }
+    printf("output hash %016llx over %d runs: %s\n\n", static_cast<unsigned long long>(firstHash), repeats,
+           deterministic ? "deterministic" : "NOT deterministic");
+
+    printf("%5s %12s %4s %5s %10s %7s %10s %12s %12s\n",
+           "block", "frame", "midi", "flags", "stage us", "load", "host us", "cycles", "instructions");
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const CaptureBlock& block = blocks[b];
+        const double periodNs = block.audioFrames * 1e9 / block.sampleRate;
+        char flags[4] = { '-', '-', '-', 0 };
+        if (block.flags & CaptureBlock::kOverrun)
+            flags[0] = 'O';
+        if (block.flags & CaptureBlock::kMidiTruncated)
+            flags[1] = 'M';
+        if (block.flags & CaptureBlock::kAnalogTruncated)
+            flags[2] = 'A';
+        printf("%5zu %12llu %4u %5s %10.1f %6.0f%% %10.2f",
+               b, static_cast<unsigned long long>(block.frame), countMessages(block), flags,
+               block.durationNs * 1e-3, 100.0 * block.durationNs / periodNs, profile[b].nanoseconds * 1e-3);
+        if (profile[b].countersValid)
+            printf(" %12.0f %12.0f\n", profile[b].cycles, profile[b].instructions);
+        else
+            printf(" %12s %12s\n", "-", "-");
+    }
+    return deterministic ? 0 : 3;
+}
@@ -0,0 +1,994 @@
+/**
+ * @file ParameterFuzzer.cpp
+ * @brief Parameter-space fuzzer for numerical blowups and slow paths in the filters and envelopes
+ *
+ * Every ladder clamps its parameters differently and none of them is
+ * checked against what a performer (or a modulation bug) can actually
+ * send: the production ladder takes feedbackGain = 4 × resonance with a
+ * one-sample feedback delay, the MSP model clamps everything, the Q16
+ * ladder does raw integer arithmetic. This tool drives each of them, and
+ * both envelopes, with random and adversarial parameter trajectories and
+ * input signals, and flags:
+ * - **nonfinite**: NaN or Inf in the output
+ * - **runaway**: output peak above a limit (for filters relative to the
+ *   input peak so far; for envelopes absolute)
+ * - **slow**: a block taking more than --slow-factor times the target's
+ *   baseline block time, confirmed by the fastest of three runs - the
+ *   signature of denormals, libm slow paths and other cost cliffs
+ *
+ * @cases
+ * A case is a target and a list of segments. A segment runs for a number
+ * of 64-frame blocks with one input signal (silence, impulse, DC, sine,
+ * square, noise, subnormal-level noise, or a very loud signal) and ramps
+ * each parameter from a start to an end value, applied once per block or,
+ * for some segments, every sample. About a third of parameter values are
+ * adversarial: range edges, zero, negatives, far out of range, tiny and
+ * huge. For the envelopes the input is the gate (on while it is positive).
+ *
+ * @minimisation
+ * A failing case is shrunk while it still fails the same way: later
+ * segments dropped, earlier segments removed one by one, block counts
+ * halved, ramps flattened, parameters reset to defaults, inputs replaced
+ * by simpler ones. The result is printed and written to
+ * fuzz-<target>-<kind>.case; --replay runs such a file again, so a fix can
+ * be checked against the exact trajectory that broke it. Only the first
+ * failure of each kind per target is minimised; later ones are counted.
+ *
+ * @targets
+ * - zdf-v2: production ladder (zdf_moogladder_v2)
+ * - msp: MSPMoogLadderFilter (double precision, envelope-style cutoff)
+ * - bilinear, empirical: the DEV tanh ladders
+ * - fixed-point: Q16 ladder; build with -fsanitize=undefined as well to
+ *   have UBSan name the overflowing expression
+ * - adsr: ADSR rates in samples, sustain and target ratios
+ * - filter-envelope: MoogFilterEnvelope, output in Hz
+ * The development ZDF ladder (DEV/ZDFMoogLadderFilter) shares the class
+ * name of the production one and cannot be linked alongside it.
+ *
+ * @build
+ * @code
+ * # From the repository root (no -ffast-math: it would flush subnormals):
+ * g++ -O2 -std=c++17 -I. -IDEV DEV/ParameterFuzzer.cpp ADSR.cpp MoogFilterEnvelope.cpp \
+ *     zdf_moogladder_v2.cpp TableBank.cpp DEV/MSPMoogLadderFilter.cpp \
+ *     DEV/BilinearTransformMoogLadderFilter.cpp DEV/EmpiricallyTunedMoogFilter.cpp \
+ *     DEV/MoogLadderFilterFixedPoint.cpp ParameterUpdate.cpp -o fuzzer
+ * ./fuzzer                          # 200 cases per target, seed 1
+ * ./fuzzer --target zdf --cases 2000 --seed 7
+ * ./fuzzer --replay fuzz-zdf-v2-nonfinite.case
+ * @endcode
+ * Options: --target substring, --cases N, --seed S, --blocks N (longest
+ * case), --slow-factor F, --no-timing. The exit status is 1 when anything
+ * failed. Timing results are only meaningful on an idle machine; run on
+ * the board for the cliffs that matter there (NEON flushes subnormals,
+ * VFP does not).
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#include "ADSR.h"
+#include "MoogFilterEnvelope.h"
+#include "zdf_moogladder_v2.h"
+#include "MSPMoogLadderFilter.h"
+#include "MoogLadderFilter.h"
+#include "EmpiricallyTunedMoogFilter.h"
+#include "MoogLadderFilterFixedPoint.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <time.h>
+#include <vector>
+
+namespace {
+
+const float kSampleRate = 44100.0f;
+const unsigned int kBlockFrames = 64;
+const unsigned int kMaxParameters = 8;
+const int kTimingRuns = 3;
+
+/** @brief Blocks shorter than this are not judged slow (timer resolution, noise) */
+const double kMinSlowNs = 2000.0;
+
+inline uint64_t nowNs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+/**
+ * @class Random
+ * @brief xorshift64*; every case is a pure function of its seed
+ */
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+    uint32_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<uint32_t>((state * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+    float uniform() { return static_cast<float>(next()) * (1.0f / 4294967296.0f); }
+    float range(float lo, float hi) { return lo + (hi - lo) * uniform(); }
+    unsigned int below(unsigned int n) { return next() % n; }
+    bool chance(float p) { return uniform() < p; }
+
+private:
+    uint64_t state;
+};
+
+// ============================================================================
+// TARGETS
+// ============================================================================
+
+/**
+ * @class Subject
+ * @brief One instance of a filter or envelope under test
+ */
+class Subject {
+public:
+    virtual ~Subject() {}
+    virtual void setParameters(const float* values) = 0;
+    virtual float process(float input) = 0;
+};
+
+/**
+ * @struct ParameterSpec
+ * @brief Nominal range of a parameter; values outside it are adversarial
+ */
+struct ParameterSpec {
+    const char* name;
+    float lo;
+    float hi;
+    float defaultValue;
+    bool logarithmic;   ///< Drawn and ramped in log space (lo > 0)
+    bool integer;
+};
+
+struct Target {
+    const char* name;
+    unsigned int numParameters;
+    ParameterSpec parameters[kMaxParameters];
+    float runawayLimit;
+    bool limitScalesWithInput;  ///< Filters: limit × max(1, input peak)
+    std::unique_ptr<Subject> (*create)();
+};
+
+class ZdfSubject : public Subject {
+public:
+    ZdfSubject() : filter(kSampleRate) {}
+    void setParameters(const float* p) override {
+        filter.setCutoff(p[0]);
+        filter.setResonance(p[1]);
+        filter.setDrive(p[2]);
+        filter.setMode(static_cast<int>(p[3]));
+    }
+    float process(float input) override { return filter.process(input); }
+
+private:
+    ZDFMoogLadderFilter filter;
+};
+
+class MspSubject : public Subject {
+public:
+    MspSubject() : filter(kSampleRate), envelope(0.0), resonance(0.0), noise(0.0), mode(0) {}
+    void setParameters(const float* p) override {
+        envelope = p[0];
+        resonance = p[1];
+        noise = p[2];
+        mode = static_cast<int>(p[3]);
+    }
+    float process(float input) override {
+        return static_cast<float>(filter.processSample(input, envelope, resonance, noise, mode));
+    }
+
+private:
+    MSPMoogLadderFilter filter;
+    double envelope;
+    double resonance;
+    double noise;
+    int mode;
+};
+
+class BilinearSubject : public Subject {
+public:
+    BilinearSubject() : filter(kSampleRate) {}
+    void setParameters(const float* p) override {
+        filter.setCutoff(p[0]);
+        filter.setResonance(p[1]);
+    }
+    float process(float input) override { return filter.process(input); }
+
+private:
+    MoogLadderFilter filter;
+};
+
+class EmpiricalSubject : public Subject {
+public:
+    EmpiricalSubject() : filter(kSampleRate) {}
+    void setParameters(const float* p) override {
+        filter.setCutoff(p[0]);
+        filter.setResonance(p[1]);
+    }
+    float process(float input) override { return filter.process(input); }
+
+private:
+    MoogFilter filter;
+};
+
+/**
+ * Input and output in Q14, as KernelCounterBench and FilterParetoAnalyser
+ * drive it. The float-to-int conversion saturates, so the overflow found
+ * is the ladder's own and not the harness's
+ */
+class FixedPointSubject : public Subject {
+public:
+    FixedPointSubject() : filter(static_cast<int>(kSampleRate)) {}
+    void setParameters(const float* p) override {
+        filter.setCutoff(static_cast<int>(p[0]));
+        filter.setResonance(static_cast<int>(p[1]));
+    }
+    float process(float input) override {
+        const float scaled = std::max(-2.0e9f, std::min(2.0e9f, input * 16384.0f));
+        return static_cast<float>(filter.process(static_cast<int>(scaled))) * (1.0f / 16384.0f);
+    }
+
+private:
+    MoogLadderFilterFixedPoint filter;
+};
+
+/**
+ * Envelopes: the input is the gate, on while positive
+ */
+class AdsrSubject : public Subject {
+public:
+    AdsrSubject() : gateOn(false) {}
+    void setParameters(const float* p) override {
+        envelope.setTargetRatioA(p[4]);
+        envelope.setTargetRatioDR(p[5]);
+        envelope.setAttackRate(p[0]);
+        envelope.setDecayRate(p[1]);
+        envelope.setSustainLevel(p[2]);
+        envelope.setReleaseRate(p[3]);
+    }
+    float process(float input) override {
+        const bool on = input > 0.0f;
+        if (on != gateOn) {
+            envelope.gate(on ? 1 : 0);
+            gateOn = on;
+        }
+        return envelope.process();
+    }
+
+private:
+    ADSR envelope;
+    bool gateOn;
+};
+
+class FilterEnvelopeSubject : public Subject {
+public:
+    FilterEnvelopeSubject() : envelope(kSampleRate), gateOn(false), cutoffBase(0.0f) {}
+    void setParameters(const float* p) override {
+        envelope.setADSR(p[0], p[1], p[2], p[3]);
+        envelope.setEnvDepth(p[4]);
+        cutoffBase = p[5];
+    }
+    float process(float input) override {
+        const bool on = input > 0.0f;
+        if (on != gateOn) {
+            envelope.gate(on ? 1 : 0, 1.0f);
+            gateOn = on;
+        }
+        return envelope.process(cutoffBase, 0.0f);
+    }
+
+private:
+    MoogFilterEnvelope envelope;
+    bool gateOn;
+    float cutoffBase;
+};
+
+template <typename T>
+std::unique_ptr<Subject> make() {
+    return std::unique_ptr<Subject>(new T());
+}
+
+const float kAdsrMaxRate = 10.0f * kSampleRate;
+
+const Target targets[] = {
+    {"zdf-v2", 4, {
+        {"cutoff", 20.0f, 20000.0f, 1000.0f, true, false},
+        {"resonance", 0.0f, 1.0f, 0.5f, false, false},
+        {"drive", 0.0f, 1.0f, 0.0f, false, false},
+        {"mode", 0.0f, 2.0f, 0.0f, false, true}},
+     100.0f, true, make<ZdfSubject>},
+    {"msp", 4, {
+        {"envelope", 0.0f, 1.0f, 0.5f, false, false},
+        {"resonance", 0.0f, 1.05f, 0.5f, false, false},
+        {"noise", 0.0f, 0.01f, 0.0f, false, false},
+        {"mode", 0.0f, 5.0f, 0.0f, false, true}},
+     100.0f, true, make<MspSubject>},
+    {"bilinear", 2, {
+        {"cutoff", 20.0f, 20000.0f, 1000.0f, true, false},
+        {"resonance", 0.0f, 1.0f, 0.5f, false, false}},
+     100.0f, true, make<BilinearSubject>},
+    {"empirical", 2, {
+        {"cutoff", 20.0f, 20000.0f, 1000.0f, true, false},
+        {"resonance", 0.0f, 1.0f, 0.5f, false, false}},
+     100.0f, true, make<EmpiricalSubject>},
+    {"fixed-point", 2, {
+        {"cutoff", 20.0f, 22050.0f, 1000.0f, true, true},
+        {"resonance", 0.0f, 255.0f, 128.0f, false, true}},
+     100.0f, true, make<FixedPointSubject>},
+    {"adsr", 6, {
+        {"attack", 1.0f, kAdsrMaxRate, 441.0f, true, false},
+        {"decay", 1.0f, kAdsrMaxRate, 4410.0f, true, false},
+        {"sustain", 0.0f, 1.0f, 0.7f, false, false},
+        {"release", 1.0f, kAdsrMaxRate, 8820.0f, true, false},
+        {"ratio-a", 1e-9f, 100.0f, 0.3f, true, false},
+        {"ratio-dr", 1e-9f, 100.0f, 0.0001f, true, false}},
+     2.0f, false, make<AdsrSubject>},
+    {"filter-envelope", 6, {
+        {"attack", 0.001f, 10.0f, 0.01f, true, false},
+        {"decay", 0.001f, 10.0f, 0.2f, true, false},
+        {"sustain", 0.0f, 1.0f, 0.5f, false, false},
+        {"release", 0.001f, 30.0f, 0.3f, true, false},
+        {"depth", 0.0f, 10000.0f, 2000.0f, false, false},
+        {"base", 20.0f, 20000.0f, 500.0f, true, false}},
+     1.0e6f, false, make<FilterEnvelopeSubject>},
+};
+
+const unsigned int kNumTargets = sizeof(targets) / sizeof(targets[0]);
+
+// ============================================================================
+// CASES
+// ============================================================================
+
+enum InputKind {
+    kSilence = 0,
+    kImpulse,
+    kDc,
+    kSine,
+    kSquare,
+    kNoise,
+    kSubnormal,     ///< Noise at 1e-39, below FLT_MIN: subnormal from the first sample
+    kLoud,          ///< Square at 1e4 × amplitude
+    kNumInputKinds
+};
+
+const char* const inputNames[kNumInputKinds] = {
+    "silence", "impulse", "dc", "sine", "square", "noise", "subnormal", "loud"
+};
+
+struct Segment {
+    unsigned int blocks;
+    InputKind input;
+    float amplitude;
+    float frequency;
+    uint32_t seed;          ///< Noise for this segment, independent of its neighbours
+    bool perSample;         ///< Apply the ramp every sample instead of every block
+    float start[kMaxParameters];
+    float end[kMaxParameters];
+};
+
+struct Case {
+    const Target* target;
+    std::vector<Segment> segments;
+
+    unsigned int totalBlocks() const {
+        unsigned int total = 0;
+        for (const Segment& s : segments)
+            total += s.blocks;
+        return total;
+    }
+};
+
+/**
+ * @brief A parameter value: in range, or (a third of the time) adversarial
+ */
+float drawParameter(Random& random, const ParameterSpec& spec) {
+    if (random.chance(0.33f)) {
+        const float span = spec.hi - spec.lo;
+        const float adversarial[] = {
+            spec.lo, spec.hi, 0.0f, -spec.hi, spec.lo - span, spec.hi * 2.0f,
+            spec.hi * 1000.0f, 1e-30f, 1e30f, -1e30f
+        };
+        const float value = adversarial[random.below(sizeof(adversarial) / sizeof(adversarial[0]))];
+        return spec.integer ? std::max(-2.0e9f, std::min(2.0e9f, std::round(value))) : value;
+    }
+    float value;
+    if (spec.logarithmic)
+        value = spec.lo * powf(spec.hi / spec.lo, random.uniform());
+    else
+        value = random.range(spec.lo, spec.hi);
+    return spec.integer ? std::round(value) : value;
+}
+
+Case generateCase(const Target& target, uint64_t seed, unsigned int maxBlocks) {
+    Random random(seed);
+    Case result;
+    result.target = &target;
+    const unsigned int numSegments = 1 + random.below(6);
+    for (unsigned int s = 0; s < numSegments; ++s) {
+        Segment segment;
+        segment.blocks = 1 + random.below(std::max(1u, maxBlocks / numSegments));
+        segment.input = static_cast<InputKind>(random.below(kNumInputKinds));
+        const float amplitudes[] = { 0.0f, 1.0f, 10.0f, 1000.0f };
+        segment.amplitude = random.chance(0.2f) ? amplitudes[random.below(4)] : random.uniform();
+        segment.frequency = 20.0f * powf(1000.0f, random.uniform());
+        segment.seed = random.next();
+        segment.perSample = random.chance(0.2f);
+        for (unsigned int p = 0; p < target.numParameters; ++p) {
+            segment.start[p] = drawParameter(random, target.parameters[p]);
+            /**
+             * Half the ramps are flat, the rest sweep to a new value (which
+             * may be adversarial: the jump itself is part of the test)
+             */
+            segment.end[p] = random.chance(0.5f) ? segment.start[p] : drawParameter(random, target.parameters[p]);
+        }
+        result.segments.push_back(segment);
+    }
+    return result;
+}
+
+/**
+ * @brief Parameter value `fraction` of the way through a segment's ramp
+ */
+float rampValue(const ParameterSpec& spec, float start, float end, float fraction) {
+    float value;
+    if (spec.logarithmic && start > 0.0f && end > 0.0f && start != end)
+        value = start * powf(end / start, fraction);
+    else
+        value = start + (end - start) * fraction;
+    return spec.integer ? std::round(value) : value;
+}
+
+float inputSample(const Segment& segment, unsigned int n, Random& noise) {
+    const float t = static_cast<float>(n) / kSampleRate;
+    const float a = segment.amplitude;
+    switch (segment.input) {
+    case kSilence:
+        return 0.0f;
+    case kImpulse:
+        return n == 0 ? a : 0.0f;
+    case kDc:
+        return a;
+    case kSine:
+        return a * sinf(2.0f * static_cast<float>(M_PI) * segment.frequency * t);
+    case kSquare:
+        return fmodf(segment.frequency * t, 1.0f) < 0.5f ? a : -a;
+    case kNoise:
+        return a * (2.0f * noise.uniform() - 1.0f);
+    case kSubnormal:
+        return 1e-39f * (2.0f * noise.uniform() - 1.0f);
+    case kLoud:
+        return 1e4f * std::max(a, 0.01f) * (fmodf(segment.frequency * t, 1.0f) < 0.5f ? 1.0f : -1.0f);
+    default:
+        return 0.0f;
+    }
+}
+
+// ============================================================================
+// RUNNING AND JUDGING
+// ============================================================================
+
+enum FailureKind {
+    kNone = 0,
+    kNonFinite,
+    kRunaway,
+    kSlow,
+    kNumFailureKinds
+};
+
+const char* const failureNames[kNumFailureKinds] = { "none", "nonfinite", "runaway", "slow" };
+
+struct Outcome {
+    FailureKind kind;
+    unsigned int block;     ///< First failing block
+    float value;            ///< Offending output sample, or block ns for kSlow
+    std::vector<double> blockNs;
+    std::vector<bool> blockPerSample;   ///< Parameters applied every sample in that block
+};
+
+/**
+ * @brief Run a case once, stopping at the first nonfinite or runaway block
+ */
+Outcome runCase(const Case& testCase, bool timing) {
+    const Target& target = *testCase.target;
+    std::unique_ptr<Subject> subject = target.create();
+    Outcome outcome = { kNone, 0, 0.0f, {}, {} };
+    float output[kBlockFrames];
+    float input[kBlockFrames];
+    float values[kMaxParameters];
+    float inputPeak = 0.0f;
+    unsigned int block = 0;
+
+    for (const Segment& segment : testCase.segments) {
+        Random noise(segment.seed);
+        const float totalFrames = static_cast<float>(segment.blocks * kBlockFrames);
+        for (unsigned int b = 0; b < segment.blocks; ++b, ++block) {
+            for (unsigned int n = 0; n < kBlockFrames; ++n) {
+                input[n] = inputSample(segment, b * kBlockFrames + n, noise);
+                inputPeak = std::max(inputPeak, fabsf(input[n]));
+            }
+
+            const uint64_t begin = timing ? nowNs() : 0;
+            if (segment.perSample) {
+                for (unsigned int n = 0; n < kBlockFrames; ++n) {
+                    const float fraction = (b * kBlockFrames + n) / totalFrames;
+                    for (unsigned int p = 0; p < target.numParameters; ++p)
+                        values[p] = rampValue(target.parameters[p], segment.start[p], segment.end[p], fraction);
+                    subject->setParameters(values);
+                    output[n] = subject->process(input[n]);
+                }
+            }
+            else {
+                const float fraction = static_cast<float>(b) / segment.blocks;
+                for (unsigned int p = 0; p < target.numParameters; ++p)
+                    values[p] = rampValue(target.parameters[p], segment.start[p], segment.end[p], fraction);
+                subject->setParameters(values);
+                for (unsigned int n = 0; n < kBlockFrames; ++n)
+                    output[n] = subject->process(input[n]);
+            }
+            if (timing) {
+                outcome.blockNs.push_back(static_cast<double>(nowNs() - begin));
+                outcome.blockPerSample.push_back(segment.perSample);
+            }
+
+            const float limit = target.runawayLimit * (target.limitScalesWithInput ? std::max(1.0f, inputPeak) : 1.0f);
+            for (unsigned int n = 0; n < kBlockFrames; ++n) {
+                if (!std::isfinite(output[n])) {
+                    outcome.kind = kNonFinite;
+                    outcome.block = block;
+                    outcome.value = output[n];
+                    return outcome;
+                }
+                if (fabsf(output[n]) > limit) {
+                    outcome.kind = kRunaway;
+                    outcome.block = block;
+                    outcome.value = output[n];
+                    return outcome;
+                }
+            }
+        }
+    }
+    return outcome;
+}
+
+/**
+ * @brief Baseline block time: default parameters, moderate noise, with the
+ *        parameters applied per block or (they cost more) every sample
+ */
+double calibrate(const Target& target, bool perSample) {
+    Case reference;
+    reference.target = &target;
+    Segment segment;
+    segment.blocks = 400;
+    segment.input = kNoise;
+    segment.amplitude = 0.5f;
+    segment.frequency = 220.0f;
+    segment.seed = 1;
+    segment.perSample = perSample;
+    for (unsigned int p = 0; p < target.numParameters; ++p)
+        segment.start[p] = segment.end[p] = target.parameters[p].defaultValue;
+    reference.segments.push_back(segment);
+
+    std::vector<double> fastest;
+    for (int r = 0; r < kTimingRuns; ++r) {
+        const Outcome outcome = runCase(reference, true);
+        if (fastest.empty())
+            fastest = outcome.blockNs;
+        for (size_t i = 0; i < fastest.size() && i < outcome.blockNs.size(); ++i)
+            fastest[i] = std::min(fastest[i], outcome.blockNs[i]);
+    }
+    std::sort(fastest.begin(), fastest.end());
+    return fastest.empty() ? 0.0 : fastest[fastest.size() / 2];
+}
+
+struct Judge {
+    bool timing;
+    double slowFactor;
+    double baselineNs[kNumTargets][2];     ///< [target][perSample]
+
+    void calibrateTarget(const Target& target) {
+        for (int perSample = 0; perSample < 2; ++perSample)
+            baselineNs[&target - targets][perSample] = timing ? calibrate(target, perSample != 0) : 0.0;
+    }
+
+    double slowThreshold(const Target& target, bool perSample) const {
+        return std::max(kMinSlowNs, slowFactor * baselineNs[&target - targets][perSample ? 1 : 0]);
+    }
+
+    /**
+     * @brief Numerical failures from one run; slow blocks only if they stay
+     *        slow in the fastest of kTimingRuns runs
+     */
+    Outcome evaluate(const Case& testCase) const {
+        Outcome outcome = runCase(testCase, timing);
+        if (outcome.kind != kNone || !timing)
+            return outcome;
+
+        const Target& target = *testCase.target;
+        bool suspect = false;
+        for (size_t i = 0; i < outcome.blockNs.size(); ++i)
+            suspect = suspect || outcome.blockNs[i] > slowThreshold(target, outcome.blockPerSample[i]);
+        if (!suspect)
+            return outcome;
+
+        std::vector<double> fastest = outcome.blockNs;
+        for (int r = 1; r < kTimingRuns; ++r) {
+            const Outcome again = runCase(testCase, true);
+            for (size_t i = 0; i < fastest.size() && i < again.blockNs.size(); ++i)
+                fastest[i] = std::min(fastest[i], again.blockNs[i]);
+        }
+        for (size_t i = 0; i < fastest.size(); ++i) {
+            if (fastest[i] > slowThreshold(target, outcome.blockPerSample[i])) {
+                outcome.kind = kSlow;
+                outcome.block = static_cast<unsigned int>(i);
+                outcome.value = static_cast<float>(fastest[i]);
+                break;
+            }
+        }
+        return outcome;
+    }
+};
+
+// ============================================================================
+// MINIMISATION
+// ============================================================================
+
+/**
+ * @brief Shrink a failing case while it still fails with the same kind
+ */
+Case minimise(const Case& failing, FailureKind kind, unsigned int failingBlock, const Judge& judge) {
+    Case best = failing;
+    auto stillFails = [&](const Case& candidate, unsigned int* block) {
+        if (candidate.segments.empty() || candidate.totalBlocks() == 0)
+            return false;
+        const Outcome outcome = judge.evaluate(candidate);
+        if (outcome.kind != kind)
+            return false;
+        if (block)
+            *block = outcome.block;
+        return true;
+    };
+
+    /**
+     * Nothing after the failing block matters
+     */
+    auto truncate = [&](unsigned int block) {
+        unsigned int start = 0;
+        for (size_t s = 0; s < best.segments.size(); ++s) {
+            if (block < start + best.segments[s].blocks) {
+                best.segments[s].blocks = block - start + 1;
+                best.segments.resize(s + 1);
+                return;
+            }
+            start += best.segments[s].blocks;
+        }
+    };
+    truncate(failingBlock);
+
+    const Target& target = *best.target;
+    bool changed = true;
+    for (int pass = 0; pass < 4 && changed; ++pass) {
+        changed = false;
+        unsigned int block = 0;
+
+        for (size_t s = 0; s < best.segments.size() && best.segments.size() > 1; ) {
+            Case candidate = best;
+            candidate.segments.erase(candidate.segments.begin() + s);
+            if (stillFails(candidate, &block)) {
+                best = candidate;
+                truncate(block);
+                changed = true;
+            }
+            else {
+                ++s;
+            }
+        }
+
+        for (size_t s = 0; s < best.segments.size(); ++s) {
+            while (best.segments[s].blocks > 1) {
+                Case candidate = best;
+                candidate.segments[s].blocks /= 2;
+                if (!stillFails(candidate, &block))
+                    break;
+                best = candidate;
+                truncate(block);
+                changed = true;
+            }
+            if (s >= best.segments.size())
+                break;
+
+            Segment& segment = best.segments[s];
+            if (segment.perSample) {
+                Case candidate = best;
+                candidate.segments[s].perSample = false;
+                if (stillFails(candidate, nullptr)) {
+                    best = candidate;
+                    changed = true;
+                }
+            }
+
+            for (unsigned int p = 0; p < target.numParameters; ++p) {
+                const float defaultValue = target.parameters[p].defaultValue;
+                const float tries[][2] = {
+                    { defaultValue, defaultValue },
+                    { best.segments[s].start[p], best.segments[s].start[p] },
+                    { best.segments[s].end[p], best.segments[s].end[p] },
+                };
+                for (const auto& values : tries) {
+                    if (best.segments[s].start[p] == values[0] && best.segments[s].end[p] == values[1])
+                        continue;
+                    Case candidate = best;
+                    candidate.segments[s].start[p] = values[0];
+                    candidate.segments[s].end[p] = values[1];
+                    if (stillFails(candidate, nullptr)) {
+                        best = candidate;
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+
+            for (int kindIndex = 0; kindIndex < kNumInputKinds; ++kindIndex) {
+                /**
+                 * InputKind is ordered from simplest to most adversarial
+                 */
+                const InputKind input = static_cast<InputKind>(kindIndex);
+                if (input >= best.segments[s].input)
+                    break;
+                Case candidate = best;
+                candidate.segments[s].input = input;
+                if (stillFails(candidate, nullptr)) {
+                    best = candidate;
+                    changed = true;
+                    break;
+                }
+            }
+            if (best.segments[s].amplitude != 1.0f && best.segments[s].input != kSilence) {
+                Case candidate = best;
+                candidate.segments[s].amplitude = 1.0f;
+                if (stillFails(candidate, nullptr)) {
+                    best = candidate;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+// ============================================================================
+// CASE FILES
+// ============================================================================
+
+void writeCase(FILE* out, const Case& testCase, const Outcome& outcome) {
+    fprintf(out, "# %s at block %u (value %.9g)\n", failureNames[outcome.kind], outcome.block, outcome.value);
+    fprintf(out, "target %s\n", testCase.target->name);
+    for (const Segment& segment : testCase.segments) {
+        fprintf(out, "segment blocks=%u input=%s amplitude=%.9g frequency=%.9g seed=%u per-sample=%d",
+                segment.blocks, inputNames[segment.input], segment.amplitude, segment.frequency,
+                segment.seed, segment.perSample ? 1 : 0);
+        for (unsigned int p = 0; p < testCase.target->numParameters; ++p)
+            fprintf(out, " %s=%.9g:%.9g", testCase.target->parameters[p].name, segment.start[p], segment.end[p]);
+        fprintf(out, "\n");
+    }
+}
+
+const Target* findTarget(const char* name) {
+    for (const Target& target : targets)
+        if (!strcmp(target.name, name))
+            return &target;
+    return nullptr;
+}
+
+/**
+ * @brief Read a case written by writeCase(); false with a message on error
+ */
+bool readCase(const char* path, Case& testCase) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    testCase.target = nullptr;
+    testCase.segments.clear();
+    char line[4096];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n')
+            continue;
+        char* save = nullptr;
+        const char* keyword = strtok_r(line, " \n", &save);
+        if (!keyword)
+            continue;
+        if (!strcmp(keyword, "target")) {
+            const char* name = strtok_r(nullptr, " \n", &save);
+            testCase.target = name ? findTarget(name) : nullptr;
+            ok = testCase.target != nullptr;
+            continue;
+        }
+        if (strcmp(keyword, "segment") || !testCase.target) {
+            ok = false;
+            break;
+        }
+        Segment segment = { 1, kSilence, 1.0f, 220.0f, 1, false, {}, {} };
+        for (unsigned int p = 0; p < testCase.target->numParameters; ++p)
+            segment.start[p] = segment.end[p] = testCase.target->parameters[p].defaultValue;
+        for (char* token = strtok_r(nullptr, " \n", &save); token && ok; token = strtok_r(nullptr, " \n", &save)) {
+            char* value = strchr(token, '=');
+            if (!value) {
+                ok = false;
+                break;
+            }
+            *value++ = '\0';
+            if (!strcmp(token, "blocks"))
+                segment.blocks = static_cast<unsigned int>(strtoul(value, nullptr, 10));
+            else if (!strcmp(token, "amplitude"))
+                segment.amplitude = strtof(value, nullptr);
+            else if (!strcmp(token, "frequency"))
+                segment.frequency = strtof(value, nullptr);
+            else if (!strcmp(token, "seed"))
+                segment.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            else if (!strcmp(token, "per-sample"))
+                segment.perSample = atoi(value) != 0;
+            else if (!strcmp(token, "input")) {
+                ok = false;
+                for (int k = 0; k < kNumInputKinds; ++k) {
+                    if (!strcmp(value, inputNames[k])) {
+                        segment.input = static_cast<InputKind>(k);
+                        ok = true;
+                    }
+                }
+            }
+            else {
+                ok = false;
+                for (unsigned int p = 0; p < testCase.target->numParameters; ++p) {
+                    if (!strcmp(token, testCase.target->parameters[p].name)) {
+                        char* colon = nullptr;
+                        segment.start[p] = strtof(value, &colon);
+                        segment.end[p] = (*colon == ':') ? strtof(colon + 1, nullptr) : segment.start[p];
+                        ok = true;
+                    }
+                }
+            }
+        }
+        testCase.segments.push_back(segment);
+    }
+    fclose(file);
+    if (!ok || !testCase.target || testCase.segments.empty()) {
+        fprintf(stderr, "%s: not a fuzzer case file\n", path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* targetFilter = nullptr;
+    const char* replayPath = nullptr;
+    unsigned int cases = 200;
+    unsigned int maxBlocks = 400;
+    uint64_t seed = 1;
+    Judge judge;
+    judge.timing = true;
+    judge.slowFactor = 8.0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--no-timing")) {
+            judge.timing = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "usage: %s [--target name] [--cases N] [--seed S] [--blocks N] "
+                            "[--slow-factor F] [--no-timing] [--replay file]\n", argv[0]);
+            return 2;
+        }
+        const char* value = argv[++i];
+        if (!strcmp(argv[i - 1], "--target"))
+            targetFilter = value;
+        else if (!strcmp(argv[i - 1], "--cases"))
+            cases = static_cast<unsigned int>(atoi(value));
+        else if (!strcmp(argv[i - 1], "--seed"))
+            seed = strtoull(value, nullptr, 10);
+        else if (!strcmp(argv[i - 1], "--blocks"))
+            maxBlocks = std::max(1, atoi(value));
+        else if (!strcmp(argv[i - 1], "--slow-factor"))
+            judge.slowFactor = atof(value);
+        else if (!strcmp(argv[i - 1], "--replay"))
+            replayPath = value;
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i - 1]);
+            return 2;
+        }
+    }
+
+    if (replayPath) {
+        Case testCase;
+        if (!readCase(replayPath, testCase))
+            return 2;
+        judge.calibrateTarget(*testCase.target);
+        const Outcome outcome = judge.evaluate(testCase);
+        printf("%s: %s, %u blocks: ", replayPath, testCase.target->name, testCase.totalBlocks());
+        if (outcome.kind == kNone)
+            printf("passes\n");
+        else if (outcome.kind == kSlow)
+            printf("slow at block %u (%.0f ns, threshold %.0f ns)\n", outcome.block, outcome.value,
+                   judge.slowThreshold(*testCase.target, outcome.blockPerSample[outcome.block]));
+        else
+            printf("%s at block %u (value %g)\n", failureNames[outcome.kind], outcome.block, outcome.value);
+        return outcome.kind == kNone ? 0 : 1;
+    }
+
+    printf("%u cases per target, up to %u blocks of %u frames, seed %llu%s\n\n", cases, maxBlocks, kBlockFrames,
+           static_cast<unsigned long long>(seed), judge.timing ? "" : ", timing off");
+    printf("%-16s %10s %8s %10s %8s %8s\n", "target", "block ns", "cases", "nonfinite", "runaway", "slow");
+
+    unsigned int totalFailures = 0;
+    std::string reports;
+    for (unsigned int t = 0; t < kNumTargets; ++t) {
+        const Target& target = targets[t];
+        if (targetFilter && !strstr(target.name, targetFilter))
+            continue;
+        judge.calibrateTarget(target);
+
+        unsigned int failures[kNumFailureKinds] = {};
+        for (unsigned int c = 0; c < cases; ++c) {
+            const uint64_t caseSeed = seed * 1000003ull + t * 7919ull + c;
+            const Case testCase = generateCase(target, caseSeed, maxBlocks);
+            const Outcome outcome = judge.evaluate(testCase);
+            if (outcome.kind == kNone)
+                continue;
+            ++totalFailures;
+            if (failures[outcome.kind]++ > 0)
+                continue;
+
+            /**
+             * First failure of its kind for this target: shrink, save, report
+             */
+            const Case minimal = minimise(testCase, outcome.kind, outcome.block, judge);
+            Outcome minimalOutcome = judge.evaluate(minimal);
+            if (minimalOutcome.kind != outcome.kind)
+                minimalOutcome = outcome;
+            char path[128];
+            snprintf(path, sizeof(path), "fuzz-%s-%s.case", target.name, failureNames[outcome.kind]);
+            FILE* file = fopen(path, "w");
+            if (file) {
+                writeCase(file, minimal, minimalOutcome);
+                fclose(file);
+            }
+
+            char header[256];
+            snprintf(header, sizeof(header), "\n%s: %s (case seed %llu, %u -> %u blocks), saved to %s\n",
+                     target.name, failureNames[outcome.kind], static_cast<unsigned long long>(caseSeed),
+                     testCase.totalBlocks(), minimal.totalBlocks(), file ? path : "(not saved)");
+            reports += header;
+            char* buffer = nullptr;
+            size_t length = 0;
+            FILE* memory = open_memstream(&buffer, &length);
+            if (memory) {
+                writeCase(memory, minimal, minimalOutcome);
+                fclose(memory);
+                reports += buffer;
+                free(buffer);
+            }
+        }
+
+        printf("%-16s %10.0f %8u %10u %8u %8u\n", target.name, judge.baselineNs[t][0], cases,
+               failures[kNonFinite], failures[kRunaway], failures[kSlow]);
+    }
+
+    if (!reports.empty())
+        printf("\nMinimised cases (replay with --replay <file>):\n%s", reports.c_str());
+    return totalFailures > 0 ? 1 : 0;
+}
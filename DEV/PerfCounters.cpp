@@ -0,0 +1,172 @@
+/**
+ * @file PerfCounters.cpp
+ * @brief Implementation of the PMU counter group
+ */
+
+#include "PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+uint64_t monotonicNanoseconds() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+#ifdef __linux__
+/**
+ * @brief perf_event_open has no libc wrapper
+ */
+int openEvent(uint32_t type, uint64_t config, int groupFd) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (groupFd < 0) ? 1 : 0;     // The leader gates the whole group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+void eventConfig(PerfCounters::Counter counter, uint32_t& type, uint64_t& config) {
+    switch (counter) {
+    case PerfCounters::kCycles:
+        type = PERF_TYPE_HARDWARE;
+        config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PerfCounters::kInstructions:
+        type = PERF_TYPE_HARDWARE;
+        config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PerfCounters::kBranchMisses:
+        type = PERF_TYPE_HARDWARE;
+        config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    default:
+        type = PERF_TYPE_HW_CACHE;
+        config = PERF_COUNT_HW_CACHE_L1D
+               | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+               | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    }
+}
+#endif
+
+} // namespace
+
+PerfCounters::PerfCounters() : numOpen(0), status("not opened"), startNanoseconds(0) {
+    for (int c = 0; c < kNumCounters; ++c) {
+        fd[c] = -1;
+        slot[c] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int i = 0; i < numOpen; ++i)
+        close(fd[i]);
+#endif
+}
+
+const char* PerfCounters::getName(Counter counter) {
+    static const char* const names[kNumCounters] = {
+        "cycles", "instructions", "branch-misses", "L1d-misses"
+    };
+    return names[counter];
+}
+
+bool PerfCounters::open() {
+#ifdef __linux__
+    int firstError = 0;
+    for (int c = 0; c < kNumCounters; ++c) {
+        uint32_t type;
+        uint64_t config;
+        eventConfig(static_cast<Counter>(c), type, config);
+        const int eventFd = openEvent(type, config, numOpen > 0 ? fd[0] : -1);
+        if (eventFd < 0) {
+            if (firstError == 0)
+                firstError = errno;
+            continue;
+        }
+        slot[c] = numOpen;
+        fd[numOpen++] = eventFd;
+    }
+
+    if (numOpen == kNumCounters)
+        status = "ok";
+    else if (firstError == EACCES || firstError == EPERM)
+        status = "permission denied (lower /proc/sys/kernel/perf_event_paranoid)";
+    else if (firstError == ENOENT || firstError == EOPNOTSUPP || firstError == ENODEV)
+        status = "event not supported by this CPU or kernel (no PMU in a VM?)";
+    else if (firstError == ENOSYS)
+        status = "kernel built without perf events";
+    else
+        status = "perf_event_open failed";
+    return numOpen > 0;
+#else
+    status = "hardware counters need Linux perf_event_open";
+    return false;
+#endif
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    if (numOpen > 0) {
+        ioctl(fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+    startNanoseconds = monotonicNanoseconds();
+}
+
+void PerfCounters::stop(Reading& reading) {
+    const uint64_t endNanoseconds = monotonicNanoseconds();
+    reading.nanoseconds = static_cast<double>(endNanoseconds - startNanoseconds);
+    for (int c = 0; c < kNumCounters; ++c) {
+        reading.count[c] = 0.0;
+        reading.valid[c] = false;
+    }
+
+#ifdef __linux__
+    if (numOpen == 0)
+        return;
+    ioctl(fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    /**
+     * Group read layout: nr, time enabled, time running, one value per event
+     */
+    uint64_t buffer[3 + kNumCounters];
+    const ssize_t bytes = read(fd[0], buffer, sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != static_cast<uint64_t>(numOpen))
+        return;
+
+    /**
+     * A group that never got onto the PMU counts nothing; one that was
+     * multiplexed with other users is extrapolated to the enabled time
+     */
+    const uint64_t enabled = buffer[1];
+    const uint64_t running = buffer[2];
+    if (running == 0)
+        return;
+    const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+
+    for (int c = 0; c < kNumCounters; ++c) {
+        if (slot[c] < 0)
+            continue;
+        reading.count[c] = static_cast<double>(buffer[3 + slot[c]]) * scale;
+        reading.valid[c] = true;
+    }
+#endif
+}
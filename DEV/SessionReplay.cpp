@@ -0,0 +1,485 @@
+/**
+ * @file SessionReplay.cpp
+ * @brief Bit-exact host replay of a recorded session, with per-block timing
+ *
+ * Decodes a tr123e-session-<n>.t3s written by SessionRecorder and runs every
+ * block through render.cpp with the recorded MIDI, pots, sample rate and
+ * period. Reconfigurations are committed at the block they committed on
+ * stage (the shim holds the reconfiguration task until then), so the
+ * engine follows exactly the path it took live.
+ *
+ * The output is hashed the way the recorder hashed it; at each checkpoint
+ * the two must agree. The replay reports either "bit-exact" or the first
+ * checkpoint that differs - the starting point for finding host/board
+ * floating-point differences or nondeterminism in the engine.
+ *
+ * Timing: every render() call is timed (and counted with PerfCounters
+ * where the PMU is available). The summary gives the realtime factor and
+ * the block-time distribution, and lists the slowest blocks with their
+ * position in the session, so an optimisation can be judged on a real gig
+ * rather than a synthetic loop.
+ *
+ * @note Host and board produce bit-identical output only when both use the
+ *       same floating-point code paths; NEON, fused multiply-add and libm
+ *       differ between ARMv7 and x86-64. Replay on the board (or an ARM
+ *       host) for exactness; on x86 the timing and the control flow are
+ *       still representative.
+ *
+ * @build
+ * @code
+ * # From the repository root:
+ * g++ -O3 -std=c++14 -IDEV/HostShim -I. -IDEV DEV/SessionReplay.cpp DEV/PerfCounters.cpp \
+ *     $(ls *.cpp) -o session-replay
+ * ./session-replay tr123e-session-0.t3s [--wav out.wav] [--slowest N]
+ * @endcode
+ *
+ * Built with -DTR123E_RT_GUARD -rdynamic ... -ldl (see RealtimeGuard.h),
+ * the replay also fails, with exit status 4, when render() allocated or
+ * made a blocking call anywhere in the session; cleanup() prints the call
+ * sites.
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#include <Bela.h>
+#include <libraries/Midi/Midi.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "OverrunCapture.h"
+#include "PerfCounters.h"
+#include "RealtimeGuard.h"
+#include "SessionRecorder.h"
+
+bool setup(BelaContext* context, void* userData);
+void render(BelaContext* context, void* userData);
+void cleanup(BelaContext* context, void* userData);
+
+extern Midi midi;
+extern OverrunCapture overrunCapture;
+extern SessionRecorder sessionRecorder;
+
+namespace {
+
+/**
+ * @struct SessionBlock
+ * @brief One decoded block record
+ */
+struct SessionBlock {
+    uint8_t tag;
+    uint64_t frame;
+    float sampleRate;
+    unsigned int audioFrames;
+    unsigned int analogFrames;
+    unsigned int analogChannels;
+    std::vector<uint8_t> midi;          ///< Status and data bytes, offsets dropped
+    unsigned int midiMessages;
+    unsigned int lateMessages;          ///< Messages with a non-zero frame offset
+    float analog[SessionRecorder::kMaxChannels];
+    uint32_t checkpoint;
+};
+
+/**
+ * @class SessionReader
+ * @brief Sequential decoder for the SessionRecorder block stream
+ */
+class SessionReader {
+public:
+    bool open(const char* path) {
+        FILE* file = fopen(path, "rb");
+        if (!file)
+            return false;
+        SessionFileHeader header;
+        bool ok = fread(&header, sizeof(header), 1, file) == 1
+               && memcmp(header.magic, "T3SE", 4) == 0
+               && header.version == SessionRecorder::kVersion;
+        if (ok) {
+            uint8_t buffer[65536];
+            size_t n;
+            while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+                data.insert(data.end(), buffer, buffer + n);
+        }
+        fclose(file);
+        position = 0;
+        configured = false;
+        for (unsigned int c = 0; c < SessionRecorder::kMaxChannels; ++c) {
+            value[c] = 0.0f;
+            quantised[c] = 0;
+        }
+        return ok;
+    }
+
+    /**
+     * @return false at the end of the stream or on a malformed record
+     */
+    bool next(SessionBlock& block) {
+        if (position >= data.size())
+            return false;
+        block.tag = data[position++];
+        block.midi.clear();
+        block.midiMessages = 0;
+        block.lateMessages = 0;
+        block.checkpoint = 0;
+
+        if (block.tag & SessionRecorder::kTagConfig) {
+            uint64_t v;
+            if (!varint(v)) return false;
+            current.frame = v;
+            if (!rawFloat(current.sampleRate)) return false;
+            if (!varint(v)) return false;
+            current.audioFrames = static_cast<unsigned int>(v);
+            if (!varint(v)) return false;
+            current.analogFrames = static_cast<unsigned int>(v);
+            if (!varint(v)) return false;
+            current.analogChannels = static_cast<unsigned int>(v);
+            configured = true;
+        }
+        if (!configured)
+            return false;
+        block.frame = current.frame;
+        block.sampleRate = current.sampleRate;
+        block.audioFrames = current.audioFrames;
+        block.analogFrames = current.analogFrames;
+        block.analogChannels = current.analogChannels;
+        current.frame += current.audioFrames;
+
+        if (block.tag & SessionRecorder::kTagLoss) {
+            for (unsigned int c = 0; c < SessionRecorder::kMaxChannels; ++c) {
+                value[c] = 0.0f;
+                quantised[c] = 0;
+            }
+        }
+
+        if (block.tag & SessionRecorder::kTagMidi) {
+            uint64_t count;
+            if (!varint(count)) return false;
+            for (uint64_t m = 0; m < count; ++m) {
+                uint64_t offset;
+                if (!varint(offset) || position + 2 > data.size()) return false;
+                const uint8_t status = data[position++];
+                const unsigned int dataBytes = data[position++];
+                if (dataBytes > 2 || position + dataBytes > data.size()) return false;
+                block.midi.push_back(status);
+                block.midi.insert(block.midi.end(), data.begin() + position, data.begin() + position + dataBytes);
+                position += dataBytes;
+                ++block.midiMessages;
+                if (offset != 0)
+                    ++block.lateMessages;
+            }
+        }
+
+        if (block.tag & SessionRecorder::kTagAnalog) {
+            if (position >= data.size()) return false;
+            const uint8_t mask = data[position++];
+            for (unsigned int c = 0; c < SessionRecorder::kMaxChannels; ++c) {
+                if (!(mask & (1u << c)))
+                    continue;
+                uint64_t code;
+                if (!varint(code)) return false;
+                if (code & 1) {
+                    if (!rawFloat(value[c])) return false;
+                }
+                else {
+                    const uint64_t z = code >> 1;
+                    const int32_t delta = static_cast<int32_t>((z >> 1) ^ (~(z & 1) + 1));
+                    quantised[c] += delta;
+                    value[c] = static_cast<float>(quantised[c]) * (1.0f / 65536.0f);
+                }
+            }
+        }
+        memcpy(block.analog, value, sizeof(value));
+
+        if (block.tag & SessionRecorder::kTagCheckpoint) {
+            if (position + 4 > data.size()) return false;
+            block.checkpoint = static_cast<uint32_t>(data[position])
+                             | static_cast<uint32_t>(data[position + 1]) << 8
+                             | static_cast<uint32_t>(data[position + 2]) << 16
+                             | static_cast<uint32_t>(data[position + 3]) << 24;
+            position += 4;
+        }
+        return true;
+    }
+
+    size_t size() const { return data.size(); }
+
+private:
+    bool varint(uint64_t& v) {
+        const unsigned int n = SessionRecorder::getVarint(data.data() + position,
+                                                          static_cast<unsigned int>(data.size() - position), v);
+        position += n;
+        return n > 0;
+    }
+
+    bool rawFloat(float& f) {
+        if (position + 4 > data.size())
+            return false;
+        const uint32_t bits = static_cast<uint32_t>(data[position])
+                            | static_cast<uint32_t>(data[position + 1]) << 8
+                            | static_cast<uint32_t>(data[position + 2]) << 16
+                            | static_cast<uint32_t>(data[position + 3]) << 24;
+        memcpy(&f, &bits, sizeof(f));
+        position += 4;
+        return true;
+    }
+
+    std::vector<uint8_t> data;
+    size_t position;
+    bool configured;
+    SessionBlock current;
+    float value[SessionRecorder::kMaxChannels];
+    int32_t quantised[SessionRecorder::kMaxChannels];
+};
+
+/**
+ * @brief Stereo 32-bit float WAV writer for listening to the replay
+ */
+class WavWriter {
+public:
+    WavWriter() : file(nullptr), samples(0), sampleRate(0) {}
+
+    bool open(const char* path, unsigned int rate) {
+        file = fopen(path, "wb");
+        sampleRate = rate;
+        return file && writeHeader();
+    }
+
+    /** @brief Interleaved left/right frames */
+    void write(const float* data, unsigned int frames) {
+        if (file)
+            samples += static_cast<uint32_t>(fwrite(data, sizeof(float), 2 * frames, file));
+    }
+
+    void close() {
+        if (!file)
+            return;
+        fseek(file, 0, SEEK_SET);
+        writeHeader();
+        fclose(file);
+        file = nullptr;
+    }
+
+private:
+    bool writeHeader() {
+        const uint32_t dataBytes = samples * 4;
+        const uint32_t riffBytes = 36 + dataBytes;
+        const uint16_t format = 3, channels = 2, blockAlign = 8, bits = 32;
+        const uint32_t fmtBytes = 16, byteRate = sampleRate * 8;
+        return fwrite("RIFF", 1, 4, file) == 4 && fwrite(&riffBytes, 4, 1, file) == 1
+            && fwrite("WAVEfmt ", 1, 8, file) == 8 && fwrite(&fmtBytes, 4, 1, file) == 1
+            && fwrite(&format, 2, 1, file) == 1 && fwrite(&channels, 2, 1, file) == 1
+            && fwrite(&sampleRate, 4, 1, file) == 1 && fwrite(&byteRate, 4, 1, file) == 1
+            && fwrite(&blockAlign, 2, 1, file) == 1 && fwrite(&bits, 2, 1, file) == 1
+            && fwrite("data", 1, 4, file) == 4 && fwrite(&dataBytes, 4, 1, file) == 1;
+    }
+
+    FILE* file;
+    uint32_t samples;       ///< Values written, both channels
+    uint32_t sampleRate;
+};
+
+/**
+ * @struct BlockTime
+ * @brief Measured cost of one replayed block
+ */
+struct BlockTime {
+    double nanoseconds;
+    uint64_t frame;
+    unsigned int midiMessages;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <tr123e-session-N.t3s> [--wav out.wav] [--slowest N]\n", argv[0]);
+        return 2;
+    }
+    const char* wavPath = nullptr;
+    int slowest = 10;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--wav") == 0 && i + 1 < argc)
+            wavPath = argv[++i];
+        else if (strcmp(argv[i], "--slowest") == 0 && i + 1 < argc)
+            slowest = atoi(argv[++i]);
+    }
+
+    SessionReader reader;
+    if (!reader.open(argv[1])) {
+        fprintf(stderr, "%s: not a session file\n", argv[1]);
+        return 1;
+    }
+    SessionReader probe = reader;
+    SessionBlock block;
+    if (!probe.next(block)) {
+        fprintf(stderr, "%s: empty session\n", argv[1]);
+        return 1;
+    }
+
+    /**
+     * Start the engine the way the session started; the replay itself must
+     * not record, capture or reconfigure on its own schedule
+     */
+    std::vector<float> analog(CaptureBlock::kMaxAnalogFrames * SessionRecorder::kMaxChannels, 0.0f);
+    std::vector<float> audioOut(2 * 1024, 0.0f);
+    std::vector<float> left(1024, 0.0f);
+    std::vector<float> right(1024, 0.0f);
+    BelaContext context;
+    memset(&context, 0, sizeof(context));
+    context.audioOut = audioOut.data();
+    context.analogIn = analog.data();
+    context.audioFrames = block.audioFrames;
+    context.audioOutChannels = 2;
+    context.audioSampleRate = block.sampleRate;
+    context.analogFrames = block.analogFrames;
+    context.analogInChannels = block.analogChannels;
+    context.analogSampleRate = block.sampleRate * block.analogFrames / block.audioFrames;
+    context.audioFramesElapsed = block.frame;
+
+    sessionRecorder.setEnabled(false);
+    overrunCapture.setArmed(false);
+    HostShim::holdAuxiliaryTask("tr123e-reconfigure");
+    if (!setup(&context, nullptr)) {
+        fprintf(stderr, "setup() rejected the session's configuration\n");
+        return 1;
+    }
+    HostShim::runAuxiliaryTasks();
+
+    WavWriter wav;
+    if (wavPath && !wav.open(wavPath, static_cast<unsigned int>(block.sampleRate)))
+        fprintf(stderr, "%s: cannot write, continuing without audio\n", wavPath);
+
+    PerfCounters counters;
+    counters.open();
+    double totalCycles = 0.0, totalInstructions = 0.0;
+    bool countersValid = true;
+
+    std::vector<BlockTime> times;
+    double seconds = 0.0;
+    uint32_t hash = SessionRecorder::kHashSeed;
+    unsigned int checkpoints = 0, lossBlocks = 0, lateMessages = 0, commits = 0;
+    long firstMismatch = -1;
+    long firstLoss = -1;
+
+    while (reader.next(block)) {
+        const long index = static_cast<long>(times.size());
+        context.audioFramesElapsed = block.frame;
+        context.audioFrames = block.audioFrames;
+        context.audioSampleRate = block.sampleRate;
+        context.analogFrames = block.analogFrames;
+        context.analogInChannels = block.analogChannels;
+        for (unsigned int f = 0; f < block.analogFrames; ++f)
+            memcpy(&analog[f * block.analogChannels], block.analog,
+                   std::min(block.analogChannels, SessionRecorder::kMaxChannels) * sizeof(float));
+        midi.getParser()->parse(block.midi.data(), static_cast<unsigned int>(block.midi.size()));
+        lateMessages += block.lateMessages;
+
+        if (block.tag & SessionRecorder::kTagLoss) {
+            ++lossBlocks;
+            if (firstLoss < 0)
+                firstLoss = index;
+        }
+        if (block.tag & SessionRecorder::kTagCommit) {
+            HostShim::runAuxiliaryTask("tr123e-reconfigure");
+            ++commits;
+        }
+
+        PerfCounters::Reading reading;
+        counters.start();
+        render(&context, nullptr);
+        counters.stop(reading);
+
+        BlockTime time = { reading.nanoseconds, block.frame, block.midiMessages };
+        times.push_back(time);
+        seconds += block.audioFrames / block.sampleRate;
+        if (reading.valid[PerfCounters::kCycles] && reading.valid[PerfCounters::kInstructions]) {
+            totalCycles += reading.count[PerfCounters::kCycles];
+            totalInstructions += reading.count[PerfCounters::kInstructions];
+        }
+        else {
+            countersValid = false;
+        }
+
+        /** render() hands the recorder the left channel, then the right */
+        for (unsigned int n = 0; n < block.audioFrames; ++n) {
+            left[n] = audioOut[2 * n];
+            right[n] = audioOut[2 * n + 1];
+        }
+        hash = SessionRecorder::hashWords(left.data(), block.audioFrames, hash);
+        hash = SessionRecorder::hashWords(right.data(), block.audioFrames, hash);
+        wav.write(audioOut.data(), block.audioFrames);
+
+        if (block.tag & SessionRecorder::kTagCheckpoint) {
+            ++checkpoints;
+            if (hash != block.checkpoint && firstMismatch < 0)
+                firstMismatch = index;
+            hash = SessionRecorder::kHashSeed;
+        }
+        HostShim::runAuxiliaryTasks();
+    }
+    cleanup(&context, nullptr);
+    wav.close();
+
+    if (times.empty())
+        return 1;
+
+    // ========================================================================
+    // Report
+    // ========================================================================
+
+    double totalNs = 0.0;
+    std::vector<double> sorted;
+    sorted.reserve(times.size());
+    for (const BlockTime& t : times) {
+        totalNs += t.nanoseconds;
+        sorted.push_back(t.nanoseconds);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) { return sorted[static_cast<size_t>(p * (sorted.size() - 1))]; };
+
+    printf("%s: %zu blocks, %.1f s of audio, %zu bytes\n", argv[1], times.size(), seconds, reader.size());
+    printf("reconfigurations %u, lost-input blocks %u, MIDI messages with frame offsets %u\n",
+           commits, lossBlocks, lateMessages);
+    if (checkpoints == 0)
+        printf("no checkpoints (session shorter than %u blocks): exactness not checked\n",
+               SessionRecorder::kCheckpointBlocks);
+    else if (firstMismatch >= 0)
+        printf("NOT bit-exact: first differing checkpoint at block %ld (frame %llu)\n",
+               firstMismatch, static_cast<unsigned long long>(times[firstMismatch].frame));
+    else if (firstLoss >= 0)
+        printf("bit-exact over %u checkpoints (input lost from block %ld on)\n", checkpoints, firstLoss);
+    else
+        printf("bit-exact over %u checkpoints\n", checkpoints);
+
+    printf("\nrender(): %.3f s total, realtime factor %.1fx\n", totalNs * 1e-9, seconds / (totalNs * 1e-9));
+    printf("block us: mean %.2f  p50 %.2f  p99 %.2f  p99.9 %.2f  max %.2f\n",
+           totalNs / times.size() * 1e-3, percentile(0.5) * 1e-3, percentile(0.99) * 1e-3,
+           percentile(0.999) * 1e-3, sorted.back() * 1e-3);
+    if (countersValid)
+        printf("cycles/block %.0f, IPC %.2f\n", totalCycles / times.size(), totalInstructions / totalCycles);
+    else
+        printf("counters: %s\n", counters.getStatus());
+
+    /**
+     * The slowest blocks, with their place in the session
+     */
+    std::vector<size_t> order(times.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    const size_t listed = std::min(order.size(), static_cast<size_t>(slowest > 0 ? slowest : 0));
+    std::partial_sort(order.begin(), order.begin() + listed, order.end(),
+                      [&](size_t a, size_t b) { return times[a].nanoseconds > times[b].nanoseconds; });
+    if (listed > 0)
+        printf("\n%8s %12s %10s %8s %5s\n", "block", "frame", "time s", "us", "midi");
+    for (size_t i = 0; i < listed; ++i) {
+        const BlockTime& t = times[order[i]];
+        printf("%8zu %12llu %10.3f %8.2f %5u\n", order[i], static_cast<unsigned long long>(t.frame),
+               t.frame / context.audioSampleRate, t.nanoseconds * 1e-3, t.midiMessages);
+    }
+    if (firstMismatch >= 0)
+        return 3;
+    return RealtimeGuard::getViolationCount() > 0 ? 4 : 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file StepSequencerStopTest.cpp
+ * @brief Checks that stopping the step sequencer releases the note it left sounding
+ *
+ * SynthInstance plays every event it pops from the sequencer, so a note is
+ * sounding from its popped note-on until a popped note-off. stop() drops
+ * the queued events, and with them the gate note-off of a note stopped
+ * mid-gate; it must queue a release of its own at the stop time. Cases:
+ * - **mid-gate**: stop between a step's note-on and its gate note-off
+ * - **after gate**: stop once the gate note-off has played; nothing to release
+ * - **scheduled ahead**: stop with several steps queued beyond the stop
+ *   time; the release must still land at the stop time
+ * - **restart**: stop, then start again; the first step lands at the start
+ *   time and nothing from before the stop is replayed
+ *
+ * Each case prints PASS or FAIL with the events it saw; the exit status is
+ * 1 when any failed.
+ *
+ * @build
+ * @code
+ * # From the repository root:
+ * g++ -O2 -std=c++14 -I. DEV/StepSequencerStopTest.cpp StepSequencer.cpp -o sequencer-stop-test
+ * ./sequencer-stop-test
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#include <cstdio>
+#include "StepSequencer.h"
+
+namespace {
+
+const float kSampleRate = 44100.0f;
+
+/** @brief Note of every step in the test pattern */
+const uint8_t kNote = 48;
+
+/**
+ * @struct EventLog
+ * @brief Events popped by one play() call
+ */
+struct EventLog {
+    static const unsigned int kMaxEvents = 64;
+    SequencerEvent events[kMaxEvents];
+    unsigned int count = 0;
+
+    void print() const {
+        for (unsigned int i = 0; i < count; ++i)
+            printf("    %llu note %u %s\n", static_cast<unsigned long long>(events[i].time), events[i].note,
+                   events[i].velocity > 0 ? "on" : "off");
+    }
+};
+
+/**
+ * @brief Pop every event due by `until`, as the render loop would play them
+ */
+EventLog play(StepSequencer& sequencer, uint64_t until) {
+    EventLog log;
+    SequencerEvent event;
+    while (sequencer.peekTime() <= until && log.count < EventLog::kMaxEvents && sequencer.popEvent(event))
+        log.events[log.count++] = event;
+    return log;
+}
+
+/** @brief A running 120 BPM pattern of kNote, gate 0.5, started at 0 */
+void startPattern(StepSequencer& sequencer) {
+    StepSequencer::Step step;
+    step.note = kNote;
+    for (int i = 0; i < StepSequencer::kMaxSteps; ++i)
+        sequencer.setStep(i, step);
+    sequencer.setTempo(120.0f);
+    sequencer.setMode(StepSequencer::kPattern, 0);
+}
+
+bool report(const char* name, bool passed, const EventLog& log) {
+    printf("%s %s\n", passed ? "PASS" : "FAIL", name);
+    if (!passed)
+        log.print();
+    return passed;
+}
+
+/** @brief Exactly one note-off of kNote at `time` */
+bool isRelease(const EventLog& log, uint64_t time) {
+    return log.count == 1 && log.events[0].velocity == 0 && log.events[0].note == kNote && log.events[0].time == time;
+}
+
+/** Steps are 5512.5 samples at 120 BPM; the first gate closes near 2756 */
+
+bool stopMidGate() {
+    StepSequencer sequencer(kSampleRate);
+    startPattern(sequencer);
+    sequencer.schedule(5000);
+    play(sequencer, 1000);
+    sequencer.stop(1000);
+    const EventLog log = play(sequencer, StepSequencer::kNoEvent - 1);
+    return report("mid-gate", isRelease(log, 1000), log);
+}
+
+bool stopAfterGate() {
+    StepSequencer sequencer(kSampleRate);
+    startPattern(sequencer);
+    sequencer.schedule(5000);
+    play(sequencer, 3000);
+    sequencer.stop(3000);
+    const EventLog log = play(sequencer, StepSequencer::kNoEvent - 1);
+    return report("after gate", log.count == 0, log);
+}
+
+bool stopScheduledAhead() {
+    StepSequencer sequencer(kSampleRate);
+    startPattern(sequencer);
+    sequencer.schedule(40000);
+    play(sequencer, 6000);
+    sequencer.stop(6000);
+    const EventLog log = play(sequencer, StepSequencer::kNoEvent - 1);
+    return report("scheduled ahead", isRelease(log, 6000), log);
+}
+
+bool restart() {
+    StepSequencer sequencer(kSampleRate);
+    startPattern(sequencer);
+    sequencer.schedule(40000);
+    play(sequencer, 6000);
+    sequencer.setMode(StepSequencer::kOff, 6000);
+    EventLog log = play(sequencer, 6000);
+    bool passed = isRelease(log, 6000);
+    sequencer.setMode(StepSequencer::kPattern, 7000);
+    sequencer.schedule(7001);
+    log = play(sequencer, 7000);
+    passed = passed && log.count == 1 && log.events[0].velocity > 0 && log.events[0].time == 7000;
+    return report("restart", passed, log);
+}
+
+} // namespace
+
+int main() {
+    unsigned int failures = 0;
+    failures += stopMidGate() ? 0 : 1;
+    failures += stopAfterGate() ? 0 : 1;
+    failures += stopScheduledAhead() ? 0 : 1;
+    failures += restart() ? 0 : 1;
+    printf("%u of 4 stop cases failed\n", failures);
+    return failures ? 1 : 0;
+}
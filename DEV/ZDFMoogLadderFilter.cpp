@@ -7,6 +7,7 @@
  * on embedded systems while maintaining exact analog modeling accuracy.
  */
 
+#include "ZDFMoogLadderFilter.h"
 #include <cmath>
 
 /**
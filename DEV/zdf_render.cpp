@@ -40,6 +40,7 @@ IMPLEMENTATION NOTES:
 #include <Bela.h>              // Bela real-time audio framework
 #include <cmath>               // Mathematical functions for signal processing
 #include "ZDFMoogLadderFilter.h"  // Zero Delay Feedback Moog filter implementation
+#include "../AudioArena.h"     // Aligned, pre-faulted audio-path memory
 
 /*
 ================================================================================
@@ -55,10 +56,14 @@ general programming, the real-time audio domain requires this approach due to:
 ================================================================================
 */
 
+// AUDIO-PATH MEMORY
+// All state touched by render() lives in one 64-byte-aligned arena that is
+// reserved and pre-faulted in setup() and locked before audio starts
+AudioArena audioArena;
+
 // FILTER OBJECT MANAGEMENT
-// Declared as pointer to enable runtime initialization with sample rate
-// This follows the RAII (Resource Acquisition Is Initialization) principle
-// adapted for real-time audio constraints
+// Declared as pointer to enable runtime initialization with sample rate;
+// the object itself is constructed inside the arena
 ZDFMoogLadderFilter* zdfMLFilter = nullptr;
 
 // OSCILLATOR STATE VARIABLES
@@ -109,11 +114,20 @@ bool setup(BelaContext *context, void *userData)
     
     /*
     FILTER OBJECT INITIALIZATION
-    Dynamic allocation is performed here (setup phase) rather than in the
-    audio callback to maintain real-time constraints. The filter requires
-    sample rate information for proper coefficient calculation.
+    The filter is constructed in the audio arena during setup rather than on
+    the heap: its state is cache-line aligned and its pages are already
+    resident when render() first touches them. The filter requires sample
+    rate information for proper coefficient calculation.
     */
-    zdfMLFilter = new ZDFMoogLadderFilter(context->audioSampleRate);
+    AudioArenaConfig arenaConfig;
+    arenaConfig.periodFrames = context->audioFrames;
+    arenaConfig.voiceBuffers = 0;
+    arenaConfig.sharedBuffers = 0;
+    arenaConfig.periodBuffers = 0;
+    arenaConfig.voiceStateBytes = sizeof(ZDFMoogLadderFilter);
+    if (!audioArena.reserve(AudioArena::requiredBytes(arenaConfig)))
+        return false;
+    zdfMLFilter = audioArena.create<ZDFMoogLadderFilter>(context->audioSampleRate);
     
     /*
     FILTER STATE INITIALIZATION
@@ -134,6 +148,12 @@ bool setup(BelaContext *context, void *userData)
 	zdfMLFilter->setResonance(0.28f);  // Moderate resonance for musical character
 	zdfMLFilter->setCutoff(400.0f);    // Initial cutoff frequency in Hz
     
+    /*
+    ARENA FREEZE
+    No further audio-path allocation is allowed once render() can run.
+    */
+    audioArena.lock();
+    
     return true;  // Successful initialization
 }
 
@@ -265,11 +285,12 @@ void cleanup(BelaContext *context, void *userData)
 {
     /*
     FILTER OBJECT DEALLOCATION
-    Releases dynamically allocated filter object.
-    Uses delete operator to properly call destructor and free memory.
+    Releases the arena holding the filter object. The filter has no
+    resources of its own, so no destructor call is needed.
     Essential for preventing memory leaks in embedded systems.
     */
-    delete zdfMLFilter;
+    audioArena.release();
+    zdfMLFilter = nullptr;
 }
 
 /*
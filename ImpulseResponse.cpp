@@ -0,0 +1,212 @@
+/**
+ * @file ImpulseResponse.cpp
+ * @brief Implementation of the impulse response source
+ */
+
+#include "ImpulseResponse.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+uint32_t readLe(const uint8_t* p, unsigned int bytes) {
+    uint32_t value = 0;
+    for (unsigned int b = 0; b < bytes; ++b)
+        value |= static_cast<uint32_t>(p[b]) << (8 * b);
+    return value;
+}
+
+/**
+ * @brief Decode one sample of a PCM or float WAV frame to [-1, 1]
+ */
+float decodeSample(const uint8_t* p, unsigned int format, unsigned int bits) {
+    if (format == 3) {
+        float value;
+        const uint32_t word = readLe(p, 4);
+        memcpy(&value, &word, sizeof(value));
+        return value;
+    }
+    const uint32_t word = readLe(p, bits / 8);
+    const int32_t value = static_cast<int32_t>(word << (32 - bits));    /** Sign-extend via the top bit */
+    return static_cast<float>(value) * (1.0f / 2147483648.0f);
+}
+
+/**
+ * @struct Biquad
+ * @brief RBJ cookbook section, double precision (design time only)
+ */
+struct Biquad {
+    double b0, b1, b2, a1, a2;
+    double z1, z2;
+
+    double process(double x) {
+        const double y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        return y;
+    }
+
+    /** @brief |H(e^jω)| */
+    double magnitude(double w) const {
+        const double c1 = std::cos(w), s1 = std::sin(w), c2 = std::cos(2.0 * w), s2 = std::sin(2.0 * w);
+        const double nr = b0 + b1 * c1 + b2 * c2, ni = -(b1 * s1 + b2 * s2);
+        const double dr = 1.0 + a1 * c1 + a2 * c2, di = -(a1 * s1 + a2 * s2);
+        return std::sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+    }
+};
+
+enum BiquadShape { kLowCut, kHighCut, kPeak };
+
+Biquad design(BiquadShape shape, double hz, double q, double gainDb, double sampleRate) {
+    const double w = 2.0 * M_PI * hz / sampleRate;
+    const double alpha = std::sin(w) / (2.0 * q);
+    const double c = std::cos(w);
+    double b0, b1, b2, a0, a1, a2;
+    if (shape == kPeak) {
+        const double a = std::pow(10.0, gainDb / 40.0);
+        b0 = 1.0 + alpha * a;  b1 = -2.0 * c;  b2 = 1.0 - alpha * a;
+        a0 = 1.0 + alpha / a;  a1 = -2.0 * c;  a2 = 1.0 - alpha / a;
+    } else if (shape == kLowCut) {
+        b0 = (1.0 + c) * 0.5;  b1 = -(1.0 + c);  b2 = b0;
+        a0 = 1.0 + alpha;      a1 = -2.0 * c;    a2 = 1.0 - alpha;
+    } else {
+        b0 = (1.0 - c) * 0.5;  b1 = 1.0 - c;     b2 = b0;
+        a0 = 1.0 + alpha;      a1 = -2.0 * c;    a2 = 1.0 - alpha;
+    }
+    const Biquad section = { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0, 0.0, 0.0 };
+    return section;
+}
+
+} // namespace
+
+ImpulseResponse::ImpulseResponse() : source(nullptr), sourceFrames(0), sourceRate(0.0f) {}
+
+bool ImpulseResponse::allocate(AudioArena& arena) {
+    source = arena.allocateFloats(kMaxSourceFrames);
+    return source != nullptr;
+}
+
+bool ImpulseResponse::loadWav(const char* path) {
+    if (!source)
+        return false;
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+
+    uint8_t header[12];
+    bool ok = fread(header, 1, sizeof(header), file) == sizeof(header)
+           && memcmp(header, "RIFF", 4) == 0 && memcmp(header + 8, "WAVE", 4) == 0;
+    unsigned int format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    unsigned int frames = 0;
+
+    /** Walk the chunks: fmt before data, anything else skipped */
+    while (ok) {
+        uint8_t chunk[8];
+        if (fread(chunk, 1, sizeof(chunk), file) != sizeof(chunk)) {
+            ok = false;
+            break;
+        }
+        const uint32_t size = readLe(chunk + 4, 4);
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[40];
+            const uint32_t keep = size < sizeof(fmt) ? size : sizeof(fmt);
+            ok = size >= 16 && fread(fmt, 1, keep, file) == keep && fseek(file, (size - keep) + (size & 1), SEEK_CUR) == 0;
+            format = readLe(fmt, 2);
+            channels = readLe(fmt + 2, 2);
+            rate = readLe(fmt + 4, 4);
+            bits = readLe(fmt + 14, 2);
+            /** WAVE_FORMAT_EXTENSIBLE: the real format is the sub-format's first word */
+            if (format == 0xFFFE && keep >= 26)
+                format = readLe(fmt + 24, 2);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            const bool supported = channels > 0 && rate > 0
+                                && ((format == 1 && (bits == 16 || bits == 24 || bits == 32)) || (format == 3 && bits == 32));
+            if (!supported) {
+                ok = false;
+                break;
+            }
+            const unsigned int frameBytes = channels * bits / 8;
+            uint8_t frame[64];
+            if (frameBytes > sizeof(frame)) {
+                ok = false;
+                break;
+            }
+            const unsigned int available = size / frameBytes;
+            while (frames < available && frames < kMaxSourceFrames && fread(frame, 1, frameBytes, file) == frameBytes)
+                source[frames++] = decodeSample(frame, format, bits);
+            break;
+        } else {
+            ok = fseek(file, size + (size & 1), SEEK_CUR) == 0;
+        }
+    }
+    fclose(file);
+
+    if (!ok || frames == 0)
+        return false;
+    sourceFrames = frames;
+    sourceRate = static_cast<float>(rate);
+    return true;
+}
+
+unsigned int ImpulseResponse::render(float* out, unsigned int maxFrames, float sampleRate) const {
+    return isLoaded() ? renderFile(out, maxFrames, sampleRate) : renderCabinet(out, maxFrames, sampleRate);
+}
+
+unsigned int ImpulseResponse::renderFile(float* out, unsigned int maxFrames, float sampleRate) const {
+    const double step = static_cast<double>(sourceRate) / sampleRate;
+    unsigned int frames = static_cast<unsigned int>((sourceFrames - 1) / step) + 1;
+    if (frames > maxFrames)
+        frames = maxFrames;
+    for (unsigned int n = 0; n < frames; ++n) {
+        const double position = n * step;
+        const unsigned int index = static_cast<unsigned int>(position);
+        const float fraction = static_cast<float>(position - index);
+        const float next = index + 1 < sourceFrames ? source[index + 1] : 0.0f;
+        out[n] = source[index] + (next - source[index]) * fraction;
+    }
+    return frames;
+}
+
+unsigned int ImpulseResponse::renderCabinet(float* out, unsigned int maxFrames, float sampleRate) {
+    const double rate = sampleRate;
+    Biquad sections[] = {
+        design(kLowCut, 70.0, 0.8, 0.0, rate),
+        design(kPeak, 120.0, 1.2, 3.0, rate),
+        design(kPeak, 700.0, 0.9, -4.0, rate),
+        design(kPeak, 2400.0, 1.6, 4.0, rate),
+        design(kHighCut, 4200.0, 0.71, 0.0, rate),
+        design(kHighCut, 5200.0, 0.6, 0.0, rate)
+    };
+    const unsigned int count = sizeof(sections) / sizeof(sections[0]);
+
+    /** Normalise to 0 dB at the loudest frequency (log grid, 20 Hz to 20 kHz) */
+    double peak = 0.0;
+    for (unsigned int i = 0; i < 256; ++i) {
+        const double hz = 20.0 * std::pow(1000.0, i / 255.0);
+        if (hz >= 0.5 * rate)
+            break;
+        double magnitude = 1.0;
+        for (unsigned int s = 0; s < count; ++s)
+            magnitude *= sections[s].magnitude(2.0 * M_PI * hz / rate);
+        if (magnitude > peak)
+            peak = magnitude;
+    }
+    const double scale = peak > 0.0 ? 1.0 / peak : 1.0;
+
+    unsigned int frames = static_cast<unsigned int>(kCabinetMs * 0.001 * rate);
+    if (frames > maxFrames)
+        frames = maxFrames;
+    const unsigned int fadeStart = frames - frames / 4;
+    for (unsigned int n = 0; n < frames; ++n) {
+        double value = n == 0 ? scale : 0.0;
+        for (unsigned int s = 0; s < count; ++s)
+            value = sections[s].process(value);
+        if (n >= fadeStart)
+            value *= 0.5 + 0.5 * std::cos(M_PI * (n - fadeStart) / (frames - fadeStart));
+        out[n] = static_cast<float>(value);
+    }
+    return frames;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file ImpulseResponse.h
+ * @brief Cabinet impulse response source: a WAV file or a built-in cabinet
+ *
+ * PartitionedConvolver needs its impulse response at the engine rate, and
+ * again at every rate change. ImpulseResponse keeps the source and renders
+ * it on demand:
+ * - loadWav() reads a mono (or first-channel) RIFF WAVE file at setup:
+ *   16/24/32-bit integer or 32-bit float PCM, truncated to kMaxSourceFrames.
+ *   render() resamples it linearly to the requested rate. Linear
+ *   interpolation is enough for the gentle spectrum of a speaker cabinet;
+ *   a file with energy near its own Nyquist would alias when downsampled.
+ * - Without a file, render() synthesises a closed-back 1x12" cabinet at the
+ *   requested rate (no resampling involved): a cascade of RBJ biquads (low
+ *   cut, low-mid bump, mid scoop, presence peak, two-pole roll-off twice)
+ *   driven by an impulse, normalised to 0 dB at its loudest frequency and
+ *   faded out over its last quarter.
+ * A file is used at its own level; the limiter at the end of the chain
+ * guards against an IR with a lot of gain.
+ *
+ * @performance_characteristics
+ * - loadWav(): file I/O, setup() only
+ * - render(): O(frames), double-precision maths with libm trigonometry,
+ *   only on the reconfiguration task (PartitionedConvolver::
+ *   prepareConfiguration()); setup() renders nothing
+ * - Memory: kMaxSourceFrames floats from the arena
+ *
+ * @usage_example
+ * @code
+ * impulse.allocate(audioArena);
+ * if (!impulse.loadWav("cabinet.wav"))
+ *     ;   // the built-in cabinet
+ * const unsigned int frames = impulse.render(taps, maxTaps, 48000.0f);
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "AudioArena.h"
+
+/**
+ * @class ImpulseResponse
+ * @brief Impulse response source, rendered to any engine rate
+ */
+class ImpulseResponse {
+public:
+    /** @brief Longest file kept, in source frames */
+    static const unsigned int kMaxSourceFrames = 8192;
+
+    /** @brief Length of the built-in cabinet */
+    static constexpr float kCabinetMs = 21.0f;
+
+    ImpulseResponse();
+
+    static size_t requiredBytes() { return kMaxSourceFrames * sizeof(float) + AudioArena::kAlignment; }
+
+    /**
+     * @brief Take the source buffer from the arena
+     *
+     * @realtime_safety Non-real-time safe (setup())
+     */
+    bool allocate(AudioArena& arena);
+
+    /**
+     * @brief Read a WAV file as the source
+     *
+     * @return false if the file is missing or not a supported format; the
+     *         built-in cabinet stays in use
+     * @realtime_safety Non-real-time (file I/O)
+     */
+    bool loadWav(const char* path);
+
+    /** @brief True once a file has been loaded */
+    bool isLoaded() const { return sourceFrames > 0; }
+
+    unsigned int getSourceFrames() const { return sourceFrames; }
+    float getSourceRate() const { return sourceRate; }
+
+    /**
+     * @brief Write the response at a sample rate
+     *
+     * @param out Destination
+     * @param maxFrames Capacity of out; longer responses are truncated
+     * @param sampleRate Rate to render at
+     * @return Frames written
+     * @realtime_safety Non-real-time safe (prepare phase on the auxiliary
+     *                  task; not from setup(), which does no transcendental
+     *                  maths)
+     */
+    unsigned int render(float* out, unsigned int maxFrames, float sampleRate) const;
+
+private:
+    unsigned int renderFile(float* out, unsigned int maxFrames, float sampleRate) const;
+    static unsigned int renderCabinet(float* out, unsigned int maxFrames, float sampleRate);
+
+    float* source;
+    unsigned int sourceFrames;
+    float sourceRate;
+};
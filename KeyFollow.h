@@ -119,6 +119,24 @@ public:
      * per octave played, which matches typical analog synthesizer behavior
      */
     float process(int midiNote);
+    
+    /**
+     * @brief Cutoff offset in octaves for a MIDI note
+     * 
+     * The pitch-domain form used by the cutoff modulation bus: the filter
+     * follows the keyboard by keyFollowAmount octaves per octave played
+     * above C2, so 1.0 tracks the pitch exactly and 0.33 opens about a
+     * third of an octave per octave. Notes below C2 give 0.
+     * 
+     * @param midiNote MIDI note number [0-127]
+     * @return Offset in octaves, added to log2 of the cutoff
+     * 
+     * @complexity O(1) - One subtraction and one multiplication
+     * @realtime_safety Real-time safe
+     */
+    float processOctaves(int midiNote) const {
+        return midiNote > 36 ? (midiNote - 36) * keyFollowAmount * (1.0f / 12.0f) : 0.0f;
+    }
 
 private:
     /**
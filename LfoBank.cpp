@@ -0,0 +1,261 @@
+/**
+ * @file LfoBank.cpp
+ * @brief Implementation of the SIMD LFO bank
+ */
+
+#include "LfoBank.h"
+#include "SimdLanes.h"
+#include <cmath>
+
+namespace {
+
+/** @brief MIDI timing clock resolution */
+const int kClocksPerBeat = 24;
+
+/** @brief Beat periods outside 20-300 BPM are treated as clock glitches */
+const float kMinBeatMs = 200.0f;
+const float kMaxBeatMs = 3000.0f;
+
+/**
+ * @brief sin(2π·p) for p in [0, 1)
+ *
+ * With x = 2p - 1 the angle is π(x + 1), so sin = -sin(πx). sin(πx) is the
+ * parabola 4x(1 - |x|) with the usual 0.225 curvature correction.
+ */
+inline vfloat4 sineShape(vfloat4 p) {
+    const vfloat4 x = vf4_sub(vf4_add(p, p), vf4_dup(1.0f));
+    vfloat4 y = vf4_mul(vf4_dup(4.0f), vf4_sub(x, vf4_mul(x, vf4_abs(x))));
+    y = vf4_mla(y, vf4_dup(0.225f), vf4_sub(vf4_mul(y, vf4_abs(y)), y));
+    return vf4_sub(vf4_dup(0.0f), y);
+}
+
+/**
+ * @brief Triangle starting at zero and rising, for p in [0, 1)
+ */
+inline vfloat4 triangleShape(vfloat4 p) {
+    vfloat4 q = vf4_add(p, vf4_dup(0.25f));
+    q = vf4_sub(q, vf4_trunc(q));
+    return vf4_sub(vf4_dup(1.0f), vf4_mul(vf4_dup(4.0f), vf4_abs(vf4_sub(q, vf4_dup(0.5f)))));
+}
+
+} // namespace
+
+LfoBank::LfoBank(float sampleRate, uint32_t seed)
+    : sampleRate(sampleRate), invSampleRate(1.0f / sampleRate), stagedSampleRate(sampleRate),
+      beatsPerSecond(2.0f), clockCount(0), beatStartMs(0.0f), beatStartValid(false), beatCount(0) {
+    if (seed == 0)
+        seed = 0x1F0B;
+
+    uint32_t s = seed;
+    for (int l = 0; l < kNumLfos; ++l) {
+        s += 0x9E3779B9u;
+        uint32_t x = s;
+        for (int round = 0; round < 4; ++round) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+        }
+        randomState[l] = (x != 0) ? x : 0x2545F491u;
+
+        phase[l] = 0.0f;
+        output[l] = 0.0f;
+        heldRandom[l] = 0.0f;
+        previousRandom[l] = 0.0f;
+        rateHz[l] = 1.0f;
+        cyclesPerBeat[l] = 0.0f;
+        startPhase[l] = 0.0f;
+        retrigger[l] = false;
+        routed[l] = false;
+        tapped[l] = false;
+        for (int d = 0; d < kNumDestinations; ++d)
+            routeDepth[d][l] = 0.0f;
+        setShape(l, kSine);
+    }
+    for (int d = 0; d < kNumDestinations; ++d)
+        destinationValue[d] = 0.0f;
+    updateIncrements();
+}
+
+void LfoBank::setShape(int lfo, Shape newShape) {
+    if (lfo < 0 || lfo >= kNumLfos || newShape < 0 || newShape >= kNumShapes)
+        return;
+    lfoShape[lfo] = newShape;
+    for (int s = 0; s < kNumShapes; ++s)
+        shapeMask[s][lfo] = (s == newShape) ? 0xFFFFFFFFu : 0u;
+}
+
+void LfoBank::setRate(int lfo, float newRateHz) {
+    if (lfo < 0 || lfo >= kNumLfos)
+        return;
+    if (newRateHz < 0.01f)
+        newRateHz = 0.01f;
+    if (newRateHz > 50.0f)
+        newRateHz = 50.0f;
+    rateHz[lfo] = newRateHz;
+    cyclesPerBeat[lfo] = 0.0f;
+    updateIncrements();
+}
+
+void LfoBank::setSync(int lfo, float newCyclesPerBeat) {
+    if (lfo < 0 || lfo >= kNumLfos)
+        return;
+    if (newCyclesPerBeat > 16.0f)
+        newCyclesPerBeat = 16.0f;
+    cyclesPerBeat[lfo] = (newCyclesPerBeat > 0.0f) ? newCyclesPerBeat : 0.0f;
+    updateIncrements();
+}
+
+void LfoBank::setRoute(int lfo, Destination dest, float depth) {
+    if (lfo < 0 || lfo >= kNumLfos || dest < 0 || dest >= kNumDestinations)
+        return;
+    for (int d = 0; d < kNumDestinations; ++d)
+        routeDepth[d][lfo] = (d == dest) ? depth : 0.0f;
+    routed[lfo] = (depth != 0.0f) || tapped[lfo];
+}
+
+void LfoBank::setTapped(int lfo, bool newTapped) {
+    if (lfo < 0 || lfo >= kNumLfos)
+        return;
+    tapped[lfo] = newTapped;
+    routed[lfo] = newTapped;
+    for (int d = 0; d < kNumDestinations; ++d) {
+        if (routeDepth[d][lfo] != 0.0f)
+            routed[lfo] = true;
+    }
+}
+
+void LfoBank::setRetrigger(int lfo, bool enabled, float newStartPhase) {
+    if (lfo < 0 || lfo >= kNumLfos)
+        return;
+    retrigger[lfo] = enabled;
+    startPhase[lfo] = newStartPhase - floorf(newStartPhase);
+}
+
+void LfoBank::noteOn() {
+    for (int l = 0; l < kNumLfos; ++l) {
+        if (retrigger[l])
+            phase[l] = startPhase[l];
+    }
+}
+
+void LfoBank::clockStart() {
+    clockCount = 0;
+    beatCount = 0;
+    beatStartValid = false;
+    for (int l = 0; l < kNumLfos; ++l) {
+        if (cyclesPerBeat[l] > 0.0f)
+            phase[l] = 0.0f;
+    }
+}
+
+void LfoBank::clockTick(float timeMs) {
+    if (!beatStartValid) {
+        beatStartMs = timeMs;
+        beatStartValid = true;
+        clockCount = 0;
+        return;
+    }
+    if (++clockCount < kClocksPerBeat)
+        return;
+
+    /**
+     * One beat: measure it as a whole, so per-message timestamp jitter
+     * (one audio block) is divided by 24, then snap synced LFOs to the grid
+     */
+    const float beatMs = timeMs - beatStartMs;
+    beatStartMs = timeMs;
+    clockCount = 0;
+    ++beatCount;
+
+    if (beatMs >= kMinBeatMs && beatMs <= kMaxBeatMs) {
+        beatsPerSecond = 1000.0f / beatMs;
+        updateIncrements();
+    }
+    for (int l = 0; l < kNumLfos; ++l) {
+        if (cyclesPerBeat[l] > 0.0f) {
+            const float cycles = static_cast<float>(beatCount) * cyclesPerBeat[l];
+            phase[l] = cycles - floorf(cycles);
+        }
+    }
+}
+
+void LfoBank::updateIncrements() {
+    for (int l = 0; l < kNumLfos; ++l) {
+        const float hz = (cyclesPerBeat[l] > 0.0f) ? cyclesPerBeat[l] * beatsPerSecond : rateHz[l];
+        increment[l] = hz * invSampleRate;
+    }
+}
+
+bool LfoBank::prepareSampleRate(float newSampleRate) {
+    if (newSampleRate <= 0.0f)
+        return false;
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+void LfoBank::commitSampleRate() {
+    sampleRate = stagedSampleRate;
+    invSampleRate = 1.0f / sampleRate;
+    updateIncrements();
+}
+
+void LfoBank::process(unsigned int frames) {
+    const vfloat4 span = vf4_dup(static_cast<float>(frames));
+    const vfloat4 one = vf4_dup(1.0f);
+    vfloat4 destination[kNumDestinations];
+    for (int d = 0; d < kNumDestinations; ++d)
+        destination[d] = vf4_dup(0.0f);
+
+    for (int g = 0; g < kNumLfos; g += 4) {
+        /**
+         * Advance and wrap. The rate limit keeps an increment per sub-block
+         * below one cycle, so a single subtraction of the integer part wraps.
+         */
+        vfloat4 p = vf4_mla(vf4_load(phase + g), vf4_load(increment + g), span);
+        const vuint4 wrapped = vf4_greater_equal(p, one);
+        p = vf4_sub(p, vf4_trunc(p));
+        vf4_store(phase + g, p);
+
+        /**
+         * Random shapes draw a new value whenever their cycle wraps
+         */
+        vuint4 state = vu4_xorshift32(vu4_load(randomState + g));
+        vu4_store(randomState + g, state);
+        const vfloat4 held = vf4_load(heldRandom + g);
+        const vfloat4 previous = vf4_select(wrapped, held, vf4_load(previousRandom + g));
+        const vfloat4 current = vf4_select(wrapped, vu4_to_bipolar(state), held);
+        vf4_store(previousRandom + g, previous);
+        vf4_store(heldRandom + g, current);
+
+        /**
+         * Phases always advance, so sync and retrigger stay correct, but a
+         * group of four with nothing routed skips the shape evaluation
+         */
+        if (!(routed[g] || routed[g + 1] || routed[g + 2] || routed[g + 3])) {
+            vf4_store(output + g, vf4_dup(0.0f));
+            continue;
+        }
+
+        /**
+         * Every shape for every lane, then a per-lane select
+         */
+        const vfloat4 saw = vf4_sub(vf4_add(p, p), one);
+        const vfloat4 square = vf4_select(vf4_less(p, vf4_dup(0.5f)), one, vf4_dup(-1.0f));
+        const vfloat4 smooth = vf4_mul(vf4_mul(p, p), vf4_sub(vf4_dup(3.0f), vf4_add(p, p)));
+        const vfloat4 smoothRandom = vf4_mla(previous, vf4_sub(current, previous), smooth);
+
+        vfloat4 out = sineShape(p);
+        out = vf4_select(vu4_load(shapeMask[kTriangle] + g), triangleShape(p), out);
+        out = vf4_select(vu4_load(shapeMask[kSaw] + g), saw, out);
+        out = vf4_select(vu4_load(shapeMask[kSquare] + g), square, out);
+        out = vf4_select(vu4_load(shapeMask[kSampleHold] + g), current, out);
+        out = vf4_select(vu4_load(shapeMask[kSmoothRandom] + g), smoothRandom, out);
+        vf4_store(output + g, out);
+
+        for (int d = 0; d < kNumDestinations; ++d)
+            destination[d] = vf4_mla(destination[d], out, vf4_load(routeDepth[d] + g));
+    }
+
+    for (int d = 0; d < kNumDestinations; ++d)
+        destinationValue[d] = vf4_hsum(destination[d]);
+}
@@ -0,0 +1,168 @@
+/**
+ * @file LookaheadLimiter.cpp
+ * @brief Implementation of the lookahead soft limiter
+ */
+
+#include "LookaheadLimiter.h"
+#include "TableBank.h"
+
+namespace {
+
+/** @brief Window N (lookahead + 1) in frames at a rate */
+unsigned int windowFrames(float sampleRate) {
+    const unsigned int lookahead = static_cast<unsigned int>(LookaheadLimiter::kLookaheadMs * 0.001f * sampleRate + 0.5f);
+    return (lookahead < 1 ? 1 : lookahead) + 1;
+}
+
+unsigned int queueFrames(unsigned int capacity) {
+    unsigned int frames = 1;
+    while (frames < capacity + 1)
+        frames <<= 1;
+    return frames;
+}
+
+} // namespace
+
+LookaheadLimiter::LookaheadLimiter()
+    : line(nullptr), queueGain(nullptr), queueTime(nullptr), average(nullptr), capacity(0), queueMask(0),
+      sampleRate(44100.0f), stagedSampleRate(44100.0f), window(windowFrames(44100.0f)), ceiling(0.966f),
+      knee(0.483f), releaseDecay(0.0f), time(0), linePosition(0), averagePosition(0), queueHead(0),
+      queueTail(0), reduction(0.0f), averageSum(0.0), minimumGain(1.0f) {
+    updateCoefficients();
+}
+
+size_t LookaheadLimiter::requiredBytes(float maxSampleRate) {
+    const unsigned int frames = windowFrames(maxSampleRate);
+    const unsigned int queue = queueFrames(frames);
+    return (2 * frames + frames) * sizeof(float) + queue * (sizeof(float) + sizeof(uint32_t))
+         + 4 * AudioArena::kAlignment;
+}
+
+bool LookaheadLimiter::allocate(AudioArena& arena, float maxSampleRate) {
+    capacity = windowFrames(maxSampleRate);
+    const unsigned int queue = queueFrames(capacity);
+    line = arena.allocateFloats(2 * capacity);
+    average = arena.allocateFloats(capacity);
+    queueGain = arena.allocateFloats(queue);
+    queueTime = static_cast<uint32_t*>(arena.allocateBytes(queue * sizeof(uint32_t)));
+    if (!line || !average || !queueGain || !queueTime)
+        return false;
+    queueMask = queue - 1;
+    reset();
+    return true;
+}
+
+void LookaheadLimiter::setCeiling(float newCeiling) {
+    ceiling = newCeiling < 0.1f ? 0.1f : (newCeiling > 1.0f ? 1.0f : newCeiling);
+    knee = 0.5f * ceiling;
+}
+
+void LookaheadLimiter::reset() {
+    if (!line)
+        return;
+    for (unsigned int i = 0; i < 2 * capacity; ++i)
+        line[i] = 0.0f;
+    for (unsigned int i = 0; i < capacity; ++i)
+        average[i] = 1.0f;
+    averageSum = static_cast<double>(window);
+    reduction = 0.0f;
+    linePosition = 0;
+    averagePosition = 0;
+    queueHead = queueTail = 0;
+    time = 0;
+}
+
+bool LookaheadLimiter::prepareSampleRate(float newSampleRate) {
+    /** The buffers were sized once in setup(); a faster rate would overrun them */
+    if (newSampleRate <= 0.0f || (line && windowFrames(newSampleRate) > capacity))
+        return false;
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+void LookaheadLimiter::commitSampleRate() {
+    sampleRate = stagedSampleRate;
+    window = windowFrames(sampleRate);
+    updateCoefficients();
+    reset();
+}
+
+void LookaheadLimiter::updateCoefficients() {
+    releaseDecay = tableExp(-1.0f / (kReleaseMs * 0.001f * sampleRate));
+}
+
+void LookaheadLimiter::process(float* left, float* right, unsigned int frames) {
+    if (!line)
+        return;
+
+    const unsigned int delay = window - 1;
+    const float span = ceiling - knee;
+    const float inverseWindow = 1.0f / static_cast<float>(window);
+    const vfloat2 upper = vf2_dup(ceiling);
+    const vfloat2 lower = vf2_dup(-ceiling);
+    float lowest = minimumGain;
+
+    for (unsigned int n = 0; n < frames; ++n) {
+        const vfloat2 input = vf2_set(left[n], right[n]);
+        const vfloat2 magnitude = vf2_abs(input);
+        const float peakL = vf2_lane0(magnitude);
+        const float peakR = vf2_lane1(magnitude);
+        const float peak = peakL > peakR ? peakL : peakR;
+
+        /**
+         * Gain that maps the peak onto the knee: with d = p − T and
+         * w = C − T, level = T + w·d/(w + d), folded into one division
+         */
+        float required = 1.0f;
+        if (peak > knee) {
+            const float excess = peak - knee;
+            required = (knee * (span + excess) + span * excess) / (peak * (span + excess));
+        }
+
+        /** Minimum over the last N frames: monotonic queue */
+        while (queueTail != queueHead && queueGain[(queueTail - 1) & queueMask] >= required)
+            --queueTail;
+        queueGain[queueTail & queueMask] = required;
+        queueTime[queueTail & queueMask] = time;
+        ++queueTail;
+        while (time - queueTime[queueHead & queueMask] >= window)
+            ++queueHead;
+        const float held = queueGain[queueHead & queueMask];
+
+        /**
+         * Release: fall at once (the average shapes the attack), recover
+         * slowly. The follower runs on the reduction 1 − gain, which decays
+         * geometrically to exactly zero; a follower on the gain itself
+         * stalls a few ulps short of unity and never turns transparent again.
+         */
+        const float heldReduction = 1.0f - held;
+        if (heldReduction >= reduction) {
+            reduction = heldReduction;
+        } else {
+            reduction = heldReduction + (reduction - heldReduction) * releaseDecay;
+            if (reduction - heldReduction < 1e-6f)
+                reduction = heldReduction;
+        }
+        const float released = 1.0f - reduction;
+
+        averageSum += released - average[averagePosition];
+        average[averagePosition] = released;
+        if (++averagePosition == window)
+            averagePosition = 0;
+        const float gain = averageSum >= window ? 1.0f : static_cast<float>(averageSum) * inverseWindow;
+        if (gain < lowest)
+            lowest = gain;
+
+        /** Delay the audio by N − 1 frames so the gain arrives ahead of the peak */
+        const vfloat2 delayed = vf2_load(line + 2 * linePosition);
+        vf2_store(line + 2 * linePosition, input);
+        if (++linePosition == delay)
+            linePosition = 0;
+
+        const vfloat2 output = vf2_min(vf2_max(vf2_mul(delayed, vf2_dup(gain)), lower), upper);
+        left[n] = vf2_lane0(output);
+        right[n] = vf2_lane1(output);
+        ++time;
+    }
+    minimumGain = lowest;
+}
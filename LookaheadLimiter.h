@@ -0,0 +1,133 @@
+/**
+ * @file LookaheadLimiter.h
+ * @brief Linked-stereo soft limiter with lookahead, last stage before the DAC
+ *
+ * The output gain pot reaches 2.0 and a resonant ladder peaks well above its
+ * input, so the signal handed to audioWrite() could exceed full scale and
+ * clip hard in the converter. The limiter keeps it under a ceiling and does
+ * so softly:
+ * - Levels up to half the ceiling pass unchanged. Above that the level is
+ *   mapped onto a knee, T + (C − T)·x/(1 + x) with x = (p − T)/(C − T), which
+ *   starts with unit slope and approaches the ceiling C asymptotically.
+ * - The gain that reaches the knee is applied ahead of the peak. The audio is
+ *   delayed by N − 1 frames; the gain is the minimum of the required gain
+ *   over the last N frames, smoothed by a moving average over N frames.
+ *   Every sample therefore sees a gain no higher than its own requirement,
+ *   and the gain falls over N frames instead of jumping.
+ * - Recovery after a peak follows a one-pole release, which only ever holds
+ *   the gain lower, so it cannot break the guarantee above.
+ * A final clamp at the ceiling catches float rounding only.
+ *
+ * The sides share one gain (from the louder side) so the stereo image does
+ * not shift under limiting. Peak detection and the gain multiply run in the
+ * two lanes of SimdLanes.h; the window minimum (a monotonic queue) and the
+ * moving average are scalar, one value per frame.
+ *
+ * @performance_characteristics
+ * - Per frame: about 10 two-lane operations, one division on frames above
+ *   the knee, amortised O(1) queue updates
+ * - Latency: kLookaheadMs (1.5 ms), reported by getLatencyFrames()
+ * - Memory: lookahead line and queues for 96 kHz, under 4 KB, from the arena
+ *
+ * @usage_example
+ * @code
+ * limiter.allocate(audioArena, kMaxSupportedSampleRate);  // setup()
+ * limiter.setCeiling(0.966f);                             // -0.3 dBFS
+ * limiter.process(left, right, frames);                   // render(), last stage
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "AudioArena.h"
+#include "SimdLanes.h"
+#include <cstdint>
+
+/**
+ * @class LookaheadLimiter
+ * @brief Window-minimum gain computer with moving-average smoothing
+ */
+class LookaheadLimiter {
+public:
+    /** @brief Lookahead window, also the time the gain takes to fall */
+    static constexpr float kLookaheadMs = 1.5f;
+
+    /** @brief Release time constant */
+    static constexpr float kReleaseMs = 80.0f;
+
+    LookaheadLimiter();
+
+    /** @brief Arena bytes for the line and queues at the highest rate */
+    static size_t requiredBytes(float maxSampleRate);
+
+    /**
+     * @brief Take the line and queues from the arena
+     *
+     * @return false if the arena cannot hold them
+     * @realtime_safety Non-real-time safe (setup())
+     */
+    bool allocate(AudioArena& arena, float maxSampleRate);
+
+    /** @brief Output ceiling, linear [0.1, 1] */
+    void setCeiling(float ceiling);
+
+    float getCeiling() const { return ceiling; }
+
+    /** @brief Frames of delay the lookahead adds */
+    unsigned int getLatencyFrames() const { return window - 1; }
+
+    /**
+     * @brief Lowest gain applied since the last call, then reset to 1
+     *
+     * @realtime_safety Real-time safe; for meters and traces
+     */
+    float takeMinimumGain() {
+        const float gain = minimumGain;
+        minimumGain = 1.0f;
+        return gain;
+    }
+
+    /** @brief Clear the line and restore unity gain */
+    void reset();
+
+    bool prepareSampleRate(float newSampleRate);
+    void commitSampleRate();
+
+    /**
+     * @brief Process a block in place
+     *
+     * @realtime_safety Real-time safe
+     */
+    void process(float* left, float* right, unsigned int frames);
+
+private:
+    void updateCoefficients();
+
+    float* line;                    ///< Interleaved left/right frames, window − 1 long
+    float* queueGain;               ///< Monotonic queue of required gains
+    uint32_t* queueTime;            ///< Frame counter of each queued gain
+    float* average;                 ///< Moving-average ring of smoothed gains
+    unsigned int capacity;          ///< Frames the buffers hold (window at 96 kHz)
+    unsigned int queueMask;         ///< Queue length − 1 (power of two)
+
+    float sampleRate;
+    float stagedSampleRate;
+    unsigned int window;            ///< N: lookahead + 1 frames at the current rate
+
+    float ceiling;
+    float knee;                     ///< Level where the curve departs from unity
+    float releaseDecay;             ///< Per-frame release factor, exp(−1/τ·fs)
+
+    uint32_t time;                  ///< Frames processed (queue timestamps)
+    unsigned int linePosition;
+    unsigned int averagePosition;
+    unsigned int queueHead;
+    unsigned int queueTail;
+    float reduction;                ///< Release follower, 1 − gain
+    double averageSum;              ///< Sum of the average ring (double: no drift)
+    float minimumGain;
+};
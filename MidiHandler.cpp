@@ -27,18 +27,19 @@
  * No dynamic allocation or complex initialization required.
  */
 MidiHandler::MidiHandler(float sampleRate, float delayMs)
-    : sampleRate(sampleRate), delayTimeMs(delayMs) {}
+    : sampleRate(sampleRate), stagedSampleRate(sampleRate), delayTimeMs(delayMs), droppedMessages(0) {}
 
 /**
  * @brief Buffer incoming MIDI message with timestamp
  * 
  * @param noteNumber MIDI note number
  * @param velocity MIDI velocity value  
+ * @param noteOn Note-on status (false for a note-off message)
  * @param currentTimeMs Current system timestamp
  * 
  * @performance_analysis
- * - Queue insertion: O(1) amortized complexity
- * - Memory allocation: Bounded by queue implementation
+ * - Queue insertion: O(1)
+ * - Memory allocation: None (fixed-capacity ring)
  * - Cache behavior: Sequential access pattern optimal for modern CPUs
  * 
  * @debug_instrumentation
@@ -46,12 +47,12 @@ MidiHandler::MidiHandler(float sampleRate, float delayMs)
  * When enabled, provides detailed message logging with timing information.
  * Use sparingly in production due to potential timing impact.
  */
-void MidiHandler::processMidiMessage(int noteNumber, int velocity, float currentTimeMs) {
+void MidiHandler::processMidiMessage(int noteNumber, int velocity, bool noteOn, float currentTimeMs) {
     /**
      * Construct message structure with input parameters
      * Uses direct initialization for optimal performance
      */
-    MidiNoteMessage msg = { noteNumber, velocity, currentTimeMs };
+    MidiNoteMessage msg = { noteNumber, velocity, noteOn, currentTimeMs };
     
     /**
      * Debug logging (disabled for production performance)
@@ -62,9 +63,10 @@ void MidiHandler::processMidiMessage(int noteNumber, int velocity, float current
     
     /**
      * Queue message for temporal processing
-     * Queue automatically handles memory management and growth
+     * A full queue drops the message rather than allocating
      */
-    incomingMessages.push(msg);
+    if (!incomingMessages.push(msg))
+        ++droppedMessages;
 }
 
 /**
@@ -93,7 +95,7 @@ void MidiHandler::update(float currentTimeMs) {
          * Examine oldest message without removing from queue
          * Reference avoids unnecessary copying for performance
          */
-        MidiNoteMessage& msg = incomingMessages.front();
+        const MidiNoteMessage& msg = incomingMessages.front();
         
         /**
          * Check if message has completed its delay period
@@ -104,7 +106,8 @@ void MidiHandler::update(float currentTimeMs) {
              * Transfer message to delayed queue for consumption
              * Message is ready for immediate audio processing
              */
-            delayedMessages.push(msg);
+            if (!delayedMessages.push(msg))
+                ++droppedMessages;
             
             /**
              * Remove processed message from incoming queue
@@ -128,7 +131,7 @@ void MidiHandler::update(float currentTimeMs) {
  * @return Availability status of delayed messages
  * 
  * @implementation_notes
- * Simple wrapper around std::queue::empty() for consistent API.
+ * Simple wrapper around MessageQueue::empty() for consistent API.
  * Provides boolean logic inversion for intuitive usage patterns.
  */
 bool MidiHandler::hasDelayedMessage() {
@@ -141,13 +144,13 @@ bool MidiHandler::hasDelayedMessage() {
  * @return Next available message or sentinel values if empty
  * 
  * @error_handling_strategy
- * Returns sentinel values {-1, -1, -1.0f} for empty queue condition
+ * Returns sentinel values {-1, -1, false, -1.0f} for empty queue condition
  * rather than throwing exceptions. This approach maintains real-time
  * safety by avoiding exception handling overhead in audio threads.
  * 
  * @memory_efficiency
  * Message data copied by value eliminates pointer management and
- * potential memory leaks. Queue automatically manages internal storage.
+ * potential memory leaks. Queue storage is a fixed ring in the object.
  */
 MidiNoteMessage MidiHandler::popDelayedMessage() {
     /**
@@ -155,7 +158,7 @@ MidiNoteMessage MidiHandler::popDelayedMessage() {
      * Sentinel values indicate invalid message to caller
      */
     if (delayedMessages.empty())
-        return {-1, -1, -1.0f};
+        return {-1, -1, false, -1.0f};
 
     /**
      * Extract message data before queue modification
@@ -276,4 +279,21 @@ float MidiHandler::samplesToMs(int samples) const {
  * - "The Audio Programming Book" by Boulanger & Lazzarini
  * - IEEE 754 Standard for Floating-Point Arithmetic
  * - Real-Time Systems Design and Analysis by Klein & Ralya
- */
\ No newline at end of file
+ */
+
+/**
+ * @brief Stage a new sample rate for time/sample conversions
+ */
+bool MidiHandler::prepareSampleRate(float newSampleRate) {
+    if (newSampleRate <= 0.0f)
+        return false;
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+/**
+ * @brief Adopt the staged sample rate
+ */
+void MidiHandler::commitSampleRate() {
+    sampleRate = stagedSampleRate;
+}
@@ -27,8 +27,8 @@
  * 
  * @performance_characteristics
  * - Timing resolution: Microsecond-level accuracy
- * - Memory efficiency: Dynamic queue sizing with bounded growth
- * - Real-time safety: Lock-free queue operations
+ * - Memory efficiency: Fixed-capacity rings inside the object, no heap
+ * - Real-time safety: No allocation; a full ring drops the newest message
  * - Computational complexity: O(1) amortized for message processing
  * 
  * @author Timothy Paul Read
@@ -50,8 +50,6 @@
 
 #pragma once
 #include <Bela.h>
-#include <vector>
-#include <queue>
 
 /**
  * @struct MidiNoteMessage
@@ -99,6 +97,14 @@ struct MidiNoteMessage {
      */
     int velocity;
     
+    /**
+     * @brief true for a note-on status byte (9x), false for a note-off (8x)
+     * 
+     * Kept with the message so the note-off test can use the status rather
+     * than guess from the velocity (see VelocityParser::isNoteOn()).
+     */
+    bool noteOn;
+    
     /**
      * @brief High-precision timestamp in milliseconds
      * 
@@ -150,6 +156,15 @@ struct MidiNoteMessage {
  */
 class MidiHandler {
 public:
+    /**
+     * @brief Messages each queue holds
+     *
+     * With the default 1 ms delay a queue holds at most the notes of about
+     * two blocks; 64 covers a full chord smashed onto every key of a
+     * controller with room to spare.
+     */
+    static const unsigned int kQueueCapacity = 64;
+
     /**
      * @brief Construct MidiHandler with timing parameters
      * 
@@ -182,12 +197,12 @@ public:
      * 
      * @param noteNumber MIDI note number [0-127]
      * @param velocity MIDI velocity [0-127]
-     *                 0 = note-off, 1-127 = note-on with velocity
+     * @param noteOn true for a note-on status byte, false for a note-off
      * @param currentTimeMs Current system time in milliseconds
      *                      Must be monotonically increasing for proper operation
      * 
-     * @complexity O(1) amortized - Queue insertion
-     * @memory O(n) where n = number of buffered messages
+     * @complexity O(1) - Ring insertion
+     * @memory None; a message arriving at a full queue is dropped
      * @realtime_safety Real-time safe (no dynamic allocation)
      * 
      * @thread_safety Safe for single-threaded MIDI input processing
@@ -196,10 +211,10 @@ public:
      * @implementation_details
      * - Creates MidiNoteMessage structure with current timestamp
      * - Pushes to incoming message queue for temporal analysis
-     * - Queue automatically manages memory with bounded growth
+     * - Queue storage is fixed (kQueueCapacity), so nothing is allocated
      * - No validation performed for maximum real-time performance
      */
-    void processMidiMessage(int noteNumber, int velocity, float currentTimeMs);
+    void processMidiMessage(int noteNumber, int velocity, bool noteOn, float currentTimeMs);
     
     /**
      * @brief Update temporal processing and transfer delayed messages
@@ -259,7 +274,7 @@ public:
      * temporal order (FIFO) to preserve musical timing relationships.
      * 
      * @return MidiNoteMessage containing note data and timestamp
-     *         Returns {-1, -1, -1.0f} if queue is empty
+     *         Returns {-1, -1, false, -1.0f} if queue is empty
      * 
      * @complexity O(1) - Constant time queue extraction
      * @thread_safety Safe for single consumer thread
@@ -313,8 +328,54 @@ public:
      * - Temporal analysis of processing delays
      */
     float samplesToMs(int samples) const;
+    
+    /**
+     * @brief Stage a new sample rate for time/sample conversions
+     * 
+     * @param newSampleRate New audio sample rate in Hz
+     * @return false for a non-positive rate
+     * @realtime_safety Call off the audio thread (see ReconfigurePipeline)
+     */
+    bool prepareSampleRate(float newSampleRate);
+    
+    /**
+     * @brief Adopt the staged sample rate
+     * 
+     * Queued messages keep their millisecond timestamps, so timing of
+     * in-flight notes is unaffected.
+     */
+    void commitSampleRate();
+    
+    /** @brief Messages dropped because a queue was full */
+    unsigned int getDroppedMessages() const { return droppedMessages; }
 
 private:
+    /**
+     * @struct MessageQueue
+     * @brief Fixed-capacity FIFO of note messages
+     *
+     * Producer and consumer are both the audio thread, so no atomics are
+     * needed; replaces the std::queue (a std::deque) that allocated a
+     * 512-byte node every few dozen pushes.
+     */
+    struct MessageQueue {
+        MidiNoteMessage messages[kQueueCapacity];
+        unsigned int head = 0;      ///< Next write (monotonic)
+        unsigned int tail = 0;      ///< Next read (monotonic)
+        
+        bool empty() const { return head == tail; }
+        bool full() const { return head - tail == kQueueCapacity; }
+        const MidiNoteMessage& front() const { return messages[tail % kQueueCapacity]; }
+        bool push(const MidiNoteMessage& message) {
+            if (full())
+                return false;
+            messages[head++ % kQueueCapacity] = message;
+            return true;
+        }
+        void pop() { ++tail; }
+    };
+    
+
     /**
      * @brief Audio system sample rate in Hz
      * 
@@ -327,6 +388,9 @@ private:
      */
     float sampleRate;
     
+    /** @brief Sample rate staged by prepareSampleRate() */
+    float stagedSampleRate;
+    
     /**
      * @brief Delay compensation period in milliseconds
      * 
@@ -348,12 +412,12 @@ private:
      * analysis. Messages remain in this queue until their delay period
      * expires, at which point they're transferred to delayedMessages queue.
      * 
-     * @container std::queue<MidiNoteMessage>
+     * @container MessageQueue (kQueueCapacity messages)
      * @ordering First-In-First-Out (preserves temporal relationships)
-     * @growth_behavior Dynamic allocation with exponential growth
+     * @growth_behavior None; full means the newest message is dropped
      * @thread_safety Not thread-safe (requires external synchronization)
      */
-    std::queue<MidiNoteMessage> incomingMessages;
+    MessageQueue incomingMessages;
     
     /**
      * @brief Queue for processed messages ready for audio consumption
@@ -362,11 +426,14 @@ private:
      * are ready for immediate processing by the audio synthesis engine.
      * Messages are consumed by audio thread in temporal order.
      * 
-     * @container std::queue<MidiNoteMessage>
+     * @container MessageQueue (kQueueCapacity messages)
      * @ordering First-In-First-Out (maintains musical timing)
      * @consumption Audio processing thread via popDelayedMessage()
      * @thread_safety Not thread-safe (single consumer assumed)
      */
-    std::queue<MidiNoteMessage> delayedMessages;
+    MessageQueue delayedMessages;
+    
+    /** @brief Messages lost to a full queue (diagnostics) */
+    unsigned int droppedMessages;
 };
 
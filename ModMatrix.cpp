@@ -0,0 +1,66 @@
+/**
+ * @file ModMatrix.cpp
+ * @brief Implementation of the modulation matrix
+ */
+
+#include "ModMatrix.h"
+#include "SimdLanes.h"
+
+namespace {
+
+const float kRange[ModMatrix::kNumDestinations] = {
+    4.0f,       // kCutoff: octaves
+    1.0f,       // kResonance
+    1.0f,       // kDrive
+    1200.0f,    // kPitch: cents
+    1.0f,       // kGain
+    4.0f        // kGlide: octaves of time
+};
+
+} // namespace
+
+ModMatrix::ModMatrix() {
+    for (int s = 0; s < kNumSources; ++s) {
+        sourceValue[s] = 0.0f;
+        for (int d = 0; d < kDestinationLanes; ++d)
+            depth[s][d] = 0.0f;
+    }
+    sourceValue[kConstant] = 1.0f;
+    for (int d = 0; d < kDestinationLanes; ++d)
+        destinationValue[d] = 0.0f;
+}
+
+float ModMatrix::getRange(Destination destination) {
+    return kRange[destination];
+}
+
+void ModMatrix::setDepth(Source source, Destination destination, float amount) {
+    if (source < 0 || source >= kNumSources || destination < 0 || destination >= kNumDestinations)
+        return;
+    amount = amount < -1.0f ? -1.0f : (amount > 1.0f ? 1.0f : amount);
+    depth[source][destination] = amount * kRange[destination];
+}
+
+float ModMatrix::getDepth(Source source, Destination destination) const {
+    return depth[source][destination] / kRange[destination];
+}
+
+bool ModMatrix::isSourceUsed(Source source) const {
+    for (int d = 0; d < kNumDestinations; ++d) {
+        if (depth[source][d] != 0.0f)
+            return true;
+    }
+    return false;
+}
+
+void ModMatrix::process() {
+    vfloat4 low = vf4_dup(0.0f);
+    vfloat4 high = vf4_dup(0.0f);
+    for (int s = 0; s < kNumSources; ++s) {
+        const vfloat4 value = vf4_dup(sourceValue[s]);
+        low = vf4_mla(low, vf4_load(depth[s]), value);
+        high = vf4_mla(high, vf4_load(depth[s] + 4), value);
+    }
+    vf4_store(destinationValue, low);
+    vf4_store(destinationValue + 4, high);
+}
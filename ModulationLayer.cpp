@@ -0,0 +1,118 @@
+/**
+ * @file ModulationLayer.cpp
+ * @brief Implementation of the multi-rate modulation layer
+ */
+
+#include "ModulationLayer.h"
+#include "AudioArena.h"
+
+ModulationLayer::ModulationLayer()
+    : numSources(0), audioRate(false), tickFrame(0), rampPositions(nullptr) {
+    for (int i = 0; i < kMaxSources; ++i) {
+        sources[i].tick = nullptr;
+        sources[i].userData = nullptr;
+        sources[i].interval = 1;
+        sources[i].invInterval = 1.0f;
+        sources[i].interpolated = false;
+        sources[i].countdown = 0;
+        sources[i].current = 0.0f;
+        sources[i].increment = 0.0f;
+        sources[i].buffer = nullptr;
+    }
+}
+
+int ModulationLayer::addSource(TickFunction tick, void* userData, unsigned int interval, bool interpolated) {
+    if (tick == nullptr || numSources >= kMaxSources)
+        return -1;
+    if (interval == 0 || (interval & (interval - 1)) != 0)
+        return -1;
+
+    Source& source = sources[numSources];
+    source.tick = tick;
+    source.userData = userData;
+    source.interval = interval;
+    source.invInterval = 1.0f / static_cast<float>(interval);
+    source.interpolated = interpolated;
+    source.countdown = 0;
+    return numSources++;
+}
+
+bool ModulationLayer::allocate(unsigned int maxFrames, AudioArena& arena) {
+    rampPositions = arena.allocateFloats(maxFrames);
+    if (rampPositions == nullptr)
+        return false;
+    for (unsigned int k = 0; k < maxFrames; ++k)
+        rampPositions[k] = static_cast<float>(k + 1);
+
+    for (int i = 0; i < numSources; ++i) {
+        sources[i].buffer = arena.allocateFloats(maxFrames);
+        if (sources[i].buffer == nullptr)
+            return false;
+    }
+    return true;
+}
+
+void ModulationLayer::setAudioRate(bool newAudioRate) {
+    audioRate = newAudioRate;
+    for (int i = 0; i < numSources; ++i) {
+        sources[i].countdown = 0;
+        sources[i].increment = 0.0f;
+    }
+}
+
+void ModulationLayer::process(unsigned int frames) {
+    const float* ramp = rampPositions;
+    for (int i = 0; i < numSources; ++i) {
+        Source& source = sources[i];
+        float* out = source.buffer;
+
+        /**
+         * Audio-rate quality: every sample is a tick, nothing to ramp
+         */
+        if (audioRate) {
+            for (unsigned int n = 0; n < frames; ++n) {
+                tickFrame = n;
+                out[n] = source.tick(source.userData);
+            }
+            source.current = out[frames - 1];
+            continue;
+        }
+
+        unsigned int n = 0;
+        while (n < frames) {
+            if (source.countdown == 0) {
+                tickFrame = n;
+                const float target = source.tick(source.userData);
+
+                /**
+                 * Ramp from the last written value so consecutive segments
+                 * join without a step
+                 */
+                if (source.interpolated) {
+                    source.increment = (target - source.current) * source.invInterval;
+                }
+                else {
+                    source.current = target;
+                    source.increment = 0.0f;
+                }
+                source.countdown = source.interval;
+            }
+
+            unsigned int run = frames - n;
+            if (run > source.countdown)
+                run = source.countdown;
+
+            /**
+             * Each sample is computed from the segment start rather than
+             * accumulated, so the loop has no serial dependency and vectorises
+             */
+            const float start = source.current;
+            const float increment = source.increment;
+            for (unsigned int k = 0; k < run; ++k)
+                out[n + k] = start + increment * ramp[k];
+            source.current = start + increment * ramp[run - 1];
+            source.countdown -= run;
+            n += run;
+        }
+    }
+}
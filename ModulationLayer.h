@@ -0,0 +1,167 @@
+/**
+ * @file ModulationLayer.h
+ * @brief Multi-rate modulation: control-rate sources interpolated to audio rate
+ *
+ * The amplitude envelope, filter envelope, key follow and resonance ramp
+ * were all evaluated on every sample, although none of them changes fast
+ * enough to need it. In this layer each modulation source declares its own
+ * update interval (e.g. every 8 or 16 samples). A source is ticked only at
+ * that rate, and its value is expanded to a per-sample buffer in one of two
+ * ways:
+ *
+ * 1. **Interpolated**: a linear ramp from the previous tick's value to the
+ *    new one over the interval. Used for destinations that would zipper on
+ *    steps (ZDF cutoff, amplitude). The ramp adds one interval of delay.
+ * 2. **Stepped**: the tick value is held until the next tick. Used for
+ *    destinations that are already smoothed or insensitive to small steps.
+ *
+ * @quality_switch
+ * setAudioRate(true) forces every source to tick on every sample, e.g. for
+ * patches with very short attacks where an 8-sample control period would
+ * soften the transient. A module ticked by a source must run its own
+ * timing at the tick rate; getEffectiveInterval() gives the divider to
+ * apply to the sample rate (see ModuleRateBinding).
+ *
+ * @performance_characteristics
+ * - Per sample and source: one add and one store (interpolated) or one
+ *   store (stepped)
+ * - Per tick: one indirect call to the source
+ * - Memory: one sub-block buffer per source, taken from the AudioArena
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+class AudioArena;
+
+/**
+ * @class ModulationLayer
+ * @brief Ticks modulation sources at their declared rates and fills per-sample buffers
+ *
+ * @usage_example
+ * @code
+ * float tickFilterEnvelope(void*) { return filterEnv.process(base, keyFollowValue); }
+ *
+ * // In setup():
+ * int cutoff = modulation.addSource(tickFilterEnvelope, nullptr, 8, true);
+ * modulation.allocate(kSubBlockFrames, audioArena);
+ *
+ * // Per sub-block:
+ * modulation.process(frames);
+ * const float* cutoffHz = modulation.getBuffer(cutoff);
+ * @endcode
+ */
+class ModulationLayer {
+public:
+    /**
+     * @brief Source callback, evaluated once per update interval
+     *
+     * @param userData Pointer passed to addSource()
+     * @return New value of the source
+     */
+    typedef float (*TickFunction)(void* userData);
+
+    /** @brief Maximum number of registered sources */
+    static const int kMaxSources = 16;
+
+    ModulationLayer();
+
+    /**
+     * @brief Register a source (setup only, before allocate())
+     *
+     * @param tick Function returning the source's next value
+     * @param userData Opaque pointer forwarded to tick
+     * @param interval Update interval in samples; a power of two, 1 for audio rate
+     * @param interpolated true to ramp linearly between ticks, false to hold
+     * @return Source index, or -1 if the table is full or interval is invalid
+     */
+    int addSource(TickFunction tick, void* userData, unsigned int interval, bool interpolated);
+
+    /**
+     * @brief Take one output buffer per source from the arena
+     *
+     * @param maxFrames Largest frame count process() will be called with
+     * @param arena Unlocked arena (numSources × maxFrames floats)
+     * @return false if the arena is exhausted
+     *
+     * @realtime_safety Non-real-time safe (call from setup())
+     */
+    bool allocate(unsigned int maxFrames, AudioArena& arena);
+
+    /**
+     * @brief Force every source to audio rate (true) or use the declared rates
+     *
+     * All sources tick on the next sample, so a switch never leaves a ramp
+     * aimed at a value computed under the old rate.
+     *
+     * @realtime_safety Real-time safe; call between blocks, together with
+     *                  the rate change of the modules the sources tick
+     */
+    void setAudioRate(bool audioRate);
+
+    /**
+     * @brief Tick a source at the start of the next process() call
+     *
+     * For events that happen between ticks (a sample-accurate note-on):
+     * the source's next control period starts exactly at the event.
+     */
+    void restartSource(int source) { sources[source].countdown = 0; }
+
+    /** @brief True while the audio-rate quality switch is on */
+    bool isAudioRate() const { return audioRate; }
+
+    /**
+     * @brief Interval a source with the given declared interval actually runs at
+     *
+     * @param declaredInterval Interval passed to addSource()
+     * @return 1 in audio-rate mode, declaredInterval otherwise
+     */
+    unsigned int getEffectiveInterval(unsigned int declaredInterval) const {
+        return audioRate ? 1u : declaredInterval;
+    }
+
+    /**
+     * @brief Fill every source buffer with the next `frames` samples
+     *
+     * @param frames At most the maxFrames given to allocate()
+     *
+     * @complexity O(sources × frames) stores plus O(frames / interval) ticks
+     * @realtime_safety Real-time safe
+     */
+    void process(unsigned int frames);
+
+    /** @brief Per-sample values of a source for the last process() call */
+    const float* getBuffer(int source) const { return sources[source].buffer; }
+
+    /**
+     * @brief Frame offset, within the current process() call, of the tick being evaluated
+     *
+     * Lets a tick function read other per-sample buffers (e.g. drift) at the
+     * sample it is being evaluated for.
+     */
+    unsigned int getTickFrame() const { return tickFrame; }
+
+private:
+    struct Source {
+        TickFunction tick;
+        void* userData;
+        unsigned int interval;      ///< Declared update interval
+        float invInterval;          ///< 1 / interval
+        bool interpolated;
+        unsigned int countdown;     ///< Samples until the next tick
+        float current;              ///< Value of the last sample written
+        float increment;            ///< Per-sample ramp step
+        float* buffer;
+    };
+
+    Source sources[kMaxSources];
+    int numSources;
+    bool audioRate;
+    unsigned int tickFrame;
+
+    /** @brief 1, 2, 3, ... : ramp multipliers, so the fill loop needs no int-to-float conversion */
+    float* rampPositions;
+};
@@ -20,7 +20,10 @@
  * The defaults provide classic analog synthesizer character while
  * maintaining timbral stability across diverse musical contexts.
  */
-MoogFilterEnvelope::MoogFilterEnvelope(float sampleRate) : envDepth(1.0f) {
+MoogFilterEnvelope::MoogFilterEnvelope(float sampleRate)
+    : envDepth(1.0f), velocityDepth(1.0f), sampleRate(sampleRate),
+      attackSec(0.01f), decaySec(0.1f), sustainLvl(0.75f), releaseSec(0.2f),
+      stagedSampleRate(sampleRate) {
     /**
      * Initialize envelope to idle state
      * Ensures clean startup without residual envelope activity
@@ -45,23 +48,48 @@ MoogFilterEnvelope::MoogFilterEnvelope(float sampleRate) : envDepth(1.0f) {
  * @param sustainLvl Sustain level [0.0-1.0]
  * @param releaseSec Release time in seconds
  * 
- * @bug_notice The implementation uses hardcoded 44100.0f sample rate conversion
- * instead of the sampleRate parameter from constructor. This causes timing
- * inaccuracies at other sample rates and should be corrected to use the
- * stored sample rate value for accurate timing across all audio configurations.
- * 
- * @correct_implementation_should_be
- * @code
- * envelope.setAttackRate(attackSec * sampleRate);
- * envelope.setDecayRate(decaySec * sampleRate);
- * envelope.setReleaseRate(releaseSec * sampleRate);
- * @endcode
+ * Times are converted using the sample rate stored at construction, so the
+ * envelope runs at the intended speed at every supported rate.
  */
 void MoogFilterEnvelope::setADSR(float attackSec, float decaySec, float sustainLvl, float releaseSec) {
-    envelope.setAttackRate(attackSec * 44100.0f);   // BUG: Should use actual sampleRate
-    envelope.setDecayRate(decaySec * 44100.0f);     // BUG: Should use actual sampleRate
-    envelope.setSustainLevel(sustainLvl);           // Correct: dimensionless level
-    envelope.setReleaseRate(releaseSec * 44100.0f); // BUG: Should use actual sampleRate
+    this->attackSec = attackSec;
+    this->decaySec = decaySec;
+    this->sustainLvl = sustainLvl;
+    this->releaseSec = releaseSec;
+    
+    envelope.setAttackRate(attackSec * sampleRate);
+    envelope.setDecayRate(decaySec * sampleRate);
+    envelope.setSustainLevel(sustainLvl);           // Dimensionless level
+    envelope.setReleaseRate(releaseSec * sampleRate);
+}
+
+/**
+ * @brief Prepare envelope coefficients for a new sample rate
+ * 
+ * The staging envelope is configured exactly like the live one (the ADSR
+ * default curvature ratios are not changed by this class), so adopting its
+ * coefficients is equivalent to calling setADSR() at the new rate. The
+ * staged coefficients are derived here, on the preparing thread, so the
+ * envelope that adopts them has nothing left to recompute.
+ */
+bool MoogFilterEnvelope::prepareSampleRate(float newSampleRate) {
+    if (newSampleRate <= 0.0f)
+        return false;
+    stagedEnvelope.setAttackRate(attackSec * newSampleRate);
+    stagedEnvelope.setDecayRate(decaySec * newSampleRate);
+    stagedEnvelope.setSustainLevel(sustainLvl);
+    stagedEnvelope.setReleaseRate(releaseSec * newSampleRate);
+    stagedEnvelope.updateCoefficients();
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+/**
+ * @brief Swap the prepared coefficients into the live envelope
+ */
+void MoogFilterEnvelope::commitSampleRate() {
+    envelope.adoptCoefficients(stagedEnvelope);
+    sampleRate = stagedSampleRate;
 }
 
 /**
@@ -80,13 +108,14 @@ void MoogFilterEnvelope::setEnvDepth(float depth) {
  * @brief Trigger envelope gate state change
  * 
  * @param gateState Gate control (1=on, 0=off)
- * @param velocity Velocity parameter (currently unused)
+ * @param velocity Depth multiplier, latched on gate-on
  * 
- * Direct delegation to underlying ADSR envelope for gate control.
- * Velocity parameter provided for interface consistency but not
- * currently implemented for velocity-sensitive envelope behavior.
+ * Delegates the gate to the ADSR. A gate-off leaves the depth alone so the
+ * release sweeps as far as the note's attack did.
  */
 void MoogFilterEnvelope::gate(int gateState, float velocity) {
+    if (gateState)
+        velocityDepth = velocity;
     envelope.gate(gateState);
 }
 
@@ -125,6 +154,16 @@ float MoogFilterEnvelope::process(float cutoffBase, float keyFollowValue) {
      * Combine all frequency components using additive synthesis
      * Linear frequency addition provides predictable filter behavior
      */
-    return (cutoffBase + keyFollowValue) + (envOut * envDepth);
+    return (cutoffBase + keyFollowValue) + (envOut * (envDepth * velocityDepth));
 }
 
+/**
+ * @brief Envelope contribution in octaves
+ * 
+ * Replaces the Hz addition of process() in the voice: a depth in semitones
+ * added to a frequency in Hz moved the cutoff by a negligible amount at
+ * 5 kHz and a large one at 100 Hz.
+ */
+float MoogFilterEnvelope::processOctaves() {
+    return envelope.process() * (envDepth * velocityDepth * (1.0f / 12.0f));
+}
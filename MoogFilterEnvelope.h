@@ -169,9 +169,8 @@ public:
      * @precision Sample-accurate timing (limited by sample rate quantization)
      * @realtime_safety Real-time safe (no allocation or blocking)
      * 
-     * @note The implementation currently uses a hardcoded 44.1kHz conversion factor
-     * which may cause timing inaccuracies at other sample rates. This appears to be
-     * a bug that should use the sampleRate parameter passed to constructor.
+     * @note Times are converted with the sample rate given to the constructor,
+     * so recreate the envelope when the audio rate is known (see setup()).
      * 
      * @musical_guidelines
      * - Lead sounds: Fast attack (1-10ms), medium decay (50-200ms), high sustain (70-90%)
@@ -217,6 +216,28 @@ public:
      */
     void setEnvDepth(float depth);
     
+    /**
+     * @brief Rebuild the envelope coefficients for a new sample rate
+     * 
+     * Recomputes the ADSR coefficients (table exp2/log2) for the times last given
+     * to setADSR() into a staging envelope, leaving the live one untouched.
+     * 
+     * @param newSampleRate New audio sample rate in Hz
+     * @return false for a non-positive rate
+     * @realtime_safety Call off the audio thread (see ReconfigurePipeline)
+     */
+    bool prepareSampleRate(float newSampleRate);
+    
+    /**
+     * @brief Swap in the staged coefficients
+     * 
+     * Envelope stage and level are preserved, so a sounding note continues
+     * smoothly at the new rate.
+     * 
+     * @realtime_safety Real-time safe (member copies only)
+     */
+    void commitSampleRate();
+    
     /**
      * @brief Trigger envelope gate with optional velocity sensitivity
      * 
@@ -228,10 +249,10 @@ public:
      *                  1 (or non-zero): Trigger envelope attack phase (note-on)
      *                  0: Trigger envelope release phase (note-off)
      * 
-     * @param velocity MIDI velocity value for future velocity sensitivity
-     *                 Currently unused but provided for interface consistency
-     *                 Range: [0.0-1.0] normalized velocity
-     *                 Future implementations may use for envelope scaling
+     * @param velocity Depth multiplier for this note, usually a velocity
+     *                 curve value (VelocityParser::getFilterDepth())
+     *                 Range: [0.0-1.0]; 1.0 gives the full envDepth
+     *                 Read on gate-on only; the release keeps the note's depth
      * 
      * @complexity O(1) - Direct delegation to ADSR envelope
      * @determinism Deterministic gate state transition
@@ -241,7 +262,7 @@ public:
      * - Gate-on (1): Immediately triggers attack phase regardless of current envelope state
      * - Gate-off (0): Triggers release phase from current envelope level
      * - Retriggering: Multiple gate-on events restart attack from beginning
-     * - Velocity parameter: Reserved for future velocity-sensitive implementations
+     * - Velocity: Scales envDepth until the next gate-on
      * 
      * @envelope_state_transitions
      * ```
@@ -257,6 +278,21 @@ public:
      */
     void gate(int gateState, float velocity);
     
+    /**
+     * @brief Advance the envelope and return its cutoff offset in octaves
+     * 
+     * The pitch-domain counterpart of process(): envDepth is read as
+     * semitones, so the offset is level × envDepth × velocity depth / 12
+     * octaves and an envelope sweep sounds the same at any base cutoff.
+     * The caller adds it to log2 of the cutoff.
+     * 
+     * @return Envelope offset in octaves [0, envDepth / 12]
+     * 
+     * @complexity O(1) - One ADSR step and two multiplications
+     * @realtime_safety Real-time safe
+     */
+    float processOctaves();
+    
     /**
      * @brief Process envelope and generate filter cutoff frequency
      * 
@@ -288,7 +324,7 @@ public:
      * 4. Return combined frequency for immediate filter control
      * 
      * @mathematical_formula
-     * output_frequency = cutoffBase + keyFollowValue + (envelope_output × envDepth)
+     * output_frequency = cutoffBase + keyFollowValue + (envelope_output × envDepth × velocityDepth)
      * 
      * @frequency_bounds_checking
      * The implementation does not perform bounds checking on output frequency.
@@ -313,6 +349,20 @@ public:
      */
     float process(float cutoffBase, float keyFollowValue);
 
+    /**
+     * @brief Envelope level from the last process() call, before depth
+     *
+     * @return Normalized envelope value [0.0-1.0]
+     *
+     * @complexity O(1) - Returns the stored ADSR output
+     * @realtime_safety Real-time safe
+     *
+     * @usage
+     * Feeds the modulation matrix, so the filter envelope's shape can drive
+     * destinations other than the cutoff.
+     */
+    float getLevel() { return envelope.getOutput(); }
+
 private:
     /**
      * @brief Internal ADSR envelope generator instance
@@ -342,5 +392,29 @@ private:
      * @default 1.0 (unity gain, conservative modulation depth)
      */
     float envDepth;
+    
+    /**
+     * @brief Depth multiplier latched by the last gate-on [0.0-1.0]
+     */
+    float velocityDepth;
+    
+    /**
+     * @brief Sample rate used for seconds-to-samples conversion in setADSR()
+     */
+    float sampleRate;
+    
+    /**
+     * @brief Envelope times from the last setADSR(), kept for rate changes
+     */
+    float attackSec;
+    float decaySec;
+    float sustainLvl;
+    float releaseSec;
+    
+    /** @brief Coefficients prepared for the staged sample rate */
+    ADSR stagedEnvelope;
+    
+    /** @brief Sample rate staged by prepareSampleRate() */
+    float stagedSampleRate;
 };
 
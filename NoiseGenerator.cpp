@@ -0,0 +1,227 @@
+/**
+ * @file NoiseGenerator.cpp
+ * @brief Implementation of the vectorised noise and drift generator
+ */
+
+#include "NoiseGenerator.h"
+#include "SimdLanes.h"
+#include "TableBank.h"
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Kellet "economy" pink filter coefficients, one pole per lane
+ *
+ * Lanes 0-2 are the three one-pole sections; lane 3 has a zero feedback
+ * coefficient and carries the direct white-noise term, so the pink output
+ * is simply the horizontal sum of the four lanes.
+ */
+const float kPinkFeedback[4] = { 0.99765f, 0.96300f, 0.57000f, 0.0f };
+const float kPinkInput[4]    = { 0.0990460f, 0.2965164f, 1.0526913f, 0.1848f };
+
+/** @brief Brings the Kellet filter output to roughly the RMS of the white input */
+const float kPinkGain = 0.334f;
+
+} // namespace
+
+NoiseGenerator::NoiseGenerator(float sampleRate, uint32_t seed)
+    : sampleRate(sampleRate) {
+    setSeed(seed);
+    setDriftRate(0.3f);
+    stagedSampleRate = sampleRate;
+    stagedDriftLeak = driftLeak;
+    stagedDriftStep = driftStep;
+
+    routeSource[kFilterNoise] = kWhite;
+    routeDepth[kFilterNoise] = 1e-5f;
+    routeSource[kPitchDrift] = kDrift;
+    routeDepth[kPitchDrift] = 2.0f;
+    routeSource[kCutoffDrift] = kDrift;
+    routeDepth[kCutoffDrift] = 0.03f;
+    updateActiveStreams();
+}
+
+void NoiseGenerator::setSeed(uint32_t seed) {
+    if (seed == 0)
+        seed = 0x7123E;
+
+    /**
+     * Derive eight decorrelated lane seeds with a Weyl sequence followed by
+     * a few scalar xorshift rounds, so neighbouring seeds do not produce
+     * visibly related streams.
+     */
+    uint32_t s = seed;
+    uint32_t laneSeeds[8];
+    for (int lane = 0; lane < 8; ++lane) {
+        s += 0x9E3779B9u;
+        uint32_t x = s;
+        for (int round = 0; round < 4; ++round) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+        }
+        laneSeeds[lane] = (x != 0) ? x : 0x2545F491u;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        whiteState[i] = laneSeeds[i];
+        driftState[i] = laneSeeds[i + 4];
+        pinkPoles[i] = 0.0f;
+        driftValue[i] = 0.0f;
+    }
+}
+
+void NoiseGenerator::setDriftRate(float rateHz) {
+    if (rateHz < 0.01f)
+        rateHz = 0.01f;
+    if (rateHz > 20.0f)
+        rateHz = 20.0f;
+    driftRateHz = rateHz;
+    computeDriftCoefficients(sampleRate, driftRateHz, driftLeak, driftStep);
+}
+
+void NoiseGenerator::computeDriftCoefficients(float rate, float cornerHz, float& leak, float& step) {
+    /**
+     * Ornstein-Uhlenbeck discretisation: d[m] = leak·d[m-1] + step·w[m],
+     * evaluated once every four samples (see process()). Stationary variance
+     * is step²·var(w) / (1 - leak²); uniform white noise in [-1, 1) has
+     * variance 1/3, hence the factor of 3.
+     */
+    leak = tableExp(-2.0f * static_cast<float>(M_PI) * cornerHz * 4.0f / rate);
+    step = sqrtf(3.0f * (1.0f - leak * leak));
+}
+
+bool NoiseGenerator::prepareSampleRate(float newSampleRate) {
+    if (newSampleRate <= 0.0f)
+        return false;
+    computeDriftCoefficients(newSampleRate, driftRateHz, stagedDriftLeak, stagedDriftStep);
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+void NoiseGenerator::commitSampleRate() {
+    sampleRate = stagedSampleRate;
+    driftLeak = stagedDriftLeak;
+    driftStep = stagedDriftStep;
+}
+
+void NoiseGenerator::setRoute(Destination dest, Source source, float depth) {
+    if (dest < 0 || dest >= kNumDestinations)
+        return;
+    routeSource[dest] = source;
+    routeDepth[dest] = depth;
+    updateActiveStreams();
+}
+
+void NoiseGenerator::updateActiveStreams() {
+    needDrift = false;
+    for (int d = 0; d < kNumDestinations; ++d)
+        needDrift |= (routeSource[d] == kDrift);
+}
+
+void NoiseGenerator::process(float* const outputs[kNumDestinations], unsigned int frames) {
+    /**
+     * Routing is copied to locals: the output buffers are plain float
+     * pointers, so without this the compiler must assume every store may
+     * alias the member state and reload it inside the inner loops.
+     */
+    Source source[kNumDestinations];
+    float depth[kNumDestinations];
+    for (int d = 0; d < kNumDestinations; ++d) {
+        source[d] = routeSource[d];
+        depth[d] = routeDepth[d];
+    }
+
+    const unsigned int vectorFrames = frames & ~3u;
+    float tail[4];
+
+    vuint4 white = vu4_load(whiteState);
+
+    for (int d = 0; d < kNumDestinations; ++d) {
+        float* out = outputs[d];
+
+        if (source[d] == kWhite) {
+            /**
+             * White noise: one vector step yields four consecutive samples
+             */
+            const vfloat4 scale = vf4_dup(depth[d]);
+            for (unsigned int n = 0; n < vectorFrames; n += 4) {
+                white = vu4_xorshift32(white);
+                vf4_store(out + n, vf4_mul(vu4_to_bipolar(white), scale));
+            }
+            if (vectorFrames < frames) {
+                white = vu4_xorshift32(white);
+                vf4_store(tail, vf4_mul(vu4_to_bipolar(white), scale));
+                for (unsigned int n = vectorFrames; n < frames; ++n)
+                    out[n] = tail[n - vectorFrames];
+            }
+        }
+        else if (source[d] == kPink) {
+            /**
+             * Pink noise is recursive in time, so it advances one sample at
+             * a time, but each step updates all three poles plus the direct
+             * term with a single four-lane multiply-accumulate
+             */
+            const vfloat4 pinkFeedback = vf4_load(kPinkFeedback);
+            const vfloat4 pinkInput = vf4_load(kPinkInput);
+            const float scale = depth[d] * kPinkGain;
+            vfloat4 poles = vf4_load(pinkPoles);
+            for (unsigned int n = 0; n < frames; n += 4) {
+                white = vu4_xorshift32(white);
+                vf4_store(tail, vu4_to_bipolar(white));
+                const unsigned int count = (frames - n < 4) ? frames - n : 4;
+                for (unsigned int k = 0; k < count; ++k) {
+                    poles = vf4_mla(vf4_mul(poles, pinkFeedback), pinkInput, vf4_dup(tail[k]));
+                    out[n + k] = vf4_hsum(poles) * scale;
+                }
+            }
+            vf4_store(pinkPoles, poles);
+        }
+        else if (source[d] != kDrift) {
+            for (unsigned int n = 0; n < frames; ++n)
+                out[n] = 0.0f;
+        }
+    }
+
+    vu4_store(whiteState, white);
+
+    if (!needDrift)
+        return;
+
+    /**
+     * Drift: all four walks advance together at a quarter of the sample
+     * rate (the walks are band-limited to a few Hz, so this loses nothing)
+     * and are linearly interpolated back to audio rate. Each drift-routed
+     * destination reads its own lane.
+     */
+    vuint4 walk = vu4_load(driftState);
+    vfloat4 drift = vf4_load(driftValue);
+    const vfloat4 leak = vf4_dup(driftLeak);
+    const vfloat4 step = vf4_dup(driftStep);
+    const vfloat4 quarter = vf4_dup(0.25f);
+    float ramp[4][4];
+
+    for (unsigned int n = 0; n < frames; n += 4) {
+        walk = vu4_xorshift32(walk);
+        const vfloat4 next = vf4_mla(vf4_mul(drift, leak), vu4_to_bipolar(walk), step);
+        const vfloat4 delta = vf4_mul(vf4_sub(next, drift), quarter);
+        for (int k = 0; k < 4; ++k) {
+            drift = vf4_add(drift, delta);
+            vf4_store(ramp[k], drift);
+        }
+        drift = next;
+
+        const unsigned int count = (frames - n < 4) ? frames - n : 4;
+        for (int d = 0; d < kNumDestinations; ++d) {
+            if (source[d] != kDrift)
+                continue;
+            float* out = outputs[d] + n;
+            for (unsigned int k = 0; k < count; ++k)
+                out[k] = ramp[k][d] * depth[d];
+        }
+    }
+
+    vu4_store(driftState, walk);
+    vf4_store(driftValue, drift);
+}
@@ -0,0 +1,209 @@
+/**
+ * @file OverrunCapture.cpp
+ * @brief Implementation of the overrun post-mortem capture
+ */
+
+#include "OverrunCapture.h"
+#include "AudioArena.h"
+#include <cstdio>
+#include <cstring>
+#include <time.h>
+
+namespace {
+
+inline uint64_t nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+const char kMagic[4] = { 'T', '3', 'O', 'V' };
+const uint32_t kVersion = 3;
+
+} // namespace
+
+OverrunCapture::OverrunCapture()
+    : ring(nullptr), capacity(0), next(0), filled(0), current(nullptr), blockStartNs(0),
+      frozenPeriodNs(0), phase(kRecording), armed(true),
+      envelope(nullptr), filter(nullptr), portamento(nullptr), resonance(nullptr),
+      snapshotCount(0), outputPrefix("tr123e-overrun") {
+}
+
+size_t OverrunCapture::requiredBytes(unsigned int blocks) {
+    return blocks * sizeof(CaptureBlock) + AudioArena::kAlignment;
+}
+
+bool OverrunCapture::allocate(unsigned int blocks, AudioArena& arena) {
+    if (blocks == 0)
+        return false;
+    ring = static_cast<CaptureBlock*>(arena.allocateBytes(blocks * sizeof(CaptureBlock)));
+    if (!ring)
+        return false;
+    capacity = blocks;
+    return true;
+}
+
+void OverrunCapture::bindModules(ADSR* envelope, StereoLadder* filter,
+                                 PortamentoPlayer* portamento, ResonanceRamp* resonance) {
+    this->envelope = envelope;
+    this->filter = filter;
+    this->portamento = portamento;
+    this->resonance = resonance;
+}
+
+void OverrunCapture::beginBlock(uint64_t frame, float sampleRate, unsigned int audioFrames) {
+    current = nullptr;
+    if (!ring || !armed)
+        return;
+
+    /**
+     * The writer hands the ring back as kRearm; what it held is stale, so
+     * the next snapshot starts from an empty ring
+     */
+    const int state = phase.load(std::memory_order_acquire);
+    if (state == kRearm) {
+        filled = 0;
+        phase.store(kRecording, std::memory_order_relaxed);
+    }
+    else if (state != kRecording) {
+        return;
+    }
+
+    current = &ring[next];
+    current->frame = frame;
+    current->sampleRate = sampleRate;
+    current->durationNs = 0;
+    current->audioFrames = static_cast<uint16_t>(audioFrames);
+    current->analogFrames = 0;
+    current->analogChannels = 0;
+    current->midiBytes = 0;
+    current->flags = 0;
+    if (envelope)
+        envelope->saveSnapshot(current->envelope);
+    if (filter)
+        filter->saveSnapshot(current->filter);
+    if (portamento)
+        portamento->saveSnapshot(current->portamento);
+    if (resonance)
+        resonance->saveSnapshot(current->resonance);
+    blockStartNs = nowNs();
+}
+
+void OverrunCapture::recordMidi(const uint8_t* bytes, unsigned int count) {
+    if (!current)
+        return;
+    const unsigned int room = CaptureBlock::kMaxMidiBytes - current->midiBytes;
+    if (count > room) {
+        current->flags |= CaptureBlock::kMidiTruncated;
+        count = room;
+    }
+    memcpy(current->midi + current->midiBytes, bytes, count);
+    current->midiBytes = static_cast<uint16_t>(current->midiBytes + count);
+}
+
+void OverrunCapture::recordAnalog(const float* analogIn, unsigned int frames, unsigned int channels) {
+    if (!current || !analogIn)
+        return;
+    unsigned int keepFrames = frames;
+    unsigned int keepChannels = channels;
+    if (keepFrames > CaptureBlock::kMaxAnalogFrames || keepChannels > CaptureBlock::kMaxAnalogChannels) {
+        current->flags |= CaptureBlock::kAnalogTruncated;
+        if (keepFrames > CaptureBlock::kMaxAnalogFrames)
+            keepFrames = CaptureBlock::kMaxAnalogFrames;
+        if (keepChannels > CaptureBlock::kMaxAnalogChannels)
+            keepChannels = CaptureBlock::kMaxAnalogChannels;
+    }
+
+    if (keepChannels == channels) {
+        memcpy(current->analog, analogIn, keepFrames * channels * sizeof(float));
+    }
+    else {
+        for (unsigned int f = 0; f < keepFrames; ++f)
+            memcpy(current->analog + f * keepChannels, analogIn + f * channels, keepChannels * sizeof(float));
+    }
+    current->analogFrames = static_cast<uint16_t>(keepFrames);
+    current->analogChannels = static_cast<uint16_t>(keepChannels);
+}
+
+bool OverrunCapture::endBlock(uint64_t periodNs) {
+    if (!current)
+        return false;
+    const uint64_t durationNs = nowNs() - blockStartNs;
+    current->durationNs = durationNs > 0xFFFFFFFFull ? 0xFFFFFFFFu : static_cast<uint32_t>(durationNs);
+    current = nullptr;
+    if (++next == capacity)
+        next = 0;
+    if (filled < capacity)
+        ++filled;
+
+    if (periodNs == 0 || durationNs <= periodNs)
+        return false;
+
+    /**
+     * Hand the ring to the writer; `next` now points just past the block
+     * that overran, which is the newest record
+     */
+    ring[(next + capacity - 1) % capacity].flags |= CaptureBlock::kOverrun;
+    frozenPeriodNs = periodNs;
+    phase.store(kFrozen, std::memory_order_release);
+    return true;
+}
+
+bool OverrunCapture::writePending() {
+    if (phase.load(std::memory_order_acquire) != kFrozen)
+        return false;
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s-%u.bin", outputPrefix, snapshotCount);
+    FILE* file = fopen(path, "wb");
+    bool written = false;
+    if (file) {
+        OverrunFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.blockBytes = sizeof(CaptureBlock);
+        header.blockCount = filled;
+        header.overrunBlock = filled - 1;
+        header.periodNs = frozenPeriodNs;
+
+        written = fwrite(&header, sizeof(header), 1, file) == 1;
+        const unsigned int oldest = (next + capacity - filled) % capacity;
+        for (unsigned int i = 0; i < filled && written; ++i)
+            written = fwrite(&ring[(oldest + i) % capacity], sizeof(CaptureBlock), 1, file) == 1;
+        written = (fclose(file) == 0) && written;
+    }
+
+    ++snapshotCount;
+    phase.store(snapshotCount < kMaxSnapshots ? kRearm : kExhausted, std::memory_order_release);
+    return written;
+}
+
+void OverrunCapture::restoreModules(const CaptureBlock& block) const {
+    if (envelope)
+        envelope->loadSnapshot(block.envelope);
+    if (filter)
+        filter->loadSnapshot(block.filter);
+    if (portamento)
+        portamento->loadSnapshot(block.portamento);
+    if (resonance)
+        resonance->loadSnapshot(block.resonance);
+}
+
+bool OverrunCapture::load(const char* path, OverrunFileHeader& header, std::vector<CaptureBlock>& blocks) {
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+
+    bool ok = fread(&header, sizeof(header), 1, file) == 1
+           && memcmp(header.magic, kMagic, sizeof(kMagic)) == 0
+           && header.version == kVersion
+           && header.blockBytes == sizeof(CaptureBlock)
+           && header.blockCount > 0;
+    if (ok) {
+        blocks.resize(header.blockCount);
+        ok = fread(blocks.data(), sizeof(CaptureBlock), header.blockCount, file) == header.blockCount;
+    }
+    fclose(file);
+    return ok;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file OverrunCapture.h
+ * @brief Overrun post-mortem: the last N blocks of inputs and module state
+ *
+ * The block trace (BlockTrace.h) says which stage was slow when a block
+ * overran; this says why, by keeping enough to run the same blocks again.
+ * For each of the last N blocks the audio thread keeps:
+ * - the raw MIDI bytes render() handled
+ * - every analog frame of the block (the panel pots)
+ * - the state of ADSR, StereoLadder, PortamentoPlayer and
+ *   ResonanceRamp as the block started
+ * - how long render() took
+ *
+ * When a block outlasts its period the ring freezes and an auxiliary task
+ * writes it to disk as one binary file. The audio thread stops capturing
+ * until the file is written, so nothing is copied on the audio thread.
+ * DEV/OverrunReplay.cpp loads the file on a host, restores the first
+ * block's module state and replays the sequence through render.cpp,
+ * timing every block.
+ *
+ * @file_format
+ * OverrunFileHeader, then blockCount CaptureBlock records, oldest first.
+ * The records are written as they are in memory: the replay host must be
+ * little-endian with the same struct layout, which the header's block size
+ * checks (ARMv7 EABI and x86-64 agree for these types).
+ *
+ * @performance_characteristics
+ * - Per block: four small struct copies, one memcpy of the analog frames,
+ *   two clock reads
+ * - Memory: ~4.3 KB per block from the AudioArena (64 blocks: ~275 KB)
+ * - Snapshots per run are capped so a persistently overloaded set cannot
+ *   fill the disk
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ADSR.h"
+#include "PortamentoPlayer.h"
+#include "ResonanceRamp.h"
+#include "StereoLadder.h"
+
+class AudioArena;
+
+/**
+ * @struct CaptureBlock
+ * @brief Everything needed to replay one render() call
+ */
+struct CaptureBlock {
+    static const unsigned int kMaxMidiBytes = 96;       ///< 32 three-byte messages
+    static const unsigned int kMaxAnalogFrames = 128;   ///< 256-frame period at 44.1 kHz
+    static const unsigned int kMaxAnalogChannels = 8;
+
+    /** @brief flags bits */
+    enum Flags {
+        kMidiTruncated = 1,     ///< More MIDI arrived than kMaxMidiBytes
+        kAnalogTruncated = 2,   ///< More analog frames or channels than captured
+        kOverrun = 4            ///< This block outlasted its period
+    };
+
+    uint64_t frame;             ///< context->audioFramesElapsed
+    float sampleRate;
+    uint32_t durationNs;        ///< Time render() took on stage
+    uint16_t audioFrames;
+    uint16_t analogFrames;      ///< Frames captured
+    uint16_t analogChannels;    ///< Channels captured per frame
+    uint16_t midiBytes;
+    uint16_t flags;
+    uint8_t midi[kMaxMidiBytes];
+    float analog[kMaxAnalogFrames * kMaxAnalogChannels];   ///< Interleaved
+
+    ADSR::Snapshot envelope;
+    StereoLadder::Snapshot filter;
+    PortamentoPlayer::Snapshot portamento;
+    ResonanceRamp::Snapshot resonance;
+};
+
+/**
+ * @struct OverrunFileHeader
+ * @brief Start of a snapshot file
+ */
+struct OverrunFileHeader {
+    char magic[4];              ///< "T3OV"
+    uint32_t version;
+    uint32_t blockBytes;        ///< sizeof(CaptureBlock) on the writer
+    uint32_t blockCount;
+    uint32_t overrunBlock;      ///< Index of the block that overran
+    uint32_t reserved;
+    uint64_t periodNs;          ///< Period of the overrunning block
+};
+
+/**
+ * @class OverrunCapture
+ * @brief Rolling capture of render() inputs, frozen and written on overrun
+ *
+ * @usage_example
+ * @code
+ * // setup():
+ * arenaConfig.extraBytes += OverrunCapture::requiredBytes(64);
+ * overrunCapture.allocate(64, audioArena);
+ * overrunCapture.bindModules(&envelope, &stereoLadder, &portamentoPlayer, &resonanceRamp);
+ *
+ * // render():
+ * overrunCapture.beginBlock(frame, sampleRate, frames);
+ * overrunCapture.recordAnalog(context->analogIn, context->analogFrames, context->analogInChannels);
+ * overrunCapture.recordMidi(bytes, count);
+ * ...
+ * if (overrunCapture.endBlock(periodNs))
+ *     Bela_scheduleAuxiliaryTask(captureTask);
+ *
+ * // auxiliary task:
+ * overrunCapture.writePending();
+ * @endcode
+ */
+class OverrunCapture {
+public:
+    OverrunCapture();
+
+    /** @brief Arena bytes for a ring of `blocks` blocks */
+    static size_t requiredBytes(unsigned int blocks);
+
+    /**
+     * @brief Take the ring from the arena
+     *
+     * @return false if the arena cannot hold it
+     * @realtime_safety Non-real-time safe (setup())
+     */
+    bool allocate(unsigned int blocks, AudioArena& arena);
+
+    /**
+     * @brief Modules whose state is saved at each block start and restored by replay
+     */
+    void bindModules(ADSR* envelope, StereoLadder* filter,
+                     PortamentoPlayer* portamento, ResonanceRamp* resonance);
+
+    /** @brief Files are named <prefix>-<n>.bin */
+    void setOutputPrefix(const char* prefix) { outputPrefix = prefix; }
+
+    /**
+     * @brief Stop or resume capturing (the host replay disarms it)
+     */
+    void setArmed(bool armed) { this->armed = armed; }
+
+    // ------------------------------------------------------------------------
+    // Audio thread
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Open the next ring slot and save the bound modules' state
+     */
+    void beginBlock(uint64_t frame, float sampleRate, unsigned int audioFrames);
+
+    /** @brief Append raw MIDI bytes handled in this block */
+    void recordMidi(const uint8_t* bytes, unsigned int count);
+
+    /**
+     * @brief Copy the block's analog input (interleaved, as in BelaContext)
+     */
+    void recordAnalog(const float* analogIn, unsigned int frames, unsigned int channels);
+
+    /**
+     * @brief Close the block; freeze the ring if it overran
+     *
+     * @param periodNs Duration of the block's audio
+     * @return true if the ring froze and the writer task should run
+     */
+    bool endBlock(uint64_t periodNs);
+
+    // ------------------------------------------------------------------------
+    // Writer task and replay
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Write a frozen ring to disk and re-arm the capture
+     *
+     * @return true if a file was written
+     * @realtime_safety Non-real-time (auxiliary task)
+     */
+    bool writePending();
+
+    /** @brief Snapshots written since allocate() */
+    unsigned int getSnapshotCount() const { return snapshotCount; }
+
+    /**
+     * @brief Restore the bound modules to the state a captured block started with
+     */
+    void restoreModules(const CaptureBlock& block) const;
+
+    /**
+     * @brief Read a snapshot file
+     *
+     * @return false if the file is missing, truncated or from a different layout
+     */
+    static bool load(const char* path, OverrunFileHeader& header, std::vector<CaptureBlock>& blocks);
+
+private:
+    /**
+     * @enum Phase
+     * @brief Ownership of the ring: the audio thread while recording, the
+     *        writer while frozen
+     */
+    enum Phase {
+        kRecording = 0,
+        kFrozen,
+        kRearm,         ///< Written; the audio thread restarts the ring
+        kExhausted      ///< Snapshot limit reached
+    };
+
+    /** @brief Upper bound on snapshot files per run */
+    static const unsigned int kMaxSnapshots = 8;
+
+    CaptureBlock* ring;
+    unsigned int capacity;
+    unsigned int next;          ///< Slot of the next block
+    unsigned int filled;        ///< Valid blocks in the ring
+    CaptureBlock* current;      ///< Block being captured, or nullptr
+    uint64_t blockStartNs;
+    uint64_t frozenPeriodNs;
+    std::atomic<int> phase;
+    bool armed;
+
+    ADSR* envelope;
+    StereoLadder* filter;
+    PortamentoPlayer* portamento;
+    ResonanceRamp* resonance;
+
+    unsigned int snapshotCount;
+    const char* outputPrefix;
+};
@@ -0,0 +1,32 @@
+/**
+ * @file ParameterUpdate.cpp
+ * @brief Recompute counters of the lazy coefficient protocol
+ */
+
+#include "ParameterUpdate.h"
+
+namespace {
+
+const char* const kCounterNames[ParameterUpdate::kNumCounters] = {
+    "envelope",
+    "ladder",
+    "stereo ladder"
+};
+
+} // namespace
+
+uint64_t ParameterUpdate::recomputes[ParameterUpdate::kNumCounters] = { 0 };
+
+void ParameterUpdate::resetCounts() {
+    for (int c = 0; c < kNumCounters; ++c)
+        recomputes[c] = 0;
+}
+
+void ParameterUpdate::report(FILE* out, double seconds) {
+    if (!(seconds > 0.0))
+        return;
+    fprintf(out, "Coefficient recomputes (per second of audio):\n");
+    for (int c = 0; c < kNumCounters; ++c)
+        fprintf(out, "  %-16s %9.1f/s  (%llu)\n", kCounterNames[c], recomputes[c] / seconds,
+                static_cast<unsigned long long>(recomputes[c]));
+}
@@ -0,0 +1,111 @@
+/**
+ * @file ParameterUpdate.h
+ * @brief Dirty-flag protocol for derived coefficients, with recompute counters
+ *
+ * Several modules derive coefficients from their parameters with real work:
+ * the envelope's segment coefficients (a log and an exp each), the ladder's
+ * pre-warp, the stereo ladder's spread ratios. render() calls their setters
+ * every period (and the ladders' once per sample in the DEV renders) with
+ * values that rarely change, so deriving inside the setter mostly repeats
+ * the last result.
+ *
+ * Every such module follows the same protocol instead:
+ *
+ * | Call        | Does                                                        |
+ * |-------------|-------------------------------------------------------------|
+ * | set...()    | Store the target; mark it dirty if changed() from the value |
+ * |             | the coefficients were last derived from                     |
+ * | process()   | If anything is dirty, derive from the targets once, record  |
+ * |             | the applied values and count() the recompute                |
+ *
+ * The comparison is against the applied value, not the previous target, so
+ * a control creeping in steps below the epsilon still recomputes once the
+ * accumulated change is large enough to matter. Setters never clear a flag:
+ * one flag may cover several parameters (a coefficient derived from two).
+ *
+ * @profiling
+ * Each recompute is counted per module. render() prints the counts as
+ * recomputes per second of audio at cleanup; a rate near the period rate
+ * means a control is being written with a changing value every period.
+ *
+ * @performance_characteristics
+ * - Setter: one compare against the applied value and a store
+ * - process(): one well-predicted branch when nothing changed
+ * - count(): one increment, only when a recompute happens
+ *
+ * @usage_example
+ * @code
+ * void Module::setRate(float rate) {
+ *     targetRate = rate;
+ *     if (ParameterUpdate::changed(rate, appliedRate, kRateEpsilon))
+ *         dirty = true;
+ * }
+ *
+ * float Module::process() {
+ *     if (dirty) {
+ *         coefficient = derive(targetRate);
+ *         appliedRate = targetRate;
+ *         dirty = false;
+ *         ParameterUpdate::count(ParameterUpdate::kModule);
+ *     }
+ *     ...
+ * }
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @class ParameterUpdate
+ * @brief Change test and per-module recompute counters shared by the modules
+ */
+class ParameterUpdate {
+public:
+    /**
+     * @enum Counter
+     * @brief Modules that count their recomputes
+     */
+    enum Counter {
+        kEnvelope = 0,      ///< ADSR segment coefficients (both envelopes)
+        kLadder,            ///< ZDFMoogLadderFilter pre-warp and feedback gain
+        kStereoLadder,      ///< StereoLadder spread ratios and output taps
+        kNumCounters
+    };
+
+    /**
+     * @brief True if a target differs from the applied value beyond epsilon
+     *
+     * @param relativeEpsilon Allowed difference as a fraction of the applied
+     *                        value; 0 recomputes on any change
+     */
+    static bool changed(float target, float applied, float relativeEpsilon) {
+        const float limit = relativeEpsilon * (applied < 0.0f ? -applied : applied);
+        const float difference = target - applied;
+        return difference > limit || difference < -limit || target != target;
+    }
+
+    /** @brief Record one recompute */
+    static void count(Counter counter) { ++recomputes[counter]; }
+
+    static uint64_t getCount(Counter counter) { return recomputes[counter]; }
+
+    static void resetCounts();
+
+    /**
+     * @brief Print each module's recomputes per second of audio
+     *
+     * @param seconds Audio time the counts cover
+     * @realtime_safety Non-real-time (stdio)
+     */
+    static void report(FILE* out, double seconds);
+
+private:
+    static uint64_t recomputes[kNumCounters];
+};
@@ -0,0 +1,266 @@
+/**
+ * @file PartitionedConvolver.cpp
+ * @brief Implementation of the partitioned cabinet convolver
+ */
+
+#include "PartitionedConvolver.h"
+#include "SimdLanes.h"
+
+namespace {
+
+/** Spectrum bins per bank and delay line: P·2B < 2L for every partition size */
+const unsigned int kSpectrumBins = 2 * PartitionedConvolver::kMaxIrFrames;
+
+bool isPartitionSize(unsigned int frames, unsigned int capacity) {
+    return frames >= 2 && frames <= capacity && (frames & (frames - 1)) == 0;
+}
+
+} // namespace
+
+PartitionedConvolver::PartitionedConvolver()
+    : impulse(nullptr), current(0), taps(nullptr), windowRe(nullptr), windowIm(nullptr), delayRe(nullptr),
+      delayIm(nullptr), accumulatorRe(nullptr), accumulatorIm(nullptr), wetLeft(nullptr), wetRight(nullptr),
+      tailLeft(nullptr), tailRight(nullptr), capacity(0), writeSlot(0), validSlots(0), mix(0.0f),
+      targetMix(0.0f) {
+    for (int b = 0; b < 2; ++b) {
+        banks[b].head = nullptr;
+        banks[b].spectrumRe = nullptr;
+        banks[b].spectrumIm = nullptr;
+        banks[b].partition = 0;
+        banks[b].partitions = 0;
+        banks[b].taps = 0;
+    }
+}
+
+size_t PartitionedConvolver::requiredBytes(unsigned int maxPartition) {
+    const size_t bank = (maxPartition + 2 * kSpectrumBins) * sizeof(float) + 3 * AudioArena::kAlignment;
+    const size_t state = (kMaxIrFrames + 2 * kSpectrumBins + 4 * 2 * maxPartition + 4 * maxPartition) * sizeof(float)
+                       + 11 * AudioArena::kAlignment;
+    return 2 * bank + state;
+}
+
+bool PartitionedConvolver::allocate(AudioArena& arena, unsigned int maxPartition) {
+    if (maxPartition > kMaxPartition)
+        return false;
+    for (int b = 0; b < 2; ++b) {
+        banks[b].head = arena.allocateFloats(maxPartition);
+        banks[b].spectrumRe = arena.allocateFloats(kSpectrumBins);
+        banks[b].spectrumIm = arena.allocateFloats(kSpectrumBins);
+        if (!banks[b].head || !banks[b].spectrumRe || !banks[b].spectrumIm)
+            return false;
+    }
+    taps = arena.allocateFloats(kMaxIrFrames);
+    delayRe = arena.allocateFloats(kSpectrumBins);
+    delayIm = arena.allocateFloats(kSpectrumBins);
+    windowRe = arena.allocateFloats(2 * maxPartition);
+    windowIm = arena.allocateFloats(2 * maxPartition);
+    accumulatorRe = arena.allocateFloats(2 * maxPartition);
+    accumulatorIm = arena.allocateFloats(2 * maxPartition);
+    wetLeft = arena.allocateFloats(maxPartition);
+    wetRight = arena.allocateFloats(maxPartition);
+    tailLeft = arena.allocateFloats(maxPartition);
+    tailRight = arena.allocateFloats(maxPartition);
+    if (!taps || !delayRe || !delayIm || !windowRe || !windowIm || !accumulatorRe || !accumulatorIm || !wetLeft
+        || !wetRight || !tailLeft || !tailRight)
+        return false;
+    capacity = maxPartition;
+    return true;
+}
+
+void PartitionedConvolver::setEnabled(bool enabled) {
+    if (enabled && mix == 0.0f && targetMix == 0.0f)
+        reset();
+    targetMix = enabled ? 1.0f : 0.0f;
+}
+
+bool PartitionedConvolver::prepareBypass() {
+    if (!taps)
+        return false;
+    Bank& bank = banks[1 - current];
+    bank.partition = 0;
+    bank.partitions = 0;
+    bank.taps = 0;
+    return true;
+}
+
+bool PartitionedConvolver::supportsPeriod(unsigned int periodFrames) const {
+    return isPartitionSize(periodFrames, capacity);
+}
+
+bool PartitionedConvolver::prepareConfiguration(float sampleRate, unsigned int periodFrames) {
+    if (!prepareBypass())
+        return false;
+    Bank& bank = banks[1 - current];
+    if (!isPartitionSize(periodFrames, capacity) || !impulse)
+        return true;
+
+    const unsigned int length = impulse->render(taps, kMaxIrFrames, sampleRate);
+    if (length == 0)
+        return true;
+    const unsigned int block = periodFrames;
+    const unsigned int size = 2 * block;
+
+    for (unsigned int i = 0; i < block; ++i) {
+        const unsigned int tap = block - 1 - i;
+        bank.head[i] = tap < length ? taps[tap] : 0.0f;
+    }
+
+    /** Partition p holds taps [B(p + 1), B(p + 2)), zero-padded to 2B */
+    const unsigned int partitions = length > block ? (length - 1) / block : 0;
+    const float scale = 1.0f / static_cast<float>(size);
+    for (unsigned int p = 0; p < partitions; ++p) {
+        float* re = bank.spectrumRe + p * size;
+        float* im = bank.spectrumIm + p * size;
+        const unsigned int first = block * (p + 1);
+        for (unsigned int i = 0; i < size; ++i) {
+            re[i] = i < block && first + i < length ? taps[first + i] * scale : 0.0f;
+            im[i] = 0.0f;
+        }
+        fft.forward(re, im, size);
+    }
+
+    bank.partition = block;
+    bank.partitions = partitions;
+    bank.taps = length;
+    return true;
+}
+
+void PartitionedConvolver::commitConfiguration() {
+    current = 1 - current;
+    reset();
+}
+
+void PartitionedConvolver::reset() {
+    if (!windowRe)
+        return;
+    for (unsigned int i = 0; i < 2 * capacity; ++i) {
+        windowRe[i] = 0.0f;
+        windowIm[i] = 0.0f;
+    }
+    for (unsigned int i = 0; i < capacity; ++i) {
+        tailLeft[i] = 0.0f;
+        tailRight[i] = 0.0f;
+    }
+    /** Delay-line slots are not cleared: none is read before it is rewritten */
+    writeSlot = 0;
+    validSlots = 0;
+}
+
+void PartitionedConvolver::process(float* left, float* right, unsigned int frames) {
+    if (mix == 0.0f && targetMix == 0.0f)
+        return;
+    const Bank& bank = banks[current];
+    if (bank.partition == 0 || frames != bank.partition)
+        return;
+    const unsigned int block = bank.partition;
+
+    /** Slide the two-block window and append this period */
+    for (unsigned int n = 0; n < block; ++n) {
+        windowRe[n] = windowRe[block + n];
+        windowIm[n] = windowIm[block + n];
+        windowRe[block + n] = left[n];
+        windowIm[block + n] = right[n];
+    }
+
+    /** Head now plus tail from the previous period, crossfaded against dry */
+    convolveHead(bank, wetLeft, wetRight);
+    const float step = (targetMix - mix) / static_cast<float>(block);
+    float wet = mix;
+    for (unsigned int n = 0; n < block; ++n) {
+        wet += step;
+        left[n] += (wetLeft[n] + tailLeft[n] - left[n]) * wet;
+        right[n] += (wetRight[n] + tailRight[n] - right[n]) * wet;
+    }
+    mix = targetMix;
+
+    if (bank.partitions == 0)
+        return;
+
+    /** Tail for the next period: transform the window into the delay line */
+    const unsigned int size = 2 * block;
+    float* slotRe = delayRe + writeSlot * size;
+    float* slotIm = delayIm + writeSlot * size;
+    for (unsigned int i = 0; i < size; ++i) {
+        slotRe[i] = windowRe[i];
+        slotIm[i] = windowIm[i];
+    }
+    fft.forward(slotRe, slotIm, size);
+    if (validSlots < bank.partitions)
+        ++validSlots;
+
+    accumulateTail(bank, writeSlot);
+    fft.inverse(accumulatorRe, accumulatorIm, size);
+
+    /** Overlap-save: the second half of the circular result is linear */
+    for (unsigned int n = 0; n < block; ++n) {
+        tailLeft[n] = accumulatorRe[block + n];
+        tailRight[n] = accumulatorIm[block + n];
+    }
+    if (++writeSlot == bank.partitions)
+        writeSlot = 0;
+}
+
+void PartitionedConvolver::convolveHead(const Bank& bank, float* outLeft, float* outRight) const {
+    const unsigned int block = bank.partition;
+    const float* head = bank.head;
+
+    /** y[n] = Σ h[j]·x[n − j] = Σ head[i]·window[n + 1 + i] with head reversed */
+    if (fft.getBackend() == SplitFft::kSimd && (block & 3) == 0) {
+        for (unsigned int n = 0; n < block; ++n) {
+            const float* inLeft = windowRe + n + 1;
+            const float* inRight = windowIm + n + 1;
+            vfloat4 sumLeft = vf4_dup(0.0f);
+            vfloat4 sumRight = vf4_dup(0.0f);
+            for (unsigned int i = 0; i < block; i += 4) {
+                const vfloat4 tap = vf4_load(head + i);
+                sumLeft = vf4_mla(sumLeft, vf4_load(inLeft + i), tap);
+                sumRight = vf4_mla(sumRight, vf4_load(inRight + i), tap);
+            }
+            outLeft[n] = vf4_hsum(sumLeft);
+            outRight[n] = vf4_hsum(sumRight);
+        }
+        return;
+    }
+    for (unsigned int n = 0; n < block; ++n) {
+        const float* inLeft = windowRe + n + 1;
+        const float* inRight = windowIm + n + 1;
+        float sumLeft = 0.0f;
+        float sumRight = 0.0f;
+        for (unsigned int i = 0; i < block; ++i) {
+            sumLeft += head[i] * inLeft[i];
+            sumRight += head[i] * inRight[i];
+        }
+        outLeft[n] = sumLeft;
+        outRight[n] = sumRight;
+    }
+}
+
+void PartitionedConvolver::accumulateTail(const Bank& bank, unsigned int slot) {
+    const unsigned int size = 2 * bank.partition;
+    for (unsigned int k = 0; k < size; ++k) {
+        accumulatorRe[k] = 0.0f;
+        accumulatorIm[k] = 0.0f;
+    }
+
+    /** Partition p meets the window from p periods ago; older slots wrap */
+    for (unsigned int p = 0; p < validSlots; ++p) {
+        const unsigned int source = slot >= p ? slot - p : slot + bank.partitions - p;
+        const float* xr = delayRe + source * size;
+        const float* xi = delayIm + source * size;
+        const float* hr = bank.spectrumRe + p * size;
+        const float* hi = bank.spectrumIm + p * size;
+        if (fft.getBackend() == SplitFft::kSimd) {
+            for (unsigned int k = 0; k < size; k += 4) {
+                const vfloat4 ar = vf4_load(xr + k), ai = vf4_load(xi + k);
+                const vfloat4 br = vf4_load(hr + k), bi = vf4_load(hi + k);
+                vf4_store(accumulatorRe + k, vf4_mls(vf4_mla(vf4_load(accumulatorRe + k), ar, br), ai, bi));
+                vf4_store(accumulatorIm + k, vf4_mla(vf4_mla(vf4_load(accumulatorIm + k), ar, bi), ai, br));
+            }
+        } else {
+            for (unsigned int k = 0; k < size; ++k) {
+                accumulatorRe[k] += xr[k] * hr[k] - xi[k] * hi[k];
+                accumulatorIm[k] += xr[k] * hi[k] + xi[k] * hr[k];
+            }
+        }
+    }
+}
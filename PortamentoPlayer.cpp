@@ -9,6 +9,7 @@
  */
 
 #include "PortamentoPlayer.h"
+#include "TableBank.h"
 #include <cmath>
 
 /**
@@ -22,12 +23,58 @@
  * valid frequency values.
  */
 PortamentoPlayer::PortamentoPlayer(float sampleRate, float defaultPortamentoTimeMs)
-    : sampleRate(sampleRate), portamentoTimeMs(defaultPortamentoTimeMs) {
+    : sampleRate(sampleRate), stagedSampleRate(sampleRate), portamentoTimeMs(defaultPortamentoTimeMs) {
     currentFreq = targetFreq = 0.0f;
     incrementPerSample = 0.0f;
     noteIsOn = false;
 }
 
+/**
+ * @brief Stage a new sample rate for glide timing
+ * 
+ * Glide increments are derived per note, so only the rate itself is staged.
+ */
+bool PortamentoPlayer::prepareSampleRate(float newSampleRate) {
+    if (newSampleRate <= 0.0f)
+        return false;
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+/**
+ * @brief Adopt the staged sample rate
+ */
+void PortamentoPlayer::commitSampleRate() {
+    sampleRate = stagedSampleRate;
+}
+
+/**
+ * @brief Copy out the glide state
+ */
+void PortamentoPlayer::saveSnapshot(Snapshot& snapshot) const {
+    snapshot.currentNote = currentNote;
+    snapshot.sampleRate = sampleRate;
+    snapshot.currentFreq = currentFreq;
+    snapshot.targetFreq = targetFreq;
+    snapshot.incrementPerSample = incrementPerSample;
+    snapshot.portamentoTimeMs = portamentoTimeMs;
+    snapshot.noteIsOn = noteIsOn;
+}
+
+/**
+ * @brief Restore a saved glide state; nothing stays staged
+ */
+void PortamentoPlayer::loadSnapshot(const Snapshot& snapshot) {
+    currentNote = snapshot.currentNote;
+    sampleRate = snapshot.sampleRate;
+    stagedSampleRate = snapshot.sampleRate;
+    currentFreq = snapshot.currentFreq;
+    targetFreq = snapshot.targetFreq;
+    incrementPerSample = snapshot.incrementPerSample;
+    portamentoTimeMs = snapshot.portamentoTimeMs;
+    noteIsOn = snapshot.noteIsOn;
+}
+
 /**
  * @brief Update portamento timing parameter
  * 
@@ -132,12 +179,11 @@ void PortamentoPlayer::noteOff() {
  * - Suitable for professional audio applications
  * 
  * @performance_characteristics
- * - Single pow() function call: ~10-20 CPU cycles on modern processors
- * - FPU pipeline friendly: no conditional branching
- * - Cache efficient: no memory access required
+ * - Notes 0-127: one lookup in the embedded note table (TableBank.h)
+ * - Out-of-range notes fall back to tableExp2(), still without powf()
  */
 float PortamentoPlayer::midiToFreq(int midiNote) {
-    return 440.0f * powf(2.0f, (midiNote - 69) / 12.0f);
+    return noteToFrequency(midiNote);
 }
 
 /**
@@ -348,4 +394,5 @@ float PortamentoPlayer::process() {
  * This implementation represents a balance of computational efficiency,
  * musical accuracy, and real-time performance suitable for professional
  * audio applications requiring smooth pitch transitions and expressive
- * musical control.
\ No newline at end of file
+ * musical control.
+ */
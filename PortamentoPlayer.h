@@ -259,6 +259,48 @@ public:
      * @endcode
      */
     float process();
+    
+    /**
+     * @brief Stage a new sample rate for glide timing
+     * 
+     * @param newSampleRate New audio sample rate in Hz
+     * @return false for a non-positive rate
+     * @realtime_safety Call off the audio thread (see ReconfigurePipeline)
+     */
+    bool prepareSampleRate(float newSampleRate);
+    
+    /**
+     * @brief Adopt the staged sample rate
+     * 
+     * A glide already in progress keeps its per-sample increment; the new
+     * rate applies from the next noteOn().
+     * 
+     * @realtime_safety Real-time safe
+     */
+    void commitSampleRate();
+    
+    /**
+     * @struct Snapshot
+     * @brief Complete glide state, including a glide in progress
+     * 
+     * Used by the overrun post-mortem to record where a block started and
+     * by the host replay to start from the same point.
+     */
+    struct Snapshot {
+        int currentNote;
+        float sampleRate;
+        float currentFreq;
+        float targetFreq;
+        float incrementPerSample;
+        float portamentoTimeMs;
+        bool noteIsOn;
+    };
+    
+    /** @brief Copy the glide state out (real-time safe) */
+    void saveSnapshot(Snapshot& snapshot) const;
+    
+    /** @brief Resume from a saved glide state (real-time safe) */
+    void loadSnapshot(const Snapshot& snapshot);
 
 private:
     /**
@@ -301,6 +343,9 @@ private:
      */
     float sampleRate;
     
+    /** @brief Sample rate staged by prepareSampleRate() */
+    float stagedSampleRate;
+    
     /**
      * @brief Current instantaneous frequency in Hz
      * 
@@ -0,0 +1,99 @@
+/**
+ * @file PostFxChain.cpp
+ * @brief Implementation of the post-FX chain and its CPU accounting
+ */
+
+#include "PostFxChain.h"
+#include <time.h>
+
+namespace {
+
+inline uint64_t nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace
+
+PostFxChain::PostFxChain() : sampleRate(44100.0f), stagedSampleRate(44100.0f) {
+    const char* names[kNumStages] = { "chorus", "delay", "limiter" };
+    const float budgets[kNumStages] = { kChorusBudget, kDelayBudget, kLimiterBudget };
+    for (int s = 0; s < kNumStages; ++s) {
+        costs[s].name = names[s];
+        costs[s].budget = budgets[s];
+        costs[s].busyNs = 0.0;
+        costs[s].audioNs = 0.0;
+        costs[s].worst = 0.0f;
+        costs[s].blocks = 0;
+        costs[s].overBudget = 0;
+    }
+}
+
+size_t PostFxChain::requiredBytes(float maxSampleRate) {
+    return StereoChorus::requiredBytes(maxSampleRate) + TempoDelay::requiredBytes(maxSampleRate)
+         + LookaheadLimiter::requiredBytes(maxSampleRate);
+}
+
+bool PostFxChain::allocate(AudioArena& arena, float maxSampleRate) {
+    return chorus.allocate(arena, maxSampleRate) && delay.allocate(arena, maxSampleRate)
+        && limiter.allocate(arena, maxSampleRate);
+}
+
+bool PostFxChain::prepareSampleRate(float newSampleRate) {
+    if (!chorus.prepareSampleRate(newSampleRate) || !delay.prepareSampleRate(newSampleRate)
+        || !limiter.prepareSampleRate(newSampleRate))
+        return false;
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+void PostFxChain::commitSampleRate() {
+    sampleRate = stagedSampleRate;
+    chorus.commitSampleRate();
+    delay.commitSampleRate();
+    limiter.commitSampleRate();
+}
+
+void PostFxChain::process(float* left, float* right, unsigned int frames) {
+    if (frames == 0)
+        return;
+    const double blockNs = frames * 1e9 / sampleRate;
+
+    const uint64_t start = nowNs();
+    chorus.process(left, right, frames);
+    const uint64_t chorusEnd = nowNs();
+    delay.process(left, right, frames);
+    const uint64_t delayEnd = nowNs();
+    limiter.process(left, right, frames);
+    const uint64_t limiterEnd = nowNs();
+
+    account(kChorus, start, chorusEnd, blockNs);
+    account(kDelay, chorusEnd, delayEnd, blockNs);
+    account(kLimiter, delayEnd, limiterEnd, blockNs);
+}
+
+void PostFxChain::account(int stage, uint64_t startNs, uint64_t endNs, double blockNs) {
+    StageCost& cost = costs[stage];
+    const double busy = static_cast<double>(endNs - startNs);
+    const float share = static_cast<float>(busy / blockNs);
+    cost.busyNs += busy;
+    cost.audioNs += blockNs;
+    ++cost.blocks;
+    if (share > cost.worst)
+        cost.worst = share;
+    if (share > cost.budget)
+        ++cost.overBudget;
+}
+
+void PostFxChain::report(FILE* out) const {
+    if (costs[kChorus].blocks == 0)
+        return;
+    fprintf(out, "Post-FX CPU (share of real time):\n");
+    for (int s = 0; s < kNumStages; ++s) {
+        const StageCost& cost = costs[s];
+        fprintf(out, "  %-8s mean %6.3f%%  worst %6.3f%%  budget %5.2f%%  over budget %u of %u blocks\n",
+                cost.name, 100.0 * cost.busyNs / cost.audioNs, 100.0f * cost.worst, 100.0f * cost.budget,
+                cost.overBudget, cost.blocks);
+    }
+}
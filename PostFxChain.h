@@ -0,0 +1,146 @@
+/**
+ * @file PostFxChain.h
+ * @brief Chorus, tempo delay and lookahead limiter between the voice and the DAC
+ *
+ * The voice used to go from the ladder's output gain straight to
+ * audioWrite(). PostFxChain processes each period's stereo output in place,
+ * in three stages:
+ * 1. StereoChorus: quadrature-swept modulated delay, widens the voice
+ * 2. TempoDelay: damped feedback echo, free or synced to the beat
+ * 3. LookaheadLimiter: keeps the result under the ceiling, softly
+ *
+ * Every buffer comes from the audio arena in setup(), sized for the highest
+ * supported rate, so nothing is allocated afterwards and a rate change only
+ * recomputes coefficients (the rate is applied through the reconfiguration
+ * pipeline like every other rate-dependent module).
+ *
+ * @cpu_budget
+ * Each stage carries a budget as a share of real time: the time it may
+ * spend per block divided by the block's duration. process() times each
+ * stage on the monotonic clock (four clock reads per block) and keeps the
+ * mean, the worst block and the count of blocks over budget; report()
+ * prints them at cleanup(), so every session on the board doubles as a
+ * measurement.
+ *
+ * | Stage   | Host, ns/frame | Budget (share of real time) |
+ * |---------|----------------|-----------------------------|
+ * | chorus  | 10.2           | 2.0% (kChorusBudget)        |
+ * | delay   | 4.4            | 1.5% (kDelayBudget)         |
+ * | limiter | 10.6           | 2.0% (kLimiterBudget)       |
+ *
+ * Host figures: DEV/KernelCounterBench.cpp (fx-*), x86-64, g++ -O3, 128-frame
+ * blocks. The budgets allow for a Cortex-A8 twenty times slower per frame
+ * than the host, with 2x headroom on top (a frame at 48 kHz is 20.8 µs).
+ * The delay's share is set apart from its arithmetic: its 2 MB line does not
+ * fit the board's L2, so every block streams fresh lines from DRAM.
+ *
+ * @usage_example
+ * @code
+ * // setup():
+ * arenaConfig.extraBytes += PostFxChain::requiredBytes(kMaxSupportedSampleRate);
+ * postFx.allocate(audioArena, kMaxSupportedSampleRate);
+ *
+ * // render(), after the voice:
+ * postFx.getDelay().setBeatSamples(sequencer.getBeatSamples(now));
+ * postFx.process(left, right, frames);
+ *
+ * // cleanup():
+ * postFx.report(stdout);
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "LookaheadLimiter.h"
+#include "StereoChorus.h"
+#include "TempoDelay.h"
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @class PostFxChain
+ * @brief The three post-FX stages with per-stage CPU accounting
+ */
+class PostFxChain {
+public:
+    /**
+     * @enum Stage
+     * @brief Processing order
+     */
+    enum Stage {
+        kChorus = 0,
+        kDelay,
+        kLimiter,
+        kNumStages
+    };
+
+    /** @brief Per-stage budgets, share of real time */
+    static constexpr float kChorusBudget = 0.02f;
+    static constexpr float kDelayBudget = 0.015f;
+    static constexpr float kLimiterBudget = 0.02f;
+
+    /**
+     * @struct StageCost
+     * @brief Measured cost of one stage since setup()
+     */
+    struct StageCost {
+        const char* name;
+        float budget;               ///< Share of real time allowed
+        double busyNs;              ///< Time spent in the stage
+        double audioNs;             ///< Duration of the audio it processed
+        float worst;                ///< Highest share of real time in one block
+        unsigned int blocks;
+        unsigned int overBudget;    ///< Blocks above the budget
+    };
+
+    PostFxChain();
+
+    /** @brief Arena bytes for all three stages at the highest rate */
+    static size_t requiredBytes(float maxSampleRate);
+
+    /**
+     * @brief Take every stage's buffers from the arena
+     *
+     * @return false if the arena cannot hold them
+     * @realtime_safety Non-real-time safe (setup())
+     */
+    bool allocate(AudioArena& arena, float maxSampleRate);
+
+    StereoChorus& getChorus() { return chorus; }
+    TempoDelay& getDelay() { return delay; }
+    LookaheadLimiter& getLimiter() { return limiter; }
+
+    bool prepareSampleRate(float newSampleRate);
+    void commitSampleRate();
+
+    /**
+     * @brief Run the three stages over a block, in place
+     *
+     * @realtime_safety Real-time safe
+     */
+    void process(float* left, float* right, unsigned int frames);
+
+    const StageCost& getCost(int stage) const { return costs[stage]; }
+
+    /**
+     * @brief Print each stage's mean and worst cost against its budget
+     *
+     * @realtime_safety Non-real-time (stdio)
+     */
+    void report(FILE* out) const;
+
+private:
+    void account(int stage, uint64_t startNs, uint64_t endNs, double blockNs);
+
+    StereoChorus chorus;
+    TempoDelay delay;
+    LookaheadLimiter limiter;
+
+    float sampleRate;
+    float stagedSampleRate;
+    StageCost costs[kNumStages];
+};
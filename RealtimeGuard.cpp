@@ -0,0 +1,524 @@
+/**
+ * @file RealtimeGuard.cpp
+ * @brief Interposers and violation table for RealtimeGuard
+ *
+ * Compiled to nothing unless TR123E_RT_GUARD is defined. The interposers
+ * are ordinary definitions of the libc symbols in the executable, so the
+ * dynamic linker binds every caller (libstdc++'s operator new included) to
+ * them first. Allocation forwards to glibc's __libc_* entry points; the
+ * rest forwards to the next definition found with dlsym(RTLD_NEXT).
+ */
+
+#include "RealtimeGuard.h"
+
+#ifdef TR123E_RT_GUARD
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <new>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/select.h>
+#include <time.h>
+#include <unistd.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+}
+
+namespace {
+
+const unsigned int kMaxViolations = 256;
+const int kMaxFrames = 12;
+
+/**
+ * @struct Violation
+ * @brief One recorded call: what, how big, and from where
+ */
+struct Violation {
+    RealtimeGuard::Kind kind;
+    size_t bytes;
+    int frameCount;
+    void* frames[kMaxFrames];
+};
+
+Violation violations[kMaxViolations];
+std::atomic<unsigned int> violationCount(0);
+std::atomic<bool> abortOnViolation(false);
+
+/**
+ * Thread-local state lives in the executable's static TLS block, so reading
+ * it never allocates, even from inside malloc
+ */
+thread_local int realtimeDepth = 0;
+thread_local bool recording = false;
+
+/**
+ * @brief Real libc entry points for everything not reached through __libc_*
+ */
+struct RealFunctions {
+    ssize_t (*read)(int, void*, size_t);
+    ssize_t (*write)(int, const void*, size_t);
+    int (*open)(const char*, int, ...);
+    int (*openat)(int, const char*, int, ...);
+    int (*close)(int);
+    int (*poll)(struct pollfd*, nfds_t, int);
+    int (*select)(int, fd_set*, fd_set*, fd_set*, struct timeval*);
+    FILE* (*fopen)(const char*, const char*);
+    int (*fclose)(FILE*);
+    size_t (*fread)(void*, size_t, size_t, FILE*);
+    size_t (*fwrite)(const void*, size_t, size_t, FILE*);
+    int (*fflush)(FILE*);
+    int (*puts)(const char*);
+    int (*putchar)(int);
+    int (*vprintf)(const char*, va_list);
+    int (*vfprintf)(FILE*, const char*, va_list);
+    int (*nanosleep)(const struct timespec*, struct timespec*);
+    int (*clock_nanosleep)(clockid_t, int, const struct timespec*, struct timespec*);
+    int (*usleep)(useconds_t);
+    unsigned int (*sleep)(unsigned int);
+    int (*pthread_mutex_lock)(pthread_mutex_t*);
+    int (*pthread_cond_wait)(pthread_cond_t*, pthread_mutex_t*);
+    int (*sem_wait)(sem_t*);
+};
+
+RealFunctions real;
+
+template <typename Function>
+void resolve(Function& function, const char* name) {
+    if (!function)
+        function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+
+void resolveAll() {
+    resolve(real.read, "read");
+    resolve(real.write, "write");
+    resolve(real.open, "open");
+    resolve(real.openat, "openat");
+    resolve(real.close, "close");
+    resolve(real.poll, "poll");
+    resolve(real.select, "select");
+    resolve(real.fopen, "fopen");
+    resolve(real.fclose, "fclose");
+    resolve(real.fread, "fread");
+    resolve(real.fwrite, "fwrite");
+    resolve(real.fflush, "fflush");
+    resolve(real.puts, "puts");
+    resolve(real.putchar, "putchar");
+    resolve(real.vprintf, "vprintf");
+    resolve(real.vfprintf, "vfprintf");
+    resolve(real.nanosleep, "nanosleep");
+    resolve(real.clock_nanosleep, "clock_nanosleep");
+    resolve(real.usleep, "usleep");
+    resolve(real.sleep, "sleep");
+    resolve(real.pthread_mutex_lock, "pthread_mutex_lock");
+    resolve(real.pthread_cond_wait, "pthread_cond_wait");
+    resolve(real.sem_wait, "sem_wait");
+}
+
+/**
+ * Resolve before main(), and call backtrace() once so its lazy load of the
+ * unwinder (which allocates) never happens inside render()
+ */
+__attribute__((constructor(101))) void initialiseGuard() {
+    resolveAll();
+    void* frames[2];
+    backtrace(frames, 2);
+    const char* setting = getenv("TR123E_RT_GUARD_ABORT");
+    if (setting && setting[0] == '1')
+        abortOnViolation.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * A call made before the constructor ran (static initialisers) is resolved
+ * on the spot; none of them can be on the audio thread yet
+ */
+template <typename Function>
+Function& lookup(Function& function, const char* name) {
+    if (!function)
+        resolve(function, name);
+    return function;
+}
+
+inline void check(RealtimeGuard::Kind kind, size_t bytes = 0) {
+    if (realtimeDepth > 0 && !recording)
+        RealtimeGuard::check(kind, bytes);
+}
+
+} // namespace
+
+// ============================================================================
+// RealtimeGuard
+// ============================================================================
+
+void RealtimeGuard::enter() {
+    ++realtimeDepth;
+}
+
+void RealtimeGuard::leave() {
+    --realtimeDepth;
+}
+
+unsigned int RealtimeGuard::getViolationCount() {
+    return violationCount.load(std::memory_order_relaxed);
+}
+
+void RealtimeGuard::setAbortOnViolation(bool abortOnViolation) {
+    ::abortOnViolation.store(abortOnViolation, std::memory_order_relaxed);
+}
+
+const char* RealtimeGuard::getKindName(Kind kind) {
+    static const char* const names[kNumKinds] = {
+        "allocation", "deallocation", "stdio", "file I/O", "sleep", "lock"
+    };
+    return (kind >= 0 && kind < kNumKinds) ? names[kind] : "?";
+}
+
+void RealtimeGuard::check(Kind kind, size_t bytes) {
+    /**
+     * Recording must not re-enter itself: backtrace() and abort() can both
+     * reach intercepted functions
+     */
+    recording = true;
+    const unsigned int index = violationCount.fetch_add(1, std::memory_order_relaxed);
+    if (index < kMaxViolations) {
+        Violation& violation = violations[index];
+        violation.kind = kind;
+        violation.bytes = bytes;
+        violation.frameCount = backtrace(violation.frames, kMaxFrames);
+    }
+    if (abortOnViolation.load(std::memory_order_relaxed)) {
+        static const char message[] = "RealtimeGuard: real-time violation, aborting\n";
+        if (real.write)
+            real.write(2, message, sizeof(message) - 1);
+        abort();
+    }
+    recording = false;
+}
+
+void RealtimeGuard::report(FILE* out) {
+    const unsigned int total = getViolationCount();
+    const unsigned int stored = (total < kMaxViolations) ? total : kMaxViolations;
+    if (total == 0) {
+        fprintf(out, "RealtimeGuard: no real-time violations\n");
+        return;
+    }
+    fprintf(out, "RealtimeGuard: %u real-time violation%s", total, total == 1 ? "" : "s");
+    if (total > stored)
+        fprintf(out, " (first %u kept)", stored);
+    fprintf(out, "\n");
+
+    /**
+     * Group by call site: same kind, same return addresses. Frame 0 is
+     * check() and frame 1 the interposer, both the same for every entry
+     */
+    bool reported[kMaxViolations] = {};
+    for (unsigned int i = 0; i < stored; ++i) {
+        if (reported[i])
+            continue;
+        const Violation& first = violations[i];
+        unsigned int count = 0;
+        size_t maxBytes = 0;
+        for (unsigned int j = i; j < stored; ++j) {
+            const Violation& other = violations[j];
+            if (reported[j] || other.kind != first.kind || other.frameCount != first.frameCount
+                || memcmp(other.frames, first.frames, sizeof(void*) * first.frameCount) != 0)
+                continue;
+            reported[j] = true;
+            ++count;
+            if (other.bytes > maxBytes)
+                maxBytes = other.bytes;
+        }
+
+        fprintf(out, "\n  %u × %s", count, getKindName(first.kind));
+        if (maxBytes)
+            fprintf(out, " (up to %zu bytes)", maxBytes);
+        fprintf(out, "\n");
+        char** symbols = backtrace_symbols(first.frames, first.frameCount);
+        for (int f = 2; f < first.frameCount; ++f)
+            fprintf(out, "    #%d %s\n", f - 2, symbols ? symbols[f] : "?");
+        free(symbols);
+    }
+}
+
+// ============================================================================
+// Allocation
+// ============================================================================
+
+extern "C" {
+
+void* malloc(size_t size) {
+    check(RealtimeGuard::kAllocation, size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    check(RealtimeGuard::kAllocation, count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    check(RealtimeGuard::kAllocation, size);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) {
+    if (pointer)
+        check(RealtimeGuard::kDeallocation);
+    __libc_free(pointer);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) {
+    check(RealtimeGuard::kAllocation, size);
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+    void* pointer = __libc_memalign(alignment, size);
+    if (!pointer)
+        return ENOMEM;
+    *result = pointer;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    check(RealtimeGuard::kAllocation, size);
+    return __libc_memalign(alignment, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    check(RealtimeGuard::kAllocation, size);
+    return __libc_memalign(alignment, size);
+}
+
+} // extern "C"
+
+/**
+ * operator new is interposed as well, so the reported site is the caller
+ * of new rather than libstdc++'s wrapper around malloc
+ */
+namespace {
+
+void* allocateOrThrow(size_t size) {
+    check(RealtimeGuard::kAllocation, size);
+    void* pointer = __libc_malloc(size ? size : 1);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void release(void* pointer) {
+    if (pointer)
+        check(RealtimeGuard::kDeallocation);
+    __libc_free(pointer);
+}
+
+} // namespace
+
+void* operator new(size_t size) { return allocateOrThrow(size); }
+void* operator new[](size_t size) { return allocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    check(RealtimeGuard::kAllocation, size);
+    return __libc_malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    check(RealtimeGuard::kAllocation, size);
+    return __libc_malloc(size ? size : 1);
+}
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+
+#if __cpp_aligned_new
+namespace {
+
+void* allocateAlignedOrThrow(size_t size, std::align_val_t alignment) {
+    check(RealtimeGuard::kAllocation, size);
+    void* pointer = __libc_memalign(static_cast<size_t>(alignment), size ? size : 1);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+} // namespace
+
+void* operator new(size_t size, std::align_val_t alignment) { return allocateAlignedOrThrow(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateAlignedOrThrow(size, alignment); }
+void operator delete(void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { release(pointer); }
+#endif
+
+// ============================================================================
+// Blocking calls
+// ============================================================================
+
+extern "C" {
+
+ssize_t read(int fd, void* buffer, size_t count) {
+    check(RealtimeGuard::kFileIo, count);
+    return lookup(real.read, "read")(fd, buffer, count);
+}
+
+ssize_t write(int fd, const void* buffer, size_t count) {
+    check(RealtimeGuard::kFileIo, count);
+    return lookup(real.write, "write")(fd, buffer, count);
+}
+
+int open(const char* path, int flags, ...) {
+    check(RealtimeGuard::kFileIo);
+    mode_t mode = 0;
+    if (flags & (O_CREAT | O_TMPFILE)) {
+        va_list arguments;
+        va_start(arguments, flags);
+        mode = static_cast<mode_t>(va_arg(arguments, int));
+        va_end(arguments);
+    }
+    return lookup(real.open, "open")(path, flags, mode);
+}
+
+int openat(int directory, const char* path, int flags, ...) {
+    check(RealtimeGuard::kFileIo);
+    mode_t mode = 0;
+    if (flags & (O_CREAT | O_TMPFILE)) {
+        va_list arguments;
+        va_start(arguments, flags);
+        mode = static_cast<mode_t>(va_arg(arguments, int));
+        va_end(arguments);
+    }
+    return lookup(real.openat, "openat")(directory, path, flags, mode);
+}
+
+int close(int fd) {
+    check(RealtimeGuard::kFileIo);
+    return lookup(real.close, "close")(fd);
+}
+
+int poll(struct pollfd* fds, nfds_t count, int timeout) {
+    check(RealtimeGuard::kFileIo);
+    return lookup(real.poll, "poll")(fds, count, timeout);
+}
+
+int select(int count, fd_set* readSet, fd_set* writeSet, fd_set* exceptSet, struct timeval* timeout) {
+    check(RealtimeGuard::kFileIo);
+    return lookup(real.select, "select")(count, readSet, writeSet, exceptSet, timeout);
+}
+
+FILE* fopen(const char* path, const char* mode) {
+    check(RealtimeGuard::kStdio);
+    return lookup(real.fopen, "fopen")(path, mode);
+}
+
+int fclose(FILE* stream) {
+    check(RealtimeGuard::kStdio);
+    return lookup(real.fclose, "fclose")(stream);
+}
+
+size_t fread(void* buffer, size_t size, size_t count, FILE* stream) {
+    check(RealtimeGuard::kStdio, size * count);
+    return lookup(real.fread, "fread")(buffer, size, count, stream);
+}
+
+size_t fwrite(const void* buffer, size_t size, size_t count, FILE* stream) {
+    check(RealtimeGuard::kStdio, size * count);
+    return lookup(real.fwrite, "fwrite")(buffer, size, count, stream);
+}
+
+int fflush(FILE* stream) {
+    check(RealtimeGuard::kStdio);
+    return lookup(real.fflush, "fflush")(stream);
+}
+
+int puts(const char* text) {
+    check(RealtimeGuard::kStdio);
+    return lookup(real.puts, "puts")(text);
+}
+
+int putchar(int character) {
+    check(RealtimeGuard::kStdio);
+    return lookup(real.putchar, "putchar")(character);
+}
+
+int printf(const char* format, ...) {
+    check(RealtimeGuard::kStdio);
+    va_list arguments;
+    va_start(arguments, format);
+    const int result = lookup(real.vprintf, "vprintf")(format, arguments);
+    va_end(arguments);
+    return result;
+}
+
+int fprintf(FILE* stream, const char* format, ...) {
+    check(RealtimeGuard::kStdio);
+    va_list arguments;
+    va_start(arguments, format);
+    const int result = lookup(real.vfprintf, "vfprintf")(stream, format, arguments);
+    va_end(arguments);
+    return result;
+}
+
+int vprintf(const char* format, va_list arguments) {
+    check(RealtimeGuard::kStdio);
+    return lookup(real.vprintf, "vprintf")(format, arguments);
+}
+
+int vfprintf(FILE* stream, const char* format, va_list arguments) {
+    check(RealtimeGuard::kStdio);
+    return lookup(real.vfprintf, "vfprintf")(stream, format, arguments);
+}
+
+int nanosleep(const struct timespec* duration, struct timespec* remaining) {
+    check(RealtimeGuard::kSleep);
+    return lookup(real.nanosleep, "nanosleep")(duration, remaining);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const struct timespec* duration, struct timespec* remaining) {
+    check(RealtimeGuard::kSleep);
+    return lookup(real.clock_nanosleep, "clock_nanosleep")(clock, flags, duration, remaining);
+}
+
+int usleep(useconds_t microseconds) {
+    check(RealtimeGuard::kSleep);
+    return lookup(real.usleep, "usleep")(microseconds);
+}
+
+unsigned int sleep(unsigned int seconds) {
+    check(RealtimeGuard::kSleep);
+    return lookup(real.sleep, "sleep")(seconds);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    check(RealtimeGuard::kLock);
+    return lookup(real.pthread_mutex_lock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex) {
+    check(RealtimeGuard::kLock);
+    return lookup(real.pthread_cond_wait, "pthread_cond_wait")(condition, mutex);
+}
+
+int sem_wait(sem_t* semaphore) {
+    check(RealtimeGuard::kLock);
+    return lookup(real.sem_wait, "sem_wait")(semaphore);
+}
+
+} // extern "C"
+
+#endif // TR123E_RT_GUARD
@@ -0,0 +1,121 @@
+/**
+ * @file RealtimeGuard.h
+ * @brief Debug-build detector for allocations and blocking calls on the audio thread
+ *
+ * A container that grows, a std::string that is copied, or a printf left in
+ * from debugging all work on a desk and turn into dropouts on stage: each
+ * one allocates or makes a system call, and on Bela a system call from the
+ * audio thread is a mode switch out of the real-time domain.
+ *
+ * Built with -DTR123E_RT_GUARD, the guard interposes on
+ * - operator new/delete and malloc/calloc/realloc/free/posix_memalign
+ * - stdio (printf, fprintf, puts, fwrite, fflush, fopen, ...)
+ * - file and socket I/O (open, read, write, close, poll, select)
+ * - sleeping and locking (nanosleep, usleep, pthread_mutex_lock,
+ *   pthread_cond_wait, sem_wait)
+ * and, while the calling thread is inside a RealtimeScope (all of
+ * render()), records the call with a short backtrace into a fixed,
+ * lock-free table. Other threads are never affected. report() prints the
+ * distinct call sites from cleanup(); getViolationCount() lets a host
+ * replay (DEV/SessionReplay.cpp) fail the run.
+ * Setting TR123E_RT_GUARD_ABORT=1 in the environment aborts at the first
+ * violation instead, for a core dump at the exact spot.
+ *
+ * Without TR123E_RT_GUARD every function here is an empty inline and the
+ * guard costs nothing.
+ *
+ * @build
+ * @code
+ * # Host replay with the guard (symbols need -rdynamic):
+ * g++ -O1 -g -std=c++14 -DTR123E_RT_GUARD -rdynamic -IDEV/HostShim -I. -IDEV \
+ *     DEV/SessionReplay.cpp DEV/PerfCounters.cpp $(ls *.cpp) -ldl -o session-replay-guard
+ * # On the board: make PROJECT=TR123e CPPFLAGS="-DTR123E_RT_GUARD -rdynamic"
+ * @endcode
+ *
+ * @limitations
+ * - glibc only (it forwards to __libc_malloc and dlsym(RTLD_NEXT))
+ * - glibc calls its own I/O internally (printf's write is not seen, the
+ *   printf is), but its allocations do go through the interposers: a
+ *   first printf also reports stdout's buffer
+ * - Xenomai's wrapped services (__wrap_pthread_mutex_lock, rt_printf) are
+ *   real-time safe and deliberately not intercepted
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <cstdio>
+
+/**
+ * @class RealtimeGuard
+ * @brief Real-time-safety violation recorder (static interface)
+ */
+class RealtimeGuard {
+public:
+    /**
+     * @enum Kind
+     * @brief What the audio thread called
+     */
+    enum Kind {
+        kAllocation = 0,    ///< new, malloc, calloc, realloc, posix_memalign
+        kDeallocation,      ///< delete, free
+        kStdio,             ///< printf family, fopen, fwrite, fflush, ...
+        kFileIo,            ///< open, read, write, close, poll, select
+        kSleep,             ///< nanosleep, usleep, sleep
+        kLock,              ///< pthread_mutex_lock, pthread_cond_wait, sem_wait
+        kNumKinds
+    };
+
+#ifdef TR123E_RT_GUARD
+    /** @brief Mark the calling thread as real-time (nests) */
+    static void enter();
+    static void leave();
+
+    /** @brief Violations recorded so far (including ones the table had no room for) */
+    static unsigned int getViolationCount();
+
+    /**
+     * @brief Print each distinct call site with its count and backtrace
+     *
+     * @realtime_safety Non-real-time (allocates for symbol names)
+     */
+    static void report(FILE* out);
+
+    /** @brief Abort on the first violation (also TR123E_RT_GUARD_ABORT=1) */
+    static void setAbortOnViolation(bool abortOnViolation);
+
+    /** @brief Called by the interposers; public for them only */
+    static void check(Kind kind, size_t bytes);
+
+    static const char* getKindName(Kind kind);
+#else
+    static void enter() {}
+    static void leave() {}
+    static unsigned int getViolationCount() { return 0; }
+    static void report(FILE*) {}
+    static void setAbortOnViolation(bool) {}
+#endif
+};
+
+/**
+ * @class RealtimeScope
+ * @brief Marks a block of code as audio-thread code for RealtimeGuard
+ *
+ * @usage_example
+ * @code
+ * void render(BelaContext* context, void* userData) {
+ *     RealtimeScope realtimeScope;
+ *     ...
+ * }
+ * @endcode
+ */
+class RealtimeScope {
+public:
+    RealtimeScope() { RealtimeGuard::enter(); }
+    ~RealtimeScope() { RealtimeGuard::leave(); }
+    RealtimeScope(const RealtimeScope&) = delete;
+    RealtimeScope& operator=(const RealtimeScope&) = delete;
+};
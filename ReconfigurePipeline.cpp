@@ -0,0 +1,139 @@
+/**
+ * @file ReconfigurePipeline.cpp
+ * @brief Implementation of the two-phase reconfiguration pipeline
+ */
+
+#include "ReconfigurePipeline.h"
+
+ReconfigurePipeline::ReconfigurePipeline()
+    : numListeners(0), state(kIdle), rejectedCount(0), requestedListener(nullptr), rejectedListener(nullptr) {
+    for (int i = 0; i < kMaxListeners; ++i)
+        listeners[i] = nullptr;
+    requestedRate.sampleRate = 0.0f;
+    requestedRate.periodFrames = 0;
+    requestedRate.audioRateModulation = false;
+    activeRate = requestedRate;
+    rejectedRate = requestedRate;
+    rejectedListenerRate = requestedRate;
+}
+
+bool ReconfigurePipeline::addListener(RateListener* listener) {
+    if (listener == nullptr || numListeners >= kMaxListeners)
+        return false;
+    listeners[numListeners++] = listener;
+    return true;
+}
+
+bool ReconfigurePipeline::reconfigureNow(const EngineRate& rate) {
+    if (!prepareAll(rate))
+        return false;
+    commitAll();
+    activeRate = rate;
+    state.store(kIdle, std::memory_order_release);
+    return true;
+}
+
+namespace {
+
+bool sameRate(const EngineRate& a, const EngineRate& b) {
+    return a.sampleRate == b.sampleRate && a.periodFrames == b.periodFrames
+        && a.audioRateModulation == b.audioRateModulation;
+}
+
+} // namespace
+
+bool ReconfigurePipeline::request(const EngineRate& rate) {
+    if (sameRate(rate, activeRate))
+        return false;
+    return claim(rate, nullptr);
+}
+
+bool ReconfigurePipeline::refresh(RateListener* listener) {
+    return listener != nullptr && claim(activeRate, listener);
+}
+
+bool ReconfigurePipeline::claim(const EngineRate& rate, RateListener* listener) {
+    /**
+     * Only one change in flight: claim the idle state before writing the
+     * request so prepare() never sees a half-written configuration.
+     * A configuration that was already rejected is not retried, nor is a
+     * refresh its listener rejected at the same configuration.
+     */
+    int expected = kIdle;
+    if (!state.compare_exchange_strong(expected, kPreparing, std::memory_order_acquire))
+        return false;
+    const bool rejected = listener ? (listener == rejectedListener && sameRate(rate, rejectedListenerRate))
+                                   : sameRate(rate, rejectedRate);
+    if (rejected) {
+        state.store(kIdle, std::memory_order_release);
+        return false;
+    }
+    requestedRate = rate;
+    requestedListener = listener;
+    state.store(kPending, std::memory_order_release);
+    return true;
+}
+
+void ReconfigurePipeline::prepare() {
+    int expected = kPending;
+    if (!state.compare_exchange_strong(expected, kPreparing, std::memory_order_acquire))
+        return;
+
+    const bool prepared = requestedListener ? requestedListener->prepareRate(requestedRate)
+                                            : prepareAll(requestedRate);
+    if (prepared) {
+        state.store(kReady, std::memory_order_release);
+    }
+    else {
+        /**
+         * Rejected: drop the request and remember it, so render() detecting
+         * the same mismatch every block does not reschedule it forever. A
+         * rejected refresh is remembered for its listener only: its rate is
+         * the active one, which a later change back to it must not find
+         * rejected
+         */
+        if (requestedListener) {
+            rejectedListener = requestedListener;
+            rejectedListenerRate = requestedRate;
+        }
+        else {
+            rejectedRate = requestedRate;
+        }
+        rejectedCount.fetch_add(1, std::memory_order_relaxed);
+        state.store(kIdle, std::memory_order_release);
+    }
+}
+
+bool ReconfigurePipeline::commitIfReady() {
+    if (state.load(std::memory_order_relaxed) != kReady)
+        return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    /**
+     * A full change prepared every listener again, so a refresh rejected
+     * before it may be tried again
+     */
+    if (requestedListener) {
+        requestedListener->commitRate();
+    }
+    else {
+        commitAll();
+        rejectedListener = nullptr;
+    }
+    activeRate = requestedRate;
+    state.store(kIdle, std::memory_order_release);
+    return true;
+}
+
+bool ReconfigurePipeline::prepareAll(const EngineRate& rate) {
+    for (int i = 0; i < numListeners; ++i) {
+        if (!listeners[i]->prepareRate(rate))
+            return false;
+    }
+    return true;
+}
+
+void ReconfigurePipeline::commitAll() {
+    for (int i = 0; i < numListeners; ++i)
+        listeners[i]->commitRate();
+}
@@ -0,0 +1,229 @@
+/**
+ * @file ReconfigurePipeline.h
+ * @brief Two-phase sample-rate and block-size reconfiguration for all modules
+ *
+ * Every module whose coefficients depend on the sample rate (or the engine
+ * block size) registers with the pipeline. A change is applied in two phases:
+ *
+ * 1. **Prepare** (auxiliary task, non-real-time): each module computes its
+ *    new coefficients into private staging members. Transcendental maths,
+ *    table rebuilds and validation all happen here.
+ * 2. **Commit** (audio thread, block boundary): once every module has
+ *    prepared, render() calls commitIfReady() and each module adopts its
+ *    staged values with plain assignments. No module ever runs a block with
+ *    a mix of old and new coefficients.
+ *
+ * setup() uses the same path synchronously through reconfigureNow(), so the
+ * initial configuration and a later change share one code path.
+ *
+ * @thread_model
+ * A single atomic state word hands the staged data from the preparing thread
+ * to the audio thread (release on publish, acquire on commit). Staging
+ * members are written only while the state is kPreparing and read only when
+ * it is kReady, so no further locking is needed.
+ *
+ * @performance_characteristics
+ * - commitIfReady() when idle: one relaxed atomic load
+ * - Commit: O(modules) assignments, no allocation, no system calls
+ * - Listener capacity is fixed at construction (kMaxListeners)
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <atomic>
+
+/**
+ * @struct EngineRate
+ * @brief Rate-related engine configuration
+ */
+struct EngineRate {
+    float sampleRate;           ///< Audio sample rate in Hz
+    unsigned int periodFrames;  ///< Hardware period in frames
+    bool audioRateModulation;   ///< Modulation quality switch (see ModulationLayer)
+};
+
+/**
+ * @class RateListener
+ * @brief Interface implemented by anything holding rate-dependent state
+ */
+class RateListener {
+public:
+    virtual ~RateListener() {}
+
+    /**
+     * @brief Compute new coefficients into staging storage
+     *
+     * Runs off the audio thread. Must not touch state the audio thread reads.
+     *
+     * @param rate Requested configuration
+     * @return false to reject the configuration (nothing is committed)
+     */
+    virtual bool prepareRate(const EngineRate& rate) = 0;
+
+    /**
+     * @brief Adopt the staged coefficients
+     *
+     * Runs on the audio thread between blocks; O(1), real-time safe.
+     */
+    virtual void commitRate() = 0;
+};
+
+/**
+ * @class ModuleRateBinding
+ * @brief RateListener adapter for modules with prepare/commitSampleRate()
+ *
+ * DSP modules expose `bool prepareSampleRate(float)` / `void commitSampleRate()`
+ * rather than inheriting from RateListener, so they stay free of virtual
+ * calls on the audio path. This adapter registers one with the pipeline.
+ *
+ * A module ticked by a control-rate modulation source runs at
+ * fs / controlInterval, or at fs when the configuration asks for audio-rate
+ * modulation; the binding hands it that rate instead of the audio rate.
+ *
+ * @tparam Module Any type providing prepareSampleRate() and commitSampleRate()
+ */
+template <typename Module>
+class ModuleRateBinding : public RateListener {
+public:
+    explicit ModuleRateBinding(Module& module, unsigned int controlInterval = 1)
+        : module(module), controlInterval(controlInterval) {}
+
+    bool prepareRate(const EngineRate& rate) override {
+        const unsigned int divider = rate.audioRateModulation ? 1u : controlInterval;
+        return module.prepareSampleRate(rate.sampleRate / static_cast<float>(divider));
+    }
+
+    void commitRate() override {
+        module.commitSampleRate();
+    }
+
+private:
+    Module& module;
+    unsigned int controlInterval;
+};
+
+/**
+ * @class ReconfigurePipeline
+ * @brief Collects rate listeners and sequences prepare/commit
+ *
+ * @usage_example
+ * @code
+ * ModuleRateBinding<ResonanceRamp> rampBinding(resonanceRamp);
+ * pipeline.addListener(&rampBinding);               // setup()
+ * pipeline.reconfigureNow({ sampleRate, frames, false });  // setup()
+ *
+ * // render(): detect a change, prepare in an auxiliary task, commit later
+ * if (pipeline.request(newRate))
+ *     Bela_scheduleAuxiliaryTask(reconfigureTask);  // task calls pipeline.prepare()
+ * pipeline.commitIfReady();
+ * @endcode
+ */
+class ReconfigurePipeline {
+public:
+    /** @brief Maximum number of registered listeners */
+    static const int kMaxListeners = 16;
+
+    ReconfigurePipeline();
+
+    /**
+     * @brief Register a listener (setup only, before audio starts)
+     * @return false if the listener table is full
+     */
+    bool addListener(RateListener* listener);
+
+    /**
+     * @brief Prepare and commit immediately on the calling thread
+     *
+     * For setup(), where no audio is running yet.
+     *
+     * @return false if any listener rejected the configuration
+     */
+    bool reconfigureNow(const EngineRate& rate);
+
+    /**
+     * @brief Ask for a new configuration (audio or control thread)
+     *
+     * @return true if the request was accepted and prepare() should now be
+     *         scheduled; false if a change is already in flight or the
+     *         configuration is already active
+     */
+    bool request(const EngineRate& rate);
+
+    /**
+     * @brief Ask for the active configuration to be prepared again for one listener
+     *
+     * For work a listener leaves out of reconfigureNow() in setup() and
+     * completes on the auxiliary task. Only that listener is prepared and
+     * committed; the others keep their state.
+     *
+     * @return true if prepare() should now be scheduled; false if a change
+     *         is already in flight or the listener already rejected this
+     *         configuration
+     */
+    bool refresh(RateListener* listener);
+
+    /**
+     * @brief Run the prepare phase for the pending request
+     *
+     * Call from an auxiliary task. Does nothing if no request is pending.
+     */
+    void prepare();
+
+    /**
+     * @brief Commit staged state if preparation has finished
+     *
+     * Call at the top of render(), before any DSP runs.
+     *
+     * @return true if a new configuration was committed in this call
+     */
+    bool commitIfReady();
+
+    /** @brief Configuration currently in effect */
+    const EngineRate& getActiveRate() const { return activeRate; }
+
+    /** @brief Number of requests rejected by a listener since construction */
+    unsigned int getRejectedCount() const { return rejectedCount.load(std::memory_order_relaxed); }
+
+private:
+    enum State {
+        kIdle = 0,
+        kPending,
+        kPreparing,
+        kReady
+    };
+
+    /** @brief Claim the idle state and publish the pending request */
+    bool claim(const EngineRate& rate, RateListener* listener);
+
+    bool prepareAll(const EngineRate& rate);
+    void commitAll();
+
+    RateListener* listeners[kMaxListeners];
+    int numListeners;
+
+    std::atomic<int> state;
+    std::atomic<unsigned int> rejectedCount;
+
+    /** @brief Written by request() while idle, read by prepare() */
+    EngineRate requestedRate;
+
+    /** @brief Sole listener of a refresh(), nullptr for all; as requestedRate */
+    RateListener* requestedListener;
+
+    /** @brief Touched only by the thread that commits */
+    EngineRate activeRate;
+
+    /** @brief Last configuration a listener rejected (not retried) */
+    EngineRate rejectedRate;
+
+    /**
+     * @brief Last refresh rejected and the configuration it was for; not
+     *        retried until a full change commits
+     */
+    RateListener* rejectedListener;
+    EngineRate rejectedListenerRate;
+};
@@ -29,7 +29,7 @@
  * will complete exactly one full parameter transition from 0.0 to 1.0.
  */
 ResonanceRamp::ResonanceRamp(float rate, float rampTimeMs)
-    : sampleRate(rate), currentValue(0.5f), targetValue(0.5f) {
+    : sampleRate(rate), currentValue(0.5f), targetValue(0.5f), rampTimeMs(rampTimeMs) {
     /**
      * Calculate increment per sample for linear interpolation
      * Formula: 1.0 / (rampTimeMs * 0.001 * sampleRate)
@@ -38,6 +38,8 @@ ResonanceRamp::ResonanceRamp(float rate, float rampTimeMs)
      * The reciprocal provides step size for normalized [0.0-1.0] parameter range
      */
     incrementPerSample = 1.0f / (rampTimeMs * 0.001f * sampleRate);
+    stagedSampleRate = sampleRate;
+    stagedIncrement = incrementPerSample;
 }
 
 /**
@@ -116,3 +118,48 @@ float ResonanceRamp::process() {
     return currentValue;
 }
 
+/**
+ * @brief Stage the ramp increment for a new sample rate
+ * 
+ * Same derivation as the constructor; the division runs here, off the audio
+ * thread, so commitSampleRate() is a plain copy.
+ */
+bool ResonanceRamp::prepareSampleRate(float newSampleRate) {
+    if (newSampleRate <= 0.0f)
+        return false;
+    stagedSampleRate = newSampleRate;
+    stagedIncrement = 1.0f / (rampTimeMs * 0.001f * newSampleRate);
+    return true;
+}
+
+/**
+ * @brief Adopt the staged sample rate and increment
+ */
+void ResonanceRamp::commitSampleRate() {
+    sampleRate = stagedSampleRate;
+    incrementPerSample = stagedIncrement;
+}
+
+/**
+ * @brief Copy out the ramp state
+ */
+void ResonanceRamp::saveSnapshot(Snapshot& snapshot) const {
+    snapshot.sampleRate = sampleRate;
+    snapshot.currentValue = currentValue;
+    snapshot.targetValue = targetValue;
+    snapshot.incrementPerSample = incrementPerSample;
+    snapshot.rampTimeMs = rampTimeMs;
+}
+
+/**
+ * @brief Restore a saved ramp state; nothing stays staged
+ */
+void ResonanceRamp::loadSnapshot(const Snapshot& snapshot) {
+    sampleRate = snapshot.sampleRate;
+    currentValue = snapshot.currentValue;
+    targetValue = snapshot.targetValue;
+    incrementPerSample = snapshot.incrementPerSample;
+    rampTimeMs = snapshot.rampTimeMs;
+    stagedSampleRate = snapshot.sampleRate;
+    stagedIncrement = snapshot.incrementPerSample;
+}
@@ -184,6 +184,45 @@ public:
      * @endcode
      */
     float process();
+    
+    /**
+     * @brief Stage the ramp increment for a new sample rate
+     * 
+     * Computes the per-sample increment for the configured ramp time at the
+     * new rate without touching the live value (see ReconfigurePipeline).
+     * 
+     * @param newSampleRate New audio sample rate in Hz
+     * @return false for a non-positive rate
+     * @realtime_safety Call off the audio thread
+     */
+    bool prepareSampleRate(float newSampleRate);
+    
+    /**
+     * @brief Adopt the increment staged by prepareSampleRate()
+     * 
+     * The ramp continues from its current value at the new speed.
+     * 
+     * @realtime_safety Real-time safe (two assignments)
+     */
+    void commitSampleRate();
+    
+    /**
+     * @struct Snapshot
+     * @brief Ramp position, target and speed
+     */
+    struct Snapshot {
+        float sampleRate;
+        float currentValue;
+        float targetValue;
+        float incrementPerSample;
+        float rampTimeMs;
+    };
+    
+    /** @brief Copy the ramp state out (real-time safe) */
+    void saveSnapshot(Snapshot& snapshot) const;
+    
+    /** @brief Continue from a saved ramp state (real-time safe) */
+    void loadSnapshot(const Snapshot& snapshot);
 
 private:
     /**
@@ -226,5 +265,16 @@ private:
      * @direction Positive for upward ramps, negative for downward ramps
      */
     float incrementPerSample;
+    
+    /**
+     * @brief Ramp duration in milliseconds, kept for sample-rate changes
+     */
+    float rampTimeMs;
+    
+    /** @brief Sample rate staged by prepareSampleRate() */
+    float stagedSampleRate;
+    
+    /** @brief Increment staged by prepareSampleRate() */
+    float stagedIncrement;
 };
 
@@ -0,0 +1,145 @@
+/**
+ * @file SampleRate.h
+ * @brief Compile-time sample-rate traits and table-driven cutoff pre-warp
+ *
+ * The per-sample synthesis path used to divide by the runtime sample rate
+ * in the oscillator phase increment and call tanf(π·fc/fs) on every cutoff
+ * update. This header makes the sample rate a template parameter instead:
+ * every rate-derived constant is a compile-time value, the cutoff pre-warp
+ * comes from a table evaluated by the compiler, and setup() selects the
+ * matching instantiation of the render path once.
+ *
+ * @supported_rates
+ * 44100, 48000, 88200 and 96000 Hz. Any other rate is rejected by
+ * isSupportedSampleRate(), so setup() can fail cleanly instead of silently
+ * running with wrong constants.
+ *
+ * @prewarp_table
+ * The ZDF ladder needs G = tan(π·fc/fs) and the stage gain 1/(1+G). Both are
+ * tabulated (kPrewarpTable, embedded by TableBank.h) over the normalised angle θ = π·fc/fs ∈ [0, 0.45π] (the filter's
+ * own cutoff limit of 0.45·fs), which makes the table itself rate-independent;
+ * each rate only contributes a compile-time Hz-to-index scale. Linear
+ * interpolation over 512 segments keeps the relative error of G below 1e-4
+ * across the range (worst case just below the 0.45·fs limit where tan is
+ * steepest), i.e. well under one cent of cutoff.
+ *
+ * @performance_characteristics
+ * - prewarp(): one multiply, one float-to-int conversion, two table lookups
+ *   and two interpolations, replacing tanf() plus two divisions
+ * - prewarpCutoff(): the same lookup for a rate known only at run time
+ *   (ZDFMoogLadderFilter::setCutoff()), at the cost of one division
+ * - Table: 2 × 513 floats (4 KB), built entirely at compile time
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "TableBank.h"
+
+/**
+ * @struct WarpedCutoff
+ * @brief Pre-warped ZDF coefficients for one cutoff frequency
+ */
+struct WarpedCutoff {
+    float g;            ///< tan(π·fc/fs)
+    float stageGain;    ///< 1 / (1 + g)
+};
+
+/**
+ * @struct SampleRateTraits
+ * @brief Rate-derived constants for one supported sample rate
+ *
+ * @tparam Rate Sample rate in Hz (44100, 48000, 88200 or 96000)
+ *
+ * @usage_example
+ * @code
+ * typedef SampleRateTraits<48000> Rate;
+ * phase += freq * Rate::kTwoPiOverRate;             // no division
+ * WarpedCutoff w = Rate::prewarp(cutoffHz);          // no tanf
+ * filter.setWarpedCutoff(w.g, w.stageGain);
+ * @endcode
+ */
+template <int Rate>
+struct SampleRateTraits {
+    static_assert(Rate == 44100 || Rate == 48000 || Rate == 88200 || Rate == 96000,
+                  "Unsupported sample rate");
+
+    static constexpr float kRate = static_cast<float>(Rate);
+    static constexpr float kInvRate = static_cast<float>(1.0 / Rate);
+    static constexpr float kTwoPiOverRate = static_cast<float>(2.0 * constexpr_math::kPi / Rate);
+    static constexpr float kSamplesPerMs = static_cast<float>(Rate / 1000.0);
+
+    /** @brief Cutoff range accepted by prewarp(), matching ZDFMoogLadderFilter */
+    static constexpr float kMinCutoffHz = 20.0f;
+    static constexpr float kMaxCutoffHz = static_cast<float>(kPrewarpMaxRatio * Rate);
+
+    /** @brief Hz-to-table-position scale */
+    static constexpr float kCutoffToIndex = static_cast<float>(kPrewarpSegments / (kPrewarpMaxRatio * Rate));
+
+    /**
+     * @brief Look up ZDF coefficients for a cutoff frequency
+     *
+     * @param cutoffHz Cutoff in Hz; clamped to [20, 0.45·fs]
+     * @return Pre-warped G and stage gain 1/(1+G)
+     */
+    static WarpedCutoff prewarp(float cutoffHz);
+};
+
+/**
+ * @brief Interpolate the pre-warp table at a position in [0, kPrewarpSegments]
+ */
+inline WarpedCutoff interpolatePrewarp(float position) {
+    int index = static_cast<int>(position);
+    if (index >= kPrewarpSegments)
+        index = kPrewarpSegments - 1;
+    const float frac = position - static_cast<float>(index);
+
+    WarpedCutoff result;
+    result.g = kPrewarpTable.g[index] + frac * (kPrewarpTable.g[index + 1] - kPrewarpTable.g[index]);
+    result.stageGain = kPrewarpTable.stageGain[index]
+                     + frac * (kPrewarpTable.stageGain[index + 1] - kPrewarpTable.stageGain[index]);
+    return result;
+}
+
+template <int Rate>
+inline WarpedCutoff SampleRateTraits<Rate>::prewarp(float cutoffHz) {
+    if (cutoffHz < kMinCutoffHz)
+        cutoffHz = kMinCutoffHz;
+    if (cutoffHz > kMaxCutoffHz)
+        cutoffHz = kMaxCutoffHz;
+    return interpolatePrewarp(cutoffHz * kCutoffToIndex);
+}
+
+/**
+ * @brief Pre-warp for a sample rate known only at run time
+ *
+ * @param cutoffHz Cutoff in Hz; clamped to [20, 0.45·sampleRate]
+ * @param sampleRate Any positive rate
+ */
+inline WarpedCutoff prewarpCutoff(float cutoffHz, float sampleRate) {
+    const float maxCutoffHz = static_cast<float>(kPrewarpMaxRatio) * sampleRate;
+    if (cutoffHz > maxCutoffHz)
+        cutoffHz = maxCutoffHz;
+    if (cutoffHz < 20.0f)
+        cutoffHz = 20.0f;
+    return interpolatePrewarp(cutoffHz * (kPrewarpSegments / maxCutoffHz));
+}
+
+/**
+ * @brief Highest supported rate; buffers whose length is a time (delay
+ *        lines, lookahead) are sized for it so a rate change never reallocates
+ */
+const float kMaxSupportedSampleRate = 96000.0f;
+
+/**
+ * @brief True for the rates that have a SampleRateTraits instantiation
+ *
+ * @param sampleRate Rate reported by the audio context, in Hz
+ */
+inline bool isSupportedSampleRate(float sampleRate) {
+    const int rate = static_cast<int>(sampleRate + 0.5f);
+    return rate == 44100 || rate == 48000 || rate == 88200 || rate == 96000;
+}
@@ -0,0 +1,331 @@
+/**
+ * @file SessionRecorder.cpp
+ * @brief Implementation of the session recorder
+ */
+
+#include "SessionRecorder.h"
+#include "AudioArena.h"
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = { 'T', '3', 'S', 'E' };
+
+inline uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline uint64_t zigzag(int32_t value) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(value)) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+}
+
+inline unsigned int putFloat(uint8_t* out, float value) {
+    const uint32_t bits = floatBits(value);
+    out[0] = static_cast<uint8_t>(bits);
+    out[1] = static_cast<uint8_t>(bits >> 8);
+    out[2] = static_cast<uint8_t>(bits >> 16);
+    out[3] = static_cast<uint8_t>(bits >> 24);
+    return 4;
+}
+
+/**
+ * @brief ADC codes are multiples of 2^-16 in [0, 1]; scaling by a power of
+ *        two is exact, so the round trip through the integer is too
+ */
+inline bool quantise(float value, int32_t& code) {
+    const float scaled = value * 65536.0f;
+    if (!(scaled >= 0.0f && scaled <= 65536.0f))
+        return false;
+    code = static_cast<int32_t>(scaled);
+    return static_cast<float>(code) == scaled;
+}
+
+} // namespace
+
+SessionRecorder::SessionRecorder()
+    : ring(nullptr), mask(0), head(0), tail(0), lostBlocks(0), pendingLoss(false),
+      tag(0), frame(0), sampleRate(0.0f), audioFrames(0), analogFrames(0), analogChannels(0),
+      nextFrame(0), configKnown(false), midiLength(0), midiCount(0), analogRecorded(0),
+      outputHash(kHashSeed), blocksSinceCheckpoint(0),
+      file(nullptr), enabled(true), outputPrefix("tr123e-session") {
+    for (unsigned int c = 0; c < kMaxChannels; ++c) {
+        analog[c] = 0.0f;
+        lastAnalog[c] = 0.0f;
+        lastQuantised[c] = 0;
+    }
+}
+
+SessionRecorder::~SessionRecorder() {
+    if (file)
+        fclose(file);
+}
+
+size_t SessionRecorder::requiredBytes(unsigned int ringBytes) {
+    return ringBytes + AudioArena::kAlignment;
+}
+
+bool SessionRecorder::allocate(unsigned int ringBytes, AudioArena& arena) {
+    if (ringBytes < 4 * kMaxRecordBytes || (ringBytes & (ringBytes - 1)) != 0)
+        return false;
+    ring = static_cast<uint8_t*>(arena.allocateBytes(ringBytes));
+    if (!ring)
+        return false;
+    mask = ringBytes - 1;
+    return true;
+}
+
+bool SessionRecorder::open() {
+    if (!enabled || !ring || file)
+        return false;
+
+    /**
+     * Never overwrite an earlier session: take the first free index
+     */
+    char path[256];
+    for (unsigned int n = 0; n < 10000 && !file; ++n) {
+        snprintf(path, sizeof(path), "%s-%u.t3s", outputPrefix, n);
+        FILE* existing = fopen(path, "rb");
+        if (existing) {
+            fclose(existing);
+            continue;
+        }
+        file = fopen(path, "wb");
+        if (!file)
+            return false;
+    }
+    if (!file)
+        return false;
+
+    SessionFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.checkpointBlocks = kCheckpointBlocks;
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        file = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Audio thread
+// ============================================================================
+
+void SessionRecorder::beginBlock(uint64_t frame, float sampleRate, unsigned int audioFrames,
+                                 unsigned int analogFrames, unsigned int analogChannels) {
+    tag = 0;
+    midiLength = 0;
+    midiCount = 0;
+    analogRecorded = 0;
+    if (!file)
+        return;
+
+    /**
+     * Anything the replay cannot infer from the previous block goes in a
+     * config section
+     */
+    if (!configKnown || pendingLoss || frame != nextFrame || sampleRate != this->sampleRate
+        || audioFrames != this->audioFrames || analogFrames != this->analogFrames
+        || analogChannels != this->analogChannels)
+        tag |= kTagConfig;
+    this->frame = frame;
+    this->sampleRate = sampleRate;
+    this->audioFrames = audioFrames;
+    this->analogFrames = analogFrames;
+    this->analogChannels = analogChannels;
+    nextFrame = frame + audioFrames;
+    configKnown = true;
+}
+
+void SessionRecorder::recordMidi(unsigned int offset, const uint8_t* bytes, unsigned int count) {
+    if (!file || count == 0)
+        return;
+    if (count > 3)
+        count = 3;
+
+    /**
+     * Offset varint (≤ 5 bytes), status, data count, data
+     */
+    if (midiLength + 5 + 1 + count > sizeof(midiBytes)) {
+        pendingLoss = true;
+        return;
+    }
+    midiLength += putVarint(midiBytes + midiLength, offset);
+    midiBytes[midiLength++] = bytes[0];
+    midiBytes[midiLength++] = static_cast<uint8_t>(count - 1);
+    for (unsigned int i = 1; i < count; ++i)
+        midiBytes[midiLength++] = bytes[i];
+    ++midiCount;
+    tag |= kTagMidi;
+}
+
+void SessionRecorder::recordAnalog(const float* frame, unsigned int channels) {
+    if (!file)
+        return;
+    if (channels > kMaxChannels)
+        channels = kMaxChannels;
+    for (unsigned int c = 0; c < channels; ++c)
+        analog[c] = frame[c];
+    analogRecorded = channels;
+}
+
+void SessionRecorder::recordOutput(const float* output, unsigned int frames) {
+    if (file)
+        outputHash = hashWords(output, frames, outputHash);
+}
+
+bool SessionRecorder::endBlock() {
+    if (!file)
+        return false;
+
+    uint8_t record[kMaxRecordBytes];
+    unsigned int length = 1;
+
+    /**
+     * A dropped block leaves the decoder's analog history behind; both sides
+     * restart it from zero at the block carrying kTagLoss
+     */
+    if (pendingLoss) {
+        tag |= kTagLoss | kTagConfig;
+        for (unsigned int c = 0; c < kMaxChannels; ++c) {
+            lastAnalog[c] = 0.0f;
+            lastQuantised[c] = 0;
+        }
+    }
+
+    if (tag & kTagConfig) {
+        length += putVarint(record + length, frame);
+        length += putFloat(record + length, sampleRate);
+        length += putVarint(record + length, audioFrames);
+        length += putVarint(record + length, analogFrames);
+        length += putVarint(record + length, analogChannels);
+    }
+
+    if (tag & kTagMidi) {
+        length += putVarint(record + length, midiCount);
+        memcpy(record + length, midiBytes, midiLength);
+        length += midiLength;
+    }
+
+    /**
+     * Analog: only channels whose value changed, each as a delta code
+     */
+    uint8_t changed = 0;
+    for (unsigned int c = 0; c < analogRecorded; ++c)
+        if (floatBits(analog[c]) != floatBits(lastAnalog[c]))
+            changed |= static_cast<uint8_t>(1u << c);
+    if (changed) {
+        tag |= kTagAnalog;
+        record[length++] = changed;
+        for (unsigned int c = 0; c < analogRecorded; ++c) {
+            if (!(changed & (1u << c)))
+                continue;
+            int32_t code;
+            if (quantise(analog[c], code)) {
+                length += putVarint(record + length, zigzag(code - lastQuantised[c]) << 1);
+                lastQuantised[c] = code;
+            }
+            else {
+                record[length++] = 1;
+                length += putFloat(record + length, analog[c]);
+            }
+            lastAnalog[c] = analog[c];
+        }
+    }
+
+    if (++blocksSinceCheckpoint == kCheckpointBlocks) {
+        tag |= kTagCheckpoint;
+        const uint32_t hash = outputHash;
+        record[length++] = static_cast<uint8_t>(hash);
+        record[length++] = static_cast<uint8_t>(hash >> 8);
+        record[length++] = static_cast<uint8_t>(hash >> 16);
+        record[length++] = static_cast<uint8_t>(hash >> 24);
+        blocksSinceCheckpoint = 0;
+        outputHash = kHashSeed;
+    }
+
+    record[0] = tag;
+    pendingLoss = false;
+    pushRecord(record, length);
+
+    const unsigned int pending = head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+    return pending >= (mask + 1) / 8;
+}
+
+void SessionRecorder::pushRecord(const uint8_t* bytes, unsigned int count) {
+    const unsigned int h = head.load(std::memory_order_relaxed);
+    if (mask + 1 - (h - tail.load(std::memory_order_acquire)) < count) {
+        lostBlocks.fetch_add(1, std::memory_order_relaxed);
+        pendingLoss = true;
+        return;
+    }
+    const unsigned int start = h & mask;
+    const unsigned int first = (count < mask + 1 - start) ? count : mask + 1 - start;
+    memcpy(ring + start, bytes, first);
+    memcpy(ring, bytes + first, count - first);
+    head.store(h + count, std::memory_order_release);
+}
+
+// ============================================================================
+// Writer task
+// ============================================================================
+
+void SessionRecorder::write() {
+    if (!file)
+        return;
+    const unsigned int h = head.load(std::memory_order_acquire);
+    const unsigned int t = tail.load(std::memory_order_relaxed);
+    const unsigned int count = h - t;
+    if (count == 0)
+        return;
+
+    const unsigned int start = t & mask;
+    const unsigned int first = (count < mask + 1 - start) ? count : mask + 1 - start;
+    fwrite(ring + start, 1, first, file);
+    fwrite(ring, 1, count - first, file);
+    tail.store(h, std::memory_order_release);
+}
+
+void SessionRecorder::close() {
+    if (!file)
+        return;
+    write();
+    fclose(file);
+    file = nullptr;
+}
+
+// ============================================================================
+// Encoding helpers
+// ============================================================================
+
+unsigned int SessionRecorder::putVarint(uint8_t* out, uint64_t value) {
+    unsigned int length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+unsigned int SessionRecorder::getVarint(const uint8_t* in, unsigned int available, uint64_t& value) {
+    value = 0;
+    for (unsigned int i = 0; i < available && i < 10; ++i) {
+        value |= static_cast<uint64_t>(in[i] & 0x7F) << (7 * i);
+        if (!(in[i] & 0x80))
+            return i + 1;
+    }
+    return 0;
+}
+
+uint32_t SessionRecorder::hashWords(const float* samples, unsigned int count, uint32_t hash) {
+    for (unsigned int i = 0; i < count; ++i) {
+        hash ^= floatBits(samples[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,242 @@
+/**
+ * @file SessionRecorder.h
+ * @brief Continuous record of render() input for bit-exact host replay
+ *
+ * Records everything render() consumes, so a whole gig can be replayed on
+ * a desktop (DEV/SessionReplay.cpp) and performance work measured on real
+ * input:
+ * - every MIDI message, with its frame offset in the block
+ * - the analog frame render() reads, all 8 channels
+ * - the sample rate and period, and the blocks where a reconfiguration
+ *   committed (its timing depends on an auxiliary task, so it is input too)
+ * - periodically, a hash of the output, so the replay can prove it is
+ *   bit-exact or say where it diverged
+ *
+ * @encoding
+ * Each block is one record, built in a small staging buffer and pushed to a
+ * byte ring as a unit. A tag byte says which sections follow; a block with
+ * no MIDI and still pots is the tag byte alone.
+ * - kTagConfig: varint frame, float sample rate, varint audio frames,
+ *   varint analog frames, varint analog channels. Written in the first
+ *   block, on a change, and after lost input; otherwise each block starts
+ *   where the previous one ended
+ * - kTagMidi: varint count, then per message varint frame offset, status,
+ *   data byte count, data bytes
+ * - kTagAnalog: channel mask, then one code per changed channel. Bela's
+ *   ADC values are exact multiples of 2^-16, so a code is the zigzag
+ *   delta of that integer, shifted left one bit; any other value is
+ *   escaped with a set low bit followed by its raw 32 bits
+ * - kTagCommit: a pending reconfiguration committed at the top of the block
+ * - kTagCheckpoint: 32-bit FNV-1a of the output since the last checkpoint
+ * - kTagLoss: input was dropped up to this block (a block that did not fit
+ *   in the ring, or more MIDI than one record holds); the replay cannot be
+ *   exact past this point
+ *
+ * @thread_model
+ * The audio thread is the only producer, a low-priority auxiliary task the
+ * only consumer, writing through stdio. A block that does not fit in the
+ * ring is dropped and the next one carries kTagLoss | kTagConfig.
+ *
+ * @performance_characteristics
+ * - Per block: eight compares for the pots, a word-wise hash of the output,
+ *   one memcpy into the ring
+ * - File size: ~350 bytes/s idle at 128 frames, 44.1 kHz; a few KB/s with
+ *   pots moving
+ * - Ring: 64 KB from the AudioArena, several seconds of worst-case input
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+class AudioArena;
+
+/**
+ * @struct SessionFileHeader
+ * @brief Start of a session file; blocks follow until end of file
+ */
+struct SessionFileHeader {
+    char magic[4];              ///< "T3SE"
+    uint32_t version;
+    uint32_t checkpointBlocks;  ///< Blocks between output hashes
+    uint32_t reserved;
+};
+
+/**
+ * @class SessionRecorder
+ * @brief Delta-encoded input recorder with a non-blocking disk writer
+ *
+ * @usage_example
+ * @code
+ * // setup():
+ * arenaConfig.extraBytes += SessionRecorder::requiredBytes(SessionRecorder::kDefaultRingBytes);
+ * sessionRecorder.allocate(SessionRecorder::kDefaultRingBytes, audioArena);
+ * sessionRecorder.open();
+ *
+ * // render():
+ * sessionRecorder.beginBlock(frame, sampleRate, audioFrames, analogFrames, 8);
+ * sessionRecorder.recordMidi(0, bytes, count);
+ * sessionRecorder.recordAnalog(lastAnalogFrame, 8);
+ * sessionRecorder.recordOutput(output, frames);
+ * if (sessionRecorder.endBlock())
+ *     Bela_scheduleAuxiliaryTask(sessionTask);
+ * @endcode
+ */
+class SessionRecorder {
+public:
+    /** @brief Block record tag bits */
+    enum Tag {
+        kTagConfig = 1,
+        kTagMidi = 2,
+        kTagAnalog = 4,
+        kTagCommit = 8,
+        kTagCheckpoint = 16,
+        kTagLoss = 32
+    };
+
+    static const uint32_t kVersion = 2;
+    static const unsigned int kMaxChannels = 8;
+    static const unsigned int kMaxRecordBytes = 512;
+    static const unsigned int kDefaultRingBytes = 1u << 16;
+    static const unsigned int kCheckpointBlocks = 256;
+
+    SessionRecorder();
+    ~SessionRecorder();
+
+    /** @brief Arena bytes for a ring of `ringBytes` */
+    static size_t requiredBytes(unsigned int ringBytes);
+
+    /**
+     * @brief Take the ring from the arena
+     *
+     * @param ringBytes Power of two, at least 4 × kMaxRecordBytes
+     * @realtime_safety Non-real-time safe (setup())
+     */
+    bool allocate(unsigned int ringBytes, AudioArena& arena);
+
+    /** @brief Files are named <prefix>-<n>.t3s, n the first unused index */
+    void setOutputPrefix(const char* prefix) { outputPrefix = prefix; }
+
+    /**
+     * @brief Enable or disable recording; must precede open() (replay disables it)
+     */
+    void setEnabled(bool enabled) { this->enabled = enabled; }
+
+    /**
+     * @brief Create the session file and write its header
+     *
+     * @return false if recording is disabled or the file cannot be created
+     * @realtime_safety Non-real-time safe (setup())
+     */
+    bool open();
+
+    /** @brief True while a file is open and blocks are being recorded */
+    bool isRecording() const { return file != nullptr; }
+
+    // ------------------------------------------------------------------------
+    // Audio thread
+    // ------------------------------------------------------------------------
+
+    void beginBlock(uint64_t frame, float sampleRate, unsigned int audioFrames,
+                    unsigned int analogFrames, unsigned int analogChannels);
+
+    /** @brief A reconfiguration committed in this block */
+    void recordCommit() { tag |= kTagCommit; }
+
+    /**
+     * @brief One MIDI message (status and up to two data bytes)
+     *
+     * @param offset Frame within the block at which render() applied it
+     */
+    void recordMidi(unsigned int offset, const uint8_t* bytes, unsigned int count);
+
+    /** @brief The analog frame render() read, `channels` ≤ kMaxChannels values */
+    void recordAnalog(const float* frame, unsigned int channels);
+
+    /**
+     * @brief Fold the block's output into the checkpoint hash
+     *
+     * Called once per output channel, in channel order; the replay hashes
+     * the channels in the same order
+     */
+    void recordOutput(const float* output, unsigned int frames);
+
+    /**
+     * @brief Encode the block and push it to the ring
+     *
+     * @return true when the writer task should run
+     */
+    bool endBlock();
+
+    // ------------------------------------------------------------------------
+    // Writer task
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Write everything in the ring to the file
+     *
+     * @realtime_safety Non-real-time (auxiliary task)
+     */
+    void write();
+
+    /**
+     * @brief Write what is left and close the file (cleanup())
+     */
+    void close();
+
+    /** @brief Blocks dropped because the ring was full */
+    unsigned int getLostBlocks() const { return lostBlocks.load(std::memory_order_relaxed); }
+
+    // ------------------------------------------------------------------------
+    // Encoding helpers, shared with the replay's decoder
+    // ------------------------------------------------------------------------
+
+    static unsigned int putVarint(uint8_t* out, uint64_t value);
+    static unsigned int getVarint(const uint8_t* in, unsigned int available, uint64_t& value);
+    static uint32_t hashWords(const float* samples, unsigned int count, uint32_t hash);
+    static const uint32_t kHashSeed = 2166136261u;
+
+private:
+    void pushRecord(const uint8_t* bytes, unsigned int count);
+
+    // Audio-thread side
+    uint8_t* ring;
+    unsigned int mask;
+    std::atomic<unsigned int> head;
+    std::atomic<unsigned int> tail;
+    std::atomic<unsigned int> lostBlocks;
+    bool pendingLoss;
+
+    uint8_t tag;
+    uint64_t frame;
+    float sampleRate;
+    unsigned int audioFrames;
+    unsigned int analogFrames;
+    unsigned int analogChannels;
+    uint64_t nextFrame;         ///< Where the next block starts if nothing changed
+    bool configKnown;
+
+    uint8_t midiBytes[kMaxRecordBytes / 2];
+    unsigned int midiLength;
+    unsigned int midiCount;
+
+    float analog[kMaxChannels];
+    float lastAnalog[kMaxChannels];
+    int32_t lastQuantised[kMaxChannels];
+    unsigned int analogRecorded;
+
+    uint32_t outputHash;
+    unsigned int blocksSinceCheckpoint;
+
+    // Writer side
+    FILE* file;
+    bool enabled;
+    const char* outputPrefix;
+};
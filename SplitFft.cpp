@@ -0,0 +1,124 @@
+/**
+ * @file SplitFft.cpp
+ * @brief Implementation of the split-array radix-2 FFT
+ */
+
+#include "SplitFft.h"
+#include "SimdLanes.h"
+#include "TableBank.h"
+
+static_assert(SplitFft::kMaxSize == kFftMaxSize, "twiddle table size");
+
+SplitFft::SplitFft() : backend(kSimd), twiddleRe(kFftTwiddleTable.re), twiddleIm(kFftTwiddleTable.im) {
+    for (unsigned int bits = 1, size = 2; size <= kMaxSize; ++bits, size <<= 1) {
+        for (unsigned int n = 0; n < size; ++n) {
+            unsigned int reversed = 0;
+            for (unsigned int b = 0; b < bits; ++b)
+                reversed |= ((n >> b) & 1u) << (bits - 1 - b);
+            bitReverse[size - 2 + n] = static_cast<uint16_t>(reversed);
+        }
+    }
+}
+
+bool SplitFft::isSupportedSize(unsigned int size) {
+    return size >= 2 && size <= kMaxSize && (size & (size - 1)) == 0;
+}
+
+void SplitFft::forward(float* re, float* im, unsigned int size) const {
+    permute(re, im, size);
+    firstStages(re, im, size);
+    if (backend == kSimd)
+        stagesSimd(re, im, size);
+    else
+        stagesScalar(re, im, size);
+}
+
+void SplitFft::permute(float* re, float* im, unsigned int size) const {
+    const uint16_t* reversed = bitReverse + size - 2;
+    for (unsigned int n = 0; n < size; ++n) {
+        const unsigned int m = reversed[n];
+        if (m > n) {
+            const float r = re[n];
+            re[n] = re[m];
+            re[m] = r;
+            const float i = im[n];
+            im[n] = im[m];
+            im[m] = i;
+        }
+    }
+}
+
+void SplitFft::firstStages(float* re, float* im, unsigned int size) const {
+    /** Span 2: twiddle 1 */
+    for (unsigned int a = 0; a < size; a += 2) {
+        const float br = re[a + 1], bi = im[a + 1];
+        re[a + 1] = re[a] - br;
+        im[a + 1] = im[a] - bi;
+        re[a] += br;
+        im[a] += bi;
+    }
+    if (size < 4)
+        return;
+    /** Span 4: twiddles 1 and −i, the latter a swap and a negation */
+    for (unsigned int a = 0; a < size; a += 4) {
+        const float b0r = re[a + 2], b0i = im[a + 2];
+        re[a + 2] = re[a] - b0r;
+        im[a + 2] = im[a] - b0i;
+        re[a] += b0r;
+        im[a] += b0i;
+        const float b1r = im[a + 3], b1i = -re[a + 3];
+        re[a + 3] = re[a + 1] - b1r;
+        im[a + 3] = im[a + 1] - b1i;
+        re[a + 1] += b1r;
+        im[a + 1] += b1i;
+    }
+}
+
+void SplitFft::stagesScalar(float* re, float* im, unsigned int size) const {
+    for (unsigned int half = 4; half < size; half <<= 1) {
+        const float* wr = twiddleRe + half - 1;
+        const float* wi = twiddleIm + half - 1;
+        for (unsigned int group = 0; group < size; group += 2 * half) {
+            float* ar = re + group;
+            float* ai = im + group;
+            float* br = ar + half;
+            float* bi = ai + half;
+            for (unsigned int k = 0; k < half; ++k) {
+                const float tr = br[k] * wr[k] - bi[k] * wi[k];
+                const float ti = br[k] * wi[k] + bi[k] * wr[k];
+                br[k] = ar[k] - tr;
+                bi[k] = ai[k] - ti;
+                ar[k] += tr;
+                ai[k] += ti;
+            }
+        }
+    }
+}
+
+void SplitFft::stagesSimd(float* re, float* im, unsigned int size) const {
+    for (unsigned int half = 4; half < size; half <<= 1) {
+        /** Stage twiddles start at half − 1: unaligned loads */
+        const float* wr = twiddleRe + half - 1;
+        const float* wi = twiddleIm + half - 1;
+        for (unsigned int group = 0; group < size; group += 2 * half) {
+            float* ar = re + group;
+            float* ai = im + group;
+            float* br = ar + half;
+            float* bi = ai + half;
+            for (unsigned int k = 0; k < half; k += 4) {
+                const vfloat4 twr = vf4_load(wr + k);
+                const vfloat4 twi = vf4_load(wi + k);
+                const vfloat4 xr = vf4_load(br + k);
+                const vfloat4 xi = vf4_load(bi + k);
+                const vfloat4 tr = vf4_mls(vf4_mul(xr, twr), xi, twi);
+                const vfloat4 ti = vf4_mla(vf4_mul(xr, twi), xi, twr);
+                const vfloat4 yr = vf4_load(ar + k);
+                const vfloat4 yi = vf4_load(ai + k);
+                vf4_store(br + k, vf4_sub(yr, tr));
+                vf4_store(bi + k, vf4_sub(yi, ti));
+                vf4_store(ar + k, vf4_add(yr, tr));
+                vf4_store(ai + k, vf4_add(yi, ti));
+            }
+        }
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * @file SplitFft.h
+ * @brief Radix-2 complex FFT on split real/imaginary arrays, scalar or SIMD
+ *
+ * The convolution stage needs forward and inverse transforms of 4 to 512
+ * points every period. SplitFft is an iterative decimation-in-time radix-2
+ * FFT over split arrays (re[], im[]): the layout SIMD wants, since four
+ * consecutive butterflies of a stage then load as one vector each of
+ * re[a], im[a], re[b], im[b] and the stage's twiddles.
+ *
+ * Two backends share the tables and produce the same result to rounding:
+ * - kScalar: one butterfly at a time
+ * - kSimd: four butterflies per step (SimdLanes.h) for every stage from
+ *   span 8 up; the first two stages (spans 2 and 4, twiddles 1 and −i)
+ *   are multiplication-free and stay scalar in both
+ * DEV/KernelCounterBench.cpp measures the two against each other.
+ *
+ * The inverse transform is the forward one with the arrays swapped (which
+ * conjugates in and out) and is unscaled: callers fold 1/N into whatever
+ * they multiply by, as the convolver does into its filter spectra.
+ *
+ * @tables
+ * Twiddles depend only on the span of a stage, not on the transform size,
+ * so one table per span (1 + 2 + ... + kMaxSize/2 entries) serves every
+ * size; so does one bit-reversal table per size. The twiddles are the
+ * embedded, checksummed kFftTwiddleTable (TableBank.h), so constructing an
+ * FFT does no trigonometry; the constructor only fills the 2 KB of
+ * bit-reversal indices.
+ *
+ * @performance_characteristics
+ * - (N/2)·log2(N) butterflies; no allocation, no trigonometry at run time
+ * - Real-time safe once constructed
+ *
+ * @usage_example
+ * @code
+ * fft.forward(re, im, 256);     // in place
+ * ...                           // multiply by a spectrum scaled by 1/256
+ * fft.inverse(re, im, 256);
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @class SplitFft
+ * @brief Power-of-two complex FFT, sizes 2 to kMaxSize
+ */
+class SplitFft {
+public:
+    /** @brief Largest transform: twice the largest period (overlap-save) */
+    static const unsigned int kMaxSize = 512;
+
+    /**
+     * @enum Backend
+     * @brief Butterfly implementation
+     */
+    enum Backend {
+        kScalar = 0,
+        kSimd
+    };
+
+    SplitFft();
+
+    void setBackend(Backend newBackend) { backend = newBackend; }
+    Backend getBackend() const { return backend; }
+
+    /** @brief True for the powers of two from 2 to kMaxSize */
+    static bool isSupportedSize(unsigned int size);
+
+    /**
+     * @brief In-place forward transform, X[k] = Σ x[n]·e^(−2πikn/N)
+     *
+     * @param re Real parts, `size` values
+     * @param im Imaginary parts, `size` values
+     * @param size Transform size (isSupportedSize())
+     * @realtime_safety Real-time safe
+     */
+    void forward(float* re, float* im, unsigned int size) const;
+
+    /** @brief In-place inverse transform without the 1/N scale */
+    void inverse(float* re, float* im, unsigned int size) const { forward(im, re, size); }
+
+private:
+    void permute(float* re, float* im, unsigned int size) const;
+    void firstStages(float* re, float* im, unsigned int size) const;
+    void stagesScalar(float* re, float* im, unsigned int size) const;
+    void stagesSimd(float* re, float* im, unsigned int size) const;
+
+    Backend backend;
+
+    /** Twiddles of the stage with half-span h at [h − 1, 2h − 1): e^(−iπk/h) */
+    const float* twiddleRe;
+    const float* twiddleIm;
+
+    /** Bit-reversed index of n for size 2^b at [2^b − 2 + n] */
+    uint16_t bitReverse[2 * kMaxSize - 2];
+};
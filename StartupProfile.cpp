@@ -0,0 +1,110 @@
+/**
+ * @file StartupProfile.cpp
+ * @brief Implementation of the cold-start timer
+ */
+
+#include "StartupProfile.h"
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+uint64_t clockNs(clockid_t clock) {
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * @brief Process start in ns since boot, from field 22 of /proc/self/stat
+ *
+ * @return 0 if unavailable
+ */
+uint64_t processStartSinceBootNs() {
+    FILE* file = fopen("/proc/self/stat", "r");
+    if (!file)
+        return 0;
+    char line[1024];
+    const size_t length = fread(line, 1, sizeof(line) - 1, file);
+    fclose(file);
+    line[length] = '\0';
+
+    /** The command name (field 2) may contain spaces: count from its ')' */
+    const char* field = strrchr(line, ')');
+    if (!field)
+        return 0;
+    for (int n = 2; n < 22 && field; ++n)
+        field = strchr(field + 1, ' ');
+    if (!field)
+        return 0;
+
+    const unsigned long long ticks = strtoull(field + 1, nullptr, 10);
+    const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    if (ticks == 0 || ticksPerSecond <= 0)
+        return 0;
+    return ticks * (1000000000ull / static_cast<uint64_t>(ticksPerSecond));
+}
+
+double msBetween(uint64_t fromNs, uint64_t toNs) {
+    return (static_cast<double>(toNs) - static_cast<double>(fromNs)) * 1e-6;
+}
+
+} // namespace
+
+StartupProfile::StartupProfile() : processStartNs(0) {
+    for (int i = 0; i < kNumMilestones; ++i)
+        timesNs[i] = 0;
+}
+
+uint64_t StartupProfile::now() {
+    return clockNs(CLOCK_MONOTONIC);
+}
+
+void StartupProfile::beginSetup() {
+    mark(kSetupBegin);
+
+    /**
+     * /proc gives the start on the boot clock; move it to the monotonic one
+     * through the current distance between the two (equal on a board that
+     * never suspends)
+     */
+    const uint64_t startSinceBootNs = processStartSinceBootNs();
+    const uint64_t bootNowNs = clockNs(CLOCK_BOOTTIME);
+    const uint64_t monotonicNowNs = now();
+    if (startSinceBootNs == 0 || startSinceBootNs > bootNowNs)
+        return;
+    const uint64_t ageNs = bootNowNs - startSinceBootNs;
+    if (ageNs < monotonicNowNs)
+        processStartNs = monotonicNowNs - ageNs;
+}
+
+void StartupProfile::report(FILE* out) const {
+    if (!isMarked(kSetupBegin))
+        return;
+    const uint64_t setupBegin = timesNs[kSetupBegin];
+
+    fprintf(out, "Cold start:\n");
+    if (processStartNs != 0)
+        fprintf(out, "  process start -> setup   %9.2f ms (10 ms resolution)\n",
+                msBetween(processStartNs, setupBegin));
+    if (isMarked(kSetupEnd)) {
+        fprintf(out, "  setup                    %9.2f ms", msBetween(setupBegin, timesNs[kSetupEnd]));
+        if (isMarked(kTablesVerified))
+            fprintf(out, " (table check %.3f ms)", msBetween(setupBegin, timesNs[kTablesVerified]));
+        fprintf(out, "\n");
+    }
+    if (isMarked(kFirstBlock) && isMarked(kSetupEnd))
+        fprintf(out, "  setup -> first block     %9.2f ms\n", msBetween(timesNs[kSetupEnd], timesNs[kFirstBlock]));
+    if (isMarked(kFirstNote) && isMarked(kFirstBlock))
+        fprintf(out, "  first block -> note      %9.2f ms\n", msBetween(timesNs[kFirstBlock], timesNs[kFirstNote]));
+
+    /** The totals, from exec when known, otherwise from setup() */
+    const uint64_t origin = processStartNs != 0 ? processStartNs : setupBegin;
+    const char* originName = processStartNs != 0 ? "cold start" : "setup";
+    if (isMarked(kFirstBlock))
+        fprintf(out, "  %s -> first block %7.2f ms\n", originName, msBetween(origin, timesNs[kFirstBlock]));
+    if (isMarked(kFirstNote))
+        fprintf(out, "  %s -> first note  %7.2f ms\n", originName, msBetween(origin, timesNs[kFirstNote]));
+}
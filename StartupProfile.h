@@ -0,0 +1,96 @@
+/**
+ * @file StartupProfile.h
+ * @brief Cold-start timing: process start to first block to first note
+ *
+ * Boot-to-sound time is something the player notices and nobody measures.
+ * StartupProfile timestamps the milestones of a cold start on the
+ * monotonic clock:
+ * - process start (from /proc/self/stat, 1/CLK_TCK resolution, usually 10 ms)
+ * - setup() entry, table verification, setup() exit
+ * - the first render() block: the instrument can sound from here
+ * - the first note-on rendered
+ *
+ * report() prints the intervals and the two totals that matter, cold start
+ * to first block and cold start to first note. For an unattended boot
+ * measurement, send a note as soon as the MIDI port enumerates; the
+ * first-note figure then includes the MIDI path as well.
+ *
+ * @performance_characteristics
+ * - mark(): one branch once the milestone is set; the first call reads the
+ *   clock (real-time safe)
+ * - beginSetup(): reads /proc/self/stat, setup thread only
+ *
+ * @usage_example
+ * @code
+ * bool setup(...) {
+ *     startupProfile.beginSetup();
+ *     ...
+ *     startupProfile.mark(StartupProfile::kSetupEnd);
+ * }
+ * void render(...) {
+ *     startupProfile.mark(StartupProfile::kFirstBlock);
+ *     ...
+ * }
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @class StartupProfile
+ * @brief Timestamps of the cold-start milestones
+ */
+class StartupProfile {
+public:
+    /**
+     * @enum Milestone
+     * @brief Points on the way from exec to the first note
+     */
+    enum Milestone {
+        kSetupBegin = 0,
+        kTablesVerified,
+        kSetupEnd,
+        kFirstBlock,
+        kFirstNote,
+        kNumMilestones
+    };
+
+    StartupProfile();
+
+    /**
+     * @brief Mark setup() entry and locate the process start on the same clock
+     *
+     * @realtime_safety Non-real-time (reads /proc)
+     */
+    void beginSetup();
+
+    /**
+     * @brief Timestamp a milestone; only the first call for each counts
+     */
+    void mark(Milestone milestone) {
+        if (timesNs[milestone] == 0)
+            timesNs[milestone] = now();
+    }
+
+    bool isMarked(Milestone milestone) const { return timesNs[milestone] != 0; }
+
+    /**
+     * @brief Print the milestones reached so far
+     *
+     * @realtime_safety Non-real-time (stdio); call from an auxiliary task
+     */
+    void report(FILE* out) const;
+
+private:
+    static uint64_t now();
+
+    uint64_t timesNs[kNumMilestones];   ///< CLOCK_MONOTONIC; 0 = not reached
+    uint64_t processStartNs;            ///< CLOCK_MONOTONIC; 0 = unknown
+};
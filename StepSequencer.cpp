@@ -0,0 +1,435 @@
+/**
+ * @file StepSequencer.cpp
+ * @brief Implementation of the sample-accurate step sequencer and clock PLL
+ */
+
+#include "StepSequencer.h"
+#include <cmath>
+
+namespace {
+
+const int kClocksPerBeat = 24;
+const int kStepsPerBeat = 4;
+
+/** @brief MIDI clock ticks per swing pair (two sixteenths) */
+const uint64_t kTicksPerPair = 2 * kClocksPerBeat / kStepsPerBeat;
+
+/**
+ * @brief PLL loop gains
+ *
+ * Phase gain 0.1 divides per-message jitter by about ten; the period gain
+ * alpha²/4 gives a critically damped loop that settles in roughly four
+ * beats after a tempo change.
+ */
+const double kPhaseGain = 0.1;
+const double kPeriodGain = 0.0025;
+
+/** @brief A clock that has not ticked for this long is considered stopped */
+const float kClockTimeoutSeconds = 0.5f;
+
+const float kMinTempo = 20.0f;
+const float kMaxTempo = 300.0f;
+
+double samplesPerTickAt(float sampleRate, float bpm) {
+    return sampleRate * 60.0 / (bpm * kClocksPerBeat);
+}
+
+} // namespace
+
+// ============================================================================
+// MidiClockPll
+// ============================================================================
+
+MidiClockPll::MidiClockPll(float sampleRate) {
+    reset(sampleRate);
+}
+
+void MidiClockPll::reset(float sampleRate) {
+    tickTime = 0.0;
+    samplesPerTick = samplesPerTickAt(sampleRate, 120.0f);
+    tickIndex = 0;
+    lastTickSample = 0;
+    ticksSeen = 0;
+    locked = false;
+    minSamplesPerTick = samplesPerTickAt(sampleRate, kMaxTempo);
+    maxSamplesPerTick = samplesPerTickAt(sampleRate, kMinTempo);
+}
+
+void MidiClockPll::tick(uint64_t sampleTime) {
+    const double time = static_cast<double>(sampleTime);
+    lastTickSample = sampleTime;
+
+    if (ticksSeen == 0) {
+        tickTime = time;
+        tickIndex = 0;
+        ticksSeen = 1;
+        return;
+    }
+
+    ++tickIndex;
+    const double predicted = tickTime + samplesPerTick;
+    const double error = time - predicted;
+
+    if (!locked) {
+        /**
+         * Second tick: take the raw interval as the first period estimate
+         */
+        const double interval = time - tickTime;
+        if (interval >= minSamplesPerTick && interval <= maxSamplesPerTick)
+            samplesPerTick = interval;
+        tickTime = time;
+        locked = true;
+    }
+    else if (fabs(error) > 0.5 * samplesPerTick) {
+        /**
+         * Dropped messages or a jump: re-anchor the phase, keep the period
+         */
+        tickTime = time;
+    }
+    else {
+        tickTime = predicted + kPhaseGain * error;
+        samplesPerTick += kPeriodGain * error;
+        if (samplesPerTick < minSamplesPerTick)
+            samplesPerTick = minSamplesPerTick;
+        if (samplesPerTick > maxSamplesPerTick)
+            samplesPerTick = maxSamplesPerTick;
+    }
+    ++ticksSeen;
+}
+
+// ============================================================================
+// StepSequencer
+// ============================================================================
+
+StepSequencer::StepSequencer(float sampleRate)
+    : sampleRate(sampleRate), stagedSampleRate(sampleRate), mode(kOff), running(false),
+      tempoBpm(120.0f), swing(0.5f), stepSamples(0.0), length(kMaxSteps), currentStep(0),
+      pairStart(0.0), secondOfPair(false), pairTick(0), clockAligned(false), clockStartPending(false),
+      clockPll(sampleRate), tiedNote(-1), soundingNote(-1), lastEventTime(0),
+      numHeldNotes(0), arpOrder(kUp), arpOctaves(1), arpGate(0.5f), arpVelocity(100),
+      arpPosition(0), arpRandom(0x5EED5u), eventHead(0), eventTail(0) {
+    for (int i = 0; i < kMaxHeldNotes; ++i)
+        heldNotes[i] = 0;
+    updateStepSamples();
+}
+
+void StepSequencer::updateStepSamples() {
+    stepSamples = sampleRate * 60.0 / (tempoBpm * kStepsPerBeat);
+}
+
+void StepSequencer::setMode(Mode newMode, uint64_t now) {
+    if (newMode == mode)
+        return;
+    mode = newMode;
+    if (mode == kOff)
+        stop(now);
+    else if (!running)
+        start(now);
+}
+
+void StepSequencer::setTempo(float bpm) {
+    if (bpm < kMinTempo)
+        bpm = kMinTempo;
+    if (bpm > kMaxTempo)
+        bpm = kMaxTempo;
+    tempoBpm = bpm;
+    updateStepSamples();
+}
+
+void StepSequencer::setSwing(float newSwing) {
+    if (newSwing < 0.5f)
+        newSwing = 0.5f;
+    if (newSwing > 0.75f)
+        newSwing = 0.75f;
+    swing = newSwing;
+}
+
+void StepSequencer::setLength(int newLength) {
+    if (newLength < 1)
+        newLength = 1;
+    if (newLength > kMaxSteps)
+        newLength = kMaxSteps;
+    length = newLength;
+    if (currentStep >= length)
+        currentStep = 0;
+}
+
+void StepSequencer::setStep(int index, const Step& step) {
+    if (index < 0 || index >= kMaxSteps)
+        return;
+    Step& s = steps[index];
+    s = step;
+    if (s.gate < 0.05f)
+        s.gate = 0.05f;
+    if (s.gate > 0.95f)
+        s.gate = 0.95f;
+    if (s.ratchet < 1)
+        s.ratchet = 1;
+    if (s.ratchet > 4)
+        s.ratchet = 4;
+    if (s.velocity < 1)
+        s.velocity = 1;
+    if (s.velocity > 127)
+        s.velocity = 127;
+}
+
+void StepSequencer::setArpeggiator(ArpOrder order, int octaves, float gate, uint8_t velocity) {
+    arpOrder = order;
+    arpOctaves = (octaves < 1) ? 1 : (octaves > 4 ? 4 : octaves);
+    arpGate = (gate < 0.05f) ? 0.05f : (gate > 0.95f ? 0.95f : gate);
+    arpVelocity = (velocity < 1) ? 1 : (velocity > 127 ? 127 : velocity);
+}
+
+void StepSequencer::arpNoteOn(uint8_t note) {
+    int position = 0;
+    while (position < numHeldNotes && heldNotes[position] < note)
+        ++position;
+    if ((position < numHeldNotes && heldNotes[position] == note) || numHeldNotes == kMaxHeldNotes)
+        return;
+    for (int i = numHeldNotes; i > position; --i)
+        heldNotes[i] = heldNotes[i - 1];
+    heldNotes[position] = note;
+    ++numHeldNotes;
+}
+
+void StepSequencer::arpNoteOff(uint8_t note) {
+    for (int i = 0; i < numHeldNotes; ++i) {
+        if (heldNotes[i] == note) {
+            for (int j = i; j < numHeldNotes - 1; ++j)
+                heldNotes[j] = heldNotes[j + 1];
+            --numHeldNotes;
+            return;
+        }
+    }
+}
+
+void StepSequencer::start(uint64_t now) {
+    running = true;
+    lastEventTime = 0;
+    currentStep = 0;
+    arpPosition = 0;
+    secondOfPair = false;
+    pairStart = static_cast<double>(now);
+    clockAligned = false;
+}
+
+void StepSequencer::stop(uint64_t now) {
+    running = false;
+    clockStartPending = false;
+
+    /**
+     * Drop everything not yet played, including a pending gate note-off,
+     * and release whatever the played events left sounding. The ring is
+     * empty, so the release may go at `now` even if the dropped events
+     * lay beyond it
+     */
+    eventHead = eventTail;
+    lastEventTime = 0;
+    if (soundingNote >= 0)
+        pushEvent(static_cast<double>(now), static_cast<uint8_t>(soundingNote), 0, false);
+    tiedNote = -1;
+}
+
+void StepSequencer::clockTick(uint64_t now) {
+    clockPll.tick(now);
+    if (clockStartPending && mode != kOff) {
+        /**
+         * MIDI start: the first tick after 0xFA is the downbeat
+         */
+        clockStartPending = false;
+        start(now);
+        pairTick = clockPll.getTickIndex();
+        clockAligned = true;
+    }
+}
+
+void StepSequencer::clockStart() {
+    clockStartPending = true;
+}
+
+void StepSequencer::clockStop(uint64_t now) {
+    if (running)
+        stop(now);
+}
+
+double StepSequencer::getBeatSamples(uint64_t now) const {
+    if (followingClock(now))
+        return kClocksPerBeat * clockPll.getSamplesPerTick();
+    return kStepsPerBeat * stepSamples;
+}
+
+bool StepSequencer::followingClock(uint64_t now) const {
+    if (!clockPll.isLocked())
+        return false;
+    const uint64_t last = clockPll.getLastTickSample();
+    return now < last + static_cast<uint64_t>(kClockTimeoutSeconds * sampleRate);
+}
+
+uint64_t StepSequencer::firstTickAfter(double time) const {
+    const uint64_t last = clockPll.getTickIndex();
+    const double ticks = ceil((time - clockPll.getTickTime(last)) / clockPll.getSamplesPerTick());
+    return (ticks < 1.0) ? last + 1 : last + static_cast<uint64_t>(ticks);
+}
+
+void StepSequencer::schedule(uint64_t horizon) {
+    if (!running)
+        return;
+
+    const bool clock = followingClock(horizon);
+    const double end = static_cast<double>(horizon);
+
+    while (kEventCapacity - (eventTail - eventHead) >= kMaxEventsPerStep) {
+        /**
+         * Pair timing: on the PLL grid while the clock runs (joining it at
+         * the next pair boundary), otherwise at the internal tempo
+         */
+        double pairLength = 2.0 * stepSamples;
+        if (clock) {
+            if (!clockAligned && !secondOfPair) {
+                pairTick = firstTickAfter(pairStart);
+                clockAligned = true;
+            }
+            if (clockAligned) {
+                pairStart = clockPll.getTickTime(pairTick);
+                pairLength = kTicksPerPair * clockPll.getSamplesPerTick();
+            }
+        }
+        else {
+            clockAligned = false;
+        }
+
+        const double firstLength = pairLength * swing;
+        const double stepStart = secondOfPair ? pairStart + firstLength : pairStart;
+        const double stepLength = secondOfPair ? pairLength - firstLength : firstLength;
+        if (stepStart >= end)
+            break;
+
+        emitStep(stepStart, stepLength);
+        currentStep = (currentStep + 1) % length;
+        if (secondOfPair) {
+            pairStart += pairLength;
+            pairTick += kTicksPerPair;
+        }
+        secondOfPair = !secondOfPair;
+    }
+}
+
+void StepSequencer::emitStep(double stepStart, double stepLength) {
+    uint8_t note;
+    uint8_t velocity;
+    float gate;
+    int ratchet;
+    bool active;
+    bool slide;
+
+    if (mode == kPattern) {
+        const Step& step = steps[currentStep];
+        note = step.note;
+        velocity = step.velocity;
+        gate = step.gate;
+        ratchet = step.ratchet;
+        active = step.active;
+        slide = step.slide;
+    }
+    else {
+        active = nextArpNote(note);
+        velocity = arpVelocity;
+        gate = arpGate;
+        ratchet = 1;
+        slide = false;
+    }
+
+    if (!active) {
+        if (tiedNote >= 0)
+            pushEvent(stepStart, static_cast<uint8_t>(tiedNote), 0, false);
+        tiedNote = -1;
+        return;
+    }
+
+    const double hitLength = stepLength / ratchet;
+    for (int k = 0; k < ratchet; ++k) {
+        const double onTime = stepStart + k * hitLength;
+        pushEvent(onTime, note, velocity, k == 0 && tiedNote >= 0);
+        if (k == ratchet - 1 && slide)
+            tiedNote = note;
+        else
+            pushEvent(onTime + gate * hitLength, note, 0, false);
+    }
+    if (!slide)
+        tiedNote = -1;
+}
+
+bool StepSequencer::nextArpNote(uint8_t& note) {
+    if (numHeldNotes == 0)
+        return false;
+
+    const int span = numHeldNotes * arpOctaves;
+    int index;
+    switch (arpOrder) {
+        case kDown:
+            index = span - 1 - (arpPosition % span);
+            break;
+        case kUpDown: {
+            const int period = (span > 1) ? 2 * span - 2 : 1;
+            const int position = arpPosition % period;
+            index = (position < span) ? position : period - position;
+            break;
+        }
+        case kRandom:
+            arpRandom ^= arpRandom << 13;
+            arpRandom ^= arpRandom >> 17;
+            arpRandom ^= arpRandom << 5;
+            index = static_cast<int>(arpRandom % static_cast<uint32_t>(span));
+            break;
+        case kUp:
+        default:
+            index = arpPosition % span;
+            break;
+    }
+    ++arpPosition;
+
+    int value = heldNotes[index % numHeldNotes] + 12 * (index / numHeldNotes);
+    while (value > 127)
+        value -= 12;
+    note = static_cast<uint8_t>(value);
+    return true;
+}
+
+void StepSequencer::pushEvent(double time, uint8_t note, uint8_t velocity, bool slide) {
+    uint64_t t = (time > 0.0) ? static_cast<uint64_t>(time + 0.5) : 0;
+    if (t < lastEventTime)
+        t = lastEventTime;
+    lastEventTime = t;
+
+    SequencerEvent& event = events[eventTail & (kEventCapacity - 1)];
+    event.time = t;
+    event.note = note;
+    event.velocity = velocity;
+    event.slide = slide;
+    ++eventTail;
+}
+
+bool StepSequencer::popEvent(SequencerEvent& event) {
+    if (eventHead == eventTail)
+        return false;
+    event = events[eventHead & (kEventCapacity - 1)];
+    ++eventHead;
+
+    /** The voice is monophonic: any note-off releases it */
+    soundingNote = (event.velocity > 0) ? event.note : -1;
+    return true;
+}
+
+bool StepSequencer::prepareSampleRate(float newSampleRate) {
+    if (newSampleRate <= 0.0f)
+        return false;
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+void StepSequencer::commitSampleRate() {
+    sampleRate = stagedSampleRate;
+    updateStepSamples();
+    clockPll.reset(sampleRate);
+    clockAligned = false;
+}
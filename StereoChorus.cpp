@@ -0,0 +1,139 @@
+/**
+ * @file StereoChorus.cpp
+ * @brief Implementation of the two-lane chorus
+ */
+
+#include "StereoChorus.h"
+
+namespace {
+
+/** @brief Frames needed for the longest delay at a rate, rounded to a power of two */
+unsigned int lineFrames(float sampleRate) {
+    const unsigned int needed = static_cast<unsigned int>(StereoChorus::kMaxDelayMs * 0.001f * sampleRate) + 2;
+    unsigned int frames = 1;
+    while (frames < needed)
+        frames <<= 1;
+    return frames;
+}
+
+} // namespace
+
+StereoChorus::StereoChorus()
+    : line(nullptr), mask(0), writeIndex(0), sampleRate(44100.0f), stagedSampleRate(44100.0f),
+      rateHz(0.8f), depthMs(3.0f), mix(0.0f), increment(0.0f), baseSamples(0.0f), depthSamples(0.0f),
+      wetGain(0.0f) {
+    phase[0] = 0.0f;
+    phase[1] = 0.75f;
+    updateCoefficients();
+}
+
+size_t StereoChorus::requiredBytes(float maxSampleRate) {
+    return 2 * lineFrames(maxSampleRate) * sizeof(float) + AudioArena::kAlignment;
+}
+
+bool StereoChorus::allocate(AudioArena& arena, float maxSampleRate) {
+    const unsigned int frames = lineFrames(maxSampleRate);
+    line = arena.allocateFloats(2 * frames);
+    if (!line)
+        return false;
+    mask = frames - 1;
+    writeIndex = 0;
+    return true;
+}
+
+void StereoChorus::setRate(float hz) {
+    rateHz = hz < 0.05f ? 0.05f : (hz > 5.0f ? 5.0f : hz);
+    updateCoefficients();
+}
+
+void StereoChorus::setDepth(float ms) {
+    depthMs = ms < 0.0f ? 0.0f : (ms > kMaxDepthMs ? kMaxDepthMs : ms);
+    updateCoefficients();
+}
+
+void StereoChorus::setMix(float newMix) {
+    mix = newMix < 0.0f ? 0.0f : (newMix > 1.0f ? 1.0f : newMix);
+}
+
+void StereoChorus::reset() {
+    if (line) {
+        for (unsigned int i = 0; i < 2 * (mask + 1); ++i)
+            line[i] = 0.0f;
+    }
+    writeIndex = 0;
+    phase[0] = 0.0f;
+    phase[1] = 0.75f;
+}
+
+bool StereoChorus::prepareSampleRate(float newSampleRate) {
+    /** The line was sized once in setup(); a faster rate would overrun it */
+    if (newSampleRate <= 0.0f || (line && lineFrames(newSampleRate) > mask + 1))
+        return false;
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+void StereoChorus::commitSampleRate() {
+    sampleRate = stagedSampleRate;
+    updateCoefficients();
+}
+
+void StereoChorus::updateCoefficients() {
+    increment = rateHz / sampleRate;
+    baseSamples = kBaseDelayMs * 0.001f * sampleRate;
+    depthSamples = depthMs * 0.001f * sampleRate;
+}
+
+void StereoChorus::process(float* left, float* right, unsigned int frames) {
+    if (!line || frames == 0)
+        return;
+
+    const vfloat2 one = vf2_dup(1.0f);
+    const vfloat2 two = vf2_dup(2.0f);
+    const vfloat2 increments = vf2_dup(increment);
+    const vfloat2 sweep = vf2_dup(2.0f * depthSamples);
+
+    /**
+     * Read position = write index + line length − delay, so it stays
+     * positive; delay = base − depth + 2·depth·triangle
+     */
+    const float lineLength = static_cast<float>(mask + 1);
+    const vfloat2 readOffset = vf2_dup(lineLength - baseSamples + depthSamples);
+
+    /** Equal blend at mix 1: the wet gain tops out at one half */
+    const float targetWet = 0.5f * mix;
+    const float wetStep = (targetWet - wetGain) / static_cast<float>(frames);
+    float wet = wetGain;
+
+    vfloat2 lfoPhase = vf2_load(phase);
+    for (unsigned int n = 0; n < frames; ++n) {
+        const vfloat2 input = vf2_set(left[n], right[n]);
+        vf2_store(line + 2 * writeIndex, input);
+
+        const vfloat2 triangle = vf2_abs(vf2_mls(one, two, lfoPhase));
+        const vfloat2 position = vf2_mls(vf2_add(vf2_dup(static_cast<float>(writeIndex)), readOffset),
+                                         sweep, triangle);
+
+        /** Scalar gather: the sides read from different positions */
+        const float positionL = vf2_lane0(position);
+        const float positionR = vf2_lane1(position);
+        const unsigned int indexL = static_cast<unsigned int>(positionL);
+        const unsigned int indexR = static_cast<unsigned int>(positionR);
+        const vfloat2 older = vf2_set(line[2 * (indexL & mask)], line[2 * (indexR & mask) + 1]);
+        const vfloat2 newer = vf2_set(line[2 * ((indexL + 1) & mask)], line[2 * ((indexR + 1) & mask) + 1]);
+        const vfloat2 fraction = vf2_set(positionL - static_cast<float>(indexL),
+                                         positionR - static_cast<float>(indexR));
+        const vfloat2 delayed = vf2_mla(older, vf2_sub(newer, older), fraction);
+
+        wet += wetStep;
+        const vfloat2 output = vf2_mla(vf2_mul(input, vf2_dup(1.0f - wet)), delayed, vf2_dup(wet));
+        left[n] = vf2_lane0(output);
+        right[n] = vf2_lane1(output);
+
+        lfoPhase = vf2_add(lfoPhase, increments);
+        lfoPhase = vf2_select(vf2_greater(lfoPhase, one), vf2_sub(lfoPhase, one), lfoPhase);
+        writeIndex = (writeIndex + 1) & mask;
+    }
+    vf2_store(phase, lfoPhase);
+    wetGain = targetWet;
+}
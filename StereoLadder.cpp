@@ -0,0 +1,103 @@
+/**
+ * @file StereoLadder.cpp
+ * @brief Parameter handling and snapshots for the stereo ladder pair
+ */
+
+#include "StereoLadder.h"
+#include "ParameterUpdate.h"
+#include "TableBank.h"
+
+StereoLadder::StereoLadder()
+    : cutoffSpread(0.0f), resonanceSpread(0.0f), drive(1.0f), mode(ZDFMoogLadderFilter::LP24),
+      appliedCutoffSpread(0.0f), appliedMode(ZDFMoogLadderFilter::LP24), dirty(true) {
+    resonanceOffset[0] = resonanceOffset[1] = 0.0f;
+    reset();
+    updateCoefficients();
+}
+
+void StereoLadder::setCutoffSpread(float octaves) {
+    if (!(octaves > 0.0f))
+        octaves = 0.0f;
+    if (octaves > kMaxCutoffSpread)
+        octaves = kMaxCutoffSpread;
+    cutoffSpread = octaves;
+    if (ParameterUpdate::changed(octaves, appliedCutoffSpread, 0.0f))
+        dirty = true;
+}
+
+void StereoLadder::setResonanceSpread(float amount) {
+    if (!(amount > 0.0f))
+        amount = 0.0f;
+    if (amount > kMaxResonanceSpread)
+        amount = kMaxResonanceSpread;
+    resonanceSpread = amount;
+    resonanceOffset[0] = -0.5f * amount;
+    resonanceOffset[1] = 0.5f * amount;
+}
+
+void StereoLadder::setDrive(float driveAmount) {
+    drive = driveAmount < 0.0f ? 0.0f : (driveAmount > 1.0f ? 1.0f : driveAmount);
+}
+
+void StereoLadder::setMode(int newMode) {
+    if (newMode != ZDFMoogLadderFilter::BP12 && newMode != ZDFMoogLadderFilter::HP24)
+        newMode = ZDFMoogLadderFilter::LP24;
+    mode = newMode;
+    if (mode != appliedMode)
+        dirty = true;
+}
+
+void StereoLadder::updateCoefficients() {
+    cutoffRatio[0] = tableExp2(-0.5f * cutoffSpread);
+    cutoffRatio[1] = tableExp2(0.5f * cutoffSpread);
+    appliedCutoffSpread = cutoffSpread;
+
+    /**
+     * The scalar ladder's output switch as tap weights:
+     * LP24 stage[3], BP12 stage[2] − stage[3], HP24 input − stage[3]
+     */
+    switch (mode) {
+    case ZDFMoogLadderFilter::BP12:
+        inputWeight = 0.0f;
+        stage2Weight = 1.0f;
+        stage3Weight = -1.0f;
+        break;
+    case ZDFMoogLadderFilter::HP24:
+        inputWeight = 1.0f;
+        stage2Weight = 0.0f;
+        stage3Weight = -1.0f;
+        break;
+    default:
+        inputWeight = 0.0f;
+        stage2Weight = 0.0f;
+        stage3Weight = 1.0f;
+        break;
+    }
+    appliedMode = mode;
+
+    dirty = false;
+    ParameterUpdate::count(ParameterUpdate::kStereoLadder);
+}
+
+void StereoLadder::reset() {
+    for (int i = 0; i < 16; ++i)
+        state[i] = 0.0f;
+}
+
+void StereoLadder::saveSnapshot(Snapshot& snapshot) const {
+    for (int i = 0; i < 16; ++i)
+        snapshot.state[i] = state[i];
+    snapshot.drive = drive;
+    snapshot.mode = mode;
+    snapshot.cutoffSpread = cutoffSpread;
+    snapshot.resonanceSpread = resonanceSpread;
+}
+
+void StereoLadder::loadSnapshot(const Snapshot& snapshot) {
+    for (int i = 0; i < 16; ++i)
+        state[i] = snapshot.state[i];
+    setDrive(snapshot.drive);
+    setMode(snapshot.mode);
+    setCutoffSpread(snapshot.cutoffSpread);
+    setResonanceSpread(snapshot.resonanceSpread);
+}
@@ -0,0 +1,288 @@
+/**
+ * @file StereoLadder.h
+ * @brief Two ZDF Moog ladders processed as a two-lane SIMD pair
+ *
+ * The voice used to filter one mono signal and copy it to both outputs.
+ * StereoLadder runs a left and a right ladder in the two lanes of one
+ * vector, so every ladder operation serves both sides at once. The sides
+ * differ by a cutoff spread (left below, right above the modulated cutoff,
+ * in octaves) and a resonance spread (left less, right more), and may be fed
+ * from detuned oscillators, which gives the voice width.
+ *
+ * Each lane computes the per-sample recurrence of
+ * ZDFMoogLadderFilter::process() (same TPT stages, same feedback from the
+ * last stage, same LP24/BP12/HP24 taps), with three differences:
+ * - the saturating feedback uses a clamped 7/6 rational tanh (error below
+ *   1e-4) instead of tanhf(), so it vectorises
+ * - the linear path (drive 0) solves the zero-delay feedback loop instead of
+ *   feeding back the previous sample's last stage, and caps the feedback at
+ *   kMaxLinearFeedback. The one-sample-delayed linear loop is unstable from
+ *   resonance 0.3 once the cutoff passes a few kHz, and with no tanh to
+ *   bound it the idle ladder ran away on the filter noise
+ * - the output tap is a weighted sum chosen by setMode(), not a switch
+ *
+ * @performance_characteristics
+ * - Per sample: two table pre-warps (scalar), then about 30 two-lane vector
+ *   operations, plus 12 for the saturating feedback or 17 for the solved
+ *   linear feedback; roughly the operation count of one scalar ladder for
+ *   both sides
+ * - The lane state is loaded once per call and stored back at the end
+ * - The spread ratios and output taps follow setCutoffSpread() and
+ *   setMode() lazily: render() sets the mode every period, and they are
+ *   re-derived at the next process() only when a value actually changed
+ *
+ * @usage_example
+ * @code
+ * ladder.setMode(ZDFMoogLadderFilter::LP24);
+ * ladder.setDrive(1.0f);
+ * ladder.setCutoffSpread(0.1f);        // ±0.05 octave
+ * ladder.setResonanceSpread(0.02f);    // ±0.01
+ * ladder.process<48000>(inL, inR, cutoffHz, resonance, gain, outL, outR, frames);
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "SampleRate.h"
+#include "SimdLanes.h"
+#include "zdf_moogladder_v2.h"
+
+/**
+ * @class StereoLadder
+ * @brief Left/right ZDF ladder pair with cutoff and resonance spread
+ */
+class StereoLadder {
+public:
+    /** @brief Widest cutoff spread, octaves between the sides */
+    static constexpr float kMaxCutoffSpread = 1.0f;
+
+    /** @brief Widest resonance spread between the sides */
+    static constexpr float kMaxResonanceSpread = 0.25f;
+
+    /**
+     * @brief Feedback ceiling of the linear path (drive 0)
+     *
+     * At 4 the solved loop's poles sit on the unit circle and nothing
+     * limits the ring; just below it they stay inside, so the linear
+     * ladder still rings at full resonance but always decays.
+     */
+    static constexpr float kMaxLinearFeedback = 3.96f;
+
+    StereoLadder();
+
+    /**
+     * @brief Cutoff distance between the sides
+     *
+     * @param octaves [0, kMaxCutoffSpread]; the left side sits octaves/2
+     *                below the modulated cutoff, the right side above
+     * @realtime_safety Real-time safe; the ratios follow at the next process()
+     */
+    void setCutoffSpread(float octaves);
+
+    /**
+     * @brief Resonance distance between the sides
+     *
+     * @param amount [0, kMaxResonanceSpread]; left gets resonance − amount/2,
+     *               right resonance + amount/2, each clamped to [0, 1]
+     */
+    void setResonanceSpread(float amount);
+
+    /** @brief Feedback saturation [0, 1], as ZDFMoogLadderFilter::setDrive() */
+    void setDrive(float driveAmount);
+
+    /** @brief ZDFMoogLadderFilter::FilterMode; unknown values select LP24 */
+    void setMode(int newMode);
+
+    /**
+     * @brief Derive the spread ratios and output taps from the current targets
+     *
+     * process() calls this when a setter changed a target; calling it
+     * earlier only moves the work.
+     */
+    void updateCoefficients();
+
+    float getCutoffSpread() const { return cutoffSpread; }
+    float getResonanceSpread() const { return resonanceSpread; }
+
+    /** @brief Clear both ladders' state */
+    void reset();
+
+    /**
+     * @brief Filter a segment
+     *
+     * @tparam Rate Sample rate (selects the compile-time pre-warp scale)
+     * @param inputL Left input, `frames` samples
+     * @param inputR Right input; may be the same buffer as inputL
+     * @param cutoffHz Modulated cutoff per sample, before the spread
+     * @param resonance Resonance per sample, before the spread
+     * @param gain Output gain
+     * @param outputL Left output
+     * @param outputR Right output
+     * @param frames Samples to process
+     * @realtime_safety Real-time safe
+     */
+    template <int Rate>
+    void process(const float* inputL, const float* inputR, const float* cutoffHz, const float* resonance,
+                 float gain, float* outputL, float* outputR, unsigned int frames);
+
+    /**
+     * @struct Snapshot
+     * @brief Everything process() reads and writes (for OverrunCapture)
+     */
+    struct Snapshot {
+        float state[16];
+        float drive;
+        int mode;
+        float cutoffSpread;
+        float resonanceSpread;
+    };
+
+    void saveSnapshot(Snapshot& snapshot) const;
+    void loadSnapshot(const Snapshot& snapshot);
+
+private:
+    template <int Rate, bool Saturate>
+    void run(const float* inputL, const float* inputR, const float* cutoffHz, const float* resonance,
+             float gain, float* outputL, float* outputR, unsigned int frames);
+
+    /** @brief tanh for both lanes: clamped 7/6 continued-fraction approximant */
+    static vfloat2 saturate(vfloat2 x);
+
+    /**
+     * Interleaved lane state: stage[k] at [2k], [2k+1], z[k] at [8+2k],
+     * [8+2k+1] (left, right)
+     */
+    alignas(8) float state[16];
+
+    float cutoffRatio[2];       ///< 2^(∓spread/2)
+    float resonanceOffset[2];   ///< ∓spread/2
+    float cutoffSpread;         ///< Target; the ratios follow lazily
+    float resonanceSpread;
+    float drive;
+    int mode;                   ///< Target; the tap weights follow lazily
+
+    float appliedCutoffSpread;  ///< Spread the ratios were derived from
+    int appliedMode;            ///< Mode the tap weights were derived from
+    bool dirty;
+
+    /** Output = inputWeight·in + stage2Weight·stage[2] + stage3Weight·stage[3] */
+    float inputWeight;
+    float stage2Weight;
+    float stage3Weight;
+};
+
+// ============================================================================
+// Inline implementation
+// ============================================================================
+
+inline vfloat2 StereoLadder::saturate(vfloat2 x) {
+    /**
+     * x(135135 + 17325x² + 378x⁴ + x⁶) / (135135 + 62370x² + 3150x⁴ + 28x⁶)
+     * reaches 1 near |x| = 4.97; clamping the input at 5 and the output at
+     * ±1 keeps the error below 1e-4 everywhere
+     */
+    x = vf2_min(vf2_max(x, vf2_dup(-5.0f)), vf2_dup(5.0f));
+    const vfloat2 x2 = vf2_mul(x, x);
+    vfloat2 numerator = vf2_add(x2, vf2_dup(378.0f));
+    numerator = vf2_mla(vf2_dup(17325.0f), numerator, x2);
+    numerator = vf2_mul(vf2_mla(vf2_dup(135135.0f), numerator, x2), x);
+    vfloat2 denominator = vf2_mla(vf2_dup(3150.0f), x2, vf2_dup(28.0f));
+    denominator = vf2_mla(vf2_dup(62370.0f), denominator, x2);
+    denominator = vf2_mla(vf2_dup(135135.0f), denominator, x2);
+    const vfloat2 y = vf2_mul(numerator, vf2_recip(denominator));
+    return vf2_min(vf2_max(y, vf2_dup(-1.0f)), vf2_dup(1.0f));
+}
+
+template <int Rate>
+inline void StereoLadder::process(const float* inputL, const float* inputR, const float* cutoffHz,
+                                  const float* resonance, float gain, float* outputL, float* outputR,
+                                  unsigned int frames) {
+    if (dirty)
+        updateCoefficients();
+    /** Same threshold as the scalar ladder's linear path */
+    if (drive > 0.001f)
+        run<Rate, true>(inputL, inputR, cutoffHz, resonance, gain, outputL, outputR, frames);
+    else
+        run<Rate, false>(inputL, inputR, cutoffHz, resonance, gain, outputL, outputR, frames);
+}
+
+template <int Rate, bool Saturate>
+inline void StereoLadder::run(const float* inputL, const float* inputR, const float* cutoffHz,
+                              const float* resonance, float gain, float* outputL, float* outputR,
+                              unsigned int frames) {
+    typedef SampleRateTraits<Rate> RateTraits;
+
+    vfloat2 stage[4];
+    vfloat2 z[4];
+    for (int k = 0; k < 4; ++k) {
+        stage[k] = vf2_load(state + 2 * k);
+        z[k] = vf2_load(state + 8 + 2 * k);
+    }
+
+    const vfloat2 resonanceOffsets = vf2_load(resonanceOffset);
+    const vfloat2 zero = vf2_dup(0.0f);
+    const vfloat2 one = vf2_dup(1.0f);
+    const vfloat2 four = vf2_dup(4.0f);
+    const vfloat2 driveLanes = vf2_dup(drive);
+    const vfloat2 maxLinearFeedback = vf2_dup(kMaxLinearFeedback);
+    const vfloat2 inputWeights = vf2_dup(inputWeight * gain);
+    const vfloat2 stage2Weights = vf2_dup(stage2Weight * gain);
+    const vfloat2 stage3Weights = vf2_dup(stage3Weight * gain);
+
+    for (unsigned int n = 0; n < frames; ++n) {
+        /**
+         * Per-side coefficients: the table pre-warp is scalar, the
+         * resonance spread and clamp run in lanes
+         */
+        const WarpedCutoff warpedL = RateTraits::prewarp(cutoffHz[n] * cutoffRatio[0]);
+        const WarpedCutoff warpedR = RateTraits::prewarp(cutoffHz[n] * cutoffRatio[1]);
+        const vfloat2 stageGain = vf2_set(warpedL.stageGain, warpedR.stageGain);
+        vfloat2 sideResonance = vf2_add(vf2_dup(resonance[n]), resonanceOffsets);
+        sideResonance = vf2_min(vf2_max(sideResonance, zero), one);
+        const vfloat2 feedbackGain = vf2_mul(sideResonance, four);
+
+        const vfloat2 input = vf2_set(inputL[n], inputR[n]);
+        vfloat2 u;
+        if (Saturate) {
+            u = vf2_mls(input, feedbackGain, saturate(vf2_mul(stage[3], driveLanes)));
+        } else {
+            /**
+             * Each stage is g·in + (1 − g)·z, so the last stage is
+             * g⁴·u + S, S being the states' share. Solving
+             * y = g⁴(x − k·y) + S gives y = (g⁴x + S) / (1 + k·g⁴)
+             */
+            const vfloat2 stageHold = vf2_sub(one, stageGain);
+            vfloat2 stateShare = vf2_mul(z[0], stageHold);
+            for (int k = 1; k < 4; ++k)
+                stateShare = vf2_mla(vf2_mul(z[k], stageHold), stateShare, stageGain);
+            const vfloat2 gain2 = vf2_mul(stageGain, stageGain);
+            const vfloat2 gain4 = vf2_mul(gain2, gain2);
+            const vfloat2 linearFeedback = vf2_min(feedbackGain, maxLinearFeedback);
+            const vfloat2 solved = vf2_mul(vf2_mla(stateShare, gain4, input),
+                                           vf2_recip(vf2_mla(one, linearFeedback, gain4)));
+            u = vf2_mls(input, linearFeedback, solved);
+        }
+
+        for (int k = 0; k < 4; ++k) {
+            const vfloat2 v = vf2_mul(vf2_sub(u, z[k]), stageGain);
+            stage[k] = vf2_add(v, z[k]);
+            z[k] = vf2_add(stage[k], v);
+            u = stage[k];
+        }
+
+        vfloat2 output = vf2_mul(stage[3], stage3Weights);
+        output = vf2_mla(output, stage[2], stage2Weights);
+        output = vf2_mla(output, input, inputWeights);
+        outputL[n] = vf2_lane0(output);
+        outputR[n] = vf2_lane1(output);
+    }
+
+    for (int k = 0; k < 4; ++k) {
+        vf2_store(state + 2 * k, stage[k]);
+        vf2_store(state + 8 + 2 * k, z[k]);
+    }
+}
@@ -0,0 +1,140 @@
+/**
+ * @file SubBlockScheduler.cpp
+ * @brief Implementation of the fixed-size sub-block scheduler
+ */
+
+#include "SubBlockScheduler.h"
+#include "AudioArena.h"
+#include <cstring>
+
+namespace {
+
+unsigned int greatestCommonDivisor(unsigned int a, unsigned int b) {
+    while (b != 0) {
+        unsigned int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+} // namespace
+
+SubBlockScheduler::SubBlockScheduler()
+    : callback(nullptr), userData(nullptr), periodFrames(0), maxPeriodFrames(0), subBlockFrames(0),
+      numChannels(0), latencyFrames(0), direct(true), fifoCount(0) {
+    for (unsigned int c = 0; c < kMaxChannels; ++c) {
+        fifo[c] = nullptr;
+        scratch[c] = nullptr;
+    }
+}
+
+bool SubBlockScheduler::setup(unsigned int periodFrames, unsigned int maxPeriodFrames, unsigned int subBlockFrames,
+                              unsigned int numChannels, SubBlockCallback callback, void* userData,
+                              AudioArena& arena) {
+    if (periodFrames == 0 || periodFrames > maxPeriodFrames)
+        return false;
+    if (subBlockFrames == 0 || (subBlockFrames & 3u) != 0)
+        return false;
+    if (numChannels == 0 || numChannels > kMaxChannels || callback == nullptr)
+        return false;
+
+    this->maxPeriodFrames = maxPeriodFrames;
+    this->subBlockFrames = subBlockFrames;
+    this->numChannels = numChannels;
+    this->callback = callback;
+    this->userData = userData;
+
+    /**
+     * FIFO sized for the largest period: at most subBlock - 1 frames are
+     * carried over, then whole sub-blocks are appended until a period is
+     * covered. Reserved even in direct mode so setPeriod() never allocates.
+     */
+    for (unsigned int c = 0; c < numChannels; ++c) {
+        fifo[c] = arena.allocateFloats(maxPeriodFrames + subBlockFrames);
+        scratch[c] = arena.allocateFloats(subBlockFrames);
+        if (fifo[c] == nullptr || scratch[c] == nullptr)
+            return false;
+    }
+    fifoCount = 0;
+    return setPeriod(periodFrames);
+}
+
+bool SubBlockScheduler::setPeriod(unsigned int newPeriodFrames) {
+    if (newPeriodFrames == 0 || newPeriodFrames > maxPeriodFrames)
+        return false;
+
+    periodFrames = newPeriodFrames;
+    updateMode();
+    return true;
+}
+
+void SubBlockScheduler::updateMode() {
+    direct = (periodFrames % subBlockFrames) == 0 && fifoCount == 0;
+    if (direct) {
+        latencyFrames = 0;
+    }
+    else {
+        /**
+         * Frames still queued from the previous period size bound the
+         * latency from below until the FIFO next empties
+         */
+        latencyFrames = subBlockFrames - greatestCommonDivisor(periodFrames, subBlockFrames);
+        if (fifoCount > latencyFrames)
+            latencyFrames = fifoCount;
+    }
+}
+
+void SubBlockScheduler::process(float* const* outputs, unsigned int frames) {
+    float* channels[kMaxChannels];
+
+    /**
+     * The FIFO holds at most maxPeriodFrames + subBlock frames; a longer
+     * period is the caller's to reject
+     */
+    if (frames > maxPeriodFrames)
+        return;
+
+    if (direct && frames == periodFrames) {
+        /**
+         * Period is a whole number of sub-blocks: render in place
+         */
+        for (unsigned int offset = 0; offset < frames; offset += subBlockFrames) {
+            for (unsigned int c = 0; c < numChannels; ++c)
+                channels[c] = outputs[c] + offset;
+            callback(channels, subBlockFrames, userData);
+        }
+        return;
+    }
+
+    /**
+     * Bridged: top the FIFO up with whole sub-blocks until it covers the
+     * period. Sub-blocks are rendered into scratch rather than straight into
+     * the FIFO so the kernel always sees the same buffer start.
+     */
+    while (fifoCount < frames) {
+        callback(scratch, subBlockFrames, userData);
+        for (unsigned int c = 0; c < numChannels; ++c)
+            memcpy(fifo[c] + fifoCount, scratch[c], subBlockFrames * sizeof(float));
+        fifoCount += subBlockFrames;
+    }
+
+    /**
+     * Serve the period and shift the remainder (< one sub-block) to the front
+     */
+    const unsigned int remaining = fifoCount - frames;
+    for (unsigned int c = 0; c < numChannels; ++c) {
+        memcpy(outputs[c], fifo[c], frames * sizeof(float));
+        memmove(fifo[c], fifo[c] + frames, remaining * sizeof(float));
+    }
+    fifoCount = remaining;
+
+    /**
+     * Once the frames queued under an earlier period size have drained, a
+     * period that is a whole number of sub-blocks goes back to direct mode;
+     * an odd-sized block served in direct mode leaves frames queued and
+     * bridges until they drain
+     */
+    if (direct != (fifoCount == 0 && (periodFrames % subBlockFrames) == 0))
+        updateMode();
+}
@@ -0,0 +1,175 @@
+/**
+ * @file SubBlockScheduler.h
+ * @brief Fixed-size sub-block scheduler decoupling the DSP from the hardware period
+ *
+ * Bela calls render() with whatever period the command line asks for
+ * (`-p 16` in settings.json), so every DSP loop in the engine has had to cope
+ * with arbitrary frame counts. This scheduler runs the DSP in fixed,
+ * SIMD-friendly sub-blocks (a multiple of 4 frames, e.g. 8 or 32) regardless
+ * of the period, so kernels can be written without remainder loops and the
+ * period can be changed for latency without touching any DSP code.
+ *
+ * @operating_modes
+ * 1. **Direct**: The period is a whole multiple of the sub-block size. The
+ *    sub-block callback writes straight into the caller's period buffers at
+ *    sub-block offsets. No copy, no added latency.
+ * 2. **FIFO bridged**: Otherwise, sub-blocks are rendered on demand into an
+ *    internal FIFO and the period is served from it. Samples left over at the
+ *    end of a period were rendered ahead of time, so any control change made
+ *    in the following render() reaches the output that many frames late.
+ *
+ * @latency_model
+ * In FIFO mode the number of frames carried between periods is always a
+ * multiple of gcd(period, subBlock) and strictly less than the sub-block size,
+ * so the worst-case added control latency is subBlock - gcd(period, subBlock)
+ * frames. Direct mode reports zero. The audio stream itself is never delayed.
+ *
+ * @performance_characteristics
+ * - Direct mode: one indirect call per sub-block, no data movement
+ * - FIFO mode: one extra copy of each rendered sample
+ * - When the sub-block is larger than the period, rendering cost falls on
+ *   the periods that trigger a new sub-block; size the period accordingly
+ * - Memory: (maxPeriod + subBlock) frames per channel plus one sub-block of
+ *   scratch, taken from the AudioArena so sub-block scratch is 64-byte
+ *   aligned. The FIFO is always reserved so the period can change at run
+ *   time (see setPeriod()) without allocating.
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+class AudioArena;
+
+/**
+ * @class SubBlockScheduler
+ * @brief Runs a DSP callback in fixed-size sub-blocks and bridges to the period
+ *
+ * @usage_example
+ * @code
+ * void renderSubBlock(float* const* outputs, unsigned int frames, void* userData);
+ *
+ * SubBlockScheduler scheduler;
+ *
+ * // In setup():
+ * scheduler.setup(context->audioFrames, 256, 8, 1, renderSubBlock, nullptr, audioArena);
+ *
+ * // In render():
+ * float* outs[1] = { outputBuffer };
+ * scheduler.process(outs, context->audioFrames);
+ * @endcode
+ */
+class SubBlockScheduler {
+public:
+    /**
+     * @brief DSP callback invoked once per sub-block
+     *
+     * @param outputs One pointer per channel, each `frames` long
+     * @param frames Always equal to getSubBlockFrames()
+     * @param userData Pointer passed to setup()
+     */
+    typedef void (*SubBlockCallback)(float* const* outputs, unsigned int frames, void* userData);
+
+    /** @brief Upper bound on channels handled by one scheduler */
+    static const unsigned int kMaxChannels = 8;
+
+    /**
+     * @brief Construct an unconfigured scheduler (call setup() before use)
+     */
+    SubBlockScheduler();
+
+    /**
+     * @brief Configure sub-block size, channel count and callback
+     *
+     * @param periodFrames Hardware period (context->audioFrames)
+     * @param maxPeriodFrames Largest period setPeriod() will accept
+     * @param subBlockFrames Internal block size; must be a non-zero multiple of 4
+     * @param numChannels Number of output channels [1-kMaxChannels]
+     * @param callback Function rendering one sub-block
+     * @param userData Opaque pointer forwarded to the callback
+     * @param arena Unlocked arena the FIFO and scratch are taken from
+     *              (numChannels × (maxPeriod + subBlock) frames plus
+     *              numChannels sub-block buffers)
+     * @return false if the arguments are invalid or the arena is exhausted
+     *
+     * @realtime_safety Non-real-time safe (call from setup())
+     */
+    bool setup(unsigned int periodFrames, unsigned int maxPeriodFrames, unsigned int subBlockFrames,
+               unsigned int numChannels, SubBlockCallback callback, void* userData,
+               AudioArena& arena);
+
+    /**
+     * @brief Produce one hardware period of output
+     *
+     * @param outputs One non-interleaved buffer per channel, `frames` long
+     * @param frames Normally the configured period; any other count up to
+     *               maxPeriodFrames is served through the FIFO (used for the
+     *               blocks between a hardware change and setPeriod()); a
+     *               count beyond maxPeriodFrames renders nothing and leaves
+     *               the outputs untouched
+     *
+     * @complexity O(frames)
+     * @realtime_safety Real-time safe (no allocation, no system calls)
+     */
+    void process(float* const* outputs, unsigned int frames);
+
+    /**
+     * @brief Change the hardware period without reallocating
+     *
+     * Frames already rendered ahead stay in the FIFO, so the change is
+     * seamless; while any remain, the scheduler stays in bridged mode and
+     * process() returns to direct mode once they have drained. A period of
+     * whole sub-blocks carries the same remainder from period to period, so
+     * only a block of another size drains it.
+     *
+     * @param newPeriodFrames New period, at most maxPeriodFrames
+     * @return false if the period is out of range (nothing changes)
+     * @realtime_safety Real-time safe; call between periods
+     */
+    bool setPeriod(unsigned int newPeriodFrames);
+
+    /**
+     * @brief Replace the sub-block callback (e.g. a different rate instantiation)
+     *
+     * @realtime_safety Real-time safe; call between periods
+     */
+    void setCallback(SubBlockCallback newCallback) { callback = newCallback; }
+
+    /** @brief Configured sub-block size in frames */
+    unsigned int getSubBlockFrames() const { return subBlockFrames; }
+
+    /** @brief True when the period is a multiple of the sub-block size */
+    bool isDirect() const { return direct; }
+
+    /**
+     * @brief Worst-case control latency added by FIFO bridging, in frames
+     *
+     * @return 0 in direct mode, subBlock - gcd(period, subBlock) otherwise
+     */
+    unsigned int getLatencyFrames() const { return latencyFrames; }
+
+private:
+    /** @brief Derive direct and latencyFrames from the period and the FIFO fill */
+    void updateMode();
+
+    SubBlockCallback callback;
+    void* userData;
+
+    unsigned int periodFrames;
+    unsigned int maxPeriodFrames;
+    unsigned int subBlockFrames;
+    unsigned int numChannels;
+    unsigned int latencyFrames;
+    bool direct;
+
+    /** @brief Per-channel FIFO storage, (maxPeriod + subBlock) frames each */
+    float* fifo[kMaxChannels];
+
+    /** @brief Rendered frames not yet handed to the period */
+    unsigned int fifoCount;
+
+    /** @brief Per-channel scratch for one sub-block (keeps kernel writes aligned) */
+    float* scratch[kMaxChannels];
+};
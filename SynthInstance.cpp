@@ -0,0 +1,538 @@
+/**
+ * @file SynthInstance.cpp
+ * @brief Setup, MIDI handling and control updates of one synth part
+ */
+
+#include "SynthInstance.h"
+#include "StartupProfile.h"
+#include "TableBank.h"
+#include <time.h>
+
+namespace {
+
+/**
+ * LFO sync divisions of CC 37 / CC 39, in cycles per beat: 1 bar, 1/2,
+ * 1/4, 1/8, 1/8 triplet, 1/16, 1/16 triplet, 1/32
+ */
+const float kLfoSyncCyclesPerBeat[8] = { 0.25f, 0.5f, 1.0f, 2.0f, 3.0f, 4.0f, 6.0f, 8.0f };
+
+} // namespace
+
+SynthInstance::SynthInstance()
+    : oscillatorPhase(0.0f),
+      oscillatorPhaseRight(0.0f),
+      detuneCents(0.0f),
+      midiHandler(44100.0f, 1.0f),
+      noteLevel(1.0f),
+      noteAttackScale(1.0f),
+      ampAttackTicks(0.0f),
+      portamentoPlayer(44100.0f, kGlideTimeMs),
+      filterEnv(44100.0f),
+      keyFollow(0.33f),
+      resonanceRamp(44100.0f, 50.0f),
+      noiseGenerator(44100.0f),
+      lfoBank(44100.0f),
+      sequencer(44100.0f),
+      inputBuffer(nullptr),
+      inputBufferRight(nullptr),
+      cutoffHzBuffer(nullptr),
+      baseCutoffOctaves(12.287712f),      // log2(5000)
+      cutoffControl(0.0f),
+      ampEnvelopeRate(44100.0f / kAmpEnvelopeInterval),
+      stagedSampleRate(44100.0f),
+      stagedAudioRateModulation(false),
+      cutoffModulationOctaves(0.0f),
+      matrixEditSource(ModMatrix::kAmpEnvelope),
+      matrixEditDestination(ModMatrix::kCutoff),
+      midiHandlerRate(midiHandler),
+      portamentoPlayerRate(portamentoPlayer),
+      filterEnvRate(filterEnv, kCutoffInterval),
+      resonanceRampRate(resonanceRamp, kResonanceInterval),
+      noiseGeneratorRate(noiseGenerator),
+      lfoBankRate(lfoBank),
+      sequencerRate(sequencer),
+      midiChannel(kOmni),
+      startupProfile(nullptr),
+      periodNs(0),
+      busyNs(0.0),
+      audioNs(0.0),
+      worstLoad(0.0f),
+      periods(0) {
+    detuneRatio[0] = detuneRatio[1] = 1.0f;
+    for (int d = 0; d < NoiseGenerator::kNumDestinations; ++d)
+        noiseBuffers[d] = nullptr;
+}
+
+size_t SynthInstance::requiredStateBytes() {
+    return sizeof(SynthInstance) + AudioArena::kAlignment + AutomationLanes::requiredBytes(kNumAutomationLanes);
+}
+
+bool SynthInstance::setup(float sampleRate, uint32_t noiseSeed, AudioArena& arena) {
+    /**
+     * Both ladders start clear; cutoff and resonance arrive per sample from
+     * the modulation layer. Drive 1, 24 dB low-pass, and the sides 0.1
+     * octave and 0.02 resonance apart: a subtle width CC 23 widens or
+     * collapses to mono
+     */
+    stereoLadder.reset();
+    stereoLadder.setDrive(1.0f);
+    stereoLadder.setMode(0);
+    stereoLadder.setCutoffSpread(0.1f);
+    stereoLadder.setResonanceSpread(0.02f);
+
+    /**
+     * -100 dBFS filter noise, ±2 cents pitch and ±0.03 octave cutoff drift
+     */
+    noiseGenerator = NoiseGenerator(sampleRate, noiseSeed);
+
+    /**
+     * Oscillator staging, cutoff in Hz and noise destinations, one
+     * sub-block each
+     */
+    inputBuffer = arena.allocateFloats(kSubBlockFrames);
+    inputBufferRight = arena.allocateFloats(kSubBlockFrames);
+    cutoffHzBuffer = arena.allocateFloats(kSubBlockFrames);
+    for (int d = 0; d < NoiseGenerator::kNumDestinations; ++d)
+        noiseBuffers[d] = arena.allocateFloats(kSubBlockFrames);
+    if (!inputBuffer || !inputBufferRight || !cutoffHzBuffer || !noiseBuffers[NoiseGenerator::kNumDestinations - 1])
+        return false;
+
+    /**
+     * Automation lanes; CC 14's lane starts from the default cutoff
+     */
+    if (!automation.allocate(kNumAutomationLanes, arena))
+        return false;
+    cutoffControl = (baseCutoffOctaves - kCutoffCurveFloor) / kCutoffCurveOctaves;
+
+    /**
+     * Modulation sources at their declared rates, in ModulationSource order
+     */
+    if (modulation.addSource(tickAmpEnvelope, this, kAmpEnvelopeInterval, true) != kModAmpEnvelope ||
+        modulation.addSource(tickCutoff, this, kCutoffInterval, true) != kModCutoff ||
+        modulation.addSource(tickResonance, this, kResonanceInterval, false) != kModResonance)
+        return false;
+    return modulation.allocate(kSubBlockFrames, arena);
+}
+
+void SynthInstance::loadDefaults() {
+    /**
+     * Filter envelope: 1 ms attack, 100 ms decay, 75% sustain, 200 ms
+     * release, 48 semitones deep; resonance starts at 0.5
+     */
+    filterEnv.setADSR(0.001f, 0.1f, 0.75f, 0.2f);
+    filterEnv.setEnvDepth(48.0f);
+    resonanceRamp.setTarget(0.5f);
+
+    /**
+     * LFO 1: 0.5 Hz triangle for cutoff sweeps (depth from CC 18)
+     * LFO 2: 5.5 Hz sine vibrato, restarted on note-on (depth from CC 19)
+     */
+    lfoBank.setShape(0, LfoBank::kTriangle);
+    lfoBank.setRate(0, 0.5f);
+    lfoBank.setRoute(0, LfoBank::kCutoff, 0.0f);
+    lfoBank.setShape(1, LfoBank::kSine);
+    lfoBank.setRate(1, 5.5f);
+    lfoBank.setRetrigger(1, true);
+    lfoBank.setRoute(1, LfoBank::kPitch, 0.0f);
+
+    /**
+     * Mod wheel opens the cutoff by up to an octave; pressure adds drive.
+     * Expression is a volume pedal: +1 from the pedal against a constant
+     * -1, with the pedal starting fully up so the gain starts at unity.
+     */
+    modMatrix.setDepth(ModMatrix::kModWheel, ModMatrix::kCutoff, 0.25f);
+    modMatrix.setDepth(ModMatrix::kAftertouch, ModMatrix::kDrive, 0.5f);
+    modMatrix.setDepth(ModMatrix::kExpression, ModMatrix::kGain, 1.0f);
+    modMatrix.setDepth(ModMatrix::kConstant, ModMatrix::kGain, -1.0f);
+    modMatrix.setSource(ModMatrix::kExpression, 1.0f);
+    lfoBank.setTapped(0, modMatrix.isSourceUsed(ModMatrix::kLfo1));
+    lfoBank.setTapped(1, modMatrix.isSourceUsed(ModMatrix::kLfo2));
+
+    /**
+     * Soft notes are quieter (exponential, about -6 dB at velocity 64),
+     * open the filter less, and hard notes attack up to twice as fast
+     */
+    velocityParser.setCurve(VelocityParser::kAmplitude, VelocityParser::kExponential, 0.6f);
+    velocityParser.setCurve(VelocityParser::kFilterDepth, VelocityParser::kLinear, 0.75f);
+    velocityParser.setCurve(VelocityParser::kAttack, VelocityParser::kLinear, 0.5f);
+
+    /**
+     * Default 16-step bass line (off until CC 20 selects a mode)
+     * Root/octave/fifth with an accent on each beat, a ratchet on step 8,
+     * a slide into step 12 and rests on steps 6 and 15
+     */
+    static const uint8_t notes[16] = {36, 36, 48, 36, 43, 36, 39, 36,
+                                      36, 48, 46, 43, 36, 41, 36, 43};
+    for (int i = 0; i < 16; ++i) {
+        StepSequencer::Step step;
+        step.note = notes[i];
+        step.velocity = (i % 4 == 0) ? 120 : 90;
+        step.active = (i != 5 && i != 14);
+        step.ratchet = (i == 7) ? 2 : 1;
+        step.slide = (i == 10);
+        sequencer.setStep(i, step);
+    }
+    sequencer.setLength(16);
+    sequencer.setArpeggiator(StepSequencer::kUp, 2, 0.5f, 100);
+
+    /**
+     * Amplitude envelope, in envelope ticks: 10 ms attack, 12 ms decay to
+     * 65%, 250 ms release; exponential attack (ratio 0.3) and near-linear
+     * decay and release (0.0001)
+     */
+    envelope.reset();
+    ampAttackTicks = 0.01f * ampEnvelopeRate;
+    envelope.setAttackRate(ampAttackTicks);
+    envelope.setDecayRate(0.012f * ampEnvelopeRate);
+    envelope.setReleaseRate(0.25f * ampEnvelopeRate);
+    envelope.setSustainLevel(0.65f);
+    envelope.setTargetRatioA(0.3f);
+    envelope.setTargetRatioDR(0.0001f);
+}
+
+bool SynthInstance::prepareRate(const EngineRate& rate) {
+    if (!midiHandlerRate.prepareRate(rate) ||
+        !portamentoPlayerRate.prepareRate(rate) ||
+        !filterEnvRate.prepareRate(rate) ||
+        !resonanceRampRate.prepareRate(rate) ||
+        !noiseGeneratorRate.prepareRate(rate) ||
+        !lfoBankRate.prepareRate(rate) ||
+        !sequencerRate.prepareRate(rate))
+        return false;
+    stagedAudioRateModulation = rate.audioRateModulation;
+    stagedSampleRate = rate.sampleRate;
+    return true;
+}
+
+void SynthInstance::commitRate() {
+    midiHandlerRate.commitRate();
+    portamentoPlayerRate.commitRate();
+    filterEnvRate.commitRate();
+    resonanceRampRate.commitRate();
+    noiseGeneratorRate.commitRate();
+    lfoBankRate.commitRate();
+    sequencerRate.commitRate();
+    modulation.setAudioRate(stagedAudioRateModulation);
+    ampEnvelopeRate = stagedSampleRate / modulation.getEffectiveInterval(kAmpEnvelopeInterval);
+}
+
+void SynthInstance::noteMessage(int note, int velocity, bool noteOnStatus, float currentTimeMs) {
+    /**
+     * In arpeggiator mode keys feed the arpeggiator, not the voice
+     */
+    if (sequencer.getMode() == StepSequencer::kArpeggiator) {
+        if (VelocityParser::isNoteOn(noteOnStatus, velocity))
+            sequencer.arpNoteOn(note);
+        else
+            sequencer.arpNoteOff(note);
+    }
+    else {
+        midiHandler.processMidiMessage(note, velocity, noteOnStatus, currentTimeMs);
+    }
+}
+
+void SynthInstance::controlChange(int controller, int value, uint64_t sampleClock) {
+    /**
+     * CC 14: Filter Cutoff, f = 20 * 1500^(cc/127) [20 Hz - 30 kHz], in octaves
+     * CC 15: Filter Resonance [0.0-1.0]
+     */
+    if (controller == 14) {
+        cutoffControl = value / 127.0f;
+        baseCutoffOctaves = kCutoffCurveFloor + cutoffControl * kCutoffCurveOctaves;
+    }
+    else if (controller == 15) {
+        resonanceRamp.setTarget(value / 127.0f);
+    }
+    /**
+     * CC 17: LFO 1 Rate, 0.05-20 Hz exponential
+     * CC 18: LFO 1 → Cutoff Depth, 0-2 octaves
+     * CC 19: LFO 2 → Pitch (vibrato) Depth, 0-50 cents
+     */
+    else if (controller == 17) {
+        lfoBank.setRate(0, kLfoRateCurveTable.value[value]);
+    }
+    else if (controller == 18) {
+        lfoBank.setRoute(0, LfoBank::kCutoff, value * (2.0f / 127.0f));
+    }
+    else if (controller == 19) {
+        lfoBank.setRoute(1, LfoBank::kPitch, value * (50.0f / 127.0f));
+    }
+    /**
+     * CC 36 / CC 38: LFO 1 / LFO 2 Shape (sine, triangle, saw, square,
+     *                sample & hold, smooth random in six equal ranges)
+     * CC 37 / CC 39: LFO 1 / LFO 2 Sync: 0-63 free at the CC 17 (or
+     *                default) rate; 64-127 synced to MIDI clock, eight
+     *                divisions from 1 bar to 1/32
+     */
+    else if (controller == 36 || controller == 38) {
+        lfoBank.setShape((controller - 36) / 2, static_cast<LfoBank::Shape>(value * LfoBank::kNumShapes / 128));
+    }
+    else if (controller == 37 || controller == 39) {
+        lfoBank.setSync((controller - 37) / 2, value < 64 ? 0.0f : kLfoSyncCyclesPerBeat[(value - 64) / 8]);
+    }
+    /**
+     * CC 20: Sequencer Mode (0-42 off, 43-85 pattern, 86-127 arpeggiator)
+     * CC 21: Sequencer Swing, 50-75%
+     * CC 22: Sequencer Internal Tempo, 40-294 BPM
+     */
+    else if (controller == 20) {
+        StepSequencer::Mode mode = (value < 43) ? StepSequencer::kOff
+                                 : (value < 86) ? StepSequencer::kPattern
+                                                : StepSequencer::kArpeggiator;
+        sequencer.setMode(mode, sampleClock);
+        if (mode != StepSequencer::kOff)
+            automation.restart();
+    }
+    else if (controller == 21) {
+        sequencer.setSwing(0.5f + value * (0.25f / 127.0f));
+    }
+    else if (controller == 22) {
+        sequencer.setTempo(40.0f + value * 2.0f);
+    }
+    /**
+     * CC 23: Stereo Spread, 0-1 octave of cutoff between the sides,
+     *        with a resonance spread of up to 0.1 alongside
+     * CC 24: Oscillator Detune between the sides, 0-20 cents
+     */
+    else if (controller == 23) {
+        stereoLadder.setCutoffSpread(value * (1.0f / 127.0f));
+        stereoLadder.setResonanceSpread(value * (0.1f / 127.0f));
+    }
+    else if (controller == 24) {
+        detuneCents = value * (20.0f / 127.0f);
+        detuneRatio[0] = tableExp2(detuneCents * (-0.5f / 1200.0f));
+        detuneRatio[1] = tableExp2(detuneCents * (0.5f / 1200.0f));
+    }
+    /**
+     * CC 30: Automation Transport (0-42 live, 43-85 loop the take,
+     *        86-127 record a new take); acts on changes only, so a
+     *        controller resending its value does not restart a take
+     */
+    else if (controller == 30) {
+        const AutomationLanes::State requested = (value < 43) ? AutomationLanes::kIdle
+                                               : (value < 86) ? AutomationLanes::kPlaying
+                                                              : AutomationLanes::kRecording;
+        if (requested != automation.getState()) {
+            if (requested == AutomationLanes::kRecording)
+                automation.record();
+            else if (requested == AutomationLanes::kPlaying)
+                automation.play();
+            else
+                automation.stop();
+        }
+    }
+    /**
+     * CC 1 / CC 11: Mod Wheel and Expression, matrix sources only
+     */
+    else if (controller == 1) {
+        modMatrix.setSource(ModMatrix::kModWheel, value / 127.0f);
+    }
+    else if (controller == 11) {
+        modMatrix.setSource(ModMatrix::kExpression, value / 127.0f);
+    }
+    /**
+     * CC 31-33: Matrix Edit
+     * CC 31 selects the source and CC 32 the destination (the range is
+     * split evenly over the enum); CC 33 sets that cell's depth, bipolar
+     * around 64 (0 removes the routing). An LFO routed only through the
+     * matrix must still run, so its tap is refreshed.
+     */
+    else if (controller == 31) {
+        matrixEditSource = static_cast<ModMatrix::Source>(value * ModMatrix::kNumSources / 128);
+    }
+    else if (controller == 32) {
+        matrixEditDestination = static_cast<ModMatrix::Destination>(value * ModMatrix::kNumDestinations / 128);
+    }
+    else if (controller == 33) {
+        modMatrix.setDepth(matrixEditSource, matrixEditDestination, (value - 64) / 63.0f);
+        lfoBank.setTapped(0, modMatrix.isSourceUsed(ModMatrix::kLfo1));
+        lfoBank.setTapped(1, modMatrix.isSourceUsed(ModMatrix::kLfo2));
+    }
+    /**
+     * CC 34: Velocity Curve (linear, exponential, compressed, custom in
+     *        four equal ranges), for every target at its amount
+     */
+    else if (controller == 34) {
+        const VelocityParser::Curve curve =
+            static_cast<VelocityParser::Curve>(value * VelocityParser::kNumCurves / 128);
+        for (int t = 0; t < VelocityParser::kNumTargets; ++t) {
+            const VelocityParser::Target target = static_cast<VelocityParser::Target>(t);
+            velocityParser.setCurve(target, curve, velocityParser.getAmount(target));
+        }
+    }
+}
+
+void SynthInstance::channelPressure(int value) {
+    modMatrix.setSource(ModMatrix::kAftertouch, value / 127.0f);
+}
+
+void SynthInstance::clockTick(float currentTimeMs, uint64_t sampleClock) {
+    lfoBank.clockTick(currentTimeMs);
+    sequencer.clockTick(sampleClock);
+}
+
+void SynthInstance::clockStart() {
+    lfoBank.clockStart();
+    sequencer.clockStart();
+    automation.restart();
+}
+
+void SynthInstance::clockStop(uint64_t sampleClock) {
+    sequencer.clockStop(sampleClock);
+}
+
+void SynthInstance::processDelayedMidi(float currentTimeMs) {
+    midiHandler.update(currentTimeMs);
+
+    while (midiHandler.hasDelayedMessage()) {
+        MidiNoteMessage delayedMsg = midiHandler.popDelayedMessage();
+
+        /**
+         * Note-off by status (8x) or by a velocity-0 note-on, per the MIDI
+         * standard; any other velocity is a note, however soft
+         */
+        bool noteOnMessage = VelocityParser::isNoteOn(delayedMsg.noteOn, delayedMsg.velocity);
+
+        /**
+         * Glide when the new note overlaps the last one (legato playing)
+         */
+        bool portamento = portamentoFilter.checkPortamento(
+            delayedMsg.noteNumber, noteOnMessage, delayedMsg.timestamp);
+
+        if (noteOnMessage)
+            noteOn(delayedMsg.noteNumber, delayedMsg.velocity, portamento, false);
+        else
+            noteOff();
+    }
+}
+
+void SynthInstance::updateControls(unsigned int periodFrames, uint64_t sampleClock) {
+    const uint64_t startNs = loadClock();
+
+    /**
+     * Automation: record the live values or replace them with the take.
+     * The grid advances by this period's share of a beat at the sequencer's
+     * tempo (the MIDI clock's while one runs)
+     */
+    float laneValues[kNumAutomationLanes] = { panel.cutoff, panel.resonance, cutoffControl };
+    automation.process(laneValues, periodFrames / sequencer.getBeatSamples(sampleClock));
+    if (automation.getState() == AutomationLanes::kPlaying) {
+        panel.cutoff = laneValues[kLaneCutoffPot];
+        panel.resonance = laneValues[kLaneResonancePot];
+        if (automation.isTouched(kLaneCutoffCc))
+            baseCutoffOctaves = kCutoffCurveFloor + laneValues[kLaneCutoffCc] * kCutoffCurveOctaves;
+    }
+
+    /**
+     * Parameters that do not need per-sample resolution. The setters only
+     * store targets; the envelope and the ladder re-derive their
+     * coefficients at their next step if a value actually moved
+     * (ParameterUpdate.h)
+     */
+    resonanceRamp.setTarget(panel.resonance);
+    stereoLadder.setMode(panel.mode);
+
+    // Filter envelope depth: 0-48 semitones (4 octaves maximum)
+    filterEnv.setEnvDepth(panel.envDepth * 48.0f);
+
+    // Attack time: 1ms to ~1 second (in envelope ticks), scaled by the note's velocity
+    ampAttackTicks = 0.001f * ampEnvelopeRate + panel.attack * 1.0f * ampEnvelopeRate;
+    envelope.setAttackRate(ampAttackTicks * noteAttackScale);
+
+    // Release time: 5ms to 2 seconds (in envelope ticks)
+    envelope.setReleaseRate(0.005f * ampEnvelopeRate +
+                           panel.release * 1.995f * ampEnvelopeRate);
+
+    periodNs += loadClock() - startNs;
+}
+
+float SynthInstance::tickAmpEnvelope(void* userData) {
+    SynthInstance* self = static_cast<SynthInstance*>(userData);
+    return self->envelope.process() * self->noteLevel;
+}
+
+/**
+ * The cutoff bus: base, key follow, filter envelope, analog drift, LFOs and
+ * matrix, and the cutoff pot, all in octaves, so every source moves the
+ * cutoff by the same musical interval at any base frequency. The drift
+ * buffer is read at the sample the tick is evaluated for. The sum is
+ * interpolated in octaves and converted to Hz per sample in renderSegment().
+ */
+float SynthInstance::tickCutoff(void* userData) {
+    SynthInstance* self = static_cast<SynthInstance*>(userData);
+    const float* cutoffDrift = self->noiseBuffers[NoiseGenerator::kCutoffDrift];
+    return self->baseCutoffOctaves
+         + self->keyFollow.processOctaves(self->portamentoPlayer.getCurrentNote())
+         + self->filterEnv.processOctaves()
+         + cutoffDrift[self->modulation.getTickFrame()]
+         + self->cutoffModulationOctaves
+         + (self->panel.cutoff - kCutoffPotUnity) * kCutoffPotOctaves;
+}
+
+float SynthInstance::tickResonance(void* userData) {
+    SynthInstance* self = static_cast<SynthInstance*>(userData);
+    return self->resonanceRamp.process() + self->lfoBank.getDestination(LfoBank::kResonance)
+         + self->modMatrix.getDestination(ModMatrix::kResonance);
+}
+
+void SynthInstance::noteOn(int note, int velocity, bool portamento, bool legato) {
+    if (startupProfile)
+        startupProfile->mark(StartupProfile::kFirstNote);
+    modMatrix.setSource(ModMatrix::kVelocity, velocity / 127.0f);
+
+    // Trigger pitch generator with portamento logic, glide time from the matrix
+    portamentoPlayer.setPortamentoTime(kGlideTimeMs * tableExp2(modMatrix.getDestination(ModMatrix::kGlide)));
+    portamentoPlayer.noteOn(note, portamento || legato);
+    if (legato)
+        return;
+
+    // Velocity dynamics: three table reads, the attack applies from this note
+    noteLevel = velocityParser.getAmplitude(velocity);
+    noteAttackScale = velocityParser.getAttackScale(velocity);
+    envelope.setAttackRate(ampAttackTicks * noteAttackScale);
+
+    envelope.gate(1);
+    filterEnv.gate(1, velocityParser.getFilterDepth(velocity));
+    lfoBank.noteOn();
+
+    modulation.restartSource(kModAmpEnvelope);
+    modulation.restartSource(kModCutoff);
+}
+
+void SynthInstance::noteOff() {
+    // Release pitch generator (maintains current pitch)
+    portamentoPlayer.noteOff();
+    envelope.gate(0);
+    filterEnv.gate(0, 0.0f);
+
+    modulation.restartSource(kModAmpEnvelope);
+    modulation.restartSource(kModCutoff);
+}
+
+uint64_t SynthInstance::loadClock() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void SynthInstance::endPeriod(double periodAudioNs) {
+    const float load = static_cast<float>(periodNs / periodAudioNs);
+    if (load > worstLoad)
+        worstLoad = load;
+    busyNs += static_cast<double>(periodNs);
+    audioNs += periodAudioNs;
+    periodNs = 0;
+    ++periods;
+}
+
+void SynthInstance::reportLoad(FILE* out, unsigned int index) const {
+    if (periods == 0)
+        return;
+    char channel[16];
+    if (midiChannel == kOmni)
+        snprintf(channel, sizeof(channel), "omni");
+    else
+        snprintf(channel, sizeof(channel), "ch %d", midiChannel + 1);
+    fprintf(out, "  instance %u (%-5s) mean %6.3f%%  worst %6.3f%%  over %u periods\n",
+            index, channel, 100.0 * getMeanLoad(), 100.0f * worstLoad, periods);
+}
@@ -0,0 +1,714 @@
+/**
+ * @file SynthInstance.h
+ * @brief One complete TR-123e part: voice, modulation, sequencer and parameter set
+ *
+ * render.cpp used to define every module of the voice as a global, so a
+ * process could play exactly one part and nothing could run two of them
+ * side by side. A SynthInstance owns everything one part needs - oscillator,
+ * both envelopes, the stereo ladder, portamento, LFOs, modulation layer and
+ * matrix, velocity curves, step sequencer, automation lanes and its own
+ * panel values - and listens on its own MIDI channel. render() hosts up to
+ * eight of them in one callback and sums them into the shared master bus.
+ *
+ * @ownership
+ * | Per instance                                | Host (render.cpp)                    |
+ * |---------------------------------------------|--------------------------------------|
+ * | Voice, envelopes, ladder, LFOs, matrix      | MIDI port, arena, sub-block scheduler|
+ * | Sequencer, automation lanes, panel values   | Cabinet, post-FX chain, master output|
+ * | MIDI channel filter, CC 1, 11, 14-15, 17-24,| CC 16, 25-29, 35; reconfiguration,   |
+ * | 30-34, 36-39, notes, channel pressure       | trace, capture, session recording    |
+ *
+ * MIDI clock and start/stop reach every instance. The hardware pots belong
+ * to whichever instance the host points them at; the others keep the panel
+ * values they were last given.
+ *
+ * @rate_handling
+ * An instance is a single RateListener: it prepares and commits all of its
+ * rate-dependent modules together, so adding an instance costs the
+ * reconfiguration pipeline one listener slot, not seven.
+ *
+ * @performance_characteristics
+ * - Per instance and period: MIDI dispatch, one control update, and the
+ *   sub-blocks of the voice; no shared state is touched, so N instances
+ *   cost N times one (DEV/InstanceScalingBench.cpp measures it)
+ * - Each instance times its own control update and sub-blocks; the host
+ *   reports the mean and worst share of real time per instance
+ * - Memory: the instance object, kSubBlockBuffers sub-block buffers and
+ *   its automation lanes, all from the audio arena
+ *
+ * @usage_example
+ * @code
+ * // setup():
+ * SynthInstance* bass = audioArena.create<SynthInstance>();
+ * bass->setup(sampleRate, 1, audioArena);
+ * bass->setMidiChannel(0);                   // MIDI channel 1
+ * reconfigurePipeline.addListener(bass);
+ * reconfigurePipeline.reconfigureNow(rate);
+ * bass->loadDefaults();
+ *
+ * // render(), per period:
+ * if (bass->acceptsChannel(message.getChannel()))
+ *     bass->controlChange(controller, value, sampleClock);
+ * bass->processDelayedMidi(currentTimeMs);
+ * bass->updateControls(context->audioFrames, sampleClock);
+ * bass->scheduleSequencer(sampleClock + context->audioFrames + SynthInstance::kSubBlockFrames);
+ *
+ * // sub-block callback:
+ * bass->renderSubBlock<44100>(outputL, outputR, frames, sampleClock);
+ * @endcode
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "ADSR.h"
+#include "AudioArena.h"
+#include "AutomationLanes.h"
+#include "KeyFollow.h"
+#include "LfoBank.h"
+#include "MidiHandler.h"
+#include "ModMatrix.h"
+#include "ModulationLayer.h"
+#include "MoogFilterEnvelope.h"
+#include "NoiseGenerator.h"
+#include "PortamentoFilter.h"
+#include "PortamentoPlayer.h"
+#include "ReconfigurePipeline.h"
+#include "ResonanceRamp.h"
+#include "SampleRate.h"
+#include "SimdLanes.h"
+#include "StepSequencer.h"
+#include "StereoLadder.h"
+#include "TableBank.h"
+#include "VelocityParser.h"
+
+class StartupProfile;
+
+/**
+ * @struct PanelControls
+ * @brief Analog potentiometer values sampled once per hardware period
+ *
+ * Read by the host before the sub-blocks run and handed to the instance
+ * the pots control. Pots move at human speed, so one reading per period
+ * (0.36ms at -p 16) is indistinguishable from per-sample reads and saves
+ * eight analogRead() calls per sample.
+ */
+struct PanelControls {
+    float cutoff = 0.5f;        ///< Cutoff scaling pot [0-1]
+    float resonance = 0.5f;     ///< Resonance pot [0-1]
+    int mode = 0;               ///< Filter mode [0-2]
+    float outGain = 1.0f;       ///< Output gain [0-2]
+    float drive = 0.0f;         ///< Filter drive [0-1]
+    float envDepth = 1.0f;      ///< Filter envelope depth pot [0-1]
+    float attack = 0.0f;        ///< Amplitude attack pot [0-1]
+    float release = 0.0f;       ///< Amplitude release pot [0-1]
+};
+
+/**
+ * @class SynthInstance
+ * @brief A monophonic part with its own MIDI channel, state and parameters
+ */
+class SynthInstance : public RateListener {
+public:
+    /**
+     * @brief Internal DSP block size in frames
+     *
+     * All synthesis and filtering runs in sub-blocks of this fixed size, whatever
+     * the hardware period. Must be a multiple of 4 so vector kernels need no
+     * remainder loops; 8 keeps control granularity at ~0.18ms at 44.1kHz.
+     */
+    static const unsigned int kSubBlockFrames = 8;
+
+    /**
+     * @brief Sub-block buffers each instance takes from the arena
+     *
+     * Oscillator staging left and right, cutoff in Hz, one per noise
+     * destination, and the modulation layer's ramp and source buffers.
+     */
+    static const unsigned int kSubBlockBuffers = 3 + NoiseGenerator::kNumDestinations + 1 + 3;
+
+    /** @brief setMidiChannel() value that accepts every channel */
+    static const int kOmni = -1;
+
+    SynthInstance();
+
+    /**
+     * @brief Arena bytes for the instance object and its automation lanes,
+     *        beyond its kSubBlockBuffers (AudioArenaConfig::voiceStateBytes)
+     */
+    static size_t requiredStateBytes();
+
+    /**
+     * @brief Take buffers from the arena and set up the ladder, noise and modulation
+     *
+     * @param sampleRate Context rate the noise generator starts at
+     * @param noiseSeed Seed of this instance's noise and drift, so parts
+     *                  do not drift in lockstep
+     * @return false if the arena is exhausted
+     * @realtime_safety Non-real-time safe (setup() only)
+     */
+    bool setup(float sampleRate, uint32_t noiseSeed, AudioArena& arena);
+
+    /**
+     * @brief Envelope, LFO, matrix, velocity and sequencer defaults
+     *
+     * Call after the first rate commit: envelope times are given in ticks
+     * of the committed modulation rate.
+     */
+    void loadDefaults();
+
+    /** @brief Profile whose first-note milestone this instance marks (optional) */
+    void setStartupProfile(StartupProfile* profile) { startupProfile = profile; }
+
+    // ========================================================================
+    // Rate handling (ReconfigurePipeline)
+    // ========================================================================
+
+    bool prepareRate(const EngineRate& rate) override;
+    void commitRate() override;
+
+    // ========================================================================
+    // MIDI
+    // ========================================================================
+
+    /**
+     * @brief Channel this instance listens on
+     *
+     * @param channel 0-15 (MIDI channels 1-16) or kOmni
+     */
+    void setMidiChannel(int channel) { midiChannel = channel; }
+    int getMidiChannel() const { return midiChannel; }
+    bool acceptsChannel(int channel) const { return midiChannel == kOmni || channel == midiChannel; }
+
+    /**
+     * @brief Note-on or note-off, to the arpeggiator or the MIDI delay path
+     *
+     * @param noteOnStatus true for a 9x status, false for 8x
+     * @param currentTimeMs Arrival time, the delay path's clock
+     */
+    void noteMessage(int note, int velocity, bool noteOnStatus, float currentTimeMs);
+
+    /**
+     * @brief Apply one of the instance's controllers; others are ignored
+     *
+     * @param sampleClock Host sample clock (sequencer mode changes are timed on it)
+     */
+    void controlChange(int controller, int value, uint64_t sampleClock);
+
+    /** @brief Channel pressure, the matrix's aftertouch source */
+    void channelPressure(int value);
+
+    /** @brief MIDI clock (0xF8): synced LFOs and the sequencer PLL */
+    void clockTick(float currentTimeMs, uint64_t sampleClock);
+
+    /** @brief MIDI start (0xFA) */
+    void clockStart();
+
+    /** @brief MIDI stop (0xFC) */
+    void clockStop(uint64_t sampleClock);
+
+    /**
+     * @brief Play the notes whose MIDI delay has elapsed
+     *
+     * @realtime_safety Real-time safe
+     */
+    void processDelayedMidi(float currentTimeMs);
+
+    // ========================================================================
+    // Per-period controls
+    // ========================================================================
+
+    /** @brief Hand the instance the hardware pots' values for this period */
+    void setPanel(const PanelControls& controls) { panel = controls; }
+
+    /** @brief Panel values in effect (after automation playback) */
+    const PanelControls& getPanel() const { return panel; }
+
+    /**
+     * @brief Automation and the period-rate parameter updates
+     *
+     * @param periodFrames Frames in this hardware period
+     * @param sampleClock Host sample clock at the start of the period
+     */
+    void updateControls(unsigned int periodFrames, uint64_t sampleClock);
+
+    /**
+     * @brief Generate sequencer events up to a sample-clock time
+     */
+    void scheduleSequencer(uint64_t until) { sequencer.schedule(until); }
+
+    // ========================================================================
+    // Rendering
+    // ========================================================================
+
+    /**
+     * @brief Synthesis and filtering for one fixed-size sub-block
+     *
+     * Sequencer events due inside the sub-block split it into segments, so
+     * each event reaches the voice at its exact frame; without events the
+     * whole sub-block is one segment.
+     *
+     * @tparam Rate Sample rate in Hz; all rate-derived constants (phase
+     *              increment scale, cutoff pre-warp) are compile-time values
+     * @param outputL Left destination, overwritten
+     * @param outputR Right destination, overwritten
+     * @param frames Sub-block length (always kSubBlockFrames)
+     * @param blockStart Host sample clock at the first frame
+     * @realtime_safety Real-time safe (no dynamic allocation or blocking operations)
+     */
+    template <int Rate>
+    void renderSubBlock(float* outputL, float* outputR, unsigned int frames, uint64_t blockStart);
+
+    // ========================================================================
+    // Load
+    // ========================================================================
+
+    /**
+     * @brief Close the period's load measurement (host, once per render())
+     *
+     * @param audioNs Duration of the audio rendered this period
+     */
+    void endPeriod(double audioNs);
+
+    /**
+     * @brief Print this instance's mean and worst share of real time
+     *
+     * @param index Position of the instance in the host
+     * @realtime_safety Non-real-time (stdio)
+     */
+    void reportLoad(FILE* out, unsigned int index) const;
+
+    /** @brief Mean share of real time spent in the instance so far */
+    double getMeanLoad() const { return audioNs > 0.0 ? busyNs / audioNs : 0.0; }
+
+    /**
+     * @brief MIDI messages the delay queues dropped because they were full
+     *
+     * A dropped note-off leaves its note hanging, so cleanup() reports this.
+     */
+    unsigned int getDroppedMidiMessages() const { return midiHandler.getDroppedMessages(); }
+
+    // ========================================================================
+    // Modules the host binds to (overrun capture, trace, tempo)
+    // ========================================================================
+
+    ADSR& getEnvelope() { return envelope; }
+    StereoLadder& getStereoLadder() { return stereoLadder; }
+    PortamentoPlayer& getPortamentoPlayer() { return portamentoPlayer; }
+    ResonanceRamp& getResonanceRamp() { return resonanceRamp; }
+    const StepSequencer& getSequencer() const { return sequencer; }
+
+private:
+    SynthInstance(const SynthInstance&) = delete;
+    SynthInstance& operator=(const SynthInstance&) = delete;
+
+    /**
+     * @brief Modulation source indices, in registration order
+     */
+    enum ModulationSource {
+        kModAmpEnvelope = 0,    ///< Amplitude envelope, interpolated
+        kModCutoff,             ///< Filter cutoff in octaves (log2 Hz), interpolated
+        kModResonance,          ///< Resonance ramp, stepped
+        kNumModSources
+    };
+
+    /**
+     * @brief Automation lanes, in the order updateControls() hands them to the recorder
+     */
+    enum AutomationLane {
+        kLaneCutoffPot = 0,
+        kLaneResonancePot,
+        kLaneCutoffCc,
+        kNumAutomationLanes
+    };
+
+    /**
+     * @brief Declared update intervals in samples
+     *
+     * The amplitude envelope and cutoff are heard directly and are interpolated,
+     * so 8 samples (one sub-block) is inaudible. The resonance ramp is already
+     * a 50ms linear ramp, so 16-sample steps of it are too small to zipper.
+     */
+    static const unsigned int kAmpEnvelopeInterval = 8;
+    static const unsigned int kCutoffInterval = 8;
+    static const unsigned int kResonanceInterval = 16;
+
+    /** @brief Glide time before modulation; the matrix's kGlide scales it per note */
+    static constexpr float kGlideTimeMs = 100.0f;
+
+    /** @brief Bottom of the CC 14 curve, log2(20 Hz) */
+    static constexpr float kCutoffCurveFloor = 4.321928f;
+
+    /** @brief Octaves spanned by the CC 14 curve, log2(1500) */
+    static constexpr float kCutoffCurveOctaves = 10.550747f;
+
+    /**
+     * @brief Cutoff pot: octaves per full turn, and the position that adds none
+     *
+     * Linear in octaves; the span matches the old 0.2-1.2 ratio scaling, which
+     * was also unity at 0.8.
+     */
+    static constexpr float kCutoffPotOctaves = 3.0f;
+    static constexpr float kCutoffPotUnity = 0.8f;
+
+    /**
+     * @brief Cents-to-frequency-ratio slope, ln(2) / 1200
+     *
+     * Pitch drift is a few cents at most, so 2^(c/1200) is replaced by its
+     * first-order expansion 1 + c·ln(2)/1200 (error < 0.05 cents for |c| < 10).
+     */
+    static constexpr float kCentsToRatio = 0.000577623f;
+
+    /** @brief 2π for the phase wrap */
+    static constexpr float kTwoPi = 6.28318530717958647692f;
+
+    /** @brief Modulation ticks (userData is the instance) */
+    static float tickAmpEnvelope(void* userData);
+    static float tickCutoff(void* userData);
+    static float tickResonance(void* userData);
+
+    /**
+     * @brief Start a note on the voice
+     *
+     * Shared by the MIDI delay path and the sequencer. The envelope and cutoff
+     * sources restart their control period here, so a note-on between two
+     * modulation ticks still starts at its own sample.
+     *
+     * @param note MIDI note number
+     * @param velocity MIDI velocity [1-127], shaped by the velocity curves
+     * @param portamento Glide from the previous pitch
+     * @param legato Tied note: glide only, envelopes keep running (and keep
+     *               the level and attack of the note they belong to)
+     */
+    void noteOn(int note, int velocity, bool portamento, bool legato);
+
+    /** @brief Release the voice */
+    void noteOff();
+
+    template <int Rate>
+    void renderSegment(float* outputL, float* outputR, unsigned int frames);
+
+    /** @brief Monotonic time for the load measurement */
+    static uint64_t loadClock();
+
+    // ========================================================================
+    // Voice
+    // ========================================================================
+
+    /**
+     * @brief Oscillator phase accumulators [0, 2π], left and right
+     *
+     * The right phase only runs separately while the sides are detuned.
+     */
+    float oscillatorPhase;
+    float oscillatorPhaseRight;
+
+    /**
+     * @brief Oscillator detune between the sides in cents (CC 24)
+     *
+     * The left oscillator runs detuneCents/2 flat and the right one as much
+     * sharp; at 0 both sides share one oscillator.
+     */
+    float detuneCents;
+    float detuneRatio[2];
+
+    /** @brief Note timing and the 1 ms delay path */
+    MidiHandler midiHandler;
+
+    /** @brief Note-on/off discrimination and velocity response curves (CC 34) */
+    VelocityParser velocityParser;
+
+    /**
+     * @brief Velocity-derived level and attack multiplier of the sounding
+     *        note; the level is applied at the envelope tick
+     */
+    float noteLevel;
+    float noteAttackScale;
+
+    /** @brief Amplitude attack time from the panel, in envelope ticks */
+    float ampAttackTicks;
+
+    /** @brief Legato detection for the delay path */
+    PortamentoFilter portamentoFilter;
+
+    /** @brief Pitch with exponential glide */
+    PortamentoPlayer portamentoPlayer;
+
+    /** @brief Amplitude envelope, ticked at the modulation rate */
+    ADSR envelope;
+
+    /** @brief Filter envelope, summed into the cutoff bus in octaves */
+    MoogFilterEnvelope filterEnv;
+
+    /** @brief Key follow, 0.33 octave of cutoff per octave above C2 */
+    KeyFollow keyFollow;
+
+    /** @brief 50 ms resonance smoothing */
+    ResonanceRamp resonanceRamp;
+
+    /** @brief Left/right ZDF ladder pair (spread on CC 23) */
+    StereoLadder stereoLadder;
+
+    /** @brief Filter noise and pitch/cutoff drift, seeded per instance */
+    NoiseGenerator noiseGenerator;
+
+    /** @brief LFO 1 cutoff sweep (CC 17/18), LFO 2 vibrato (CC 19); shape and sync on CC 36-39 */
+    LfoBank lfoBank;
+
+    /** @brief Pattern sequencer and arpeggiator (CC 20-22) */
+    StepSequencer sequencer;
+
+    // ========================================================================
+    // Buffers (arena)
+    // ========================================================================
+
+    /** @brief Oscillator output plus filter noise, left and right */
+    float* inputBuffer;
+    float* inputBufferRight;
+
+    /** @brief exp2 of the cutoff bus for the current segment */
+    float* cutoffHzBuffer;
+
+    /** @brief One sub-block per noise destination */
+    float* noiseBuffers[NoiseGenerator::kNumDestinations];
+
+    // ========================================================================
+    // Parameters and modulation
+    // ========================================================================
+
+    /** @brief Panel values: the hardware pots' while the host points them here */
+    PanelControls panel;
+
+    /** @brief Recorder and looper for the cutoff and resonance pots and CC 14 (CC 30) */
+    AutomationLanes automation;
+
+    /** @brief Base filter cutoff as log2 of its frequency in Hz (CC 14) */
+    float baseCutoffOctaves;
+
+    /** @brief Last CC 14 position, normalised; the value its automation lane records */
+    float cutoffControl;
+
+    /** @brief Envelopes, cutoff and resonance ticked at their declared intervals */
+    ModulationLayer modulation;
+
+    /** @brief Rate the amplitude envelope is ticked at (fs / interval) */
+    float ampEnvelopeRate;
+
+    /** @brief Configuration prepared for the next commitRate() */
+    float stagedSampleRate;
+    bool stagedAudioRateModulation;
+
+    /** @brief LFO and matrix cutoff modulation in octaves, updated per segment */
+    float cutoffModulationOctaves;
+
+    /** @brief Any source to any destination, one mat-vec per segment (CC 31-33) */
+    ModMatrix modMatrix;
+    ModMatrix::Source matrixEditSource;
+    ModMatrix::Destination matrixEditDestination;
+
+    /** @brief Pipeline bindings, fanned out by prepareRate() and commitRate() */
+    ModuleRateBinding<MidiHandler> midiHandlerRate;
+    ModuleRateBinding<PortamentoPlayer> portamentoPlayerRate;
+    ModuleRateBinding<MoogFilterEnvelope> filterEnvRate;
+    ModuleRateBinding<ResonanceRamp> resonanceRampRate;
+    ModuleRateBinding<NoiseGenerator> noiseGeneratorRate;
+    ModuleRateBinding<LfoBank> lfoBankRate;
+    ModuleRateBinding<StepSequencer> sequencerRate;
+
+    // ========================================================================
+    // Host links
+    // ========================================================================
+
+    int midiChannel;
+    StartupProfile* startupProfile;
+
+    /** @brief Work time of the current period, the totals and the worst period's share */
+    uint64_t periodNs;
+    double busyNs;
+    double audioNs;
+    float worstLoad;
+    unsigned int periods;
+};
+
+// ============================================================================
+// Inline implementation
+// ============================================================================
+
+template <int Rate>
+inline void SynthInstance::renderSubBlock(float* outputL, float* outputR, unsigned int frames,
+                                          uint64_t blockStart) {
+    const uint64_t startNs = loadClock();
+    const uint64_t blockEnd = blockStart + frames;
+    unsigned int done = 0;
+
+    while (done < frames) {
+        /**
+         * Apply every event due at this frame (late ones included), then
+         * render up to the next event or the end of the sub-block
+         */
+        uint64_t eventTime = sequencer.peekTime();
+        SequencerEvent event;
+        while (eventTime <= blockStart + done && sequencer.popEvent(event)) {
+            if (event.velocity > 0)
+                noteOn(event.note, event.velocity, false, event.slide);
+            else
+                noteOff();
+            eventTime = sequencer.peekTime();
+        }
+
+        unsigned int segmentEnd = frames;
+        if (eventTime < blockEnd)
+            segmentEnd = static_cast<unsigned int>(eventTime - blockStart);
+        renderSegment<Rate>(outputL + done, outputR + done, segmentEnd - done);
+        done = segmentEnd;
+    }
+
+    periodNs += loadClock() - startNs;
+}
+
+template <int Rate>
+inline void SynthInstance::renderSegment(float* outputL, float* outputR, unsigned int frames) {
+    typedef SampleRateTraits<Rate> RateTraits;
+
+    /**
+     * Generate this segment's filter noise and pitch/cutoff drift
+     * One vectorised pass per segment instead of per-sample random calls
+     */
+    noiseGenerator.process(noiseBuffers, frames);
+    const float* filterNoise = noiseBuffers[NoiseGenerator::kFilterNoise];
+    const float* pitchDrift = noiseBuffers[NoiseGenerator::kPitchDrift];
+
+    /**
+     * Advance the LFO bank once for the whole segment and convert its
+     * exponential destinations to ratios here, outside the sample loop
+     */
+    lfoBank.process(frames);
+
+    /**
+     * Evaluate the modulation matrix from this tick's sources; the
+     * controller and velocity sources are held from their last event
+     */
+    modMatrix.setSource(ModMatrix::kAmpEnvelope, envelope.getOutput());
+    modMatrix.setSource(ModMatrix::kFilterEnvelope, filterEnv.getLevel());
+    modMatrix.setSource(ModMatrix::kLfo1, lfoBank.getOutput(0));
+    modMatrix.setSource(ModMatrix::kLfo2, lfoBank.getOutput(1));
+    modMatrix.setSource(ModMatrix::kKey, (portamentoPlayer.getCurrentNote() - 60) * (1.0f / 12.0f));
+    modMatrix.setSource(ModMatrix::kCutoffPot, panel.cutoff);
+    modMatrix.setSource(ModMatrix::kResonancePot, panel.resonance);
+    modMatrix.process();
+
+    cutoffModulationOctaves = lfoBank.getDestination(LfoBank::kCutoff) + modMatrix.getDestination(ModMatrix::kCutoff);
+    const float lfoPitchRatio = tableExp2((lfoBank.getDestination(LfoBank::kPitch) + modMatrix.getDestination(ModMatrix::kPitch))
+                                          * (1.0f / 1200.0f));
+    stereoLadder.setDrive(panel.drive + lfoBank.getDestination(LfoBank::kDrive) + modMatrix.getDestination(ModMatrix::kDrive));
+    const float gainModulation = 1.0f + modMatrix.getDestination(ModMatrix::kGain);
+    const float outGain = panel.outGain * (gainModulation > 0.0f ? gainModulation : 0.0f);
+
+    /**
+     * Tick the envelopes, key follow and resonance ramp at their control
+     * rates and expand them to per-sample values for this segment
+     * Runs after the noise pass: the cutoff tick reads the drift buffer
+     */
+    modulation.process(frames);
+    const float* ampEnvelope = modulation.getBuffer(kModAmpEnvelope);
+    const float* resonance = modulation.getBuffer(kModResonance);
+
+    /**
+     * Cutoff bus to Hz for the pre-warp: four lanes of exp2 per step. A
+     * partial last vector reads and writes the spare frames of the
+     * sub-block buffers, which nothing else reads this segment.
+     */
+    static_assert(kSubBlockFrames % 4 == 0, "Cutoff conversion runs in vectors of four");
+    const float* cutoffOctaves = modulation.getBuffer(kModCutoff);
+    for (unsigned int n = 0; n < frames; n += 4)
+        vf4_store(cutoffHzBuffer + n, vf4_exp2(vf4_load(cutoffOctaves + n)));
+    const float* cutoffHz = cutoffHzBuffer;
+
+    /**
+     * Detuned sides need a second oscillator; otherwise both ladders are
+     * fed from the left staging buffer
+     */
+    const bool detuned = detuneCents > 0.0f;
+
+    for (unsigned int n = 0; n < frames; n++) {
+        /**
+         * Amplitude envelope value [0.0-1.0], interpolated from control rate
+         */
+        float envValue = ampEnvelope[n];
+
+        /**
+         * Oscillator frequency from the glide, with LFO/matrix pitch and
+         * analog drift (cents, linearised exponential)
+         */
+        float freq = portamentoPlayer.process();
+        freq *= lfoPitchRatio * (1.0f + pitchDrift[n] * kCentsToRatio);
+
+        float oscillatorOut = 0.0f;
+        float oscillatorOutRight = 0.0f;
+        float noise = 0.0f;
+
+        /**
+         * Only generate oscillator output when envelope is active
+         * Saves CPU cycles during silent periods (envelope in idle state)
+         */
+        if (envelope.getState() != env_idle) {
+            /**
+             * Sine by phase accumulation; 2π/fs is a compile-time constant
+             * for this rate, and the wrap keeps the phase in [0, 2π]
+             */
+            oscillatorOut = sinf(oscillatorPhase);
+            oscillatorPhase += freq * detuneRatio[0] * RateTraits::kTwoPiOverRate;
+            if (oscillatorPhase >= kTwoPi)
+                oscillatorPhase -= kTwoPi;
+            oscillatorOut *= envValue;
+            noise = filterNoise[n];
+
+            /**
+             * Right oscillator, detuned sharp; while the sides are not
+             * detuned it follows the left phase so a later detune starts
+             * in phase
+             */
+            if (detuned) {
+                oscillatorOutRight = sinf(oscillatorPhaseRight) * envValue;
+                oscillatorPhaseRight += freq * detuneRatio[1] * RateTraits::kTwoPiOverRate;
+                if (oscillatorPhaseRight >= kTwoPi)
+                    oscillatorPhaseRight -= kTwoPi;
+            } else {
+                oscillatorPhaseRight = oscillatorPhase;
+            }
+        } else {
+            /**
+             * Reset oscillator phase during silent periods
+             * Ensures clean restart for next note-on event
+             */
+            oscillatorPhase = 0.0f;
+            oscillatorPhaseRight = 0.0f;
+            oscillatorOut = 0.0f;
+        }
+
+        /**
+         * 50% scaling leaves headroom for resonance peaks; thermal noise is
+         * added at the filter input, where it also seeds self-oscillation.
+         * The noise follows the voice: an idle part feeds the ladder exactly
+         * zero, so its tail decays to silence
+         */
+        inputBuffer[n] = oscillatorOut * 0.5f + noise;
+        if (detuned)
+            inputBufferRight[n] = oscillatorOutRight * 0.5f + noise;
+    }
+
+    /**
+     * Filter the whole segment through the left/right ladder pair in one
+     * two-lane pass; output gain is applied at the ladder's output tap
+     */
+    const float* inputRight = detuned ? inputBufferRight : inputBuffer;
+    stereoLadder.process<Rate>(inputBuffer, inputRight, cutoffHz, resonance, outGain,
+                               outputL, outputR, frames);
+}
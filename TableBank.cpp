@@ -0,0 +1,123 @@
+/**
+ * @file TableBank.cpp
+ * @brief The embedded tables, their manifest and the boot-time checksum check
+ */
+
+#include "TableBank.h"
+
+// ============================================================================
+// Embedded tables
+// ============================================================================
+
+/**
+ * constexpr definitions of the extern declarations: constant-initialised
+ * into read-only data, no dynamic initialisation
+ */
+constexpr PrewarpTable kPrewarpTable{};
+constexpr Exp2Table kExp2Table{};
+constexpr Log2Table kLog2Table{};
+constexpr NoteFrequencyTable kNoteFrequencyTable{};
+constexpr ControlCurveTable kCutoffCurveTable{20.0, 1500.0};
+constexpr ControlCurveTable kLfoRateCurveTable{0.05, 400.0};
+constexpr VelocityShapeTable kVelocityShapeTable{};
+constexpr FftTwiddleTable kFftTwiddleTable{};
+
+namespace {
+
+constexpr bool near(float value, double expected, double tolerance) {
+    return value - expected <= tolerance && expected - value <= tolerance;
+}
+
+}
+
+/** Spot checks on the generator, evaluated at build time */
+static_assert(kPrewarpTable.g[0] == 0.0f && kPrewarpTable.stageGain[0] == 1.0f, "pre-warp origin");
+static_assert(near(kPrewarpTable.g[kPrewarpSegments / 2], 0.8540806855, 1e-7), "tan(0.225π)");
+static_assert(kExp2Table.power[0] == 1.0f && kExp2Table.power[kOctaveSegments] == 2.0f, "exp2 endpoints");
+static_assert(near(kExp2Table.power[128], 1.4142135624, 1e-7), "exp2(0.5)");
+static_assert(kLog2Table.log2[0] == 0.0f && kLog2Table.log2[kOctaveSegments] == 1.0f, "log2 endpoints");
+static_assert(near(kLog2Table.log2[128], 0.5849625007, 1e-7), "log2(1.5)");
+static_assert(kNoteFrequencyTable.hz[69] == 440.0f && kNoteFrequencyTable.hz[81] == 880.0f, "A4, A5");
+static_assert(near(kNoteFrequencyTable.hz[60], 261.6255653, 1e-4), "C4");
+static_assert(kCutoffCurveTable.value[0] == 20.0f && near(kCutoffCurveTable.value[127], 30000.0, 1e-2), "CC 14 range");
+static_assert(near(kLfoRateCurveTable.value[0], 0.05, 1e-9) && near(kLfoRateCurveTable.value[127], 20.0, 1e-5), "CC 17 range");
+static_assert(kVelocityShapeTable.exponential[0] == 0.0f && kVelocityShapeTable.exponential[127] == 1.0f &&
+              kVelocityShapeTable.compressed[0] == 0.0f && kVelocityShapeTable.compressed[127] == 1.0f,
+              "velocity shape endpoints");
+static_assert(kFftTwiddleTable.re[0] == 1.0f && kFftTwiddleTable.im[0] == 0.0f, "twiddle 1");
+static_assert(near(kFftTwiddleTable.re[2], 0.0, 1e-15) && kFftTwiddleTable.im[2] == -1.0f, "twiddle -i");
+static_assert(near(kFftTwiddleTable.re[kFftMaxSize / 2 - 1 + 64], 0.7071067812, 1e-7), "twiddle e^(-iπ/4)");
+
+namespace {
+
+using constexpr_math::checksum;
+
+constexpr TableBank::Entry kManifest[] = {
+    {"prewarp.g", kPrewarpTable.g, kPrewarpSegments + 1,
+     checksum(kPrewarpTable.g, kPrewarpSegments + 1)},
+    {"prewarp.stageGain", kPrewarpTable.stageGain, kPrewarpSegments + 1,
+     checksum(kPrewarpTable.stageGain, kPrewarpSegments + 1)},
+    {"exp2", kExp2Table.power, kOctaveSegments + 1,
+     checksum(kExp2Table.power, kOctaveSegments + 1)},
+    {"log2", kLog2Table.log2, kOctaveSegments + 1,
+     checksum(kLog2Table.log2, kOctaveSegments + 1)},
+    {"log2.inverse", kLog2Table.inverse, kOctaveSegments + 1,
+     checksum(kLog2Table.inverse, kOctaveSegments + 1)},
+    {"noteFrequency", kNoteFrequencyTable.hz, 128,
+     checksum(kNoteFrequencyTable.hz, 128)},
+    {"cutoffCurve", kCutoffCurveTable.value, 128,
+     checksum(kCutoffCurveTable.value, 128)},
+    {"lfoRateCurve", kLfoRateCurveTable.value, 128,
+     checksum(kLfoRateCurveTable.value, 128)},
+    {"velocityShape.exponential", kVelocityShapeTable.exponential, 128,
+     checksum(kVelocityShapeTable.exponential, 128)},
+    {"velocityShape.compressed", kVelocityShapeTable.compressed, 128,
+     checksum(kVelocityShapeTable.compressed, 128)},
+    {"fftTwiddle.re", kFftTwiddleTable.re, kFftMaxSize - 1,
+     checksum(kFftTwiddleTable.re, kFftMaxSize - 1)},
+    {"fftTwiddle.im", kFftTwiddleTable.im, kFftMaxSize - 1,
+     checksum(kFftTwiddleTable.im, kFftMaxSize - 1)},
+};
+
+constexpr unsigned int kNumTables = sizeof(kManifest) / sizeof(kManifest[0]);
+
+/**
+ * @brief Runtime counterpart of constexpr_math::checksum() over the bytes in memory
+ */
+uint32_t checksumMemory(const float* data, unsigned int count) {
+    uint32_t hash = 2166136261u;
+    for (unsigned int i = 0; i < count; ++i) {
+        uint32_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        for (int byte = 0; byte < 4; ++byte) {
+            hash ^= (bits >> (8 * byte)) & 0xFFu;
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+}
+
+unsigned int TableBank::getNumTables() {
+    return kNumTables;
+}
+
+const TableBank::Entry& TableBank::getTable(unsigned int index) {
+    return kManifest[index < kNumTables ? index : kNumTables - 1];
+}
+
+unsigned int TableBank::getTotalBytes() {
+    unsigned int bytes = 0;
+    for (unsigned int i = 0; i < kNumTables; ++i)
+        bytes += kManifest[i].count * sizeof(float);
+    return bytes;
+}
+
+const char* TableBank::verify() {
+    for (unsigned int i = 0; i < kNumTables; ++i) {
+        if (checksumMemory(kManifest[i].data, kManifest[i].count) != kManifest[i].checksum)
+            return kManifest[i].name;
+    }
+    return nullptr;
+}
@@ -0,0 +1,459 @@
+/**
+ * @file TableBank.h
+ * @brief Lookup tables generated by the compiler, embedded read-only and checksummed
+ *
+ * Everything that used to be computed with a transcendental function when the
+ * instrument boots (cutoff pre-warp, envelope coefficients, noise drift leak,
+ * note frequencies, controller curves) is read from a table instead. The
+ * tables are built by constexpr constructors, so the generator is the
+ * compiler: each table is constant-initialised into .rodata, there is no
+ * generator step, no data file to ship or mmap, and no code runs for them at
+ * start-up. Being constant-initialised, they are also safe to read from the
+ * constructors of other globals (the engine's modules are globals).
+ *
+ * @tables
+ * | Table                | Points    | Contents                                |
+ * |----------------------|-----------|-----------------------------------------|
+ * | kPrewarpTable        | 2 × 513   | tan(θ) and 1/(1+tan θ), θ ∈ [0, 0.45π]  |
+ * | kExp2Table           | 257       | 2^(i/256)                               |
+ * | kLog2Table           | 2 × 257   | log2(1 + i/256) and 1/(1 + i/256)       |
+ * | kNoteFrequencyTable  | 128       | 440·2^((n−69)/12) Hz                    |
+ * | kCutoffCurveTable    | 128       | CC 14: 20·1500^(v/127) Hz               |
+ * | kLfoRateCurveTable   | 128       | CC 17: 0.05·400^(v/127) Hz              |
+ * | kVelocityShapeTable  | 2 × 128   | (2^(4x)−1)/15, log2(1+15x)/4, x = v/127 |
+ * | kFftTwiddleTable     | 2 × 511   | e^(−iπk/h), k < h, h = 1, 2, ..., 256   |
+ *
+ * @checksums
+ * TableBank.cpp computes an FNV-1a checksum of every table's IEEE-754 bit
+ * patterns at compile time. TableBank::verify() hashes the tables as they
+ * sit in memory and compares; setup() refuses to start on a mismatch (a
+ * corrupted image on the SD card, or a miscompiled table), naming the table.
+ * A few spot values are also pinned with static_assert, so a broken
+ * generator fails the build rather than the boot.
+ *
+ * @performance_characteristics
+ * - tableExp2(): float-to-int split, one lookup, a cubic residual and an
+ *   exponent insert; relative error below 2e-7 (about 1 ulp)
+ * - tableLog2(): exponent extract, one lookup, a multiply and a cubic;
+ *   error below 2e-7 (absolute below 1, relative above)
+ * - All tables: 13.5 KB of read-only data
+ * - verify(): about 0.1 ms at boot, most of it first-touch page faults
+ *   on the table pages
+ *
+ * @author Timothy Paul Read
+ * @date 2026/10/17
+ * @version 1.0
+ */
+
+#pragma once
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Constexpr helpers for building tables at compile time
+ *
+ * <cmath> functions are not constexpr, so these use range reduction and
+ * power series carried to full double precision over the arguments the
+ * tables need.
+ */
+namespace constexpr_math {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kLn2 = 0.69314718055994530942;
+
+/** @brief sin(x) for |x| ≤ π/2 */
+constexpr double sin(double x) {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 14; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+/** @brief cos(x) for |x| ≤ π/2 */
+constexpr double cos(double x) {
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 14; ++n) {
+        term *= -x * x / ((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double tan(double x) {
+    return sin(x) / cos(x);
+}
+
+/** @brief e^x for |x| < 700: x = k·ln2 + r with |r| ≤ ln2/2 */
+constexpr double exp(double x) {
+    int k = static_cast<int>(x / kLn2 + (x >= 0.0 ? 0.5 : -0.5));
+    const double r = x - k * kLn2;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 20; ++n) {
+        term *= r / n;
+        sum += term;
+    }
+    for (; k > 0; --k)
+        sum *= 2.0;
+    for (; k < 0; ++k)
+        sum *= 0.5;
+    return sum;
+}
+
+/** @brief ln(x) for x > 0: x = m·2^e with m ∈ [1, 2), ln m = 2·atanh((m−1)/(m+1)) */
+constexpr double log(double x) {
+    int e = 0;
+    while (x >= 2.0) {
+        x *= 0.5;
+        ++e;
+    }
+    while (x < 1.0) {
+        x *= 2.0;
+        --e;
+    }
+    const double t = (x - 1.0) / (x + 1.0);
+    double term = t;
+    double sum = t;
+    for (int n = 1; n < 20; ++n) {
+        term *= t * t;
+        sum += term / (2 * n + 1);
+    }
+    return 2.0 * sum + e * kLn2;
+}
+
+constexpr double exp2(double x) {
+    return exp(x * kLn2);
+}
+
+/**
+ * @brief IEEE-754 bit pattern of a float, without a reinterpret cast
+ *
+ * The float is widened to double (exact) and decomposed by halving and
+ * doubling; normal and subnormal values, zero and sign are handled.
+ */
+constexpr uint32_t floatBits(float f) {
+    double v = f;
+    uint32_t sign = 0;
+    if (v < 0.0) {
+        sign = 0x80000000u;
+        v = -v;
+    }
+    if (v == 0.0)
+        return sign;
+    int e = 0;
+    while (v >= 2.0) {
+        v *= 0.5;
+        ++e;
+    }
+    while (v < 1.0) {
+        v *= 2.0;
+        --e;
+    }
+    if (e < -126) {
+        /** Subnormal: the significand is v·2^(e+149), exponent field zero */
+        for (int n = e + 149; n > 0; --n)
+            v *= 2.0;
+        return sign | static_cast<uint32_t>(v);
+    }
+    return sign | (static_cast<uint32_t>(e + 127) << 23)
+                | static_cast<uint32_t>((v - 1.0) * 8388608.0);
+}
+
+/** @brief FNV-1a over the little-endian bytes of each float's bit pattern */
+constexpr uint32_t checksum(const float* data, unsigned int count, uint32_t hash = 2166136261u) {
+    for (unsigned int i = 0; i < count; ++i) {
+        const uint32_t bits = floatBits(data[i]);
+        for (int byte = 0; byte < 4; ++byte) {
+            hash ^= (bits >> (8 * byte)) & 0xFFu;
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+} // namespace constexpr_math
+
+// ============================================================================
+// Table layouts
+// ============================================================================
+
+/** @brief Segments in the pre-warp table (table holds kPrewarpSegments + 1 points) */
+constexpr int kPrewarpSegments = 512;
+
+/** @brief Highest normalised cutoff covered by the table, as a fraction of fs */
+constexpr double kPrewarpMaxRatio = 0.45;
+
+/** @brief Segments per octave in the exp2/log2 tables */
+constexpr int kOctaveSegments = 256;
+
+/**
+ * @struct PrewarpTable
+ * @brief G = tan(θ) and stage gain 1/(1+G) over θ ∈ [0, 0.45π]
+ */
+struct PrewarpTable {
+    float g[kPrewarpSegments + 1];
+    float stageGain[kPrewarpSegments + 1];
+
+    constexpr PrewarpTable() : g(), stageGain() {
+        for (int i = 0; i <= kPrewarpSegments; ++i) {
+            const double theta = constexpr_math::kPi * kPrewarpMaxRatio * i / kPrewarpSegments;
+            const double t = constexpr_math::tan(theta);
+            g[i] = static_cast<float>(t);
+            stageGain[i] = static_cast<float>(1.0 / (1.0 + t));
+        }
+    }
+};
+
+/**
+ * @struct Exp2Table
+ * @brief 2^(i/256) for i ∈ [0, 256]
+ */
+struct Exp2Table {
+    float power[kOctaveSegments + 1];
+
+    constexpr Exp2Table() : power() {
+        for (int i = 0; i <= kOctaveSegments; ++i)
+            power[i] = static_cast<float>(constexpr_math::exp2(static_cast<double>(i) / kOctaveSegments));
+    }
+};
+
+/**
+ * @struct Log2Table
+ * @brief log2(1 + i/256) and its segment's reciprocal 1/(1 + i/256)
+ */
+struct Log2Table {
+    float log2[kOctaveSegments + 1];
+    float inverse[kOctaveSegments + 1];
+
+    constexpr Log2Table() : log2(), inverse() {
+        for (int i = 0; i <= kOctaveSegments; ++i) {
+            const double m = 1.0 + static_cast<double>(i) / kOctaveSegments;
+            log2[i] = static_cast<float>(constexpr_math::log(m) / constexpr_math::kLn2);
+            inverse[i] = static_cast<float>(1.0 / m);
+        }
+    }
+};
+
+/**
+ * @struct NoteFrequencyTable
+ * @brief Equal-tempered frequency of every MIDI note, A4 = 440 Hz
+ */
+struct NoteFrequencyTable {
+    float hz[128];
+
+    constexpr NoteFrequencyTable() : hz() {
+        for (int n = 0; n < 128; ++n)
+            hz[n] = static_cast<float>(440.0 * constexpr_math::exp2((n - 69) / 12.0));
+    }
+};
+
+/**
+ * @struct ControlCurveTable
+ * @brief Exponential controller curve low·ratio^(v/127) for v ∈ [0, 127]
+ */
+struct ControlCurveTable {
+    float value[128];
+
+    constexpr ControlCurveTable(double low, double ratio) : value() {
+        for (int v = 0; v < 128; ++v)
+            value[v] = static_cast<float>(low * constexpr_math::exp(constexpr_math::log(ratio) * v / 127.0));
+    }
+};
+
+/**
+ * @struct VelocityShapeTable
+ * @brief VelocityParser's exponential and compressed shapes for v ∈ [0, 127]
+ */
+struct VelocityShapeTable {
+    float exponential[128];
+    float compressed[128];
+
+    constexpr VelocityShapeTable() : exponential(), compressed() {
+        for (int v = 0; v < 128; ++v) {
+            const double x = v / 127.0;
+            exponential[v] = static_cast<float>((constexpr_math::exp2(4.0 * x) - 1.0) / 15.0);
+            compressed[v] = static_cast<float>(constexpr_math::log(1.0 + 15.0 * x) / constexpr_math::kLn2 / 4.0);
+        }
+    }
+};
+
+/** @brief Twiddles for transforms up to this size (SplitFft::kMaxSize) */
+constexpr int kFftMaxSize = 512;
+
+/**
+ * @struct FftTwiddleTable
+ * @brief e^(−iπk/h) of the FFT stage with half-span h at [h − 1, 2h − 1)
+ *
+ * The series in constexpr_math hold for |θ| ≤ π/2, so the upper half of
+ * each stage is folded: e^(−iθ) = −e^(i(π−θ)). k = 0 stores +0, not −0,
+ * which constexpr_math::floatBits() cannot tell apart for the checksum.
+ */
+struct FftTwiddleTable {
+    float re[kFftMaxSize - 1];
+    float im[kFftMaxSize - 1];
+
+    constexpr FftTwiddleTable() : re(), im() {
+        for (int half = 1; half < kFftMaxSize; half <<= 1) {
+            for (int k = 0; k < half; ++k) {
+                const bool folded = 2 * k > half;
+                const double theta = constexpr_math::kPi * (folded ? half - k : k) / half;
+                re[half - 1 + k] = static_cast<float>(folded ? -constexpr_math::cos(theta) : constexpr_math::cos(theta));
+                im[half - 1 + k] = k == 0 ? 0.0f : static_cast<float>(-constexpr_math::sin(theta));
+            }
+        }
+    }
+};
+
+/**
+ * @name Embedded tables
+ * Defined (constexpr) in TableBank.cpp: one read-only copy, the one
+ * verify() checks.
+ * @{
+ */
+extern const PrewarpTable kPrewarpTable;
+extern const Exp2Table kExp2Table;
+extern const Log2Table kLog2Table;
+extern const NoteFrequencyTable kNoteFrequencyTable;
+extern const ControlCurveTable kCutoffCurveTable;
+extern const ControlCurveTable kLfoRateCurveTable;
+extern const VelocityShapeTable kVelocityShapeTable;
+extern const FftTwiddleTable kFftTwiddleTable;
+/** @} */
+
+// ============================================================================
+// Table-driven math
+// ============================================================================
+
+/**
+ * @brief 2^x from kExp2Table
+ *
+ * x = whole + i/256 + d: the table supplies 2^(i/256), a cubic in d·ln2
+ * the residual, the exponent field 2^whole.
+ *
+ * @param x Exponent; below −126 returns 0, 128 and above returns +inf, NaN
+ *          passes through
+ */
+inline float tableExp2(float x) {
+    if (!(x > -126.0f))
+        return x != x ? x : 0.0f;
+    if (x >= 128.0f)
+        return HUGE_VALF;
+
+    int whole = static_cast<int>(x);
+    if (static_cast<float>(whole) > x)
+        --whole;
+    const float position = (x - static_cast<float>(whole)) * kOctaveSegments;
+    const int index = static_cast<int>(position);
+    const float d = (position - static_cast<float>(index)) * static_cast<float>(constexpr_math::kLn2 / kOctaveSegments);
+    const float residual = 1.0f + d * (1.0f + d * (0.5f + d * (1.0f / 6.0f)));
+
+    /** whole ∈ [−126, 127]: a normal exponent field */
+    const uint32_t scaleBits = static_cast<uint32_t>(whole + 127) << 23;
+    float scale;
+    memcpy(&scale, &scaleBits, sizeof(scale));
+    return kExp2Table.power[index] * residual * scale;
+}
+
+/**
+ * @brief log2(x) from kLog2Table
+ *
+ * x = 2^e·m: the table supplies log2 of m's leading 8 mantissa bits and
+ * their reciprocal, a cubic ln(1+u) the remaining u < 1/256.
+ *
+ * @param x Argument; 0 returns −inf, negative values and NaN return NaN,
+ *          subnormals are treated as 2^−126
+ */
+inline float tableLog2(float x) {
+    if (!(x >= FLT_MIN)) {
+        if (x > 0.0f)
+            return -126.0f;
+        return x == 0.0f ? -HUGE_VALF : NAN;
+    }
+    if (x > FLT_MAX)
+        return x;
+
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    const int exponent = static_cast<int>(bits >> 23) - 127;
+    const uint32_t mantissaBits = bits & 0x007FFFFFu;
+    const int index = static_cast<int>(mantissaBits >> 15);
+
+    const uint32_t unitBits = mantissaBits | 0x3F800000u;
+    float m;
+    memcpy(&m, &unitBits, sizeof(m));
+    const float u = m * kLog2Table.inverse[index] - 1.0f;
+    const float lnResidual = u * (1.0f - u * (0.5f - u * (1.0f / 3.0f)));
+
+    return static_cast<float>(exponent) + kLog2Table.log2[index]
+         + lnResidual * static_cast<float>(1.0 / constexpr_math::kLn2);
+}
+
+/**
+ * @brief e^x through tableExp2()
+ */
+inline float tableExp(float x) {
+    return tableExp2(x * static_cast<float>(1.0 / constexpr_math::kLn2));
+}
+
+/**
+ * @brief Equal-tempered frequency of a MIDI note
+ *
+ * @param note Note number; 0-127 come from the table, others are computed
+ */
+inline float noteToFrequency(int note) {
+    if (note >= 0 && note < 128)
+        return kNoteFrequencyTable.hz[note];
+    return 440.0f * tableExp2((note - 69) * (1.0f / 12.0f));
+}
+
+// ============================================================================
+// Verification
+// ============================================================================
+
+/**
+ * @class TableBank
+ * @brief Manifest of the embedded tables and their build-time checksums
+ *
+ * @usage_example
+ * @code
+ * const char* corrupt = TableBank::verify();
+ * if (corrupt) {
+ *     rt_printf("Table %s failed its checksum\n", corrupt);
+ *     return false;
+ * }
+ * @endcode
+ */
+class TableBank {
+public:
+    /**
+     * @struct Entry
+     * @brief One checksummed float array
+     */
+    struct Entry {
+        const char* name;
+        const float* data;
+        unsigned int count;
+        uint32_t checksum;      ///< Computed by the compiler from the generator
+    };
+
+    static unsigned int getNumTables();
+    static const Entry& getTable(unsigned int index);
+
+    /** @brief Bytes of table data embedded in the image */
+    static unsigned int getTotalBytes();
+
+    /**
+     * @brief Hash every table in memory and compare with its build-time checksum
+     *
+     * @return nullptr if all match, otherwise the first mismatching table's name
+     * @realtime_safety Real-time safe, but meant for setup()
+     */
+    static const char* verify();
+};
@@ -0,0 +1,186 @@
+/**
+ * @file TempoDelay.cpp
+ * @brief Implementation of the stereo tempo delay
+ */
+
+#include "TempoDelay.h"
+#include "TableBank.h"
+
+namespace {
+
+/** @brief Delay per division, in beats */
+const float kDivisionBeats[TempoDelay::kNumDivisions] = {
+    0.25f,          // sixteenth
+    1.0f / 3.0f,    // eighth triplet
+    0.5f,           // eighth
+    2.0f / 3.0f,    // quarter triplet
+    0.75f,          // dotted eighth
+    1.0f,           // quarter
+    1.5f,           // dotted quarter
+    2.0f            // half
+};
+
+/** @brief Frames needed for the longest delay at a rate, rounded to a power of two */
+unsigned int lineFrames(float sampleRate) {
+    const unsigned int needed = static_cast<unsigned int>(TempoDelay::kMaxDelaySeconds * sampleRate) + 1;
+    unsigned int frames = 1;
+    while (frames < needed)
+        frames <<= 1;
+    return frames;
+}
+
+} // namespace
+
+TempoDelay::TempoDelay()
+    : line(nullptr), mask(0), writeIndex(0), sampleRate(44100.0f), stagedSampleRate(44100.0f),
+      division(kEighth), freeSeconds(0.375f), beatSamples(22050.0), feedback(0.35f), dampingHz(5000.0f),
+      mix(0.0f), delayFrames(1), targetFrames(1), fadeFrom(1), fadeRemaining(0), crossfadeFrames(1),
+      fadeStep(1.0f), dampingCoefficient(1.0f), wetGain(0.0f) {
+    damped[0] = damped[1] = 0.0f;
+    updateCoefficients();
+}
+
+size_t TempoDelay::requiredBytes(float maxSampleRate) {
+    return 2 * lineFrames(maxSampleRate) * sizeof(float) + AudioArena::kAlignment;
+}
+
+bool TempoDelay::allocate(AudioArena& arena, float maxSampleRate) {
+    const unsigned int frames = lineFrames(maxSampleRate);
+    line = arena.allocateFloats(2 * frames);
+    if (!line)
+        return false;
+    mask = frames - 1;
+    writeIndex = 0;
+    updateTarget();
+    delayFrames = targetFrames;
+    return true;
+}
+
+void TempoDelay::setTimeSeconds(float seconds) {
+    freeSeconds = seconds < 0.001f ? 0.001f : (seconds > kMaxDelaySeconds ? kMaxDelaySeconds : seconds);
+    division = kFree;
+    updateTarget();
+}
+
+void TempoDelay::setDivision(int newDivision) {
+    division = (newDivision >= 0 && newDivision < kNumDivisions) ? newDivision : kFree;
+    updateTarget();
+}
+
+void TempoDelay::setBeatSamples(double samples) {
+    if (samples > 0.0 && samples != beatSamples) {
+        beatSamples = samples;
+        if (division != kFree)
+            updateTarget();
+    }
+}
+
+void TempoDelay::setFeedback(float amount) {
+    feedback = amount < 0.0f ? 0.0f : (amount > 0.95f ? 0.95f : amount);
+}
+
+void TempoDelay::setDamping(float hz) {
+    dampingHz = hz < 500.0f ? 500.0f : hz;
+    updateCoefficients();
+}
+
+void TempoDelay::setMix(float newMix) {
+    mix = newMix < 0.0f ? 0.0f : (newMix > 1.0f ? 1.0f : newMix);
+}
+
+void TempoDelay::reset() {
+    if (line) {
+        for (unsigned int i = 0; i < 2 * (mask + 1); ++i)
+            line[i] = 0.0f;
+    }
+    writeIndex = 0;
+    damped[0] = damped[1] = 0.0f;
+    delayFrames = targetFrames;
+    fadeRemaining = 0;
+}
+
+bool TempoDelay::prepareSampleRate(float newSampleRate) {
+    /** The line was sized once in setup(); a faster rate would overrun it */
+    if (newSampleRate <= 0.0f || (line && lineFrames(newSampleRate) > mask + 1))
+        return false;
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+void TempoDelay::commitSampleRate() {
+    /**
+     * The line holds audio at the old rate; jump to the new time rather
+     * than crossfade into a resampled echo
+     */
+    sampleRate = stagedSampleRate;
+    updateCoefficients();
+    updateTarget();
+    delayFrames = targetFrames;
+    fadeRemaining = 0;
+}
+
+void TempoDelay::updateTarget() {
+    const double wanted = (division == kFree) ? static_cast<double>(freeSeconds) * sampleRate
+                                              : kDivisionBeats[division] * beatSamples;
+    double limit = static_cast<double>(kMaxDelaySeconds) * sampleRate;
+    if (line && limit > mask)
+        limit = mask;
+    const double clamped = wanted < 1.0 ? 1.0 : (wanted > limit ? limit : wanted);
+    const unsigned int frames = static_cast<unsigned int>(clamped + 0.5);
+
+    const float change = static_cast<float>(frames) - static_cast<float>(targetFrames);
+    if (change > kRetargetThreshold * targetFrames || -change > kRetargetThreshold * targetFrames)
+        targetFrames = frames;
+}
+
+void TempoDelay::updateCoefficients() {
+    const float maxDampingHz = 0.45f * sampleRate;
+    const float hz = dampingHz > maxDampingHz ? maxDampingHz : dampingHz;
+    dampingCoefficient = 1.0f - tableExp(static_cast<float>(-2.0 * constexpr_math::kPi) * hz / sampleRate);
+    crossfadeFrames = static_cast<unsigned int>(kCrossfadeMs * 0.001f * sampleRate);
+    if (crossfadeFrames < 1)
+        crossfadeFrames = 1;
+    fadeStep = 1.0f / static_cast<float>(crossfadeFrames);
+}
+
+void TempoDelay::process(float* left, float* right, unsigned int frames) {
+    if (!line || frames == 0)
+        return;
+
+    /** A time change starts only once the previous crossfade has finished */
+    if (fadeRemaining == 0 && targetFrames != delayFrames) {
+        fadeFrom = delayFrames;
+        delayFrames = targetFrames;
+        fadeRemaining = crossfadeFrames;
+    }
+
+    const vfloat2 feedbackGain = vf2_dup(feedback);
+    const vfloat2 coefficient = vf2_dup(dampingCoefficient);
+    const float wetStep = (mix - wetGain) / static_cast<float>(frames);
+    float wet = wetGain;
+    const unsigned int lineLength = mask + 1;
+
+    vfloat2 lowpass = vf2_load(damped);
+    for (unsigned int n = 0; n < frames; ++n) {
+        const vfloat2 input = vf2_set(left[n], right[n]);
+        vfloat2 echo = vf2_load(line + 2 * ((writeIndex + lineLength - delayFrames) & mask));
+
+        if (fadeRemaining != 0) {
+            const vfloat2 previous = vf2_load(line + 2 * ((writeIndex + lineLength - fadeFrom) & mask));
+            const float position = 1.0f - static_cast<float>(fadeRemaining) * fadeStep;
+            echo = vf2_mla(previous, vf2_sub(echo, previous), vf2_dup(position));
+            --fadeRemaining;
+        }
+
+        lowpass = vf2_mla(lowpass, vf2_sub(echo, lowpass), coefficient);
+        vf2_store(line + 2 * writeIndex, vf2_mla(input, lowpass, feedbackGain));
+
+        wet += wetStep;
+        const vfloat2 output = vf2_mla(input, echo, vf2_dup(wet));
+        left[n] = vf2_lane0(output);
+        right[n] = vf2_lane1(output);
+        writeIndex = (writeIndex + 1) & mask;
+    }
+    vf2_store(damped, lowpass);
+    wetGain = mix;
+}
@@ -1,46 +1,79 @@
 /**
  * @file VelocityParser.cpp
- * @brief Implementation of MIDI velocity threshold discrimination
+ * @brief Implementation of note-on discrimination and velocity response tables
  * 
- * This implementation provides simple, reliable MIDI velocity parsing with
- * configurable threshold-based note-on/note-off discrimination. The system
- * is optimized for real-time performance while maintaining musical accuracy
- * and controller compatibility across diverse MIDI hardware configurations.
+ * Tables are rebuilt only when a curve or amount changes; the note path reads
+ * them directly, so velocity shaping never costs a transcendental call per note.
+ * The exponential and compressed shapes themselves are embedded in TableBank.
  */
 
 #include "VelocityParser.h"
+#include "TableBank.h"
 
 /**
- * @brief Initialize velocity parser with threshold configuration
- * 
- * @param threshold Velocity discrimination threshold
- * 
- * Simple initialization storing threshold value for subsequent velocity
- * analysis. No validation performed for maximum real-time performance,
- * relying on caller to provide musically appropriate threshold values.
+ * @brief Start with every target ignoring velocity and a linear custom shape
  */
-VelocityParser::VelocityParser(int threshold) {
-    velocityThreshold = threshold;
+VelocityParser::VelocityParser() {
+    for (int v = 0; v < kTableSize; ++v)
+        customShape[v] = v / 127.0f;
+    for (int t = 0; t < kNumTargets; ++t) {
+        curve[t] = kLinear;
+        amount[t] = 0.0f;
+        build(static_cast<Target>(t));
+    }
+}
+
+void VelocityParser::setCurve(Target target, Curve newCurve, float newAmount) {
+    if (target < 0 || target >= kNumTargets || newCurve < 0 || newCurve >= kNumCurves)
+        return;
+    curve[target] = newCurve;
+    amount[target] = newAmount < 0.0f ? 0.0f : (newAmount > 1.0f ? 1.0f : newAmount);
+    build(target);
+}
+
+void VelocityParser::setCustomCurve(const float* shape) {
+    for (int v = 0; v < kTableSize; ++v)
+        customShape[v] = shape[v] < 0.0f ? 0.0f : (shape[v] > 1.0f ? 1.0f : shape[v]);
+    for (int t = 0; t < kNumTargets; ++t) {
+        if (curve[t] == kCustom)
+            build(static_cast<Target>(t));
+    }
 }
 
 /**
- * @brief Perform threshold-based velocity discrimination
- * 
- * @param velocity MIDI velocity value for analysis
- * @return Boolean note-on/note-off determination
+ * @brief Evaluate the curve at every velocity and apply the target's mapping
  * 
- * @implementation_efficiency
- * Single integer comparison provides optimal performance for real-time
- * MIDI processing. No complex logic or state tracking required, ensuring
- * deterministic execution time suitable for low-latency audio applications.
- * 
- * @precision_analysis
- * Integer comparison eliminates floating-point precision concerns and
- * provides exact threshold behavior. Binary discrimination ensures
- * consistent results across processor architectures and compiler optimizations.
+ * Amount 0 yields exactly 1.0 for every target, so a target that ignores
+ * velocity leaves the voice bit-identical to one without velocity shaping.
+ * The shapes come from kVelocityShapeTable and the attack mapping from
+ * tableExp2(), so no libm call runs here: build() is safe from setup() and
+ * from the CC 34 handler on the audio thread.
  */
-bool VelocityParser::isNoteOn(int velocity) {
-    return velocity > velocityThreshold;
+void VelocityParser::build(Target target) {
+    const float a = amount[target];
+    for (int v = 0; v < kTableSize; ++v) {
+        const float x = v / 127.0f;
+        float shape;
+        switch (curve[target]) {
+        case kExponential:
+            shape = kVelocityShapeTable.exponential[v];
+            break;
+        case kCompressed:
+            shape = kVelocityShapeTable.compressed[v];
+            break;
+        case kCustom:
+            shape = customShape[v];
+            break;
+        default:
+            shape = x;
+            break;
+        }
+        
+        if (target == kAttack)
+            table[target][v] = tableExp2(-kAttackOctaves * a * shape);
+        else
+            table[target][v] = 1.0f - a + a * shape;
+    }
 }
 
 /**
@@ -69,8 +102,9 @@ bool VelocityParser::isNoteOn(int velocity) {
  * - Prevents: Audio artifacts from abrupt parameter changes
  * 
  * **VelocityParser**:
- * - Consumes: Raw MIDI velocity data
- * - Produces: Binary note-on/note-off decisions
+ * - Consumes: MIDI note status and velocity
+ * - Produces: Note-on/note-off decisions and per-note dynamics (level,
+ *   filter depth, attack time) from precomputed curves
  * - Enables: Reliable note triggering across controllers
  * 
  * **System Integration**:
@@ -93,7 +127,6 @@ bool VelocityParser::isNoteOn(int velocity) {
  * 
  * - **Advanced Envelope Shapes**: Non-linear interpolation curves
  * - **Multi-segment Envelopes**: Complex modulation patterns
- * - **Velocity Curves**: Non-linear velocity response mapping
  * - **Parameter Automation**: Timeline-based parameter control
  * - **Polyphonic Extensions**: Multi-voice envelope and control systems
  * 
@@ -103,7 +136,6 @@ bool VelocityParser::isNoteOn(int velocity) {
  * - MoogFilterEnvelope.cpp line 23-26: Hardcoded sample rate bug
  * - All modules: Consider adding parameter validation for development builds
  * - ResonanceRamp: Evaluate exponential vs. linear parameter interpolation
- * - VelocityParser: Consider adding hysteresis for noise immunity
  * 
  * **Testing Recommendations**:
  * - Unit tests for edge cases (zero values, extreme parameters)
@@ -111,3 +143,4 @@ bool VelocityParser::isNoteOn(int velocity) {
  * - Performance profiling under real-time constraints
  * - Musical validation with diverse MIDI controllers
  * 
+ */
@@ -1,12 +1,12 @@
 /**
  * @file VelocityParser.h
- * @brief MIDI velocity analysis and note-on/note-off discrimination
+ * @brief MIDI note-on/note-off discrimination and velocity response curves
  * 
- * This module implements intelligent MIDI velocity parsing to distinguish between
- * note-on and note-off events based on configurable velocity thresholds. The system
- * addresses ambiguities in MIDI protocol where velocity-zero note-on messages serve
- * as note-off events, and provides hysteresis-based velocity discrimination for
- * improved performance reliability with electronic controllers.
+ * This module decides whether a MIDI note message starts or ends a note, and
+ * turns the velocity of a note-on into the voice's dynamics: output level,
+ * filter envelope depth and amplitude attack time. Each of the three targets
+ * reads a precomputed 128-entry table, so a note-on costs three array reads
+ * and no transcendental functions.
  * 
  * @midi_protocol_background
  * The MIDI specification defines two methods for note termination:
@@ -15,30 +15,38 @@
  * 2. **Velocity-Zero Note-On**: Note-on message with velocity = 0 (status byte 9x)
  * 
  * Many MIDI controllers and software implementations use method 2 for efficiency,
- * sending only note-on messages with velocity 0 for note release. Additionally,
- * some controllers may send very low velocity values that should be interpreted
- * as note-off events to prevent unwanted note triggering.
- * 
- * @threshold_DISCRIMINATION_THEORY
- * Electronic keyboards and controllers often exhibit velocity sensing variations
- * due to mechanical tolerances, sensor calibration, and playing technique. A
- * configurable threshold provides:
- * 
- * 1. **False Trigger Prevention**: Eliminates unwanted notes from light key touches
- * 2. **Performance Consistency**: Ensures reliable note triggering across devices
- * 3. **Musical Expression**: Maintains velocity sensitivity above threshold
- * 4. **Compatibility**: Adapts to different controller characteristics
- * 
- * @implementation_philosophy
- * The implementation prioritizes simplicity and reliability over complex heuristics.
- * A single threshold value provides effective discrimination while maintaining
- * predictable behavior across diverse MIDI sources and performance styles.
+ * sending only note-on messages with velocity 0 for note release. Both are
+ * recognised from the status byte and the zero velocity alone: every note-on
+ * with velocity 1-127 is a note, however softly it was played. (An earlier
+ * version compared the velocity against a threshold of 64, which turned soft
+ * notes into note-offs.)
+ * 
+ * @response_curves
+ * Each table maps velocity v to a shape s(x) of x = v/127, blended with a
+ * fixed value by a per-target amount a in [0, 1] (a = 0 ignores velocity):
+ * 
+ * | Curve        | s(x)                      | Feel                          |
+ * |--------------|---------------------------|-------------------------------|
+ * | kLinear      | x                         | Even response                 |
+ * | kExponential | (2^(4x) − 1) / 15         | Soft notes much quieter       |
+ * | kCompressed  | log2(1 + 15x) / 4         | Soft notes close to hard ones |
+ * | kCustom      | user table                | Matched to a controller       |
+ * 
+ * | Target       | Table value               | Applied as                    |
+ * |--------------|---------------------------|-------------------------------|
+ * | kAmplitude   | 1 − a + a·s               | × amplitude envelope          |
+ * | kFilterDepth | 1 − a + a·s               | × filter envelope depth       |
+ * | kAttack      | 2^(−kAttackOctaves·a·s)   | × amplitude attack time       |
+ * 
+ * Exponential and compressed are inverses of each other.
  * 
  * @performance_characteristics
- * - Computational complexity: O(1) - Single comparison operation
- * - Memory footprint: 4 bytes (single integer threshold)
- * - Real-time safety: No allocation or blocking operations
- * - Deterministic behavior: Consistent output for identical inputs
+ * - Note-on/off test: one compare on the status and one on the velocity
+ * - Per note-on: three table reads
+ * - setCurve(): rebuilds one table from the embedded shapes
+ *   (kVelocityShapeTable) plus, for kAttack, 128 tableExp2() calls; no libm
+ *   call, so it runs from setup() and from a CC handler
+ * - Memory: 3 × 128 floats of tables plus a 128-entry custom shape (2 KB)
  * 
  * @author Timothy Paul Read
  * @date 2025/03/10
@@ -57,136 +65,128 @@
 
 /**
  * @class VelocityParser
- * @brief MIDI velocity threshold processor for note-on/note-off discrimination
- * 
- * The VelocityParser class provides intelligent MIDI velocity analysis with
- * configurable threshold-based discrimination between note-on and note-off events.
- * It handles MIDI protocol ambiguities and controller variations to ensure reliable
- * note triggering behavior across diverse hardware and software configurations.
- * 
- * @design_principles
- * - **Simplicity**: Single threshold comparison for predictable behavior
- * - **Configurability**: User-adjustable threshold for different controllers
- * - **Reliability**: Consistent discrimination across velocity ranges
- * - **Performance**: Minimal computational overhead for real-time processing
- * 
- * @threshold_selection_guidelines
- * Optimal threshold values depend on MIDI controller characteristics:
- * 
- * - **Conservative (32-48)**: Prevents false triggers, may reduce sensitivity
- * - **Balanced (49-80)**: Good compromise for most controllers and playing styles
- * - **Sensitive (81-100)**: Maximum expression, may allow false triggers
- * - **Aggressive (101-127)**: Only strong velocities trigger notes
- * 
- * @musical_applications
- * - Monophonic synthesizers requiring reliable note triggering
- * - Drum machines with velocity-sensitive sample triggering
- * - Educational software with consistent note response
- * - Live performance systems requiring predictable behavior
- * - MIDI recording applications with clean note discrimination
+ * @brief Status-based note-on test and velocity lookup tables
  * 
  * @usage_example
  * @code
- * VelocityParser parser(64);  // Moderate threshold for balanced response
+ * VelocityParser velocity;
+ * velocity.setCurve(VelocityParser::kAmplitude, VelocityParser::kExponential, 0.6f);
  * 
  * // In MIDI message processing:
- * if (messageType == kmmNoteOn) {
- *     bool isNoteOn = parser.isNoteOn(velocity);
- *     if (isNoteOn) {
- *         synthesizer.noteOn(noteNumber, velocity);
- *     } else {
- *         synthesizer.noteOff(noteNumber);
- *     }
+ * bool isNoteOn = VelocityParser::isNoteOn(type == kmmNoteOn, data1);
+ * if (isNoteOn) {
+ *     voiceLevel = velocity.getAmplitude(data1);
+ *     filterEnv.gate(1, velocity.getFilterDepth(data1));
  * }
  * @endcode
  */
 class VelocityParser {
 public:
     /**
-     * @brief Construct velocity parser with configurable threshold
-     * 
-     * @param threshold Velocity threshold for note-on discrimination
-     *                  Values above threshold trigger note-on events
-     *                  Values at or below threshold are interpreted as note-off
-     *                  Default: 64 (middle MIDI range, balanced sensitivity)
-     *                  Range: [1-126] practical limits for musical applications
-     * 
-     * @complexity O(1) - Constant time initialization
-     * @memory 4 bytes object size (single integer member)
-     * @thread_safety Safe for concurrent construction
-     * 
-     * @threshold_rationale
-     * Default value of 64 provides balanced behavior suitable for most
-     * musical applications and MIDI controllers. This represents 50% of
-     * the MIDI velocity range, offering good sensitivity while preventing
-     * false triggering from light touches or controller noise.
-     * 
-     * @boundary_considerations
-     * - Threshold = 0: All non-zero velocities trigger notes (maximum sensitivity)
-     * - Threshold = 127: No velocities trigger notes (effectively disabled)
-     * - Threshold = 126: Only maximum velocity triggers notes (minimum sensitivity)
+     * @enum Target
+     * @brief Voice parameters shaped by velocity
      */
-    VelocityParser(int threshold = 64);
+    enum Target {
+        kAmplitude = 0,     ///< Level multiplier [0-1]
+        kFilterDepth,       ///< Filter envelope depth multiplier [0-1]
+        kAttack,            ///< Attack time multiplier (0-1]
+        kNumTargets
+    };
     
     /**
-     * @brief Analyze velocity value and determine note-on status
+     * @enum Curve
+     * @brief Response curve shapes (formulas in the file header)
+     */
+    enum Curve {
+        kLinear = 0,
+        kExponential,
+        kCompressed,
+        kCustom,
+        kNumCurves
+    };
+    
+    /** @brief One entry per MIDI velocity */
+    static const int kTableSize = 128;
+    
+    /** @brief Largest attack shortening, in octaves of time (a = 1, v = 127) */
+    static constexpr float kAttackOctaves = 2.0f;
+    
+    /**
+     * @brief Construct with every target linear at amount 0 (velocity ignored)
      * 
-     * Performs threshold-based analysis of MIDI velocity values to determine
-     * whether the velocity represents a note-on or note-off event. Provides
-     * consistent discrimination behavior essential for reliable musical performance.
+     * The custom shape starts linear.
      * 
-     * @param velocity MIDI velocity value for analysis
-     *                 Range: [0-127] per MIDI specification
-     *                 Values outside range processed without validation
+     * @realtime_safety Non-real-time (fills the tables)
+     */
+    VelocityParser();
+    
+    /**
+     * @brief Decide note-on or note-off from the MIDI status and velocity
      * 
-     * @return true if velocity indicates note-on event (velocity > threshold)
-     *         false if velocity indicates note-off event (velocity ≤ threshold)
+     * @param noteOnStatus true for a note-on status byte (9x), false for a
+     *                     note-off (8x)
+     * @param velocity MIDI velocity [0-127]
      * 
-     * @complexity O(1) - Single integer comparison
-     * @determinism Identical output for identical inputs
-     * @realtime_safety Real-time safe (no allocation or blocking)
+     * @return true for a note-on with velocity 1-127; false for a note-off,
+     *         including the velocity-zero note-on
      * 
-     * @discrimination_logic
-     * The method implements strict threshold comparison:
-     * - velocity > threshold → note-on event
-     * - velocity ≤ threshold → note-off event
+     * @complexity O(1) - Two comparisons
+     * @realtime_safety Real-time safe
+     */
+    static bool isNoteOn(bool noteOnStatus, int velocity) {
+        return noteOnStatus && velocity > 0;
+    }
+    
+    /**
+     * @brief Select the curve and amount of one target and rebuild its table
      * 
-     * This provides clean binary discrimination without hysteresis or
-     * complex state tracking, ensuring predictable behavior for musical
-     * applications requiring consistent note triggering.
+     * @param target Parameter to shape
+     * @param curve Response shape
+     * @param amount Velocity sensitivity [0-1], clamped; 0 makes the target
+     *               ignore velocity
      * 
-     * @musical_implications
-     * Threshold-based discrimination affects musical expression:
-     * - Lower thresholds: Greater velocity sensitivity, potential false triggers
-     * - Higher thresholds: Reduced sensitivity, consistent triggering
-     * - Balanced thresholds: Optimal compromise for most musical contexts
+     * @realtime_safety Real-time safe (no allocation, no libm calls)
+     */
+    void setCurve(Target target, Curve curve, float amount);
+    
+    /**
+     * @brief Replace the kCustom shape and rebuild the targets that use it
      * 
-     * @edge_case_behavior
-     * - velocity = 0: Always returns false (standard MIDI note-off)
-     * - velocity = threshold: Returns false (at-threshold interpreted as off)
-     * - velocity = threshold + 1: Returns true (above-threshold interpreted as on)
+     * @param shape kTableSize values [0-1], indexed by velocity, clamped
      * 
-     * @controller_compatibility
-     * Different MIDI controllers exhibit varying velocity characteristics:
-     * - Weighted keyboards: Generally consistent velocity curves
-     * - Synth-action keys: May have different velocity response
-     * - Drum pads: Often require lower thresholds for sensitivity
-     * - Wind controllers: Continuous velocity, may need special handling
+     * @realtime_safety Real-time safe (no allocation)
      */
-    bool isNoteOn(int velocity);
+    void setCustomCurve(const float* shape);
+    
+    Curve getCurve(Target target) const { return curve[target]; }
+    float getAmount(Target target) const { return amount[target]; }
+    
+    /** @brief Table value of a target for a MIDI velocity (masked to 0-127) */
+    float lookup(Target target, int velocity) const {
+        return table[target][velocity & (kTableSize - 1)];
+    }
+    
+    /** @brief Level multiplier for a note-on velocity */
+    float getAmplitude(int velocity) const { return lookup(kAmplitude, velocity); }
+    
+    /** @brief Filter envelope depth multiplier for a note-on velocity */
+    float getFilterDepth(int velocity) const { return lookup(kFilterDepth, velocity); }
+    
+    /** @brief Attack time multiplier for a note-on velocity */
+    float getAttackScale(int velocity) const { return lookup(kAttack, velocity); }
 
 private:
     /**
-     * @brief Velocity threshold for note-on discrimination
-     * 
-     * Integer threshold value used for binary velocity discrimination.
-     * Values above this threshold are interpreted as note-on events,
-     * while values at or below are interpreted as note-off events.
-     * 
-     * @range [0-127] per MIDI velocity specification
-     * @default 64 (balanced sensitivity for most applications)
-     * @units MIDI velocity units (dimensionless integer)
+     * @brief Fill one target's table from its curve and amount
      */
-    int velocityThreshold;
+    void build(Target target);
+    
+    /** @brief Precomputed responses, one row per target */
+    float table[kNumTargets][kTableSize];
+    
+    /** @brief Shape used by kCustom [0-1] */
+    float customShape[kTableSize];
+    
+    Curve curve[kNumTargets];
+    float amount[kNumTargets];
 };
-
@@ -1,28 +1,41 @@
 /**
  * @file render.cpp
- * @brief Real-time monophonic synthesizer implementation for Bela platform
+ * @brief Real-time multi-timbral synthesizer host for the Bela platform
  * 
- * This file implements a complete monophonic synthesizer using the Bela real-time audio platform.
- * The synthesizer features a sine wave oscillator with portamento, dual ADSR envelopes 
- * (amplitude and filter), a zero-delay feedback Moog ladder filter, and comprehensive
- * MIDI control with analog input integration.
+ * This file hosts one or more TR-123e parts (SynthInstance) in the Bela
+ * render callback. Each part is a complete monophonic synthesizer - a sine
+ * oscillator with portamento, dual ADSR envelopes (amplitude and filter), a
+ * zero-delay feedback Moog ladder pair, LFOs, modulation matrix and step
+ * sequencer - with its own MIDI channel and parameter set. The host owns
+ * the MIDI port, the panel, the shared cabinet and post-FX chain, and the
+ * diagnostics.
  * 
  * @architecture
  * The system employs a modular signal flow architecture:
- * MIDI Input → Note Processing → Oscillator → Filter → Amplification → Audio Output
- *             ↓                    ↓         ↓
- *         Portamento         Amp Envelope  Filter Envelope
+ * MIDI Input → Channel Routing → Instance 0..N-1 → Sum → Cabinet → Post-FX → Audio Output
+ *                                 ↓
+ *              Oscillator → Filter → Amplification (per instance)
+ * 
+ * @instances
+ * TR123E_INSTANCES (default 1, at most 8) sets the number of parts at
+ * compile time, so the arena is sized exactly and the sub-block loop has a
+ * fixed trip count. A single part listens on every channel, as before;
+ * with several, part i listens on MIDI channel i+1. CC 35 (any channel)
+ * chooses which part the panel's pots control. MIDI clock, start and stop
+ * reach every part.
  * 
  * @performance_characteristics
  * - Real-time processing at variable sample rates (typically 44.1kHz)
  * - Ultra-low latency audio processing (< 5ms typical)
  * - Zero-delay feedback filter implementation for analog-accurate response
  * - Hardware analog control integration with smooth parameter interpolation
+ * - CPU cost linear in the number of parts; each part's share of real time
+ *   is reported at cleanup
  * 
  * @dependencies
  * - Bela.h: Real-time audio framework
  * - libraries/Midi/Midi.h: MIDI protocol implementation
- * - Custom DSP classes: ADSR, KeyFollow, MidiHandler, etc.
+ * - SynthInstance: one part; custom DSP classes: PostFxChain, PartitionedConvolver, etc.
  * 
  * @author [Timothy Paul Read]
  * @date [2025/5/25]
@@ -32,201 +45,418 @@
 #include <Bela.h>
 #include <libraries/Midi/Midi.h>
 #include <cmath>
-#include "ADSR.h"
-#include "KeyFollow.h"
-#include "MidiHandler.h"
-#include "MoogFilterEnvelope.h"
-#include "PortamentoFilter.h"
-#include "PortamentoPlayer.h"
-#include "ResonanceRamp.h"
-#include "VelocityParser.h"
-#include "zdf_moogladder_v2.h"
+#include "AudioArena.h"
+#include "BlockTrace.h"
+#include "ImpulseResponse.h"
+#include "OverrunCapture.h"
+#include "ParameterUpdate.h"
+#include "PartitionedConvolver.h"
+#include "PostFxChain.h"
+#include "RealtimeGuard.h"
+#include "ReconfigurePipeline.h"
+#include "SampleRate.h"
+#include "SessionRecorder.h"
+#include "StartupProfile.h"
+#include "SubBlockScheduler.h"
+#include "SynthInstance.h"
+#include "TableBank.h"
 
 // ============================================================================
-// GLOBAL STATE VARIABLES
+// INSTANCES
 // ============================================================================
 
 /**
- * @brief Primary oscillator phase accumulator [0, 2π]
- * 
- * Maintains phase continuity for sine wave generation using direct digital 
- * synthesis (DDS) method. Phase wrapping prevents floating-point precision
- * degradation over extended operation periods.
+ * @brief Number of synth parts hosted in the callback (-DTR123E_INSTANCES=N)
  */
-float oscillatorPhase = 0.0f;
+#ifndef TR123E_INSTANCES
+#define TR123E_INSTANCES 1
+#endif
+
+const unsigned int kNumInstances = TR123E_INSTANCES;
+static_assert(kNumInstances >= 1 && kNumInstances <= static_cast<unsigned int>(BlockTrace::kMaxEnvelopes),
+              "TR123E_INSTANCES must be 1-8: each part's amplitude envelope has a trace slot");
 
 /**
- * @brief Precomputed 2π constant for computational efficiency
- * 
- * Cached value eliminates repeated trigonometric calculations in the
- * audio processing loop, reducing CPU overhead in real-time context.
+ * @brief The parts, constructed in the audio arena by setup()
+ */
+SynthInstance* instances[kNumInstances] = { nullptr };
+
+/**
+ * @brief Part whose parameters the hardware pots control (CC 35)
+ */
+unsigned int panelInstance = 0;
+
+/**
+ * @brief Seed of part 0's noise; part i uses kNoiseSeed + i
+ */
+const uint32_t kNoiseSeed = 0x7123E;
+
+/**
+ * @brief Trace names of the parts' amplitude envelopes
  */
-float twoPi = 2.0f * M_PI;
+const char* const kEnvelopeTraceNames[BlockTrace::kMaxEnvelopes] = {
+    "amp envelope", "amp envelope 2", "amp envelope 3", "amp envelope 4",
+    "amp envelope 5", "amp envelope 6", "amp envelope 7", "amp envelope 8"
+};
 
 // ============================================================================
-// AUDIO PROCESSING MODULES
+// HOST MODULES
 // ============================================================================
 
 /**
  * @brief MIDI interface controller
  * 
  * Handles low-level MIDI protocol parsing and message buffering.
- * Configured for hardware MIDI interface "hw:0,0" (first MIDI device).
+ * Configured for the hardware MIDI interface kMidiPort.
  */
 Midi midi;
 
 /**
- * @brief High-level MIDI message processor and timing controller
- * @param sampleRate 44100.0f Hz - Standard audio sample rate
- * @param jitterReduction 1.0f - Temporal quantization factor for timing stability
- * 
- * Implements sophisticated MIDI timing algorithms to handle note scheduling,
- * velocity-sensitive triggering, and temporal message buffering for
- * frame-accurate event processing.
+ * @brief First MIDI device on the system
+ */
+const char* const kMidiPort = "hw:0,0";
+
+/**
+ * @brief Speaker-cabinet impulse response: cabinet.wav if present, else built in
  */
-MidiHandler midiHandler(44100.0f, 1.0f);
+ImpulseResponse cabinetImpulse;
 
 /**
- * @brief Velocity-sensitive note triggering processor
- * @param threshold 64 - MIDI velocity threshold for note-on discrimination
+ * @brief Cabinet convolution of the summed parts, ahead of the post-FX chain
  * 
- * Implements hysteresis-based velocity parsing to distinguish between
- * note-on and note-off events, preventing false triggering from low
- * velocity note-on messages (common in electronic controllers).
+ * Zero added latency: a direct-form head plus a partitioned FFT tail in
+ * blocks of the hardware period. Off until CC 29 switches it in.
  */
-VelocityParser velocityParser(64);
+PartitionedConvolver cabinet;
 
 /**
- * @brief Portamento behavior analysis module
+ * @brief Chorus, tempo delay and limiter between the parts and the DAC
  * 
- * Analyzes incoming MIDI note patterns to determine appropriate portamento
- * behavior based on legato playing technique detection and note overlap timing.
+ * Processes each period's output in place after the sub-blocks; the
+ * limiter keeps the output gain pot's full range (up to 2.0) from clipping
+ * the converter. Buffers come from the audio arena.
  */
-PortamentoFilter portamentoFilter;
+PostFxChain postFx;
 
 /**
- * @brief Pitch interpolation and portamento synthesis engine
- * @param sampleRate 44100.0f Hz - Audio processing rate
- * @param glideTime 100.0f ms - Default portamento transition duration
+ * @brief Analog potentiometer values of the current period
  * 
- * Implements exponential pitch interpolation algorithms for smooth frequency
- * transitions between notes. Uses logarithmic frequency scaling to maintain
- * perceptually linear pitch movement across the entire musical range.
+ * Read once per period and handed to instances[panelInstance].
  */
-PortamentoPlayer portamentoPlayer(44100.0f, 100.0f);
+PanelControls panel;
+
+// ============================================================================
+// AUDIO BUFFER MANAGEMENT
+// ============================================================================
 
 /**
- * @brief Primary amplitude envelope generator
+ * @brief Output audio buffers for the summed parts, left and right
  * 
- * Four-stage ADSR (Attack, Decay, Sustain, Release) envelope with
- * exponential segment shaping and configurable curvature parameters.
- * Implements state machine for proper envelope stage transitions.
+ * Stores final processed audio after filter stage, ready for DAC output.
+ * Double-buffering architecture prevents audio artifacts during processing.
  */
-ADSR envelope;
+float* outputBuffer = nullptr;
+float* outputBufferRight = nullptr;
 
 /**
- * @brief Filter cutoff frequency envelope generator
- * @param sampleRate 44100.0f Hz - Audio processing rate
+ * @brief One sub-block per channel for parts 1..N-1 before they are summed
  * 
- * Specialized envelope generator for filter frequency modulation with
- * velocity sensitivity and exponential frequency mapping. Provides
- * musical filter sweeps with proper logarithmic frequency scaling.
+ * Part 0 renders straight into the output; the others render here and are
+ * added to it, so a single part costs no extra pass.
  */
-MoogFilterEnvelope filterEnv(44100.0f);
+float* mixBuffer = nullptr;
+float* mixBufferRight = nullptr;
 
 /**
- * @brief Keyboard tracking / key follow processor
- * @param intensity 0.01f - Key tracking coefficient [0.0-1.0]
+ * @brief Aligned arena holding every audio-path buffer
  * 
- * Implements keyboard tracking for filter cutoff frequency, allowing
- * higher notes to open the filter proportionally. Uses MIDI note number
- * to frequency mapping with configurable tracking intensity.
+ * Reserved and pre-faulted in setup(), locked before the first render() so
+ * nothing can allocate on the audio thread, released in cleanup().
  */
-KeyFollow keyFollow(0.01f);
+AudioArena audioArena;
 
 /**
- * @brief Resonance parameter smoothing filter
- * @param sampleRate 44100.0f Hz - Audio processing rate  
- * @param rampTime 50.0f ms - Parameter transition smoothing time
+ * @brief Current audio buffer size in samples
  * 
- * Implements first-order low-pass filtering for resonance parameter changes
- * to prevent audio artifacts from abrupt control changes, particularly
- * important for high-Q filter settings where parameter discontinuities
- * can cause instability.
+ * Dynamically determined from Bela context, typically 64-512 samples
+ * depending on system configuration and latency requirements.
  */
-ResonanceRamp resonanceRamp(44100.0f, 50.0f);
+int bufferSize = 0;
 
 /**
- * @brief Zero-delay feedback Moog ladder filter implementation
- * @param sampleRate 44100.0f Hz - Audio processing rate
+ * @brief Internal DSP block size in frames, fixed by the parts
+ */
+const unsigned int kSubBlockFrames = SynthInstance::kSubBlockFrames;
+
+/**
+ * @brief Bridges fixed-size DSP sub-blocks to the hardware period
  * 
- * Advanced digital implementation of the classic Moog transistor ladder filter
- * using zero-delay feedback (ZDF) topology. Provides analog-accurate frequency
- * response and self-oscillation behavior with numerical stability across
- * all parameter ranges.
+ * Runs renderSubBlock() directly into outputBuffer when the period is a
+ * multiple of kSubBlockFrames, otherwise through a FIFO whose worst-case
+ * control latency is printed at setup.
+ */
+SubBlockScheduler subBlockScheduler;
+
+/**
+ * @brief Largest hardware period the engine is prepared for
  * 
- * @note ZDF implementation eliminates the one-sample delay inherent in 
- * traditional digital filter structures, providing superior transient response
- * and improved analog modeling accuracy.
+ * Output buffer and scheduler FIFO are reserved for this size so a
+ * block-size change at run time never allocates.
+ */
+const unsigned int kMaxPeriodFrames = 256;
+
+/**
+ * @brief Output channels rendered by the parts (left, right)
  */
-ZDFMoogLadderFilter zdfFilter(44100.0f);
+const unsigned int kNumOutputChannels = 2;
 
 // ============================================================================
-// AUDIO BUFFER MANAGEMENT
+// ENGINE STATE
 // ============================================================================
 
 /**
- * @brief Input audio buffer for oscillator output
+ * @brief Audio-to-analog frame ratio for control rate processing
  * 
- * Dynamically allocated buffer for storing raw oscillator output before
- * filter processing. Separation of generation and filtering stages allows
- * for potential future multi-stage processing implementations.
+ * Bela systems process analog inputs at lower rates than audio (typically 8:1 ratio).
+ * This variable caches the ratio for efficient analog input indexing without
+ * repeated division operations in the audio callback.
  */
-float* inputBuffer = nullptr;
+int gAudioFramesPerAnalogFrame = 0;
 
 /**
- * @brief Output audio buffer for filtered audio
+ * @brief Audio sample rate of the active configuration
  * 
- * Stores final processed audio after filter stage, ready for DAC output.
- * Double-buffering architecture prevents audio artifacts during processing.
+ * The per-sample path uses SampleRateTraits<Rate> constants instead; this
+ * runtime copy converts the sample clock to seconds for the reports.
  */
-float* outputBuffer = nullptr;
+float audioSampleRate = 44100.0f;
 
 /**
- * @brief Current audio buffer size in samples
- * 
- * Dynamically determined from Bela context, typically 64-512 samples
- * depending on system configuration and latency requirements.
+ * @brief Modulation quality switch, set from MIDI CC 16
+ *
+ * true ticks every source of every part on every sample (for snappy
+ * attacks). Applied through the reconfiguration pipeline, because the
+ * envelope and ramp timings depend on the rate they are ticked at.
  */
-int bufferSize = 0;
+bool audioRateModulation = false;
+
+/**
+ * @brief 64-bit sample clock: frames rendered by the sub-block callback
+ *
+ * Sub-blocks may be rendered ahead of the hardware period (FIFO bridging),
+ * so sequencer events and MIDI clock timestamps use this clock rather than
+ * context->audioFramesElapsed.
+ */
+uint64_t sampleClock = 0;
+
+template <int Rate>
+void renderSubBlock(float* const* outputs, unsigned int frames, void* userData);
+SubBlockScheduler::SubBlockCallback selectSubBlockRenderer(float sampleRate);
 
 // ============================================================================
-// SYNTHESIS PARAMETERS
+// SAMPLE-RATE RECONFIGURATION
 // ============================================================================
 
 /**
- * @brief Base filter cutoff frequency in Hz
+ * @brief Two-phase rate/block-size reconfiguration for all modules
  * 
- * Fundamental filter frequency before envelope and key tracking modulation.
- * Set to 5kHz as musically useful default providing bright, open character
- * while allowing sufficient modulation range.
+ * setup() applies the initial configuration through it; render() requests
+ * a change when the context reports a different rate or period, an
+ * auxiliary task prepares it and the next render() commits it.
  */
-float baseCutoffFrequency = 5000.0f;
+ReconfigurePipeline reconfigurePipeline;
 
 /**
- * @brief Audio-to-analog frame ratio for control rate processing
+ * @brief Auxiliary task running the prepare phase off the audio thread
+ */
+AuxiliaryTask reconfigureTask;
+
+/**
+ * @brief Per-block trace of the audio thread, exported after overruns
  * 
- * Bela systems process analog inputs at lower rates than audio (typically 8:1 ratio).
- * This variable caches the ratio for efficient analog input indexing without
- * repeated division operations in the audio callback.
+ * The ring holds ~180 periods of 128 frames; the drain task empties it
+ * every quarter ring, keeping ~10 s of history for export.
  */
-int gAudioFramesPerAnalogFrame = 0;
+BlockTrace blockTrace;
+AuxiliaryTask traceTask;
+const unsigned int kTraceCapacity = 4096;
+const unsigned int kTraceHistory = 1u << 18;
+
+/**
+ * @brief Rolling capture of the last blocks' inputs, written after an overrun
+ * 
+ * 64 blocks is ~190 ms at 128 frames, 44.1 kHz: enough to catch the
+ * note-on or knob sweep that led into the spike. Replay it on a host with
+ * DEV/OverrunReplay.cpp.
+ */
+OverrunCapture overrunCapture;
+AuxiliaryTask captureTask;
+const unsigned int kCaptureBlocks = 64;
+
+/**
+ * @brief Continuous record of render() input, replayed with DEV/SessionReplay.cpp
+ */
+SessionRecorder sessionRecorder;
+AuxiliaryTask sessionTask;
+
+/**
+ * @brief Cold-start milestones, reported once the first note has sounded
+ */
+StartupProfile startupProfile;
+AuxiliaryTask startupTask;
+bool startupReported = false;
+
+/**
+ * @brief Trace stage ids
+ */
+enum TraceStage {
+    kTraceReconfigure = 0,
+    kTraceMidi,
+    kTraceDelayedMidi,
+    kTraceControls,
+    kTraceSequencer,
+    kTraceSubBlocks,
+    kTraceSubBlock,
+    kTraceOutput,
+    kTracePostFx,
+    kTraceCabinet
+};
+
+/**
+ * @brief Trace parameter ids: 0-127 are MIDI CCs, panel controls follow
+ */
+enum TraceParameter {
+    kTracePanelCutoff = 128,
+    kTracePanelResonance,
+    kTracePanelMode,
+    kTracePanelGain,
+    kTracePanelDrive,
+    kTracePanelEnvDepth,
+    kTracePanelAttack,
+    kTracePanelRelease
+};
+
+/**
+ * @brief Smallest panel movement worth a trace record (pot noise is ~1e-3)
+ */
+const float kTracePanelThreshold = 0.01f;
+
+
+/**
+ * @brief Pipeline registration of the post-FX chain; each part registers itself
+ */
+ModuleRateBinding<PostFxChain> postFxRate(postFx);
+
+/**
+ * @class EngineRateBinding
+ * @brief Rate-dependent state owned by render.cpp itself
+ * 
+ * Selects the renderSubBlock instantiation for the new rate and the new
+ * period for the scheduler; rejects rates without an instantiation and
+ * periods beyond kMaxPeriodFrames.
+ */
+class EngineRateBinding : public RateListener {
+public:
+    bool prepareRate(const EngineRate& rate) override {
+        stagedCallback = selectSubBlockRenderer(rate.sampleRate);
+        stagedRate = rate;
+        return stagedCallback != nullptr && rate.periodFrames <= kMaxPeriodFrames;
+    }
+
+    void commitRate() override {
+        subBlockScheduler.setCallback(stagedCallback);
+        subBlockScheduler.setPeriod(stagedRate.periodFrames);
+        audioSampleRate = stagedRate.sampleRate;
+        bufferSize = stagedRate.periodFrames;
+    }
+
+private:
+    SubBlockScheduler::SubBlockCallback stagedCallback = nullptr;
+    EngineRate stagedRate = { 0.0f, 0, false };
+};
+
+EngineRateBinding engineRate;
+
+/**
+ * @class CabinetRateBinding
+ * @brief The convolver depends on the period as well as the rate
+ * 
+ * Its partition is the period, so it takes the whole EngineRate rather
+ * than going through ModuleRateBinding. Rendering the response is
+ * transcendental maths, which setup() does not do: the synchronous prepare
+ * in setup() stages a bypassed cabinet, and render() has the response
+ * rendered by the reconfiguration task (ReconfigurePipeline::refresh())
+ * until one has been committed.
+ */
+class CabinetRateBinding : public RateListener {
+public:
+    bool prepareRate(const EngineRate& rate) override {
+        stagedRendered = !deferResponse;
+        if (deferResponse)
+            return cabinet.prepareBypass();
+        return cabinet.prepareConfiguration(rate.sampleRate, rate.periodFrames);
+    }
+
+    void commitRate() override {
+        cabinet.commitConfiguration();
+        rendered = stagedRendered;
+    }
+
+    /** @brief Stage a bypass instead of rendering (setup() only) */
+    void setDeferResponse(bool defer) { deferResponse = defer; }
+
+    /** @brief True once a configuration with its response has been committed */
+    bool isRendered() const { return rendered; }
+
+private:
+    bool deferResponse = true;
+    bool stagedRendered = false;
+    bool rendered = false;
+};
+
+CabinetRateBinding cabinetRate;
+
+/**
+ * @brief Auxiliary task entry point: run the pipeline's prepare phase
+ */
+void prepareReconfiguration(void*) {
+    reconfigurePipeline.prepare();
+}
+
+/**
+ * @brief Auxiliary task: move trace records out of the ring
+ */
+void drainTrace(void*) {
+    blockTrace.drain();
+}
+
+/**
+ * @brief Auxiliary task: append recorded session input to its file
+ */
+void writeSession(void*) {
+    sessionRecorder.write();
+}
+
+/**
+ * @brief Auxiliary task: print the cold-start timings
+ */
+void reportStartup(void*) {
+    startupProfile.report(stdout);
+}
+
+/**
+ * @brief Auxiliary task: write a frozen overrun capture to disk
+ */
+void writeOverrunCapture(void*) {
+    if (overrunCapture.writePending())
+        rt_printf("Overrun captured (%u)\n", overrunCapture.getSnapshotCount());
+}
 
 /**
  * @function setup
  * @brief System initialization and configuration
  * 
- * Initializes all audio processing modules, allocates dynamic memory,
+ * Initializes the parts and the host modules, allocates dynamic memory,
  * configures MIDI interface, and establishes initial parameter states.
  * Called once at system startup before real-time processing begins.
  * 
@@ -234,7 +464,7 @@ int gAudioFramesPerAnalogFrame = 0;
  * @param userData User-defined data pointer (unused in this implementation)
  * @return true if initialization successful, false triggers system abort
  * 
- * @complexity O(1) - Constant time initialization
+ * @complexity O(N) in the number of parts
  * @realtime_safety Non-real-time safe (performs memory allocation)
  * 
  * @note This function performs dynamic memory allocation and must complete
@@ -242,15 +472,31 @@ int gAudioFramesPerAnalogFrame = 0;
  * will prevent audio system startup.
  */
 bool setup(BelaContext *context, void *userData) {
+    startupProfile.beginSetup();
+
+    // ========================================================================
+    // Embedded Tables
+    // ========================================================================
+    
+    /**
+     * Pre-warp, exponential, note and controller tables are compiled into
+     * the image (TableBank.h); check them against their build-time
+     * checksums before anything reads them
+     */
+    if (const char* corruptTable = TableBank::verify()) {
+        rt_printf("Table %s failed its checksum; the image is corrupt\n", corruptTable);
+        return false;
+    }
+    startupProfile.mark(StartupProfile::kTablesVerified);
+
     // ========================================================================
     // MIDI Interface Initialization
     // ========================================================================
     
     /**
-     * Configure MIDI interface for hardware device "hw:0,0"
-     * This corresponds to the first MIDI interface on the system
+     * Configure MIDI interface for the first hardware device
      */
-    midi.readFrom("hw:0,0");
+    midi.readFrom(kMidiPort);
     
     /**
      * Enable built-in MIDI message parsing for automatic protocol handling
@@ -268,6 +514,16 @@ bool setup(BelaContext *context, void *userData) {
      * Eliminates repeated context dereferencing in audio callback
      */
     float sampleRate = context->audioSampleRate;
+    audioSampleRate = sampleRate;
+    
+    /**
+     * The synthesis path is compiled once per supported rate; refuse to
+     * start rather than run with constants for the wrong rate
+     */
+    if (!isSupportedSampleRate(sampleRate)) {
+        rt_printf("Unsupported sample rate %.0f Hz (supported: 44100, 48000, 88200, 96000)\n", sampleRate);
+        return false;
+    }
     
     /**
      * Calculate and cache audio/analog frame ratio
@@ -277,119 +533,249 @@ bool setup(BelaContext *context, void *userData) {
     gAudioFramesPerAnalogFrame = context->audioFrames / context->analogFrames;
 
     // ========================================================================
-    // Filter Module Initialization
+    // Audio Buffer Allocation
     // ========================================================================
     
     /**
-     * Initialize ZDF Moog ladder filter with current sample rate
-     * Reconfiguration ensures proper coefficient calculation for actual
-     * system sample rate (may differ from default 44.1kHz)
+     * Cache buffer size for memory allocation
+     * Size determined by Bela configuration, typically 64-512 samples
      */
-    zdfFilter = ZDFMoogLadderFilter(sampleRate);
+    bufferSize = context->audioFrames;
+    if (bufferSize > (int)kMaxPeriodFrames) {
+        rt_printf("Block size %d exceeds the supported maximum of %u frames\n", bufferSize, kMaxPeriodFrames);
+        return false;
+    }
     
     /**
-     * Reset filter internal state to prevent initialization artifacts
-     * Clears delay lines and feedback paths for clean startup
+     * Size and reserve the audio arena from the engine configuration
+     * - Per part: the instance object, its sub-block buffers and automation lanes
+     * - Shared sub-block buffers: scheduler scratch and mix buffer per channel
+     * - Period buffers: output buffer and scheduler FIFO per channel
+     * - Post-FX delay lines, sized for the highest supported rate
+     * - Cabinet response, spectra and delay line, sized for the largest period
      */
-    zdfFilter.reset();
+    AudioArenaConfig arenaConfig;
+    arenaConfig.maxVoices = kNumInstances;
+    arenaConfig.oversampling = 1;
+    arenaConfig.periodFrames = kMaxPeriodFrames;
+    arenaConfig.subBlockFrames = kSubBlockFrames;
+    arenaConfig.voiceBuffers = SynthInstance::kSubBlockBuffers;
+    arenaConfig.sharedBuffers = 2 * kNumOutputChannels;
+    arenaConfig.periodBuffers = 2 * kNumOutputChannels;
+    arenaConfig.voiceStateBytes = SynthInstance::requiredStateBytes();
+    arenaConfig.extraBytes = BlockTrace::requiredBytes(kTraceCapacity)
+                           + OverrunCapture::requiredBytes(kCaptureBlocks)
+                           + SessionRecorder::requiredBytes(SessionRecorder::kDefaultRingBytes)
+                           + PostFxChain::requiredBytes(kMaxSupportedSampleRate)
+                           + ImpulseResponse::requiredBytes()
+                           + PartitionedConvolver::requiredBytes(kMaxPeriodFrames);
+    if (!audioArena.reserve(AudioArena::requiredBytes(arenaConfig)))
+        return false;
     
     /**
-     * Configure initial filter parameters
-     * - Cutoff: 1kHz (musically neutral, not too bright or dull)
-     * - Resonance: 0.5 (moderate Q, stable self-oscillation threshold)
-     * - Drive: 1.0 (unity gain, no input saturation)
-     * - Mode: 0 (24dB/octave low-pass, classic Moog response)
+     * Allocate output buffers for final processed audio
+     * Sized to the largest supported period; the scheduler fills the
+     * current period each render call
      */
-    zdfFilter.setCutoff(1000.0f);
-    zdfFilter.setResonance(0.5f);
-    zdfFilter.setDrive(1.0f);
-    zdfFilter.setMode(0);
+    outputBuffer = audioArena.allocateFloats(kMaxPeriodFrames);
+    outputBufferRight = audioArena.allocateFloats(kMaxPeriodFrames);
+    mixBuffer = audioArena.allocateFloats(kSubBlockFrames);
+    mixBufferRight = audioArena.allocateFloats(kSubBlockFrames);
 
     // ========================================================================
-    // Audio Buffer Allocation
+    // Parts
     // ========================================================================
     
     /**
-     * Cache buffer size for memory allocation
-     * Size determined by Bela configuration, typically 64-512 samples
+     * Build each part in the arena with its own noise seed, so the parts'
+     * analog drift does not move in lockstep. One part hears every channel;
+     * with more, part i hears MIDI channel i+1.
      */
-    bufferSize = context->audioFrames;
+    for (unsigned int i = 0; i < kNumInstances; ++i) {
+        instances[i] = audioArena.create<SynthInstance>();
+        if (!instances[i] || !instances[i]->setup(sampleRate, kNoiseSeed + i, audioArena))
+            return false;
+        instances[i]->setMidiChannel(kNumInstances == 1 ? SynthInstance::kOmni : static_cast<int>(i));
+        instances[i]->setStartupProfile(&startupProfile);
+    }
     
     /**
-     * Allocate input buffer for oscillator output staging
-     * Enables separation of synthesis and filtering for modular processing
+     * Post-FX delay lines and limiter buffers
      */
-    inputBuffer = new float[bufferSize];
+    if (!postFx.allocate(audioArena, kMaxSupportedSampleRate))
+        return false;
     
     /**
-     * Allocate output buffer for final processed audio
-     * Provides clean separation between processing stages
+     * Cabinet: a cabinet.wav next to the project replaces the built-in
+     * response; the reconfiguration task renders it and builds its spectra
+     * once audio runs (see CabinetRateBinding)
      */
-    outputBuffer = new float[bufferSize];
-
-    // ========================================================================
-    // Envelope Generator Configuration
-    // ========================================================================
+    if (!cabinetImpulse.allocate(audioArena) || !cabinet.allocate(audioArena, kMaxPeriodFrames))
+        return false;
+    if (cabinetImpulse.loadWav("cabinet.wav"))
+        rt_printf("Cabinet: cabinet.wav, %u frames at %.0f Hz\n", cabinetImpulse.getSourceFrames(),
+                  cabinetImpulse.getSourceRate());
+    cabinet.setImpulse(&cabinetImpulse);
     
     /**
-     * Configure filter envelope parameters
-     * - Attack: 1ms (near-instantaneous response for percussive sounds)
-     * - Decay: 100ms (moderate decay for musical filter sweeps)
-     * - Sustain: 0.75 (maintains 75% of peak level during note hold)
-     * - Release: 200ms (smooth fade-out preventing clicks)
+     * Configure the sub-block scheduler for the two output channels
+     * Report the control latency added when the period is not a multiple
+     * of the sub-block size
      */
-    filterEnv.setADSR(0.001f, 0.1f, 0.75f, 0.2f);
+    SubBlockScheduler::SubBlockCallback renderCallback = selectSubBlockRenderer(sampleRate);
+    if (!subBlockScheduler.setup(bufferSize, kMaxPeriodFrames, kSubBlockFrames, kNumOutputChannels,
+                                 renderCallback, nullptr, audioArena))
+        return false;
+    if (!subBlockScheduler.isDirect())
+        rt_printf("Sub-block scheduler: %u-frame sub-blocks bridged to %d-frame period, +%u frames control latency\n",
+                  kSubBlockFrames, bufferSize, subBlockScheduler.getLatencyFrames());
+
+
+    // ========================================================================
+    // Rate-Dependent Module Initialization
+    // ========================================================================
     
     /**
-     * Set filter envelope depth to 48 semitones (4 octaves)
-     * Provides musically significant frequency modulation range
-     * while preventing excessive filter opening that could cause aliasing
+     * Register every module whose timing depends on the sample rate and
+     * apply the context's rate through the same prepare/commit path used for
+     * run-time changes. Each part registers once and fans out to its MIDI
+     * delay, glide, envelopes, ramp, noise, LFOs and sequencer, which are
+     * constructed for 44.1kHz and would otherwise run at the wrong speed.
      */
-    filterEnv.setEnvDepth(48.0f);
+    for (unsigned int i = 0; i < kNumInstances; ++i)
+        reconfigurePipeline.addListener(instances[i]);
+    reconfigurePipeline.addListener(&postFxRate);
+    reconfigurePipeline.addListener(&cabinetRate);
+    reconfigurePipeline.addListener(&engineRate);
+    EngineRate initialRate = { sampleRate, context->audioFrames, audioRateModulation };
+    if (!reconfigurePipeline.reconfigureNow(initialRate))
+        return false;
+    cabinetRate.setDeferResponse(false);
+    if (!cabinet.supportsPeriod(bufferSize))
+        rt_printf("Cabinet unavailable: %d-frame period is not a power of two\n", bufferSize);
     
     /**
-     * Initialize resonance ramping to moderate value
-     * 0.5 provides good filter character without excessive self-oscillation
+     * Create the auxiliary task that prepares later changes off the audio thread
      */
-    resonanceRamp.setTarget(0.5f);
+    reconfigureTask = Bela_createAuxiliaryTask(prepareReconfiguration, 50, "tr123e-reconfigure");
 
     // ========================================================================
-    // Amplitude Envelope Configuration
+    // Block Trace
     // ========================================================================
     
     /**
-     * Reset amplitude envelope to idle state
-     * Ensures clean initialization without residual envelope activity
+     * Take the trace ring from the arena and name what the viewer shows;
+     * the drain task runs below the reconfiguration task's priority
      */
-    envelope.reset();
+    if (!blockTrace.allocate(kTraceCapacity, kTraceHistory, audioArena))
+        return false;
+    blockTrace.setStageName(kTraceReconfigure, "reconfigure");
+    blockTrace.setStageName(kTraceMidi, "midi");
+    blockTrace.setStageName(kTraceDelayedMidi, "delayed midi");
+    blockTrace.setStageName(kTraceControls, "controls");
+    blockTrace.setStageName(kTraceSequencer, "sequencer");
+    blockTrace.setStageName(kTraceSubBlocks, "sub-blocks");
+    blockTrace.setStageName(kTraceSubBlock, "sub-block");
+    blockTrace.setStageName(kTraceOutput, "output");
+    blockTrace.setStageName(kTracePostFx, "post-fx");
+    blockTrace.setStageName(kTraceCabinet, "cabinet");
+    blockTrace.setParameterName(1, "cc1 mod wheel");
+    blockTrace.setParameterName(11, "cc11 expression");
+    blockTrace.setParameterName(14, "cc14 cutoff");
+    blockTrace.setParameterName(15, "cc15 resonance");
+    blockTrace.setParameterName(16, "cc16 audio-rate modulation");
+    blockTrace.setParameterName(17, "cc17 lfo1 rate");
+    blockTrace.setParameterName(18, "cc18 lfo1 cutoff depth");
+    blockTrace.setParameterName(19, "cc19 lfo2 vibrato depth");
+    blockTrace.setParameterName(20, "cc20 sequencer mode");
+    blockTrace.setParameterName(21, "cc21 swing");
+    blockTrace.setParameterName(22, "cc22 tempo");
+    blockTrace.setParameterName(23, "cc23 stereo spread");
+    blockTrace.setParameterName(24, "cc24 detune");
+    blockTrace.setParameterName(25, "cc25 chorus mix");
+    blockTrace.setParameterName(26, "cc26 delay mix");
+    blockTrace.setParameterName(27, "cc27 delay feedback");
+    blockTrace.setParameterName(28, "cc28 delay time");
+    blockTrace.setParameterName(29, "cc29 cabinet");
+    blockTrace.setParameterName(30, "cc30 automation");
+    blockTrace.setParameterName(31, "cc31 matrix source");
+    blockTrace.setParameterName(32, "cc32 matrix destination");
+    blockTrace.setParameterName(33, "cc33 matrix depth");
+    blockTrace.setParameterName(34, "cc34 velocity curve");
+    blockTrace.setParameterName(35, "cc35 panel instance");
+    blockTrace.setParameterName(kTracePanelCutoff, "panel cutoff");
+    blockTrace.setParameterName(kTracePanelResonance, "panel resonance");
+    blockTrace.setParameterName(kTracePanelMode, "panel mode");
+    blockTrace.setParameterName(kTracePanelGain, "panel gain");
+    blockTrace.setParameterName(kTracePanelDrive, "panel drive");
+    blockTrace.setParameterName(kTracePanelEnvDepth, "panel env depth");
+    blockTrace.setParameterName(kTracePanelAttack, "panel attack");
+    blockTrace.setParameterName(kTracePanelRelease, "panel release");
+    for (unsigned int i = 0; i < kNumInstances; ++i)
+        blockTrace.setEnvelopeName(i, kEnvelopeTraceNames[i]);
+    traceTask = Bela_createAuxiliaryTask(drainTrace, 20, "tr123e-trace");
     
     /**
-     * Configure amplitude envelope timing (values in samples)
-     * - Attack: 441 samples ≈ 10ms (quick response, prevents clicks)
-     * - Decay: 529 samples ≈ 12ms (fast initial decay for punch)
-     * - Release: 11,025 samples ≈ 250ms (musical release tail)
+     * Overrun capture: the modules whose state each block starts from
+     * (part 0's; the capture holds one voice)
      */
-    envelope.setAttackRate(0.01f * sampleRate);
-    envelope.setDecayRate(0.012f * sampleRate);
-    envelope.setReleaseRate(0.25f * sampleRate);
+    if (!overrunCapture.allocate(kCaptureBlocks, audioArena))
+        return false;
+    overrunCapture.bindModules(&instances[0]->getEnvelope(), &instances[0]->getStereoLadder(),
+                               &instances[0]->getPortamentoPlayer(), &instances[0]->getResonanceRamp());
+    captureTask = Bela_createAuxiliaryTask(writeOverrunCapture, 20, "tr123e-overrun");
     
     /**
-     * Set sustain level to 65% of peak amplitude
-     * Balances musical sustain with dynamic range preservation
+     * Session recording; a missing file (read-only or full disk) only
+     * disables the recorder
      */
-    envelope.setSustainLevel(0.65f);
+    if (!sessionRecorder.allocate(SessionRecorder::kDefaultRingBytes, audioArena))
+        return false;
+    if (!sessionRecorder.open())
+        rt_printf("Session recording disabled\n");
+    sessionTask = Bela_createAuxiliaryTask(writeSession, 10, "tr123e-session");
+    startupTask = Bela_createAuxiliaryTask(reportStartup, 5, "tr123e-startup");
+
+    // ========================================================================
+    // Part Defaults
+    // ========================================================================
     
     /**
-     * Configure envelope curvature parameters
-     * - Attack ratio: 0.3 (exponential attack curve)
-     * - Decay/Release ratio: 0.0001 (near-linear decay for natural sound)
-     * 
-     * These parameters control the mathematical curvature of envelope segments,
-     * affecting the perceptual character of amplitude changes
+     * Envelopes, LFOs, matrix, velocity curves and the sequencer pattern;
+     * envelope times are in ticks of the rate committed above
      */
-    envelope.setTargetRatioA(0.3f);
-    envelope.setTargetRatioDR(0.0001f);
+    for (unsigned int i = 0; i < kNumInstances; ++i)
+        instances[i]->loadDefaults();
 
+    // ========================================================================
+    // Post-FX Configuration
+    // ========================================================================
+
+    /**
+     * Chorus and delay start dry (CC 25 / CC 26 bring them in); the delay
+     * defaults to a dotted eighth on the tempo. The limiter is always on,
+     * ceiling -0.3 dBFS.
+     */
+    postFx.getChorus().setRate(0.8f);
+    postFx.getChorus().setDepth(3.0f);
+    postFx.getChorus().setMix(0.0f);
+    postFx.getDelay().setDivision(TempoDelay::kDottedEighth);
+    postFx.getDelay().setFeedback(0.35f);
+    postFx.getDelay().setDamping(4000.0f);
+    postFx.getDelay().setMix(0.0f);
+    postFx.getLimiter().setCeiling(0.966f);
+
+    /**
+     * Freeze the arena: any allocation from here on is a real-time bug
+     */
+    audioArena.lock();
+
+    /**
+     * Recomputes made while configuring are not steady-state load
+     */
+    ParameterUpdate::resetCounts();
+
+    startupProfile.mark(StartupProfile::kSetupEnd);
     return true;
 }
 
@@ -398,13 +784,14 @@ bool setup(BelaContext *context, void *userData) {
  * @brief Real-time audio processing callback
  * 
  * Core real-time audio processing function called at regular intervals
- * (typically every 64-512 samples). Implements complete signal chain from
- * MIDI input through oscillator, envelope, and filter processing to audio output.
+ * (typically every 64-512 samples). Routes MIDI to the parts, runs their
+ * control updates and sub-blocks, and passes the sum through the cabinet
+ * and post-FX chain to the audio output.
  * 
  * @param context Bela audio context with I/O buffers and timing information
  * @param userData User-defined data pointer (unused)
  * 
- * @complexity O(n) where n = context->audioFrames
+ * @complexity O(n * N) where n = context->audioFrames, N = parts
  * @realtime_safety Real-time safe (no dynamic allocation or blocking operations)
  * @latency Ultra-low latency (< 5ms typical processing delay)
  * 
@@ -413,6 +800,25 @@ bool setup(BelaContext *context, void *userData) {
  * must be deterministic and bounded in execution time.
  */
 void render(BelaContext *context, void *userData) {
+    /**
+     * Debug builds (-DTR123E_RT_GUARD) record any allocation or blocking
+     * call made from here down; otherwise this compiles away
+     */
+    RealtimeScope realtimeScope;
+    startupProfile.mark(StartupProfile::kFirstBlock);
+    
+    /**
+     * A period beyond kMaxPeriodFrames cannot be committed (EngineRateBinding
+     * rejects it) and would overrun the period buffers: play silence
+     */
+    if (context->audioFrames > kMaxPeriodFrames) {
+        for (unsigned int n = 0; n < context->audioFrames; n++) {
+            audioWrite(context, n, 0, 0.0f);
+            audioWrite(context, n, 1, 0.0f);
+        }
+        return;
+    }
+
     // ========================================================================
     // TIMING AND SYNCHRONIZATION
     // ========================================================================
@@ -423,6 +829,33 @@ void render(BelaContext *context, void *userData) {
      * Formula: (samples_elapsed / sample_rate) * 1000 = time_in_ms
      */
     float currentTimeMs = context->audioFramesElapsed / context->audioSampleRate * 1000.0f;
+    blockTrace.blockBegin(context->audioFramesElapsed);
+    overrunCapture.beginBlock(context->audioFramesElapsed, context->audioSampleRate, context->audioFrames);
+    overrunCapture.recordAnalog(context->analogIn, context->analogFrames, context->analogInChannels);
+    sessionRecorder.beginBlock(context->audioFramesElapsed, context->audioSampleRate, context->audioFrames,
+                               context->analogFrames, context->analogInChannels);
+
+    // ========================================================================
+    // SAMPLE-RATE / BLOCK-SIZE RECONFIGURATION
+    // ========================================================================
+    
+    /**
+     * If the context no longer matches the active configuration, hand the
+     * rebuild to the auxiliary task; commit it here, at the block boundary,
+     * once it is ready. Until then the previous coefficients stay in use.
+     * The cabinet response setup() left out is rendered the same way, by
+     * preparing the active configuration again for the cabinet alone.
+     */
+    blockTrace.stageBegin(kTraceReconfigure);
+    EngineRate contextRate = { context->audioSampleRate, context->audioFrames, audioRateModulation };
+    bool reconfigure = reconfigurePipeline.request(contextRate);
+    if (!reconfigure && !cabinetRate.isRendered())
+        reconfigure = reconfigurePipeline.refresh(&cabinetRate);
+    if (reconfigure)
+        Bela_scheduleAuxiliaryTask(reconfigureTask);
+    if (reconfigurePipeline.commitIfReady())
+        sessionRecorder.recordCommit();
+    blockTrace.stageEnd(kTraceReconfigure);
 
     // ========================================================================
     // MIDI MESSAGE PROCESSING
@@ -433,327 +866,323 @@ void render(BelaContext *context, void *userData) {
      * Non-blocking iteration ensures real-time safety while handling
      * multiple simultaneous MIDI events with sample-accurate timing
      */
+    blockTrace.stageBegin(kTraceMidi);
     while (midi.getParser()->numAvailableMessages() > 0) {
         MidiChannelMessage message = midi.getParser()->getNextChannelMessage();
         
         /**
-         * Process Note On/Off messages for synthesis control
-         * Both message types handled by unified processor for consistent timing
+         * Log the message as it arrived, before any handling
+         */
+        uint8_t midiBytes[3] = { message.getStatusByte(), 0, 0 };
+        unsigned int numDataBytes = message.getNumDataBytes();
+        for (unsigned int i = 0; i < numDataBytes && i < 2; ++i)
+            midiBytes[1 + i] = message.getDataByte(i);
+        blockTrace.midi(midiBytes[0], midiBytes[1], midiBytes[2]);
+        overrunCapture.recordMidi(midiBytes, 1 + (numDataBytes < 2 ? numDataBytes : 2));
+        sessionRecorder.recordMidi(0, midiBytes, 1 + (numDataBytes < 2 ? numDataBytes : 2));
+        
+        /**
+         * Note On/Off: to every part listening on the message's channel
          */
         if (message.getType() == kmmNoteOn || message.getType() == kmmNoteOff) {
             int note = message.getDataByte(0);      // MIDI note number [0-127]
             int velocity = message.getDataByte(1);  // Velocity value [0-127]
-            midiHandler.processMidiMessage(note, velocity, currentTimeMs);
+            const bool noteOnStatus = message.getType() == kmmNoteOn;
+            for (unsigned int i = 0; i < kNumInstances; ++i)
+                if (instances[i]->acceptsChannel(message.getChannel()))
+                    instances[i]->noteMessage(note, velocity, noteOnStatus, currentTimeMs);
         }
         /**
-         * Process Control Change messages for real-time parameter modification
-         * Implements standard MIDI CC protocol for synthesizer control
+         * Control Change: the engine-wide controllers act on any channel;
+         * the rest belong to the parts listening on the message's channel
          */
         else if (message.getType() == kmmControlChange) {
             int controller = message.getDataByte(0);    // CC number [0-127]
             int value = message.getDataByte(1);         // CC value [0-127]
+            blockTrace.parameter(controller, value / 127.0f);
             
             /**
-             * CC 14: Filter Cutoff Frequency Control
-             * Maps MIDI CC value to exponential frequency range [20Hz - 30kHz]
-             * Formula: f = 20 * (1500^(cc/127)) provides musical frequency scaling
+             * CC 16: Modulation Quality
+             * Values >= 64 evaluate all modulation at audio rate (snappy
+             * attacks); the switch takes effect through the pipeline above
              */
-            if (controller == 14) {
-                baseCutoffFrequency = 20.0f * powf(1500.0f, value / 127.0f);
+            if (controller == 16) {
+                audioRateModulation = value >= 64;
             }
             /**
-             * CC 15: Filter Resonance Control
-             * Linear mapping from MIDI CC to resonance parameter [0.0-1.0]
-             * Higher values increase filter Q and self-oscillation tendency
+             * CC 25: Chorus Mix, dry to an equal blend
+             * CC 26: Delay Mix, 0-100% echo level
+             * CC 27: Delay Feedback, 0-95%
+             * CC 28: Delay Time: 0-63 free, 10 ms-1 s exponential;
+             *        64-127 synced, eight divisions from 1/16 to 1/2
              */
-            else if (controller == 15) {
-                float resonanceValue = value / 127.0f;
-                resonanceRamp.setTarget(resonanceValue);
+            else if (controller == 25) {
+                postFx.getChorus().setMix(value / 127.0f);
+            }
+            else if (controller == 26) {
+                postFx.getDelay().setMix(value / 127.0f);
+            }
+            else if (controller == 27) {
+                postFx.getDelay().setFeedback(value * (0.95f / 127.0f));
+            }
+            else if (controller == 28) {
+                if (value < 64)
+                    postFx.getDelay().setTimeSeconds(0.01f * tableExp2(value * (6.643856f / 63.0f)));
+                else
+                    postFx.getDelay().setDivision((value - 64) / 8);
+            }
+            /**
+             * CC 29: Cabinet, off below 64, on from 64
+             */
+            else if (controller == 29) {
+                cabinet.setEnabled(value >= 64);
+            }
+            /**
+             * CC 35: Panel Instance, the range split evenly over the parts
+             */
+            else if (controller == 35) {
+                panelInstance = value * kNumInstances / 128;
+            }
+            else {
+                for (unsigned int i = 0; i < kNumInstances; ++i)
+                    if (instances[i]->acceptsChannel(message.getChannel()))
+                        instances[i]->controlChange(controller, value, sampleClock);
+            }
+        }
+        /**
+         * Channel pressure: aftertouch source for the parts' matrices
+         */
+        else if (message.getType() == kmmChannelPressure) {
+            for (unsigned int i = 0; i < kNumInstances; ++i)
+                if (instances[i]->acceptsChannel(message.getChannel()))
+                    instances[i]->channelPressure(message.getDataByte(0));
+        }
+        /**
+         * System real-time messages reach every part: MIDI clock drives the
+         * synced LFOs and the sequencers' PLLs
+         * 0xF8 timing clock (24 per beat), 0xFA start, 0xFC stop
+         */
+        else if (message.getType() == kmmSystem) {
+            for (unsigned int i = 0; i < kNumInstances; ++i) {
+                if (message.getStatusByte() == 0xF8)
+                    instances[i]->clockTick(currentTimeMs, sampleClock);
+                else if (message.getStatusByte() == 0xFA)
+                    instances[i]->clockStart();
+                else if (message.getStatusByte() == 0xFC)
+                    instances[i]->clockStop(sampleClock);
             }
         }
     }
+    blockTrace.stageEnd(kTraceMidi);
 
     // ========================================================================
     // MIDI TIMING AND DELAYED MESSAGE PROCESSING
     // ========================================================================
     
     /**
-     * Update MIDI handler timing state for accurate event scheduling
-     * Maintains internal timing reference for sample-accurate MIDI processing
+     * Play the notes whose delay has elapsed, part by part
      */
-    midiHandler.update(currentTimeMs);
+    blockTrace.stageBegin(kTraceDelayedMidi);
+    for (unsigned int i = 0; i < kNumInstances; ++i)
+        instances[i]->processDelayedMidi(currentTimeMs);
+    blockTrace.stageEnd(kTraceDelayedMidi);
 
+    // ========================================================================
+    // ANALOG CONTROL INPUT READING
+    // ========================================================================
+    
     /**
-     * Process all sample-accurate delayed MIDI messages
-     * Handles messages that require precise timing alignment with audio samples
-     * for glitch-free note transitions and envelope triggering
+     * Read analog control potentiometers [0.0-1.0] once per period
+     * The most recent analog frame is used; sub-blocks read the cached values
      */
-    while (midiHandler.hasDelayedMessage()) {
-        MidiNoteMessage delayedMsg = midiHandler.popDelayedMessage();
-        
-        /**
-         * Parse velocity to determine note-on vs note-off state
-         * Implements MIDI standard where velocity 0 = note-off
-         */
-        bool noteOn = velocityParser.isNoteOn(delayedMsg.velocity);
-        
-        /**
-         * Analyze portamento requirements based on playing technique
-         * Determines whether smooth pitch transition is appropriate
-         * based on note overlap timing and musical context
-         */
-        bool portamento = portamentoFilter.checkPortamento(
-            delayedMsg.noteNumber, noteOn, delayedMsg.timestamp);
-        
-        /**
-         * Convert MIDI velocity to normalized amplitude scaling [0.0-1.0]
-         * Provides velocity-sensitive filter envelope response
-         */
-        float velocityScaled = delayedMsg.velocity / 127.0f;
-
-        /**
-         * Process note-on events: trigger all synthesis modules
-         */
-        if (noteOn) {
-            // Trigger pitch generator with portamento logic
-            portamentoPlayer.noteOn(delayedMsg.noteNumber, portamento);
-            
-            // Trigger amplitude envelope
-            envelope.gate(1);
-            
-            // Trigger filter envelope with velocity sensitivity
-            filterEnv.gate(1, velocityScaled);
-        } 
-        /**
-         * Process note-off events: release all synthesis modules
-         */
-        else {
-            // Release pitch generator (maintains current pitch)
-            portamentoPlayer.noteOff();
-            
-            // Trigger amplitude envelope release
-            envelope.gate(0);
-            
-            // Trigger filter envelope release
-            filterEnv.gate(0, 0.0f);
-        }
-
-        /**
-         * Set resonance emphasis during note events
-         * Creates characteristic filter "pop" during note articulation
-         * typical of classic analog synthesizers
-         */
-        resonanceRamp.setTarget(0.7f);
-    }
+    blockTrace.stageBegin(kTraceControls);
+    unsigned int analogIndex = context->analogFrames - 1;
+    panel.cutoff = analogRead(context, analogIndex, 0);         // Filter cutoff
+    panel.resonance = analogRead(context, analogIndex, 1);      // Filter resonance
+    
+    /**
+     * Read filter mode selection from analog input
+     * Maps continuous [0.0-1.0] to discrete mode values [0-2]
+     * Modes: 0=LP24, 1=BP12, 2=HP24
+     */
+    panel.mode = static_cast<int>(analogRead(context, analogIndex, 2) * 3.0f);
+    
+    /**
+     * Read additional control parameters from analog inputs
+     */
+    panel.outGain = analogRead(context, analogIndex, 3) * 2.0f; // Output gain [0-2]
+    panel.drive = analogRead(context, analogIndex, 4);          // Filter drive [0-1]
+    panel.envDepth = analogRead(context, analogIndex, 5);       // Envelope depth [0-1]
+    panel.attack = analogRead(context, analogIndex, 6);         // Attack time [0-1]
+    panel.release = analogRead(context, analogIndex, 7);        // Release time [0-1]
+    sessionRecorder.recordAnalog(&context->analogIn[analogIndex * context->analogInChannels],
+                                 context->analogInChannels);
+    
+    /**
+     * The pots set the selected part; every part then runs its automation
+     * and period-rate parameter updates
+     */
+    instances[panelInstance]->setPanel(panel);
+    for (unsigned int i = 0; i < kNumInstances; ++i)
+        instances[i]->updateControls(context->audioFrames, sampleClock);
+    
+    /**
+     * Trace the selected part's panel only when a control actually moves
+     */
+    const PanelControls& tracedPanel = instances[panelInstance]->getPanel();
+    blockTrace.parameterIfChanged(kTracePanelCutoff, tracedPanel.cutoff, kTracePanelThreshold);
+    blockTrace.parameterIfChanged(kTracePanelResonance, tracedPanel.resonance, kTracePanelThreshold);
+    blockTrace.parameterIfChanged(kTracePanelMode, static_cast<float>(tracedPanel.mode), 0.5f);
+    blockTrace.parameterIfChanged(kTracePanelGain, tracedPanel.outGain, kTracePanelThreshold);
+    blockTrace.parameterIfChanged(kTracePanelDrive, tracedPanel.drive, kTracePanelThreshold);
+    blockTrace.parameterIfChanged(kTracePanelEnvDepth, tracedPanel.envDepth, kTracePanelThreshold);
+    blockTrace.parameterIfChanged(kTracePanelAttack, tracedPanel.attack, kTracePanelThreshold);
+    blockTrace.parameterIfChanged(kTracePanelRelease, tracedPanel.release, kTracePanelThreshold);
+    blockTrace.stageEnd(kTraceControls);
 
     // ========================================================================
-    // AUDIO SAMPLE PROCESSING LOOP
+    // SEQUENCER SCHEDULING
     // ========================================================================
     
     /**
-     * Static variable for output gain to maintain state between function calls
-     * Note: Double semicolon appears to be a typo in original code
+     * Generate sequencer events for every frame this call can render
+     * (one period, plus one sub-block rendered ahead when bridging)
      */
-    static float outGain;
+    blockTrace.stageBegin(kTraceSequencer);
+    for (unsigned int i = 0; i < kNumInstances; ++i)
+        instances[i]->scheduleSequencer(sampleClock + context->audioFrames + kSubBlockFrames);
+    blockTrace.stageEnd(kTraceSequencer);
+
+    // ========================================================================
+    // SUB-BLOCK PROCESSING
+    // ========================================================================
     
     /**
-     * Process each audio sample in the current buffer
-     * Implements complete synthesis chain: oscillator → envelope → filter → output
+     * Run synthesis and filtering in fixed-size sub-blocks
+     * The scheduler fills exactly context->audioFrames of both output buffers
      */
-    for(unsigned int n = 0; n < context->audioFrames; n++) {
-        // ====================================================================
-        // ANALOG CONTROL INPUT PROCESSING
-        // ====================================================================
-        
-        /**
-         * Calculate analog input index based on audio/analog frame ratio
-         * Analog inputs sampled at lower rate than audio (typically 8:1)
-         * This indexing ensures proper correlation between control and audio timing
-         */
-        unsigned int analogIndex = n / gAudioFramesPerAnalogFrame;
+    blockTrace.stageBegin(kTraceSubBlocks);
+    float* outputs[kNumOutputChannels] = { outputBuffer, outputBufferRight };
+    subBlockScheduler.process(outputs, context->audioFrames);
+    blockTrace.stageEnd(kTraceSubBlocks);
 
-        // ====================================================================
-        // SYNTHESIS MODULE PROCESSING
-        // ====================================================================
-        
-        /**
-         * Generate amplitude envelope value [0.0-1.0]
-         * Provides time-varying amplitude control for musical articulation
-         */
-        float envValue = envelope.process();
-        
-        /**
-         * Generate current oscillator frequency from portamento processor
-         * Returns frequency in Hz with smooth transitions between notes
-         */
-        float freq = portamentoPlayer.process();
-        
-        /**
-         * Calculate keyboard tracking contribution to filter frequency
-         * Higher notes slightly open filter for consistent timbre across range
-         */
-        float keyFollowValue = keyFollow.process(portamentoPlayer.getCurrentNote());
-        
-        /**
-         * Generate filter cutoff frequency from envelope and key tracking
-         * Combines base frequency, envelope modulation, and keyboard tracking
-         */
-        float filterCutoff = filterEnv.process(baseCutoffFrequency, keyFollowValue);
-        
-        // ====================================================================
-        // ANALOG CONTROL INPUT READING
-        // ====================================================================
-        
-        /**
-         * Read analog control potentiometers [0.0-1.0]
-         * Hardware control integration for real-time parameter adjustment
-         */
-        float cutoffPot = analogRead(context, analogIndex, 0);      // Filter cutoff
-        float resonancePot = analogRead(context, analogIndex, 1);   // Filter resonance
-        
-        /**
-         * Read filter mode selection from analog input
-         * Maps continuous [0.0-1.0] to discrete mode values [0-2]
-         * Modes: 0=LP24, 1=LP12, 2=HP12, 3=BP12 (depending on filter implementation)
-         */
-        int mode = static_cast<int>(analogRead(context, analogIndex, 2) * 3.0f);
-        
-        /**
-         * Read additional control parameters from analog inputs
-         */
-        outGain = analogRead(context, analogIndex, 3) * 2.0f;       // Output gain [0-2]
-        float drive = analogRead(context, analogIndex, 4);          // Filter drive [0-1]
-        float envDepth = analogRead(context, analogIndex, 5);       // Envelope depth [0-1]
-        float attack = analogRead(context, analogIndex, 6);         // Attack time [0-1]
-        float release = analogRead(context, analogIndex, 7);        // Release time [0-1]
-        
-        // ====================================================================
-        // REAL-TIME PARAMETER UPDATES
-        // ====================================================================
-        
-        /**
-         * Update filter resonance with smooth ramping
-         * Prevents audio artifacts from abrupt parameter changes
-         */
-        resonanceRamp.setTarget(resonancePot);
-        float resonance = resonanceRamp.process();
-        
-        /**
-         * Update filter parameters for current sample
-         * Combines envelope-generated cutoff with manual control
-         */
-        zdfFilter.setCutoff(filterCutoff * (0.2f + cutoffPot));  // Min 20% + pot control
-        zdfFilter.setResonance(resonance);
-        zdfFilter.setMode(mode);
-        zdfFilter.setDrive(drive);
-
-        /**
-         * Update envelope parameters in real-time
-         * Allows dynamic response characteristics during performance
-         */
-        
-        // Filter envelope depth: 0-96 semitones (8 octaves maximum)
-        filterEnv.setEnvDepth(envDepth * 48.0f);
-        
-        // Attack time: 1ms to 1 second exponential mapping
-        envelope.setAttackRate(0.001f * context->audioSampleRate + 
-                              attack * 1.0f * context->audioSampleRate);
-        
-        // Release time: 5ms to 2 seconds exponential mapping  
-        envelope.setReleaseRate(0.005f * context->audioSampleRate + 
-                               release * 1.995f * context->audioSampleRate);
+    // ========================================================================
+    // CABINET
+    // ========================================================================
+    
+    /**
+     * Convolve the period with the cabinet response; a no-op while it is off
+     */
+    blockTrace.stageBegin(kTraceCabinet);
+    cabinet.process(outputBuffer, outputBufferRight, context->audioFrames);
+    blockTrace.stageEnd(kTraceCabinet);
 
-        // ====================================================================
-        // OSCILLATOR PROCESSING
-        // ====================================================================
-        
-        /**
-         * Generate oscillator output using Direct Digital Synthesis (DDS)
-         * Implements conditional processing for CPU efficiency
-         */
-        float oscillatorOut = 0.0f;
-        
-        /**
-         * Only generate oscillator output when envelope is active
-         * Saves CPU cycles during silent periods (envelope in idle state)
-         */
-        if(envelope.getState() != env_idle) {
-            /**
-             * Generate sine wave using phase accumulator method
-             * sin(φ) where φ = accumulated phase [0, 2π]
-             */
-            oscillatorOut = sinf(oscillatorPhase);
-            
-            /**
-             * Update phase accumulator for next sample
-             * Phase increment = 2π * frequency / sample_rate
-             * This implements the fundamental DDS frequency equation
-             */
-            oscillatorPhase += twoPi * freq / context->audioSampleRate;
-            
-            /**
-             * Phase wrapping to prevent floating-point precision loss
-             * Maintains phase within [0, 2π] range for optimal accuracy
-             */
-            if(oscillatorPhase >= twoPi)
-                oscillatorPhase -= twoPi;
-            
-            /**
-             * Apply amplitude envelope to oscillator output
-             * Creates time-varying amplitude response for musical articulation
-             */
-            oscillatorOut *= envValue;
-        } else {
-            /**
-             * Reset oscillator phase during silent periods
-             * Ensures clean restart for next note-on event
-             */
-            oscillatorPhase = 0.0f;
-            oscillatorOut = 0.0f;
-        }
+    // ========================================================================
+    // POST-FX
+    // ========================================================================
+    
+    /**
+     * Chorus, delay and limiter over the whole period; the delay follows
+     * the MIDI clock's tempo while one runs, otherwise part 0's internal tempo
+     */
+    blockTrace.stageBegin(kTracePostFx);
+    postFx.getDelay().setBeatSamples(instances[0]->getSequencer().getBeatSamples(sampleClock));
+    postFx.process(outputBuffer, outputBufferRight, context->audioFrames);
+    blockTrace.stageEnd(kTracePostFx);
 
-        /**
-         * Apply output scaling to prevent clipping
-         * 50% scaling provides headroom for filter resonance peaks
-         */
-        oscillatorOut *= 0.5f;
-        
-        /**
-         * Store oscillator output in input buffer for filter processing
-         * Separation allows for potential future multi-stage processing
-         */
-        inputBuffer[n] = oscillatorOut;
-    }
-	
     // ========================================================================
-    // FILTER PROCESSING
+    // AUDIO OUTPUT
     // ========================================================================
     
     /**
-     * Apply filter processing to entire buffer
-     * Separate loop allows for potential SIMD optimization and
-     * maintains clean separation between synthesis and filtering stages
+     * Write the stereo mix to the two output channels
      */
+    blockTrace.stageBegin(kTraceOutput);
     for(unsigned int n = 0; n < context->audioFrames; n++) {
-        /**
-         * Process each sample through ZDF Moog ladder filter
-         * Apply output gain control for final level adjustment
-         */
-        outputBuffer[n] = zdfFilter.process(inputBuffer[n]) * outGain;
+        audioWrite(context, n, 0, outputBuffer[n]);         // Left channel
+        audioWrite(context, n, 1, outputBufferRight[n]);    // Right channel
     }
+    blockTrace.stageEnd(kTraceOutput);
 
     // ========================================================================
-    // AUDIO OUTPUT
+    // BLOCK TRACE
     // ========================================================================
     
     /**
-     * Write processed audio to both output channels (stereo)
-     * Monophonic synthesizer output duplicated to both channels
-     * for standard stereo compatibility
+     * Close the block against its period and wake the drain task when the
+     * ring is filling up or an overrun needs exporting; an overrun also
+     * freezes the input capture for its writer task
      */
-    for(unsigned int n = 0; n < context->audioFrames; n++) {
-        audioWrite(context, n, 0, outputBuffer[n]);  // Left channel
-        audioWrite(context, n, 1, outputBuffer[n]);  // Right channel
+    uint64_t periodNs = static_cast<uint64_t>(context->audioFrames * 1e9 / context->audioSampleRate);
+    for (unsigned int i = 0; i < kNumInstances; ++i) {
+        ADSR& envelope = instances[i]->getEnvelope();
+        blockTrace.envelope(i, envelope.getState(), envelope.getOutput());
+        instances[i]->endPeriod(static_cast<double>(periodNs));
+    }
+    blockTrace.blockEnd(periodNs);
+    if (blockTrace.needsDrain())
+        Bela_scheduleAuxiliaryTask(traceTask);
+    if (overrunCapture.endBlock(periodNs))
+        Bela_scheduleAuxiliaryTask(captureTask);
+    sessionRecorder.recordOutput(outputBuffer, context->audioFrames);
+    sessionRecorder.recordOutput(outputBufferRight, context->audioFrames);
+    if (sessionRecorder.endBlock())
+        Bela_scheduleAuxiliaryTask(sessionTask);
+    if (!startupReported && startupProfile.isMarked(StartupProfile::kFirstNote)) {
+        startupReported = true;
+        Bela_scheduleAuxiliaryTask(startupTask);
+    }
+}
+
+/**
+ * @function renderSubBlock
+ * @brief One fixed-size sub-block of every part, summed
+ * 
+ * Called by subBlockScheduler with frames == kSubBlockFrames. Part 0
+ * renders straight into the outputs; each further part renders into the
+ * mix buffers, which are added to them.
+ * 
+ * @tparam Rate Sample rate in Hz; all rate-derived constants (phase
+ *              increment scale, cutoff pre-warp) are compile-time values
+ * @param outputs Left and right output channels, `frames` samples each
+ * @param frames Sub-block length (always kSubBlockFrames)
+ * @param userData Unused
+ * 
+ * @realtime_safety Real-time safe (no dynamic allocation or blocking operations)
+ */
+template <int Rate>
+void renderSubBlock(float* const* outputs, unsigned int frames, void* userData) {
+    float* outputL = outputs[0];
+    float* outputR = outputs[1];
+    blockTrace.stageBegin(kTraceSubBlock);
+    
+    instances[0]->renderSubBlock<Rate>(outputL, outputR, frames, sampleClock);
+    for (unsigned int i = 1; i < kNumInstances; ++i) {
+        instances[i]->renderSubBlock<Rate>(mixBuffer, mixBufferRight, frames, sampleClock);
+        for (unsigned int n = 0; n < frames; n++) {
+            outputL[n] += mixBuffer[n];
+            outputR[n] += mixBufferRight[n];
+        }
+    }
+    
+    sampleClock += frames;
+    blockTrace.stageEnd(kTraceSubBlock);
+}
+
+/**
+ * @function selectSubBlockRenderer
+ * @brief Pick the renderSubBlock instantiation for a sample rate
+ * 
+ * @param sampleRate Audio rate from the Bela context
+ * @return Matching instantiation, or nullptr for an unsupported rate
+ */
+SubBlockScheduler::SubBlockCallback selectSubBlockRenderer(float sampleRate) {
+    switch (static_cast<int>(sampleRate + 0.5f)) {
+        case 44100: return renderSubBlock<44100>;
+        case 48000: return renderSubBlock<48000>;
+        case 88200: return renderSubBlock<88200>;
+        case 96000: return renderSubBlock<96000>;
+        default: return nullptr;
     }
 }
 
@@ -767,7 +1196,7 @@ void render(BelaContext *context, void *userData) {
  * @param context Bela audio context (unused in cleanup)
  * @param userData User-defined data pointer (unused)
  * 
- * @complexity O(1) - Constant time cleanup
+ * @complexity O(N) in the number of parts
  * @realtime_safety Non-real-time safe (performs memory deallocation)
  * 
  * @note This function is called outside the real-time audio context
@@ -775,14 +1204,49 @@ void render(BelaContext *context, void *userData) {
  */
 void cleanup(BelaContext *context, void *userData) {
     /**
-     * Deallocate input buffer memory
-     * Prevents memory leaks on system shutdown
+     * Write out whatever the trace holds before its ring goes with the arena
+     */
+    if (!blockTrace.flush())
+        rt_printf("Block trace could not be written\n");
+    sessionRecorder.close();
+    if (!startupReported)
+        startupProfile.report(stdout);
+    fprintf(stdout, "Instance CPU (share of real time):\n");
+    for (unsigned int i = 0; i < kNumInstances; ++i)
+        if (instances[i])
+            instances[i]->reportLoad(stdout, i);
+    postFx.report(stdout);
+    ParameterUpdate::report(stdout, sampleClock / static_cast<double>(audioSampleRate));
+    RealtimeGuard::report(stdout);
+    
+    /**
+     * Messages lost to a full MIDI delay queue; a lost note-off is otherwise
+     * only heard as a hung note
      */
-    delete[] inputBuffer;
+    unsigned int droppedMidi = 0;
+    for (unsigned int i = 0; i < kNumInstances; ++i)
+        if (instances[i])
+            droppedMidi += instances[i]->getDroppedMidiMessages();
+    if (droppedMidi == 0) {
+        fprintf(stdout, "MIDI: no messages dropped\n");
+    }
+    else {
+        fprintf(stdout, "MIDI: %u message%s dropped at a full delay queue (notes may have hung)\n", droppedMidi,
+                droppedMidi == 1 ? "" : "s");
+        for (unsigned int i = 0; i < kNumInstances; ++i)
+            if (instances[i] && instances[i]->getDroppedMidiMessages() > 0)
+                fprintf(stdout, "  instance %u: %u\n", i, instances[i]->getDroppedMidiMessages());
+    }
     
     /**
-     * Deallocate output buffer memory  
-     * Completes memory management for audio buffers
+     * Release the audio arena
+     * Frees every part, audio buffer and the scheduler FIFO in one call
      */
-    delete[] outputBuffer;
-}
\ No newline at end of file
+    audioArena.release();
+    for (unsigned int i = 0; i < kNumInstances; ++i)
+        instances[i] = nullptr;
+    outputBuffer = nullptr;
+    outputBufferRight = nullptr;
+    mixBuffer = nullptr;
+    mixBufferRight = nullptr;
+}
@@ -9,6 +9,8 @@
  */
 
 #include "zdf_moogladder_v2.h"
+#include "ParameterUpdate.h"
+#include "SampleRate.h"
 
 /**
  * @brief Utility function for parameter range validation and clamping
@@ -48,7 +50,8 @@ inline float clamp_float(float x, float minVal, float maxVal) {
  * - LP24 mode: Classic Moog low-pass characteristic
  */
 ZDFMoogLadderFilter::ZDFMoogLadderFilter(float sampleRate)
-    : sampleRate(sampleRate), drive(1.0f), mode(LP24) {
+    : sampleRate(sampleRate), stagedSampleRate(sampleRate), appliedCutoff(0.0f), cutoffDirty(false),
+      drive(1.0f), mode(LP24) {
     /**
      * Initialize all state variables to zero for clean startup
      * Prevents artifacts from uninitialized memory content
@@ -61,17 +64,30 @@ ZDFMoogLadderFilter::ZDFMoogLadderFilter(float sampleRate)
      */
     setCutoff(1000.0f);
     setResonance(0.5f);
+    updateCoefficients();
 }
 
 /**
- * @brief Configure filter cutoff frequency with automatic validation and warping
+ * @brief Store a cutoff target for the next process()
  * 
  * @param cutoffHz Desired cutoff frequency in Hertz
  * 
+ * Callers set the cutoff once per sample, mostly with the value they set
+ * last time; a pre-warp is only scheduled when it moved beyond
+ * kCutoffEpsilon of the cutoff in use.
+ */
+void ZDFMoogLadderFilter::setCutoff(float cutoffHz) {
+    targetCutoff = cutoffHz;
+    if (ParameterUpdate::changed(cutoffHz, appliedCutoff, kCutoffEpsilon))
+        cutoffDirty = true;
+}
+
+/**
+ * @brief Validate and pre-warp the target cutoff
+ * 
  * @algorithm_implementation
  * 1. **Parameter Validation**: Clamp frequency to safe operating range
  * 2. **Frequency Pre-warping**: Calculate G coefficient for ZDF accuracy
- * 3. **Feedback Update**: Recalculate feedback gain for resonance scaling
  * 
  * @frequency_limits_rationale
  * - Lower limit (20 Hz): Below human hearing threshold, prevents DC issues
@@ -88,29 +104,29 @@ ZDFMoogLadderFilter::ZDFMoogLadderFilter(float sampleRate)
  * - Provides sample-rate independent frequency response
  * 
  * @computational_analysis
- * - tanf() function: ~15-20 CPU cycles on modern processors
- * - Frequency clamping: ~3-5 CPU cycles for conditional logic
- * - Total overhead: Negligible compared to per-sample processing
- * - Call frequency: Typically infrequent (user parameter changes)
+ * - G and 1/(1+G) come from the embedded pre-warp table (prewarpCutoff(),
+ *   SampleRate.h): one division and two interpolated lookups, no tanf(),
+ *   so constructing the filter in setup() does no transcendental math
+ * - Call frequency: once per process() after the cutoff actually moved
  */
-void ZDFMoogLadderFilter::setCutoff(float cutoffHz) {
+void ZDFMoogLadderFilter::updateCoefficients() {
     /**
      * Validate and clamp cutoff frequency to safe operating range
      * Prevents aliasing (upper limit) and DC/stability issues (lower limit)
      */
-    cutoffHz = clamp_float(cutoffHz, 20.0f, sampleRate * 0.45f);
+    const float cutoffHz = clamp_float(targetCutoff, 20.0f, sampleRate * 0.45f);
     
     /**
-     * Calculate frequency warping coefficient for ZDF accuracy
-     * Ensures digital filter cutoff matches analog prototype frequency
+     * Frequency warping coefficient G = tan(π·fc/fs) and stage gain
+     * 1/(1+G) from the pre-warp table
      */
-    G = tanf(M_PI * cutoffHz / sampleRate);
+    const WarpedCutoff warped = prewarpCutoff(cutoffHz, sampleRate);
+    G = warped.g;
+    stageGain = warped.stageGain;
     
-    /**
-     * Update feedback gain to maintain proper resonance scaling
-     * Coupling between frequency and resonance ensures consistent behavior
-     */
-    feedbackGain = resonance * 4.0f;
+    appliedCutoff = targetCutoff;
+    cutoffDirty = false;
+    ParameterUpdate::count(ParameterUpdate::kLadder);
 }
 
 /**
@@ -273,7 +289,7 @@ void ZDFMoogLadderFilter::reset() {
  * **Phase 3: Four-Stage TPT Ladder Processing**
  * For each stage i ∈ [0,3]:
  * ```cpp
- * float v = (u - z[i]) / (1.0f + G);     // TPT integrator input calculation
+ * float v = (u - z[i]) * stageGain;       // TPT integrator input, stageGain = 1/(1+G)
  * stage[i] = v + z[i];                   // Stage output (current sample)
  * z[i] = stage[i] + v;                   // State update (next sample)
  * u = stage[i];                          // Cascade to next stage
@@ -370,6 +386,9 @@ void ZDFMoogLadderFilter::reset() {
  * - Natural envelope following for musical content
  */
 float ZDFMoogLadderFilter::process(float input) {
+    if (cutoffDirty)
+        updateCoefficients();
+    
     /**
      * Phase 1: Feedback Signal Extraction and Conditioning
      * 
@@ -406,7 +425,7 @@ float ZDFMoogLadderFilter::process(float input) {
          * TPT integrator calculation with zero-delay feedback
          * v represents the input to the integrator after state feedback
          */
-        float v = (u - z[i]) / (1.0f + G);
+        float v = (u - z[i]) * stageGain;
         
         /**
          * Stage output combines integrator input and current state
@@ -535,4 +554,55 @@ float ZDFMoogLadderFilter::process(float input) {
  * Its combination of accuracy, efficiency, and musical utility makes it
  * suitable for both professional audio applications and educational use
  * in demonstrating the principles of virtual analog modeling.
- */
\ No newline at end of file
+ */
+
+/**
+ * @brief Stage a new sample rate for setCutoff()
+ */
+bool ZDFMoogLadderFilter::prepareSampleRate(float newSampleRate) {
+    if (newSampleRate <= 0.0f)
+        return false;
+    stagedSampleRate = newSampleRate;
+    return true;
+}
+
+/**
+ * @brief Copy out everything process() reads and writes
+ */
+void ZDFMoogLadderFilter::saveSnapshot(Snapshot& snapshot) const {
+    snapshot.sampleRate = sampleRate;
+    snapshot.targetCutoff = targetCutoff;
+    snapshot.appliedCutoff = appliedCutoff;
+    snapshot.cutoffDirty = cutoffDirty ? 1 : 0;
+    snapshot.resonance = resonance;
+    snapshot.feedbackGain = feedbackGain;
+    snapshot.G = G;
+    snapshot.stageGain = stageGain;
+    snapshot.drive = drive;
+    snapshot.mode = static_cast<int>(mode);
+    for (int i = 0; i < 4; ++i) {
+        snapshot.stage[i] = stage[i];
+        snapshot.z[i] = z[i];
+    }
+}
+
+/**
+ * @brief Restore a saved state; the staged rate follows the live one
+ */
+void ZDFMoogLadderFilter::loadSnapshot(const Snapshot& snapshot) {
+    sampleRate = snapshot.sampleRate;
+    stagedSampleRate = snapshot.sampleRate;
+    targetCutoff = snapshot.targetCutoff;
+    appliedCutoff = snapshot.appliedCutoff;
+    cutoffDirty = snapshot.cutoffDirty != 0;
+    resonance = snapshot.resonance;
+    feedbackGain = snapshot.feedbackGain;
+    G = snapshot.G;
+    stageGain = snapshot.stageGain;
+    drive = snapshot.drive;
+    mode = static_cast<FilterMode>(snapshot.mode);
+    for (int i = 0; i < 4; ++i) {
+        stage[i] = snapshot.stage[i];
+        z[i] = snapshot.z[i];
+    }
+}
@@ -227,15 +227,17 @@ public:
      * 
      * Configures the filter's cutoff frequency using frequency pre-warping to ensure
      * accurate analog modeling across different sample rates. The method automatically
-     * clamps frequency values to prevent aliasing and numerical instability while
-     * recalculating internal coefficients for immediate effect.
+     * clamps frequency values to prevent aliasing and numerical instability. The
+     * coefficients are derived lazily: the target is stored here and the next
+     * process() pre-warps it, only when it moved by more than kCutoffEpsilon
+     * (relative) from the cutoff in use (ParameterUpdate.h).
      * 
      * @param cutoffHz Desired cutoff frequency in Hz
      *                 Automatically clamped to [20.0, sampleRate × 0.45] Hz
      *                 Upper limit prevents aliasing (below Nyquist frequency)
      *                 Lower limit ensures musical relevance and numerical stability
      * 
-     * @complexity O(1) - Single transcendental function call (tanf)
+     * @complexity O(1) - One compare; the table pre-warp runs in process()
      * @precision IEEE 754 single precision with frequency pre-warping
      * @realtime_safety Real-time safe (no allocation, bounded execution time)
      * 
@@ -247,11 +249,6 @@ public:
      * transform, ensuring that the digital filter's cutoff frequency exactly
      * matches the analog prototype frequency regardless of sample rate.
      * 
-     * @parameter_interaction
-     * Changing cutoff frequency also updates the feedback gain calculation
-     * to maintain proper resonance scaling relative to the new frequency setting.
-     * This ensures consistent resonance behavior across the frequency range.
-     * 
      * @musical_frequency_guidelines
      * - Bass frequencies: 20-200 Hz (sub-bass and bass fundamentals)
      * - Mid-range: 200-2000 Hz (vocal and instrumental fundamentals)
@@ -266,6 +263,41 @@ public:
      */
     void setCutoff(float cutoffHz);
     
+    /**
+     * @brief Set pre-warped cutoff coefficients directly
+     * 
+     * Fast path for per-sample cutoff modulation. The caller supplies
+     * G = tan(π × cutoff / sampleRate) and the stage gain 1/(1+G), normally
+     * from SampleRateTraits<Rate>::prewarp(), so neither tanf() nor any
+     * division runs here.
+     * 
+     * @param g Pre-warped frequency coefficient (already range-limited)
+     * @param stageGainValue 1 / (1 + g)
+     * 
+     * Supersedes a cutoff still pending from setCutoff(); the next
+     * setCutoff() always re-derives.
+     * 
+     * @complexity O(1) - Two assignments
+     * @realtime_safety Real-time safe
+     */
+    void setWarpedCutoff(float g, float stageGainValue) {
+        G = g;
+        stageGain = stageGainValue;
+        appliedCutoff = 0.0f;
+        cutoffDirty = false;
+    }
+    
+    /**
+     * @brief Pre-warp the pending cutoff now
+     * 
+     * process() calls this when setCutoff() moved the target; calling it
+     * earlier only moves the work.
+     */
+    void updateCoefficients();
+    
+    /** @brief Relative cutoff change below which no pre-warp is redone (~0.2 cent) */
+    static constexpr float kCutoffEpsilon = 1e-4f;
+    
     /**
      * @brief Configure filter resonance with automatic range validation
      * 
@@ -468,7 +500,8 @@ public:
      * Core processing method that implements the complete ZDF ladder filter
      * algorithm including nonlinear feedback, four-stage processing, and
      * mode-dependent output selection. This method must be called once per
-     * audio sample to maintain proper filter timing and response.
+     * audio sample to maintain proper filter timing and response. A cutoff
+     * pending from setCutoff() is pre-warped first.
      * 
      * @param input Single audio sample for filtering
      *              Range: [-1.0, +1.0] typical for normalized audio
@@ -552,6 +585,57 @@ public:
      * consistent loudness across resonance settings in musical applications.
      */
     float process(float input);
+    
+    /**
+     * @brief Stage a new sample rate
+     * 
+     * Only setCutoff() and its clamp depend on the rate; the per-sample path
+     * in render.cpp supplies pre-warped coefficients from the compile-time
+     * table of the matching SampleRateTraits instantiation.
+     * 
+     * @param newSampleRate New audio sample rate in Hz
+     * @return false for a non-positive rate
+     */
+    bool prepareSampleRate(float newSampleRate);
+    
+    /**
+     * @brief Adopt the staged sample rate (real-time safe)
+     * 
+     * G and stageGain were pre-warped for the old rate, so the cutoff is
+     * marked for re-derivation even though it did not move.
+     */
+    void commitSampleRate() {
+        sampleRate = stagedSampleRate;
+        cutoffDirty = true;
+    }
+    
+    /**
+     * @struct Snapshot
+     * @brief Complete filter state: coefficients, mode and ladder memory
+     * 
+     * Captured at a block boundary by the overrun post-mortem and loaded
+     * back on the host to replay the block exactly.
+     */
+    struct Snapshot {
+        float sampleRate;
+        float targetCutoff;
+        float appliedCutoff;
+        int cutoffDirty;
+        float resonance;
+        float feedbackGain;
+        float G;
+        float stageGain;
+        float drive;
+        int mode;
+        float stage[4];
+        float z[4];
+    };
+    
+    /** @brief Copy the filter state out (real-time safe) */
+    void saveSnapshot(Snapshot& snapshot) const;
+    
+    /** @brief Replace the filter state with a saved one (real-time safe) */
+    void loadSnapshot(const Snapshot& snapshot);
 
 private:
     /**
@@ -567,6 +651,9 @@ private:
      */
     float sampleRate;
     
+    /** @brief Sample rate staged by prepareSampleRate() */
+    float stagedSampleRate;
+    
     /**
      * @brief Current resonance setting [0.0-1.0]
      * 
@@ -604,6 +691,23 @@ private:
      */
     float G;
     
+    /**
+     * @brief Integrator input gain 1 / (1 + G)
+     * 
+     * Cached with G so the four ladder stages multiply instead of dividing
+     * by (1 + G) on every sample.
+     */
+    float stageGain;
+    
+    /** @brief Cutoff last passed to setCutoff(), in Hz (before the clamp) */
+    float targetCutoff;
+    
+    /** @brief Cutoff G and stageGain were derived from; 0 after setWarpedCutoff() */
+    float appliedCutoff;
+    
+    /** @brief targetCutoff still has to be pre-warped */
+    bool cutoffDirty;
+    
     /**
      * @brief Nonlinear feedback drive amount [0.0-1.0]
      * 